@@ -0,0 +1,567 @@
+/*
+ * Time-budgeted Monte Carlo tree search advisor for interactive play.
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "advisor.h"
+#include "policy.h"
+#include "batch.h"
+
+// Answers one turn can need replayed, and answers between two searches
+#define ADVISOR_MAX_PREFIX 64
+#define ADVISOR_MAX_PATH 128
+
+// Exploration constant for UCB1; survival odds are small, so keep it modest
+#define ADVISOR_UCB_C 0.35
+
+// Start the tree afresh once this much of the pool is in use
+#define ADVISOR_POOL_REFILL (ADVISOR_POOL_NODES / 4 * 3)
+
+// Shooting answers are replayed but never searched
+#define ANSWER_SHOT -1
+
+typedef struct {
+    atomic_int first_child;     // -1 for none
+    int next_sibling;           // Written before the node is published
+    int key;                    // kind * ADVISOR_MAX_ACTIONS + action
+    atomic_uint visits;         // Counted on the way down, so a running rollout is a loss
+    atomic_uint wins;
+} AdvisorNode;
+
+typedef struct {
+    int kind;                   // AdviceKind or ANSWER_SHOT
+    int value;                  // What the player answered
+    int action;                 // The matching tree action, -1 if none
+} Answer;
+
+typedef struct RolloutWorker RolloutWorker;
+
+struct Advisor {
+    const Policy* player;
+    const Policy* rollout_policy;
+    double budget;
+    int threads;
+
+    AdvisorNode* nodes;
+    atomic_int node_count;
+    int root;                   // -1 until the first search
+
+    // Position the rollouts restart from
+    GameState turn_start;
+    unsigned int turn_random;
+    Answer prefix[ADVISOR_MAX_PREFIX];      // Answers given so far this turn
+    int prefix_count;
+    Answer pending[ADVISOR_MAX_PATH];       // Answers since the root's prompt
+    int pending_count;
+
+    // Search in progress
+    double deadline;
+    atomic_uint_fast64_t new_rollouts;
+
+    // Worker threads, started once and woken for each search
+    RolloutWorker* workers;
+    pthread_t* handles;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint64_t generation;
+    int running;
+    int stopping;
+};
+
+struct RolloutWorker {
+    Advisor* advisor;
+    Policy policy;
+    uint64_t rng;
+    int replay_pos;
+    int root_done;
+    int in_tree;
+    int node;
+    int path_len;
+    int path[ADVISOR_MAX_PATH];
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t worker_random(RolloutWorker* worker) {
+    worker->rng ^= worker->rng >> 12;
+    worker->rng ^= worker->rng << 25;
+    worker->rng ^= worker->rng >> 27;
+    return worker->rng * 0x2545f4914f6cdd1dull;
+}
+
+// Fort actions spend none, a quarter, half or all of the cash on the item
+static int fort_amount(int cash, int action) {
+    static const int quarters[ADVISOR_MAX_ACTIONS] = {0, 1, 2, 4};
+    return cash > 0 ? cash * quarters[action] / 4 : 0;
+}
+
+// Node pool
+
+static int new_node(Advisor* advisor, int key) {
+    int index = atomic_fetch_add(&advisor->node_count, 1);
+    if (index >= ADVISOR_POOL_NODES) {
+        return -1;
+    }
+    AdvisorNode* node = &advisor->nodes[index];
+    atomic_store_explicit(&node->first_child, -1, memory_order_relaxed);
+    node->next_sibling = -1;
+    node->key = key;
+    atomic_store_explicit(&node->visits, 0, memory_order_relaxed);
+    atomic_store_explicit(&node->wins, 0, memory_order_relaxed);
+    return index;
+}
+
+static int find_child_from(const Advisor* advisor, int child, int key) {
+    for (; child >= 0; child = advisor->nodes[child].next_sibling) {
+        if (advisor->nodes[child].key == key) {
+            return child;
+        }
+    }
+    return -1;
+}
+
+static int find_child(Advisor* advisor, int parent, int key) {
+    int head = atomic_load_explicit(&advisor->nodes[parent].first_child, memory_order_acquire);
+    return find_child_from(advisor, head, key);
+}
+
+// Find or publish the child for key; -1 when the pool is exhausted
+static int add_child(Advisor* advisor, int parent, int key) {
+    atomic_int* head_slot = &advisor->nodes[parent].first_child;
+    int head = atomic_load_explicit(head_slot, memory_order_acquire);
+    int fresh = -1;
+
+    for (;;) {
+        int found = find_child_from(advisor, head, key);
+        if (found >= 0) {
+            return found; // Another worker got there first; a fresh node is simply left unused
+        }
+        if (fresh < 0 && (fresh = new_node(advisor, key)) < 0) {
+            return -1;
+        }
+        advisor->nodes[fresh].next_sibling = head;
+        if (atomic_compare_exchange_weak_explicit(head_slot, &head, fresh,
+                                                  memory_order_release, memory_order_acquire)) {
+            return fresh;
+        }
+    }
+}
+
+// Tree policy: try every action once, then UCB1
+static int select_action(RolloutWorker* worker, int kind, int first, int last) {
+    Advisor* advisor = worker->advisor;
+    int parent = worker->node;
+    int best = -1, best_child = -1;
+    double best_score = -1.0;
+    double log_visits = log((double)atomic_load_explicit(&advisor->nodes[parent].visits,
+                                                         memory_order_relaxed) + 1.0);
+
+    for (int a = first; a <= last; a++) {
+        int child = find_child(advisor, parent, kind * ADVISOR_MAX_ACTIONS + a);
+        if (child < 0) {
+            best = a;
+            best_child = -1;
+            break;
+        }
+        unsigned int visits = atomic_load_explicit(&advisor->nodes[child].visits, memory_order_relaxed);
+        unsigned int wins = atomic_load_explicit(&advisor->nodes[child].wins, memory_order_relaxed);
+        double score = visits ? (double)wins / visits + ADVISOR_UCB_C * sqrt(log_visits / visits) : 2.0;
+        if (score > best_score) {
+            best_score = score;
+            best = a;
+            best_child = child;
+        }
+    }
+
+    if (best_child < 0) {
+        best_child = add_child(advisor, parent, kind * ADVISOR_MAX_ACTIONS + best);
+        worker->in_tree = 0; // One new node per rollout
+        if (best_child < 0) {
+            return best;
+        }
+    }
+    atomic_fetch_add_explicit(&advisor->nodes[best_child].visits, 1, memory_order_relaxed);
+    if (worker->path_len < ADVISOR_MAX_PATH) {
+        worker->path[worker->path_len++] = best_child;
+    }
+    worker->node = best_child;
+    return best;
+}
+
+// The answer at a rollout prompt: returns 1 with *value set while replaying
+// this turn's answers, otherwise 0 with *action the tree's pick or -1 to leave
+// the prompt to the rollout policy
+static int next_answer(RolloutWorker* worker, int kind, int first, int last, int* value, int* action) {
+    Advisor* advisor = worker->advisor;
+
+    if (worker->replay_pos < advisor->prefix_count) {
+        *value = advisor->prefix[worker->replay_pos++].value;
+        return 1;
+    }
+    *action = -1;
+    if (kind == ANSWER_SHOT) {
+        return 0;
+    }
+    if (!worker->root_done) {
+        worker->root_done = 1;
+        *action = select_action(worker, kind, first, last);
+        // From here on the future is a fresh sample
+        seed_random((unsigned int)(worker_random(worker) >> 33) & SEED_MASK);
+    } else if (worker->in_tree) {
+        *action = select_action(worker, kind, first, last);
+    }
+    return 0;
+}
+
+static int rollout_turn_action(const GameState* game, int fort_open, void* ctx) {
+    RolloutWorker* worker = (RolloutWorker*)ctx;
+    const Policy* fallback = worker->advisor->rollout_policy;
+    int value, action;
+    if (next_answer(worker, ADVICE_TURN, fort_open ? 0 : 1, 2, &value, &action)) {
+        return value;
+    }
+    return action >= 0 ? action + 1 : fallback->turn_action(game, fort_open, fallback->ctx);
+}
+
+static int rollout_eating_level(const GameState* game, void* ctx) {
+    RolloutWorker* worker = (RolloutWorker*)ctx;
+    const Policy* fallback = worker->advisor->rollout_policy;
+    int value, action;
+    if (next_answer(worker, ADVICE_EAT, 0, 2, &value, &action)) {
+        return value;
+    }
+    return action >= 0 ? action + 1 : fallback->eating_level(game, fallback->ctx);
+}
+
+static int rollout_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    RolloutWorker* worker = (RolloutWorker*)ctx;
+    const Policy* fallback = worker->advisor->rollout_policy;
+    int kind = hostile ? ADVICE_RIDERS_HOSTILE : ADVICE_RIDERS_FRIENDLY;
+    int value, action;
+    if (next_answer(worker, kind, 0, 3, &value, &action)) {
+        return value;
+    }
+    return action >= 0 ? action + 1 : fallback->rider_tactic(game, hostile, fallback->ctx);
+}
+
+static int rollout_fort_purchase(const GameState* game, int item, void* ctx) {
+    RolloutWorker* worker = (RolloutWorker*)ctx;
+    const Policy* fallback = worker->advisor->rollout_policy;
+    int value, action;
+    if (next_answer(worker, ADVICE_FORT + item, 0, 3, &value, &action)) {
+        return value;
+    }
+    return action >= 0 ? fort_amount(game->cash, action) : fallback->fort_purchase(game, item, fallback->ctx);
+}
+
+static int rollout_shot_result(int skill_level, const char* word, void* ctx) {
+    RolloutWorker* worker = (RolloutWorker*)ctx;
+    int value, action;
+    if (next_answer(worker, ANSWER_SHOT, 0, 0, &value, &action)) {
+        return value;
+    }
+    return bot_shot_result(skill_level, word, NULL);
+}
+
+static void rollout(RolloutWorker* worker) {
+    Advisor* advisor = worker->advisor;
+    TripResult result;
+
+    worker->replay_pos = 0;
+    worker->root_done = 0;
+    worker->in_tree = 1;
+    worker->node = advisor->root;
+    worker->path_len = 0;
+    atomic_fetch_add_explicit(&advisor->nodes[advisor->root].visits, 1, memory_order_relaxed);
+
+    resume_trip(&advisor->turn_start, advisor->turn_random, &worker->policy, &result);
+
+    if (result.outcome == TRIP_ARRIVED) {
+        atomic_fetch_add_explicit(&advisor->nodes[advisor->root].wins, 1, memory_order_relaxed);
+        for (int i = 0; i < worker->path_len; i++) {
+            atomic_fetch_add_explicit(&advisor->nodes[worker->path[i]].wins, 1, memory_order_relaxed);
+        }
+    }
+}
+
+static void* advisor_worker_main(void* arg) {
+    RolloutWorker* worker = (RolloutWorker*)arg;
+    Advisor* advisor = worker->advisor;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&advisor->lock);
+    for (;;) {
+        while (advisor->generation == seen && !advisor->stopping) {
+            pthread_cond_wait(&advisor->start, &advisor->lock);
+        }
+        if (advisor->stopping) {
+            break;
+        }
+        seen = advisor->generation;
+        double deadline = advisor->deadline;
+        pthread_mutex_unlock(&advisor->lock);
+
+        uint64_t count = 0;
+        while (now_seconds() < deadline) {
+            rollout(worker);
+            count++;
+        }
+        atomic_fetch_add(&advisor->new_rollouts, count);
+
+        pthread_mutex_lock(&advisor->lock);
+        if (--advisor->running == 0) {
+            pthread_cond_signal(&advisor->done);
+        }
+    }
+    pthread_mutex_unlock(&advisor->lock);
+    return NULL;
+}
+
+Advisor* advisor_create(int threads, double budget_seconds, const Policy* rollout_policy) {
+    Advisor* advisor = calloc(1, sizeof(Advisor));
+    if (!advisor) {
+        return NULL;
+    }
+    advisor->threads = threads > 0 ? threads : batch_default_threads();
+    advisor->budget = budget_seconds > 0 ? budget_seconds : ADVISOR_DEFAULT_BUDGET;
+    advisor->rollout_policy = rollout_policy ? rollout_policy : &cautious_policy;
+    advisor->root = -1;
+    advisor->nodes = malloc(ADVISOR_POOL_NODES * sizeof(AdvisorNode));
+    advisor->workers = calloc((size_t)advisor->threads, sizeof(RolloutWorker));
+    advisor->handles = calloc((size_t)advisor->threads, sizeof(pthread_t));
+    if (!advisor->nodes || !advisor->workers || !advisor->handles) {
+        free(advisor->nodes);
+        free(advisor->workers);
+        free(advisor->handles);
+        free(advisor);
+        return NULL;
+    }
+    atomic_init(&advisor->node_count, 0);
+    atomic_init(&advisor->new_rollouts, 0);
+    pthread_mutex_init(&advisor->lock, NULL);
+    pthread_cond_init(&advisor->start, NULL);
+    pthread_cond_init(&advisor->done, NULL);
+
+    for (int w = 0; w < advisor->threads; w++) {
+        RolloutWorker* worker = &advisor->workers[w];
+        Policy policy = {
+            "advisor rollout", rollout_turn_action, rollout_eating_level, rollout_rider_tactic,
+            rollout_fort_purchase, rollout_shot_result, worker
+        };
+        worker->advisor = advisor;
+        worker->policy = policy;
+        worker->rng = 0x9e3779b97f4a7c15ull * (uint64_t)(w + 1) ^ (uint64_t)time(NULL);
+        if (worker->rng == 0) {
+            worker->rng = 1;
+        }
+    }
+    // Searches wait only for the workers that started
+    advisor->threads = start_worker_threads(advisor->handles, advisor->threads, advisor_worker_main,
+                                            advisor->workers, sizeof(RolloutWorker));
+    if (advisor->threads == 0) {
+        advisor_destroy(advisor);
+        return NULL;
+    }
+    return advisor;
+}
+
+void advisor_destroy(Advisor* advisor) {
+    if (!advisor) {
+        return;
+    }
+    pthread_mutex_lock(&advisor->lock);
+    advisor->stopping = 1;
+    pthread_cond_broadcast(&advisor->start);
+    pthread_mutex_unlock(&advisor->lock);
+    for (int w = 0; w < advisor->threads; w++) {
+        pthread_join(advisor->handles[w], NULL);
+    }
+    pthread_mutex_destroy(&advisor->lock);
+    pthread_cond_destroy(&advisor->start);
+    pthread_cond_destroy(&advisor->done);
+    free(advisor->nodes);
+    free(advisor->workers);
+    free(advisor->handles);
+    free(advisor);
+}
+
+// Follow the answers given since the last search down to the new root, or
+// start a fresh tree if they left it or the pool is running low
+static void advance_root(Advisor* advisor) {
+    int root = advisor->root;
+
+    for (int i = 0; i < advisor->pending_count && root >= 0; i++) {
+        const Answer* answer = &advisor->pending[i];
+        root = answer->action < 0 ? -1
+               : find_child(advisor, root, answer->kind * ADVISOR_MAX_ACTIONS + answer->action);
+    }
+    if (root < 0 || atomic_load(&advisor->node_count) > ADVISOR_POOL_REFILL) {
+        atomic_store(&advisor->node_count, 0);
+        root = new_node(advisor, -1);
+    }
+    advisor->root = root;
+    advisor->pending_count = 0;
+}
+
+// Search the prompt of the given kind, whose position is turn_start plus prefix
+static void advise(Advisor* advisor, const GameState* game, int kind, int first, int last,
+                   Advice* advice) {
+    advance_root(advisor);
+    atomic_store(&advisor->new_rollouts, 0);
+
+    double start = now_seconds();
+    pthread_mutex_lock(&advisor->lock);
+    advisor->deadline = start + advisor->budget;
+    advisor->running = advisor->threads;
+    advisor->generation++;
+    pthread_cond_broadcast(&advisor->start);
+    while (advisor->running > 0) {
+        pthread_cond_wait(&advisor->done, &advisor->lock);
+    }
+    pthread_mutex_unlock(&advisor->lock);
+
+    memset(advice, 0, sizeof(*advice));
+    advice->kind = kind;
+    advice->first_action = first;
+    advice->action_count = last + 1;
+    advice->best = last;
+    advice->rollouts = atomic_load(&advisor->nodes[advisor->root].visits);
+    advice->new_rollouts = atomic_load(&advisor->new_rollouts);
+    advice->seconds = now_seconds() - start;
+
+    // Recommend the most visited action, the usual robust choice
+    uint32_t best_visits = 0;
+    for (int a = first; a <= last; a++) {
+        int child = find_child(advisor, advisor->root, kind * ADVISOR_MAX_ACTIONS + a);
+        if (kind >= ADVICE_FORT) {
+            advice->answers[a] = fort_amount(game->cash, a);
+        } else if (kind == ADVICE_TURN && first > 0) {
+            advice->answers[a] = a; // Without a fort the prompt numbers from hunt
+        } else {
+            advice->answers[a] = a + 1;
+        }
+        if (child < 0) {
+            continue;
+        }
+        advice->visits[a] = atomic_load(&advisor->nodes[child].visits);
+        advice->survival[a] = advice->visits[a] ?
+            (double)atomic_load(&advisor->nodes[child].wins) / advice->visits[a] : 0.0;
+        if (advice->visits[a] > best_visits) {
+            best_visits = advice->visits[a];
+            advice->best = a;
+        }
+    }
+    advice->answer = advice->answers[advice->best];
+}
+
+static void print_advice(const Advice* advice) {
+    const char* unit = advice->kind >= ADVICE_FORT ? "$" : "";
+
+    printf("[ADVISOR: %s%d, SURVIVAL %.0f%% --", unit, advice->answer,
+           100.0 * advice->survival[advice->best]);
+    for (int a = advice->first_action; a < advice->action_count; a++) {
+        printf(" %s%d: %.0f%%", unit, advice->answers[a], 100.0 * advice->survival[a]);
+    }
+    printf(" (%llu ROLLOUTS, %.0f MS)]\n", (unsigned long long)advice->rollouts,
+           advice->seconds * 1e3);
+}
+
+// Note an answer the player gave, for replay this turn and for moving the root
+static void record_answer(Advisor* advisor, int kind, int value, int action) {
+    Answer answer = {kind, value, action};
+    if (advisor->prefix_count < ADVISOR_MAX_PREFIX) {
+        advisor->prefix[advisor->prefix_count++] = answer;
+    }
+    if (kind != ANSWER_SHOT && advisor->pending_count < ADVISOR_MAX_PATH) {
+        advisor->pending[advisor->pending_count++] = answer;
+    }
+}
+
+// The wrapped player: hint first, then let the player answer
+
+static int advised_turn_action(const GameState* game, int fort_open, void* ctx) {
+    Advisor* advisor = (Advisor*)ctx;
+    Advice advice;
+
+    // A new turn: every rollout restarts from here
+    advisor->turn_start = *game;
+    advisor->turn_random = get_random_state();
+    advisor->prefix_count = 0;
+
+    advise(advisor, game, ADVICE_TURN, fort_open ? 0 : 1, 2, &advice);
+    print_advice(&advice);
+    int value = advisor->player->turn_action(game, fort_open, advisor->player->ctx);
+    int action = (value >= (fort_open ? ACTION_FORT : ACTION_HUNT) && value <= ACTION_CONTINUE)
+                 ? value - 1 : ACTION_CONTINUE - 1;
+    record_answer(advisor, ADVICE_TURN, value, action);
+    return value;
+}
+
+static int advised_eating_level(const GameState* game, void* ctx) {
+    Advisor* advisor = (Advisor*)ctx;
+    Advice advice;
+
+    advise(advisor, game, ADVICE_EAT, 0, 2, &advice);
+    print_advice(&advice);
+    int value = advisor->player->eating_level(game, advisor->player->ctx);
+    record_answer(advisor, ADVICE_EAT, value, (value >= 1 && value <= 3) ? value - 1 : 2);
+    return value;
+}
+
+static int advised_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    Advisor* advisor = (Advisor*)ctx;
+    int kind = hostile ? ADVICE_RIDERS_HOSTILE : ADVICE_RIDERS_FRIENDLY;
+    Advice advice;
+
+    advise(advisor, game, kind, 0, 3, &advice);
+    print_advice(&advice);
+    int value = advisor->player->rider_tactic(game, hostile, advisor->player->ctx);
+    int action = (value >= TACTIC_RUN && value <= TACTIC_CIRCLE_WAGONS)
+                 ? value - 1 : TACTIC_CIRCLE_WAGONS - 1;
+    record_answer(advisor, kind, value, action);
+    return value;
+}
+
+static int advised_fort_purchase(const GameState* game, int item, void* ctx) {
+    Advisor* advisor = (Advisor*)ctx;
+    Advice advice;
+
+    advise(advisor, game, ADVICE_FORT + item, 0, 3, &advice);
+    print_advice(&advice);
+    int value = advisor->player->fort_purchase(game, item, advisor->player->ctx);
+    int action = -1;
+    for (int a = 0; a < ADVISOR_MAX_ACTIONS; a++) {
+        if (fort_amount(game->cash, a) == value) {
+            action = a;
+            break;
+        }
+    }
+    record_answer(advisor, ADVICE_FORT + item, value, action);
+    return value;
+}
+
+static int advised_shot_result(int skill_level, const char* word, void* ctx) {
+    Advisor* advisor = (Advisor*)ctx;
+    int value = advisor->player->shot_result(skill_level, word, advisor->player->ctx);
+    record_answer(advisor, ANSWER_SHOT, value, -1);
+    return value;
+}
+
+void advisor_wrap_policy(Advisor* advisor, const Policy* player, Policy* wrapped) {
+    advisor->player = player;
+    wrapped->name = player->name;
+    wrapped->turn_action = advised_turn_action;
+    wrapped->eating_level = advised_eating_level;
+    wrapped->rider_tactic = advised_rider_tactic;
+    wrapped->fort_purchase = advised_fort_purchase;
+    wrapped->shot_result = advised_shot_result;
+    wrapped->ctx = advisor;
+}
@@ -0,0 +1,69 @@
+/*
+ * Time-budgeted Monte Carlo tree search advisor for interactive play.
+ *
+ * At each trip prompt the advisor searches the decisions ahead for a fixed
+ * wall-clock budget and reports the answer with the best estimated survival
+ * odds. The search is open-loop: tree nodes stand for sequences of decisions,
+ * and every rollout draws fresh chance events, so the hint never depends on
+ * the live game's own random sequence.
+ *
+ * Rollouts start from the state captured at the turn-action prompt. Prompts
+ * later in the turn (fort purchases, eating, riders) are reached again by
+ * replaying the answers already given this turn with the generator state the
+ * turn started with, which reproduces the live position exactly; the
+ * generator is reseeded right after the decision being searched.
+ *
+ * Nodes come from a fixed pool that is allocated once. Worker threads share
+ * the tree without locks: statistics are atomic counters, a visit counts as a
+ * loss until its rollout finishes, and children are published with a
+ * compare-and-swap on the parent's list head. After the player answers, the
+ * subtree below that answer becomes the next root, so work carries over from
+ * prompt to prompt until the pool runs low and the tree is started afresh.
+ */
+
+#ifndef ADVISOR_H
+#define ADVISOR_H
+
+#include <stdint.h>
+#include "oregon.h"
+
+#define ADVISOR_DEFAULT_BUDGET 0.050    // Seconds of search per prompt
+#define ADVISOR_POOL_NODES (1 << 19)
+#define ADVISOR_MAX_ACTIONS 4
+
+// Prompt kinds the advisor searches
+typedef enum {
+    ADVICE_TURN = 0,            // Actions ACTION_FORT .. ACTION_CONTINUE
+    ADVICE_EAT,                 // Eating levels 1-3
+    ADVICE_RIDERS_FRIENDLY,     // TACTIC_*
+    ADVICE_RIDERS_HOSTILE,
+    ADVICE_FORT,                // + ITEM_*; spend none, a quarter, half or all of the cash
+    ADVICE_KIND_COUNT = ADVICE_FORT + ITEM_COUNT
+} AdviceKind;
+
+typedef struct {
+    int kind;                   // AdviceKind
+    int first_action;           // Valid actions first_action .. action_count - 1
+    int action_count;
+    int best;                   // Index of the recommended action
+    int answer;                 // What to type for it (a choice, or dollars at the fort)
+    int answers[ADVISOR_MAX_ACTIONS];
+    double survival[ADVISOR_MAX_ACTIONS];
+    uint32_t visits[ADVISOR_MAX_ACTIONS];
+    uint64_t rollouts;          // Rollouts through the root, including carried-over ones
+    uint64_t new_rollouts;      // Rollouts run for this prompt
+    double seconds;
+} Advice;
+
+typedef struct Advisor Advisor;
+
+// threads 0 picks the number of online CPUs; rollout_policy plays beyond the tree.
+// Returns NULL if memory runs out or no worker thread starts
+Advisor* advisor_create(int threads, double budget_seconds, const Policy* rollout_policy);
+void advisor_destroy(Advisor* advisor);
+
+// Wrap player so every trip prompt first prints the advisor's hint; the
+// wrapper's ctx is the advisor, which must outlive it
+void advisor_wrap_policy(Advisor* advisor, const Policy* player, Policy* wrapped);
+
+#endif // ADVISOR_H
@@ -0,0 +1,235 @@
+/*
+ * Multithreaded batch runner for headless trips.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "batch.h"
+#include "trail.h"
+
+// Trips handed to a worker at a time
+#define BATCH_CHUNK 1024
+
+#define BATCH_PROBE_TRIPS 64    // Played for batch_job_digest
+
+typedef struct {
+    const BatchJob* job;
+    atomic_uint_fast64_t* next_trip;
+    int worker;
+    BatchStats stats;
+} BatchWorker;
+
+void batch_stats_add(BatchStats* stats, const TripResult* result) {
+    stats->trips++;
+    stats->turn_sum += (uint64_t)result->turn_number;
+
+    if (result->outcome == TRIP_ARRIVED) {
+        stats->arrived++;
+        stats->arrival_day_sum += (uint64_t)result->arrival_day;
+        stats->arrival_day_sq_sum += (uint64_t)result->arrival_day * (uint64_t)result->arrival_day;
+        stats->cash_sum += result->cash;
+    } else if (result->outcome == TRIP_DIED) {
+        stats->deaths[result->death_cause]++;
+    } else {
+        stats->abandoned++;
+    }
+}
+
+void batch_stats_merge(BatchStats* into, const BatchStats* from) {
+    into->trips += from->trips;
+    into->arrived += from->arrived;
+    for (int i = 0; i < DEATH_CAUSE_COUNT; i++) {
+        into->deaths[i] += from->deaths[i];
+    }
+    into->abandoned += from->abandoned;
+    into->turn_sum += from->turn_sum;
+    into->arrival_day_sum += from->arrival_day_sum;
+    into->arrival_day_sq_sum += from->arrival_day_sq_sum;
+    into->cash_sum += from->cash_sum;
+}
+
+void batch_stats_print(FILE* out, const BatchStats* stats) {
+    static const char* cause_names[DEATH_CAUSE_COUNT] = {
+        "starvation", "exhaustion", "disease", "injuries",
+        "winter blizzard", "snakebite", "massacre"
+    };
+    double trips = stats->trips ? (double)stats->trips : 1.0;
+    double arrived = stats->arrived ? (double)stats->arrived : 1.0;
+
+    fprintf(out, "trips            %llu\n", (unsigned long long)stats->trips);
+    fprintf(out, "survival rate    %.4f\n", (double)stats->arrived / trips);
+    fprintf(out, "mean turns       %.3f\n", (double)stats->turn_sum / trips);
+    fprintf(out, "mean arrival day %.3f\n", (double)stats->arrival_day_sum / arrived);
+    fprintf(out, "mean cash left   %.2f\n", (double)stats->cash_sum / arrived);
+    for (int i = 0; i < DEATH_CAUSE_COUNT; i++) {
+        fprintf(out, "died of %-16s %llu\n", cause_names[i], (unsigned long long)stats->deaths[i]);
+    }
+    if (stats->abandoned) {
+        fprintf(out, "abandoned        %llu\n", (unsigned long long)stats->abandoned);
+    }
+}
+
+int batch_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+int start_worker_threads(pthread_t* handles, int count, void* (*worker_main)(void*), void* workers,
+                         size_t worker_size) {
+    for (int w = 0; w < count; w++) {
+        if (pthread_create(&handles[w], NULL, worker_main, (char*)workers + (size_t)w * worker_size) != 0) {
+            return w;
+        }
+    }
+    return count;
+}
+
+void run_worker_threads(void* (*worker_main)(void*), void* workers, size_t worker_size, int count) {
+    pthread_t* handles = calloc((size_t)count, sizeof(pthread_t));
+    int started = handles ? start_worker_threads(handles, count, worker_main, workers, worker_size) : 0;
+
+    for (int w = started; w < count; w++) {
+        worker_main((char*)workers + (size_t)w * worker_size);
+    }
+    for (int w = 0; w < started; w++) {
+        pthread_join(handles[w], NULL);
+    }
+    free(handles);
+}
+
+void default_purchase_plan(PurchasePlan* plan) {
+    plan->shooting_skill = 2;
+    plan->oxen = 250;
+    plan->food = 180;
+    plan->ammunition = 50;
+    plan->clothing = 110;
+    plan->misc_supplies = 60;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t hash_trail(uint64_t hash, const Trail* trail) {
+    hash = fnv1a(hash, trail->name, strlen(trail->name));
+    hash = fnv1a(hash, trail->segments, (size_t)trail->segment_count * sizeof(TrailSegment));
+    return fnv1a(hash, trail->mile_segment, (size_t)trail->length + 1);
+}
+
+uint64_t batch_trail_digest(const Trail* trail) {
+    return hash_trail(0xcbf29ce484222325ull, trail);
+}
+
+uint64_t batch_rules_digest(void) {
+    int rules[2] = {OREGON_RULES_REVISION, AVAILABLE_MONEY};
+    uint64_t hash = fnv1a(0xcbf29ce484222325ull, rules, sizeof(rules));
+    return fnv1a(hash, event_probabilities, sizeof(event_probabilities));
+}
+
+uint64_t batch_job_digest(const BatchJob* job) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    TripResult probe;
+
+    hash = fnv1a(hash, job->policy->name, strlen(job->policy->name));
+    hash = fnv1a(hash, &job->plan, sizeof(job->plan));
+    hash = hash_trail(hash, current_trail());
+    for (unsigned int seed = 1; seed <= BATCH_PROBE_TRIPS; seed++) {
+        if (simulate_trip(&job->plan, job->policy, seed, NULL, NULL, &probe) == 0) {
+            hash = fnv1a(hash, &probe, sizeof(probe));
+        }
+    }
+    return hash;
+}
+
+TripKernel batch_job_kernel(const BatchJob* job) {
+    if (job->generic || job->on_turn) {
+        return NULL;
+    }
+    return find_trip_kernel(job->policy, job->plan.shooting_skill);
+}
+
+void batch_play_range(const BatchJob* job, int worker, uint64_t first, uint64_t last,
+                      BatchStats* stats) {
+    void* ctx = job->worker_ctx ? job->worker_ctx[worker] : NULL;
+    TripKernel kernel = batch_job_kernel(job);
+    TripResult result;
+
+    for (uint64_t i = first; i < last; i++) {
+        unsigned int seed = (unsigned int)((job->first_seed + i) & SEED_MASK);
+        if (kernel) {
+            kernel(&job->plan, seed, &result);
+        } else {
+            simulate_trip(&job->plan, job->policy, seed, job->on_turn, ctx, &result);
+        }
+        batch_stats_add(stats, &result);
+        if (job->on_trip) {
+            job->on_trip(worker, seed, &result, ctx);
+        }
+    }
+}
+
+static void* batch_worker_main(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    const BatchJob* job = worker->job;
+    uint64_t handed_out = 0;
+
+    if (job->on_chunk) {
+        job->on_chunk(worker->worker, &worker->stats, handed_out, 0, job->chunk_ctx);
+    }
+    for (;;) {
+        uint64_t first = atomic_fetch_add(worker->next_trip, BATCH_CHUNK);
+        if (first >= job->trips) {
+            break;
+        }
+        uint64_t last = first + BATCH_CHUNK;
+        if (last > job->trips) {
+            last = job->trips;
+        }
+        handed_out = last;
+        batch_play_range(job, worker->worker, first, last, &worker->stats);
+        if (job->on_chunk) {
+            job->on_chunk(worker->worker, &worker->stats, handed_out, 0, job->chunk_ctx);
+        }
+    }
+    if (job->on_chunk) {
+        job->on_chunk(worker->worker, &worker->stats, job->trips, 1, job->chunk_ctx);
+    }
+    return NULL;
+}
+
+// Play every trip of the job; returns 0, or -1 if the purchase plan is invalid
+int run_batch(const BatchJob* job, BatchStats* stats) {
+    GameState probe;
+    atomic_uint_fast64_t next_trip;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+
+    if (apply_purchase_plan(&probe, &job->plan) != 0) {
+        return -1;
+    }
+
+    BatchWorker* workers = calloc((size_t)threads, sizeof(BatchWorker));
+    if (!workers) {
+        return -1;
+    }
+
+    atomic_init(&next_trip, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].job = job;
+        workers[w].next_trip = &next_trip;
+        workers[w].worker = w;
+    }
+    run_worker_threads(batch_worker_main, workers, sizeof(BatchWorker), threads);
+
+    memset(stats, 0, sizeof(BatchStats));
+    for (int w = 0; w < threads; w++) {
+        batch_stats_merge(stats, &workers[w].stats);
+    }
+
+    free(workers);
+    return 0;
+}
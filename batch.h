@@ -0,0 +1,106 @@
+/*
+ * Multithreaded batch runner for headless trips.
+ *
+ * A batch plays trips with consecutive seeds, first_seed, first_seed + 1, ...
+ * (kept to the 31 bits the generator uses). Each trip depends only on its
+ * seed, and the statistics are plain integer sums, so the result is identical
+ * for any thread count and any split of the seed range.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "oregon.h"
+#include "kernels.h"
+#include "trail.h"
+
+#define SEED_MASK 0x7fffffffu
+
+// Mergeable outcome statistics
+typedef struct {
+    uint64_t trips;
+    uint64_t arrived;
+    uint64_t deaths[DEATH_CAUSE_COUNT];
+    uint64_t abandoned;          // Stopped early by a hook, see abandon_trip
+    uint64_t turn_sum;           // Turns played, all trips
+    uint64_t arrival_day_sum;    // Arrived trips only
+    uint64_t arrival_day_sq_sum; // Arrived trips only
+    int64_t cash_sum;            // Cash left, arrived trips only
+} BatchStats;
+
+// Called once per finished trip on the worker thread that played it
+typedef void (*TripHook)(int worker, unsigned int seed, const TripResult* result, void* ctx);
+
+// Progress of run_batch, on the worker's thread: once as it starts, after each
+// chunk it plays, and with finished set as it stops. totals are the worker's
+// trips so far; handed_out is how many of the job's trips had been given to
+// any worker when it last took a chunk
+typedef void (*ChunkHook)(int worker, const BatchStats* totals, uint64_t handed_out, int finished, void* ctx);
+
+typedef struct {
+    PurchasePlan plan;
+    const Policy* policy;
+    unsigned int first_seed;
+    uint64_t trips;
+    int threads;            // 0 picks the number of online CPUs
+    int generic;            // 1 never plays a trip kernel (kernels.h)
+
+    // Optional hooks; worker_ctx[w] is passed to both hooks on worker w, so a
+    // job with worker_ctx must set threads explicitly
+    TurnHook on_turn;
+    TripHook on_trip;
+    void** worker_ctx;
+
+    // Optional progress hook, with its own context shared by every worker
+    ChunkHook on_chunk;
+    void* chunk_ctx;
+} BatchJob;
+
+void batch_stats_add(BatchStats* stats, const TripResult* result);
+void batch_stats_merge(BatchStats* into, const BatchStats* from);
+void batch_stats_print(FILE* out, const BatchStats* stats);
+
+int batch_default_threads(void);
+
+// Start worker_main on up to count threads, thread w given workers + w *
+// worker_size (worker_size 0 hands every thread the same pointer); returns
+// how many started, always the first ones
+int start_worker_threads(pthread_t* handles, int count, void* (*worker_main)(void*), void* workers,
+                         size_t worker_size);
+
+// Run worker_main for each of count workers on threads and wait for all of
+// them. A worker whose thread cannot be created runs on the calling thread
+// once the others have started, so the work is done regardless, only with
+// fewer threads; for pools whose workers share a queue and never wait on
+// one another
+void run_worker_threads(void* (*worker_main)(void*), void* workers, size_t worker_size, int count);
+
+// The kernel that plays the job's trips, NULL for simulate_trip
+TripKernel batch_job_kernel(const BatchJob* job);
+
+// Play trips first .. last - 1 of the job on this thread as worker number
+// worker, adding them to stats; the plan must be valid
+void batch_play_range(const BatchJob* job, int worker, uint64_t first, uint64_t last,
+                      BatchStats* stats);
+
+// Play every trip of the job; returns 0, or -1 if the purchase plan is invalid
+int run_batch(const BatchJob* job, BatchStats* stats);
+
+// Identity of the trips a job plays for each seed: its policy, purchases and
+// trail, and a few probe trips to catch engine builds and learned players
+// that differ. Jobs with the same digest play the same trip for a seed.
+uint64_t batch_job_digest(const BatchJob* job);
+
+// Identity of a trail's layout: its name, stretches and mile map
+uint64_t batch_trail_digest(const Trail* trail);
+
+// Identity of the engine's rules: OREGON_RULES_REVISION, the money and the
+// event thresholds. Unlike a job digest it does not tell engine builds apart
+uint64_t batch_rules_digest(void);
+
+// The purchase split used when a tool is not given one
+void default_purchase_plan(PurchasePlan* plan);
+
+#endif // BATCH_H
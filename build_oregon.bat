@@ -91,8 +91,17 @@ if %ERRORLEVEL% NEQ 0 (
     exit /b 1
 )
 
+echo Compiling trail.c...
+gcc -c -DUNIVAC -O2 -Wall -Wextra -std=c99 trail.c -o trail_univac.o
+
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile trail.c
+    pause
+    exit /b 1
+)
+
 echo Linking...
-gcc -o oregon_univac.exe oregon_univac.o -lm
+gcc -o oregon_univac.exe oregon_univac.o trail_univac.o -lm
 
 if %ERRORLEVEL% EQU 0 (
     echo.
@@ -193,7 +202,7 @@ echo.
 echo Compiling and linking...
 gcc %WARNING_FLAGS% %OPTIMIZE_FLAGS% %PERF_FLAGS% ^
     -o oregon_mingw.exe ^
-    oregon.c ^
+    oregon.c trail.c ^
     %LINKER_FLAGS% -lm
 
 if %ERRORLEVEL% EQU 0 (
@@ -266,7 +275,7 @@ set MSVC_OPTIMIZE=/O2 /Ox /Ob2 /Oi /Ot /Oy /GL /arch:AVX2
 set MSVC_LINKER=/LTCG /OPT:REF /OPT:ICF
 
 REM Compile source file with maximum optimizations
-cl /W4 %MSVC_OPTIMIZE% /Fe:oregon.exe oregon.c /link %MSVC_LINKER%
+cl /W4 %MSVC_OPTIMIZE% /Fe:oregon.exe oregon.c trail.c /link %MSVC_LINKER%
 
 if %ERRORLEVEL% EQU 0 (
     echo.
@@ -303,14 +312,14 @@ REM ADDITIONAL BUILD OPTIONS
 REM ============================================================================
 REM
 REM For debugging builds, you can manually run:
-REM   gcc -g -O0 -DDEBUG -Wall -Wextra oregon.c -o oregon_debug.exe -lm
+REM   gcc -g -O0 -DDEBUG -Wall -Wextra oregon.c trail.c -o oregon_debug.exe -lm
 REM
 REM For profile-guided optimization with GCC:
-REM   Step 1: gcc -O3 -fprofile-generate oregon.c -o oregon_pgo.exe -lm
+REM   Step 1: gcc -O3 -fprofile-generate oregon.c trail.c -o oregon_pgo.exe -lm
 REM   Step 2: Run oregon_pgo.exe with typical usage patterns
-REM   Step 3: gcc -O3 -fprofile-use oregon.c -o oregon_optimized.exe -lm
+REM   Step 3: gcc -O3 -fprofile-use oregon.c trail.c -o oregon_optimized.exe -lm
 REM
 REM For static analysis:
-REM   gcc -Wall -Wextra -Wpedantic -Wformat=2 -Wconversion oregon.c -lm
+REM   gcc -Wall -Wextra -Wpedantic -Wformat=2 -Wconversion oregon.c trail.c -lm
 REM
 REM ============================================================================
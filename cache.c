@@ -0,0 +1,354 @@
+/*
+ * Content-addressed cache of batch statistics.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "cache.h"
+
+#define CACHE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint64_t version;
+    uint64_t key;
+    uint64_t engine;            // cache_engine_digest
+    uint64_t job;               // batch_job_digest
+    uint64_t salt;
+    uint64_t check;             // FNV-1a of the fields above
+} CacheHeader;
+
+typedef struct {
+    uint32_t first_seed;
+    uint32_t trips;
+    BatchStats stats;
+    uint64_t check;             // FNV-1a of the fields above
+} CacheRecord;
+
+// A run of seeds the request needs: a whole shard or a range end
+typedef struct {
+    uint32_t first_seed;
+    uint32_t trips;
+    int cached;
+    BatchStats stats;
+} CachePiece;
+
+typedef struct {
+    const BatchJob* job;
+    CachePiece* pieces;
+    const uint64_t* missing;    // Indexes into pieces
+    uint64_t missing_count;
+    atomic_uint_fast64_t next;
+    int fd;                     // The key's file, appended to
+    atomic_int write_failed;
+} CacheRun;
+
+typedef struct {
+    CacheRun* run;
+    int worker;
+} CacheWorker;
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+uint64_t cache_engine_digest(void) {
+    static unsigned char buffer[1 << 16];
+    uint64_t hash = 0xcbf29ce484222325ull;
+    int rules[4] = {CACHE_VERSION, OREGON_RULES_REVISION, AVAILABLE_MONEY, fixed_point_engine()};
+
+    hash = fnv1a(hash, rules, sizeof(rules));
+    hash = fnv1a(hash, event_probabilities, sizeof(event_probabilities));
+    FILE* exe = fopen("/proc/self/exe", "rb");
+    if (exe) {
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), exe)) > 0) {
+            hash = fnv1a(hash, buffer, size);
+        }
+        fclose(exe);
+    }
+    return hash;
+}
+
+static uint64_t record_check(const CacheRecord* record) {
+    return fnv1a(0xcbf29ce484222325ull, record, offsetof(CacheRecord, check));
+}
+
+// Cut the request at shard boundaries, wrapping at the end of the seeds
+static CachePiece* request_pieces(const BatchJob* job, uint64_t* count) {
+    uint64_t seed = job->first_seed & SEED_MASK;
+    uint64_t left = job->trips;
+    uint64_t capacity = job->trips / CACHE_SHARD + 4;
+    CachePiece* pieces = calloc((size_t)capacity, sizeof(CachePiece));
+
+    *count = 0;
+    while (pieces && left > 0) {
+        uint64_t end = (seed / CACHE_SHARD + 1) * CACHE_SHARD;
+        uint64_t trips = end - seed < left ? end - seed : left;
+        if (*count == capacity) {
+            capacity *= 2;
+            CachePiece* grown = realloc(pieces, (size_t)capacity * sizeof(CachePiece));
+            if (!grown) {
+                free(pieces);
+                return NULL;
+            }
+            pieces = grown;
+        }
+        memset(&pieces[*count], 0, sizeof(CachePiece));
+        pieces[*count].first_seed = (uint32_t)seed;
+        pieces[*count].trips = (uint32_t)trips;
+        (*count)++;
+        seed = (seed + trips) & SEED_MASK;
+        left -= trips;
+    }
+    return pieces;
+}
+
+static int compare_pieces(const void* a, const void* b) {
+    const CachePiece* x = *(const CachePiece* const*)a;
+    const CachePiece* y = *(const CachePiece* const*)b;
+    if (x->first_seed != y->first_seed) {
+        return x->first_seed < y->first_seed ? -1 : 1;
+    }
+    return x->trips < y->trips ? -1 : x->trips > y->trips;
+}
+
+// Fill the pieces the file holds records for
+static void read_records(FILE* file, CachePiece* pieces, uint64_t count) {
+    CachePiece** sorted = malloc((size_t)count * sizeof(CachePiece*));
+    CacheRecord records[256];
+    size_t read;
+
+    if (!sorted) {
+        return; // Everything is played again
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        sorted[i] = &pieces[i];
+    }
+    qsort(sorted, (size_t)count, sizeof(CachePiece*), compare_pieces);
+
+    while ((read = fread(records, sizeof(CacheRecord), 256, file)) > 0) {
+        for (size_t r = 0; r < read; r++) {
+            const CacheRecord* record = &records[r];
+            if (record->check != record_check(record)) {
+                continue; // Damaged
+            }
+            // First piece at or after the record's seeds, then every equal one
+            uint64_t low = 0, high = count;
+            while (low < high) {
+                uint64_t mid = (low + high) / 2;
+                const CachePiece* piece = sorted[mid];
+                if (piece->first_seed < record->first_seed ||
+                    (piece->first_seed == record->first_seed && piece->trips < record->trips)) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            for (; low < count && sorted[low]->first_seed == record->first_seed &&
+                   sorted[low]->trips == record->trips; low++) {
+                if (!sorted[low]->cached) {
+                    sorted[low]->cached = 1;
+                    sorted[low]->stats = record->stats;
+                }
+            }
+        }
+    }
+    free(sorted);
+}
+
+// Open the key's file for appending, creating it with its header if it is
+// new, and read the records it holds; returns the descriptor, or -1
+static int open_cache_file(const char* path, const CacheHeader* header, CachePiece* pieces, uint64_t count,
+                           FILE* log) {
+    char temp[4096 + 32];
+    CacheHeader found;
+
+    FILE* file = fopen(path, "rb");
+    if (!file && errno == ENOENT) {
+        // Publish the header whole: written to a private name, then linked in
+        snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+        FILE* out = fopen(temp, "wb");
+        int written = out && fwrite(header, sizeof(*header), 1, out) == 1;
+        if (out && fclose(out) != 0) {
+            written = 0;
+        }
+        if (written && link(temp, path) != 0 && errno != EEXIST) {
+            written = 0;
+        }
+        unlink(temp);
+        if (!written) {
+            fprintf(log, "%s: cannot create cache file: %s\n", path, strerror(errno));
+            return -1;
+        }
+        file = fopen(path, "rb");
+    }
+    if (!file) {
+        fprintf(log, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (fread(&found, sizeof(found), 1, file) != 1 || memcmp(&found, header, sizeof(found)) != 0) {
+        fclose(file);
+        fprintf(log, "%s: not a cache file of this job, or damaged\n", path);
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        fprintf(log, "%s: %s\n", path, strerror(errno));
+        fclose(file);
+        return -1;
+    }
+
+    // A crash during an append leaves part of a record: cut it off, so the
+    // records appended from here on line up again. Runs appending hold a
+    // shared lock until they close; only one that finds itself alone may cut
+    struct stat info;
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0 && fstat(fd, &info) == 0) {
+        off_t whole = (off_t)sizeof(CacheHeader) +
+                      (info.st_size - (off_t)sizeof(CacheHeader)) / (off_t)sizeof(CacheRecord) *
+                      (off_t)sizeof(CacheRecord);
+        if (info.st_size != whole && ftruncate(fd, whole) != 0) {
+            fprintf(log, "%s: %s\n", path, strerror(errno));
+            fclose(file);
+            close(fd);
+            return -1;
+        }
+    }
+    flock(fd, LOCK_SH);
+    read_records(file, pieces, count);
+    fclose(file);
+    return fd;
+}
+
+static void* cache_worker_main(void* arg) {
+    CacheWorker* worker = (CacheWorker*)arg;
+    CacheRun* run = worker->run;
+
+    for (;;) {
+        uint64_t next = atomic_fetch_add(&run->next, 1);
+        if (next >= run->missing_count) {
+            break;
+        }
+        CachePiece* piece = &run->pieces[run->missing[next]];
+        BatchJob job = *run->job;
+        job.first_seed = piece->first_seed;
+        job.trips = piece->trips;
+        batch_play_range(&job, worker->worker, 0, piece->trips, &piece->stats);
+
+        CacheRecord record;
+        memset(&record, 0, sizeof(record));
+        record.first_seed = piece->first_seed;
+        record.trips = piece->trips;
+        record.stats = piece->stats;
+        record.check = record_check(&record);
+        if (write(run->fd, &record, sizeof(record)) != (ssize_t)sizeof(record)) {
+            atomic_store(&run->write_failed, 1);
+        }
+    }
+    return NULL;
+}
+
+int run_batch_cached(const BatchJob* job, uint64_t salt, const char* dir, BatchStats* stats,
+                     CacheReport* report, FILE* log) {
+    CacheHeader header;
+    CacheRun run;
+    GameState probe;
+    char path[4096];
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    double start = now_seconds();
+    int status = -1;
+
+    memset(report, 0, sizeof(*report));
+    memset(stats, 0, sizeof(BatchStats));
+    if (apply_purchase_plan(&probe, &job->plan) != 0) {
+        fprintf(log, "invalid purchase plan\n");
+        return -1;
+    }
+    if (job->on_turn || job->on_trip) {
+        fprintf(log, "a cached batch cannot call hooks\n");
+        return -1;
+    }
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(log, "%s: %s\n", dir, strerror(errno));
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.engine = cache_engine_digest();
+    header.job = batch_job_digest(job);
+    header.salt = salt;
+    header.key = fnv1a(header.engine, &header.job, sizeof(header.job));
+    header.key = fnv1a(header.key, &header.salt, sizeof(header.salt));
+    header.check = fnv1a(0xcbf29ce484222325ull, &header, offsetof(CacheHeader, check));
+    report->key = header.key;
+    snprintf(path, sizeof(path), "%s/%016llx.cache", dir, (unsigned long long)header.key);
+
+    memset(&run, 0, sizeof(run));
+    run.job = job;
+    run.pieces = request_pieces(job, &report->pieces);
+    uint64_t* missing = run.pieces ? malloc((size_t)(report->pieces + 1) * sizeof(uint64_t)) : NULL;
+    CacheWorker* workers = calloc((size_t)threads, sizeof(CacheWorker));
+    if (!run.pieces || !missing || !workers) {
+        fprintf(log, "out of memory\n");
+        goto cleanup;
+    }
+    run.fd = open_cache_file(path, &header, run.pieces, report->pieces, log);
+    if (run.fd < 0) {
+        goto cleanup;
+    }
+
+    for (uint64_t i = 0; i < report->pieces; i++) {
+        if (run.pieces[i].cached) {
+            report->cached_pieces++;
+            report->cached_trips += run.pieces[i].trips;
+        } else {
+            missing[run.missing_count++] = i;
+        }
+    }
+    run.missing = missing;
+    atomic_init(&run.next, 0);
+    atomic_init(&run.write_failed, 0);
+    if (run.missing_count > 0) {
+        for (int w = 0; w < threads; w++) {
+            workers[w].run = &run;
+            workers[w].worker = w;
+        }
+        run_worker_threads(cache_worker_main, workers, sizeof(CacheWorker), threads);
+    }
+    close(run.fd);
+    if (atomic_load(&run.write_failed)) {
+        fprintf(log, "%s: cannot append to the cache; the results are not stored\n", path);
+    }
+
+    for (uint64_t i = 0; i < report->pieces; i++) {
+        batch_stats_merge(stats, &run.pieces[i].stats);
+    }
+    report->played_trips = stats->trips - report->cached_trips;
+    status = 0;
+
+cleanup:
+    report->seconds = now_seconds() - start;
+    free(run.pieces);
+    free(missing);
+    free(workers);
+    return status;
+}
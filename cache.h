@@ -0,0 +1,56 @@
+/*
+ * Result cache: batch statistics stored by what determines them, so a batch
+ * that was played before is answered from disk.
+ *
+ * A job's trips depend only on the engine, the rules it was built with, the
+ * job's identity (batch_job_digest: policy, purchases, trail) and the seeds.
+ * The cache key hashes the first three; the engine is the running executable
+ * itself, read through /proc/self/exe, together with the event table, the
+ * starting money and the arithmetic (which still tell builds apart where the
+ * executable cannot be read), so rebuilding the engine or changing a rule
+ * gives new keys and the old entries are simply never found again. A caller
+ * may mix in a salt for what the job's digest cannot see, such as the
+ * contents of a learned player.
+ *
+ * Each key has one append-only file in the cache directory, named by the key:
+ * a header, then records of statistics for a run of seeds. Seed ranges are
+ * cut at multiples of CACHE_SHARD seeds, so requests that overlap share the
+ * whole shards between them; the partial shards at a range's ends are
+ * records of their own. Only the pieces with no record are played, on worker
+ * threads, and each is appended as soon as it is done, so an interrupted
+ * batch keeps what it finished. Each record carries a check and goes to the
+ * file in a single append, so concurrent runs may share a directory; a piece
+ * played by two of them is stored twice, harmlessly. Runs hold a shared lock
+ * on the file while they append, and a torn tail left by a crash is cut off
+ * only by a run that finds the file unlocked.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define CACHE_MAGIC "ORCACH1"
+#define CACHE_SHARD 4096u           // Seeds per whole shard
+
+typedef struct {
+    uint64_t key;
+    uint64_t pieces;            // Of the request
+    uint64_t cached_pieces;
+    uint64_t cached_trips;
+    uint64_t played_trips;
+    double seconds;
+} CacheReport;
+
+// Identity of this engine build and its rules
+uint64_t cache_engine_digest(void);
+
+// Play the job's trips that dir does not hold and store them; returns 0 with
+// the statistics of the whole range, or -1 (message in log) if the plan is
+// invalid, the job has hooks, or the cache cannot be read or written
+int run_batch_cached(const BatchJob* job, uint64_t salt, const char* dir, BatchStats* stats,
+                     CacheReport* report, FILE* log);
+
+#endif // CACHE_H
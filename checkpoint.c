@@ -0,0 +1,322 @@
+/*
+ * Checkpointed batches.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+typedef struct {
+    char magic[8];
+    uint64_t digest;            // batch_job_digest of the job
+    uint64_t first_seed;
+    uint64_t trips;
+    uint64_t block_trips;
+    uint64_t blocks;
+    uint64_t done_blocks;
+    BatchStats stats;           // Of the done blocks
+} CheckpointHeader;
+
+typedef struct {
+    const BatchJob* job;
+    const char* path;
+    FILE* log;
+    uint64_t blocks;
+    size_t bitmap_size;
+    const uint8_t* resumed;     // Done before this run; read only
+    atomic_uint_fast64_t next_block;
+
+    // Shared progress, under lock
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // Wakes the writer early at the end
+    uint8_t* done;
+    CheckpointHeader header;
+    int finished;
+
+    // The writer's snapshot
+    uint8_t* snapshot;
+    uint64_t checkpoints;
+} Checkpointer;
+
+typedef struct {
+    Checkpointer* checkpointer;
+    int worker;
+} CheckpointWorker;
+
+static atomic_int g_stop_requested;
+
+void checkpoint_request_stop(void) {
+    atomic_store(&g_stop_requested, 1);
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t checkpoint_check(const CheckpointHeader* header, const uint8_t* bitmap, size_t size) {
+    uint64_t hash = fnv1a(0xcbf29ce484222325ull, header, sizeof(*header));
+    return fnv1a(hash, bitmap, size);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Load a checkpoint of this job into header and bitmap; returns 1 if loaded,
+// 0 if there is none, -1 if it is unreadable or another job's
+static int load_checkpoint(Checkpointer* checkpointer, CheckpointHeader* header, uint8_t* bitmap) {
+    FILE* file = fopen(checkpointer->path, "rb");
+    uint64_t check;
+
+    if (!file) {
+        if (errno == ENOENT) {
+            return 0;
+        }
+        fprintf(checkpointer->log, "%s: %s\n", checkpointer->path, strerror(errno));
+        return -1;
+    }
+    int whole = fread(header, sizeof(*header), 1, file) == 1 &&
+                memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) == 0 &&
+                header->blocks == checkpointer->blocks &&
+                fread(bitmap, 1, checkpointer->bitmap_size, file) == checkpointer->bitmap_size &&
+                fread(&check, sizeof(check), 1, file) == 1 &&
+                check == checkpoint_check(header, bitmap, checkpointer->bitmap_size);
+    fclose(file);
+    if (!whole) {
+        fprintf(checkpointer->log, "%s: not a checkpoint of this job, or damaged\n", checkpointer->path);
+        return -1;
+    }
+    if (header->digest != checkpointer->header.digest ||
+        header->first_seed != checkpointer->header.first_seed ||
+        header->trips != checkpointer->header.trips ||
+        header->block_trips != checkpointer->header.block_trips) {
+        fprintf(checkpointer->log, "%s: checkpoint of a different job (policy, purchases, trail, "
+                "seeds or trips)\n", checkpointer->path);
+        return -1;
+    }
+    return 1;
+}
+
+// Make a rename in path's directory durable
+static int sync_directory(const char* path) {
+    char dir[4096];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char* slash = strrchr(dir, '/');
+    if (!slash) {
+        snprintf(dir, sizeof(dir), ".");
+    } else if (slash == dir) {
+        slash[1] = '\0'; // The root
+    } else {
+        *slash = '\0';
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return -1;
+    }
+    int status = fsync(fd);
+    close(fd);
+    return status;
+}
+
+// Write a snapshot to PATH.tmp, sync it, rename it over PATH and sync the
+// directory, so a crash leaves the old snapshot or the new one, never neither
+static int write_checkpoint(const Checkpointer* checkpointer, const CheckpointHeader* header,
+                            const uint8_t* bitmap) {
+    char temp[4096];
+    uint64_t check = checkpoint_check(header, bitmap, checkpointer->bitmap_size);
+
+    snprintf(temp, sizeof(temp), "%s.tmp", checkpointer->path);
+    FILE* file = fopen(temp, "wb");
+    if (!file) {
+        return -1;
+    }
+    int written = fwrite(header, sizeof(*header), 1, file) == 1 &&
+                  fwrite(bitmap, 1, checkpointer->bitmap_size, file) == checkpointer->bitmap_size &&
+                  fwrite(&check, sizeof(check), 1, file) == 1 &&
+                  fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0 || !written || rename(temp, checkpointer->path) != 0) {
+        unlink(temp);
+        return -1;
+    }
+    return sync_directory(checkpointer->path);
+}
+
+// Copy the progress under the lock, write it outside
+static int take_checkpoint(Checkpointer* checkpointer) {
+    CheckpointHeader header;
+
+    pthread_mutex_lock(&checkpointer->lock);
+    header = checkpointer->header;
+    memcpy(checkpointer->snapshot, checkpointer->done, checkpointer->bitmap_size);
+    pthread_mutex_unlock(&checkpointer->lock);
+
+    if (write_checkpoint(checkpointer, &header, checkpointer->snapshot) != 0) {
+        fprintf(checkpointer->log, "%s: cannot write checkpoint: %s\n", checkpointer->path,
+                strerror(errno));
+        return -1;
+    }
+    checkpointer->checkpoints++;
+    return 0;
+}
+
+typedef struct {
+    Checkpointer* checkpointer;
+    double interval;
+} CheckpointWriter;
+
+static void* checkpoint_writer_main(void* arg) {
+    CheckpointWriter* writer = (CheckpointWriter*)arg;
+    Checkpointer* checkpointer = writer->checkpointer;
+    uint64_t written_blocks = checkpointer->header.done_blocks;
+
+    pthread_mutex_lock(&checkpointer->lock);
+    while (!checkpointer->finished) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        double whole = (double)until.tv_sec + (double)until.tv_nsec / 1e9 + writer->interval;
+        until.tv_sec = (time_t)whole;
+        until.tv_nsec = (long)((whole - (double)until.tv_sec) * 1e9);
+        pthread_cond_timedwait(&checkpointer->wake, &checkpointer->lock, &until);
+        if (checkpointer->finished || checkpointer->header.done_blocks == written_blocks) {
+            continue;
+        }
+        written_blocks = checkpointer->header.done_blocks;
+        pthread_mutex_unlock(&checkpointer->lock);
+        take_checkpoint(checkpointer); // A failure is logged, and the next one may succeed
+        pthread_mutex_lock(&checkpointer->lock);
+    }
+    pthread_mutex_unlock(&checkpointer->lock);
+    return NULL;
+}
+
+static void* checkpoint_worker_main(void* arg) {
+    CheckpointWorker* worker = (CheckpointWorker*)arg;
+    Checkpointer* checkpointer = worker->checkpointer;
+    const BatchJob* job = checkpointer->job;
+
+    while (!atomic_load(&g_stop_requested)) {
+        uint64_t block = atomic_fetch_add(&checkpointer->next_block, 1);
+        if (block >= checkpointer->blocks) {
+            break;
+        }
+        if (checkpointer->resumed[block / 8] & (1u << (block % 8))) {
+            continue;
+        }
+
+        BatchStats stats;
+        uint64_t first = block * CHECKPOINT_BLOCK;
+        uint64_t last = first + CHECKPOINT_BLOCK < job->trips ? first + CHECKPOINT_BLOCK : job->trips;
+        memset(&stats, 0, sizeof(stats));
+        batch_play_range(job, worker->worker, first, last, &stats);
+
+        pthread_mutex_lock(&checkpointer->lock);
+        batch_stats_merge(&checkpointer->header.stats, &stats);
+        checkpointer->done[block / 8] |= (uint8_t)(1u << (block % 8));
+        checkpointer->header.done_blocks++;
+        pthread_mutex_unlock(&checkpointer->lock);
+    }
+    return NULL;
+}
+
+int run_batch_checkpointed(const BatchJob* job, const char* path, double interval,
+                           BatchStats* stats, CheckpointReport* report, FILE* log) {
+    Checkpointer checkpointer;
+    CheckpointWriter writer;
+    CheckpointHeader loaded;
+    GameState probe;
+    pthread_t writer_thread;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    double start = now_seconds();
+    int status = -1;
+
+    memset(report, 0, sizeof(*report));
+    if (apply_purchase_plan(&probe, &job->plan) != 0) {
+        fprintf(log, "invalid purchase plan\n");
+        return -1;
+    }
+
+    memset(&checkpointer, 0, sizeof(checkpointer));
+    checkpointer.job = job;
+    checkpointer.path = path;
+    checkpointer.log = log;
+    checkpointer.blocks = (job->trips + CHECKPOINT_BLOCK - 1) / CHECKPOINT_BLOCK;
+    checkpointer.bitmap_size = (size_t)((checkpointer.blocks + 7) / 8);
+    memcpy(checkpointer.header.magic, CHECKPOINT_MAGIC, sizeof(checkpointer.header.magic));
+    checkpointer.header.digest = batch_job_digest(job);
+    checkpointer.header.first_seed = job->first_seed;
+    checkpointer.header.trips = job->trips;
+    checkpointer.header.block_trips = CHECKPOINT_BLOCK;
+    checkpointer.header.blocks = checkpointer.blocks;
+
+    uint8_t* resumed = calloc(checkpointer.bitmap_size + 1, 1);
+    checkpointer.done = calloc(checkpointer.bitmap_size + 1, 1);
+    checkpointer.snapshot = calloc(checkpointer.bitmap_size + 1, 1);
+    CheckpointWorker* workers = calloc((size_t)threads, sizeof(CheckpointWorker));
+    if (!resumed || !checkpointer.done || !checkpointer.snapshot || !workers) {
+        fprintf(log, "out of memory\n");
+        goto cleanup;
+    }
+
+    int found = load_checkpoint(&checkpointer, &loaded, resumed);
+    if (found < 0) {
+        goto cleanup;
+    }
+    if (found) {
+        checkpointer.header = loaded;
+        memcpy(checkpointer.done, resumed, checkpointer.bitmap_size);
+        report->resumed_trips = loaded.stats.trips;
+    }
+    checkpointer.resumed = resumed;
+
+    pthread_mutex_init(&checkpointer.lock, NULL);
+    pthread_cond_init(&checkpointer.wake, NULL);
+    atomic_init(&checkpointer.next_block, 0);
+    writer.checkpointer = &checkpointer;
+    writer.interval = interval > 0 ? interval : 1.0;
+    if (pthread_create(&writer_thread, NULL, checkpoint_writer_main, &writer) != 0) {
+        fprintf(log, "cannot start the checkpoint writer thread\n");
+        pthread_mutex_destroy(&checkpointer.lock);
+        pthread_cond_destroy(&checkpointer.wake);
+        goto cleanup;
+    }
+    for (int w = 0; w < threads; w++) {
+        workers[w].checkpointer = &checkpointer;
+        workers[w].worker = w;
+    }
+    run_worker_threads(checkpoint_worker_main, workers, sizeof(CheckpointWorker), threads);
+
+    pthread_mutex_lock(&checkpointer.lock);
+    checkpointer.finished = 1;
+    pthread_cond_signal(&checkpointer.wake);
+    pthread_mutex_unlock(&checkpointer.lock);
+    pthread_join(writer_thread, NULL);
+
+    // The last checkpoint, written whether the batch finished or was stopped
+    if (take_checkpoint(&checkpointer) == 0) {
+        *stats = checkpointer.header.stats;
+        report->played_trips = stats->trips - report->resumed_trips;
+        report->stopped = checkpointer.header.done_blocks < checkpointer.blocks;
+        status = 0;
+    }
+    report->checkpoints = checkpointer.checkpoints;
+    pthread_mutex_destroy(&checkpointer.lock);
+    pthread_cond_destroy(&checkpointer.wake);
+
+cleanup:
+    report->seconds = now_seconds() - start;
+    free(resumed);
+    free(checkpointer.done);
+    free(checkpointer.snapshot);
+    free(workers);
+    return status;
+}
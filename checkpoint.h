@@ -0,0 +1,52 @@
+/*
+ * Checkpointed batches: run_batch for jobs long enough to be interrupted.
+ *
+ * The seed range is cut into blocks of CHECKPOINT_BLOCK trips. Workers claim
+ * blocks as run_batch claims chunks, and a finished block's statistics are
+ * merged into the job's running total with its bit set in a done bitmap.
+ * Every trip depends only on its seed, so the bitmap is the whole position of
+ * the job's generator streams, and a checkpoint is just
+ *
+ *   header   magic, job digest (batch_job_digest), seed range, block size,
+ *            merged BatchStats of the done blocks
+ *   bitmap   one bit per block
+ *   check    FNV-1a of both
+ *
+ * A writer thread takes a snapshot under the lock every interval and writes it
+ * to PATH.tmp, syncs it and renames it over PATH, so a checkpoint on disk is
+ * always a whole one and workers never wait on the disk. Started again with
+ * the same job and path, the batch skips the done blocks and ends with the
+ * statistics an uninterrupted run gives. checkpoint_request_stop (safe in a
+ * signal handler) makes the workers finish their blocks and the batch write a
+ * last checkpoint and return early.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define CHECKPOINT_BLOCK 65536u     // Trips per block
+#define CHECKPOINT_MAGIC "ORCKPT1"
+
+typedef struct {
+    uint64_t resumed_trips;     // Done when the batch started
+    uint64_t played_trips;      // Played by this run
+    uint64_t checkpoints;       // Written by this run, the last one included
+    int stopped;                // 1 if checkpoint_request_stop ended it early
+    double seconds;
+} CheckpointReport;
+
+// Play the job, resuming from the checkpoint at path if there is one, and
+// checkpoint every interval seconds; returns 0 with the stats of the whole
+// range (of the done blocks if stopped early), or -1 (message in log): invalid
+// purchase plan, a checkpoint of another job, or the last checkpoint could
+// not be read or written
+int run_batch_checkpointed(const BatchJob* job, const char* path, double interval,
+                           BatchStats* stats, CheckpointReport* report, FILE* log);
+
+void checkpoint_request_stop(void);
+
+#endif // CHECKPOINT_H
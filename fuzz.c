@@ -0,0 +1,821 @@
+/*
+ * Coverage-guided fuzzer.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "fuzz.h"
+#include "batch.h"
+
+#define FUZZ_FLAG_COMBOS 64         // Every combination of the six FLAG_* bits
+#define FUZZ_MAX_FEATURES 80        // Three a turn, at most 21 turns
+#define FUZZ_MAP_SIZE (1u << FUZZ_MAP_BITS)
+
+typedef enum {
+    INVARIANT_RESOURCE_AT_PROMPT = 0,
+    INVARIANT_CASH_AT_PROMPT,
+    INVARIANT_TURN_LIMIT,
+    INVARIANT_RESOURCE_ON_ARRIVAL,
+    INVARIANT_CASH_ON_ARRIVAL,
+    INVARIANT_COUNT
+} Invariant;
+
+// Point numbers
+#define POINT_TEXT 0
+#define POINT_FLAGS (POINT_TEXT + TEXT_COUNT)
+#define POINT_RIDER (POINT_FLAGS + FUZZ_FLAG_COMBOS)                // hostile * 4 + tactic - 1
+#define POINT_OUTCOME (POINT_RIDER + 8)                             // outcome * 2 + stopped at a fort
+#define POINT_BEHIND_START (POINT_OUTCOME + 2 * (1 + DEATH_CAUSE_COUNT))
+#define POINT_INVARIANT (POINT_BEHIND_START + 1)
+#define POINT_COUNT (POINT_INVARIANT + INVARIANT_COUNT)
+
+static const char* const text_names[TEXT_COUNT] = {
+#define TEXT(id, text) #id,
+#include "oregon_text.def"
+#undef TEXT
+};
+
+static const char* const flag_names[6] = {
+    "illness", "injury", "south_pass", "blue_mountains", "blizzard", "fort_option"
+};
+
+static const char* const tactic_names[4] = {"run", "attack", "continue", "circle wagons"};
+
+static const char* const death_names[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "winter blizzard", "snakebite", "massacre"
+};
+
+static const char* const event_names[EVENT_COUNT] = {
+    "wagon breakdown", "ox injury", "daughter breaks arm", "ox wanders off",
+    "son gets lost", "unsafe water", "heavy rains", "bandits attack", "fire in wagon",
+    "lose way in fog", "poisonous snake", "wagon swamped fording", "wild animals attack",
+    "cold weather", "hail storm", "helpful indians"
+};
+
+static const char* const invariant_names[INVARIANT_COUNT] = {
+    "negative resource at a turn prompt",
+    "negative cash at a turn prompt",
+    "turn started past the twentieth",
+    "negative resource on arrival",
+    "negative cash on arrival",
+};
+
+// One trip under the fuzzer, and what it reached
+typedef struct {
+    const FuzzInput* input;
+    const Policy* base;
+    Policy policy;              // base, with the input's decisions; ctx is this trip
+    FuzzProbe probe;
+    unsigned char text_seen[TEXT_COUNT];
+    uint32_t decisions;         // Made so far
+    int next_draw;              // Cursors into the input's overrides
+    int next_decision;
+    int fort_stops;
+    int last_event;             // Of the turn before
+    TripResult result;
+    unsigned char reached[POINT_COUNT];
+    uint32_t features[FUZZ_MAX_FEATURES];
+    int feature_count;
+    FILE* trace;                // fuzz_replay's output, NULL while fuzzing
+} FuzzTrip;
+
+typedef struct {
+    FuzzInput input;
+    uint32_t draws;             // Draws and decisions its trip made, for mutations
+    uint32_t decisions;
+} CorpusEntry;
+
+typedef struct {
+    const FuzzJob* job;
+    double start;
+    atomic_uint_fast64_t execs;
+    atomic_int stop;
+    atomic_uchar* feature_map;
+    atomic_uchar points[POINT_COUNT];
+
+    pthread_mutex_t lock;       // Guards the corpus and the first writes to the maps
+    CorpusEntry* corpus;
+    size_t count;
+    size_t capacity;
+    int violations;
+} Fuzzer;
+
+typedef struct {
+    Fuzzer* fuzzer;
+    int worker;
+} FuzzWorker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// xorshift64*, one stream per worker
+static uint64_t next_rng(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545f4914f6cdd1dull;
+}
+
+static uint32_t rng_below(uint64_t* state, uint32_t bound) {
+    return bound ? (uint32_t)((next_rng(state) >> 32) % bound) : 0;
+}
+
+static void point_name(int point, char* name, size_t size) {
+    if (point < POINT_FLAGS) {
+        snprintf(name, size, "message %s", text_names[point - POINT_TEXT]);
+    } else if (point < POINT_RIDER) {
+        int flags = point - POINT_FLAGS;
+        size_t length = (size_t)snprintf(name, size, "flags");
+        for (int bit = 0; bit < 6; bit++) {
+            if ((flags & (1 << bit)) && length < size) {
+                length += (size_t)snprintf(name + length, size - length, "%s%s",
+                                           length > 5 ? "+" : " ", flag_names[bit]);
+            }
+        }
+        if (!flags) {
+            snprintf(name, size, "flags none");
+        }
+    } else if (point < POINT_OUTCOME) {
+        int rider = point - POINT_RIDER;
+        snprintf(name, size, "rider %s %s", rider >= 4 ? "hostile" : "friendly", tactic_names[rider % 4]);
+    } else if (point < POINT_BEHIND_START) {
+        int outcome = (point - POINT_OUTCOME) / 2;
+        int fort = (point - POINT_OUTCOME) % 2;
+        snprintf(name, size, "%s%s %s a fort stop", outcome ? "died of " : "arrived",
+                 outcome ? death_names[outcome - 1] : "", fort ? "after" : "without");
+    } else if (point == POINT_BEHIND_START) {
+        snprintf(name, size, "behind the start at a turn prompt"); // A blizzard costs up to 1630 miles
+    } else {
+        snprintf(name, size, "invariant: %s", invariant_names[point - POINT_INVARIANT]);
+    }
+}
+
+// Trip hooks
+
+static void reach(FuzzTrip* trip, int point) {
+    trip->reached[point] = 1;
+}
+
+static void add_feature(FuzzTrip* trip, uint32_t kind, uint32_t value) {
+    uint32_t hash = (kind * 0x9e3779b1u) ^ value;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    if (trip->feature_count < FUZZ_MAX_FEATURES) {
+        trip->features[trip->feature_count++] = hash & (FUZZ_MAP_SIZE - 1);
+    }
+}
+
+// Coarse, roughly logarithmic size class of a quantity
+static uint32_t bucket(int value) {
+    if (value < 0) {
+        return 0;
+    }
+    if (value == 0) {
+        return 1;
+    }
+    if (value < 10) {
+        return 2;
+    }
+    if (value < 30) {
+        return 3;
+    }
+    if (value < 100) {
+        return 4;
+    }
+    if (value < 300) {
+        return 5;
+    }
+    return value < 1000 ? 6 : 7;
+}
+
+static unsigned int fuzz_draw(unsigned int index, unsigned int value, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    const FuzzInput* input = trip->input;
+
+    while (trip->next_draw < input->draw_count && input->draws[trip->next_draw].index < index) {
+        trip->next_draw++;
+    }
+    if (trip->next_draw < input->draw_count && input->draws[trip->next_draw].index == index) {
+        unsigned int replaced = input->draws[trip->next_draw++].value & RANDOM_MAX;
+        if (trip->trace) {
+            fprintf(trip->trace, "  draw %u replaced: %u -> %u\n", index, value, replaced);
+        }
+        return replaced;
+    }
+    return value;
+}
+
+// The policy's decision, or the input's in low .. high
+static int fuzz_decide(FuzzTrip* trip, const char* what, int planned, int low, int high) {
+    const FuzzInput* input = trip->input;
+    uint32_t index = trip->decisions++;
+
+    while (trip->next_decision < input->decision_count &&
+           input->decisions[trip->next_decision].index < index) {
+        trip->next_decision++;
+    }
+    if (trip->next_decision < input->decision_count &&
+        input->decisions[trip->next_decision].index == index) {
+        uint32_t value = input->decisions[trip->next_decision++].value;
+        int decided = low + (int)(value % (uint32_t)(high - low + 1));
+        if (trip->trace) {
+            fprintf(trip->trace, "  decision %u (%s) replaced: %d -> %d\n", index, what, planned, decided);
+        }
+        return decided;
+    }
+    return planned;
+}
+
+static void check_prompt_invariants(FuzzTrip* trip, const GameState* game) {
+    if (game->food < 0 || game->bullets < 0 || game->clothing < 0 || game->misc_supplies < 0) {
+        reach(trip, POINT_INVARIANT + INVARIANT_RESOURCE_AT_PROMPT);
+    }
+    if (game->cash < 0) {
+        reach(trip, POINT_INVARIANT + INVARIANT_CASH_AT_PROMPT);
+    }
+    if (game->miles_traveled < 0) {
+        reach(trip, POINT_BEHIND_START);
+    }
+    if (game->turn_number > 20) {
+        reach(trip, POINT_INVARIANT + INVARIANT_TURN_LIMIT);
+    }
+}
+
+static int fuzz_turn_action(const GameState* game, int fort_open, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    check_prompt_invariants(trip, game);
+    int planned = trip->base->turn_action(game, fort_open, trip->base->ctx);
+    int choice = fuzz_decide(trip, "turn action", planned, fort_open ? ACTION_FORT : ACTION_HUNT,
+                             ACTION_CONTINUE);
+    if (fort_open && choice == ACTION_FORT) {
+        trip->fort_stops++;
+    }
+    return choice;
+}
+
+static int fuzz_eating_level(const GameState* game, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    return fuzz_decide(trip, "eating level", trip->base->eating_level(game, trip->base->ctx), 1, 3);
+}
+
+static int fuzz_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    int planned = trip->base->rider_tactic(game, hostile, trip->base->ctx);
+    int tactic = fuzz_decide(trip, "rider tactic", planned, TACTIC_RUN, TACTIC_CIRCLE_WAGONS);
+    if (tactic < TACTIC_RUN || tactic > TACTIC_CIRCLE_WAGONS) {
+        tactic = TACTIC_CIRCLE_WAGONS; // As the engine reads it
+    }
+    reach(trip, POINT_RIDER + (hostile ? 4 : 0) + tactic - 1);
+    return tactic;
+}
+
+static int fuzz_fort_purchase(const GameState* game, int item, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    int planned = trip->base->fort_purchase(game, item, trip->base->ctx);
+    return fuzz_decide(trip, "fort purchase", planned, 0, game->cash > 0 ? game->cash : 0);
+}
+
+static int fuzz_shot_result(int skill_level, const char* word, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    return fuzz_decide(trip, "shot", trip->base->shot_result(skill_level, word, trip->base->ctx), 1, 9);
+}
+
+static void fuzz_turn_hook(const GameState* game, void* ctx) {
+    FuzzTrip* trip = (FuzzTrip*)ctx;
+    int flags = game->game_flags & (FUZZ_FLAG_COMBOS - 1);
+
+    reach(trip, POINT_FLAGS + flags);
+    add_feature(trip, 1, (uint32_t)(trip->last_event + 1) * (EVENT_COUNT + 1) + (uint32_t)(game->last_event + 1));
+    add_feature(trip, 2, (uint32_t)game->turn_number | bucket(game->miles_traveled / 10) << 5 |
+                         (uint32_t)flags << 8);
+    add_feature(trip, 3, bucket(game->food) | bucket(game->bullets) << 3 | bucket(game->clothing) << 6 |
+                         bucket(game->misc_supplies) << 9 | bucket(game->cash) << 12 |
+                         (uint32_t)(game->turn_number / 4) << 15);
+    trip->last_event = game->last_event;
+
+    if (trip->trace) {
+        char name[64];
+        point_name(POINT_FLAGS + flags, name, sizeof(name));
+        fprintf(trip->trace, "turn %2d  miles %5d  food %4d  bullets %5d  clothing %4d  misc %4d  "
+                "cash %4d  %s  %s\n", game->turn_number, game->miles_traveled, game->food,
+                game->bullets, game->clothing, game->misc_supplies, game->cash,
+                game->last_event >= 0 ? event_names[game->last_event] : "no event", name);
+    }
+}
+
+static void init_trip(FuzzTrip* trip, const Policy* base) {
+    memset(trip, 0, sizeof(*trip));
+    trip->base = base;
+    trip->policy.name = base->name;
+    trip->policy.turn_action = fuzz_turn_action;
+    trip->policy.eating_level = fuzz_eating_level;
+    trip->policy.rider_tactic = fuzz_rider_tactic;
+    trip->policy.fort_purchase = fuzz_fort_purchase;
+    trip->policy.shot_result = fuzz_shot_result;
+    trip->policy.ctx = trip;
+    trip->probe.text_seen = trip->text_seen;
+    trip->probe.draw = fuzz_draw;
+    trip->probe.ctx = trip;
+}
+
+// Play an input; returns 0 with trip->reached and features filled, or -1 if the plan is invalid
+static int play_input(FuzzTrip* trip, const FuzzInput* input) {
+    trip->input = input;
+    trip->decisions = 0;
+    trip->next_draw = 0;
+    trip->next_decision = 0;
+    trip->fort_stops = 0;
+    trip->last_event = -1;
+    trip->feature_count = 0;
+    trip->probe.draws = 0;
+    memset(trip->text_seen, 0, sizeof(trip->text_seen));
+    memset(trip->reached, 0, sizeof(trip->reached));
+
+    set_fuzz_probe(&trip->probe);
+    int status = simulate_trip(&input->plan, &trip->policy, input->seed, fuzz_turn_hook, trip,
+                               &trip->result);
+    set_fuzz_probe(NULL);
+    if (status != 0) {
+        return -1;
+    }
+
+    for (int id = 0; id < TEXT_COUNT; id++) {
+        if (trip->text_seen[id]) {
+            reach(trip, POINT_TEXT + id);
+        }
+    }
+    const TripResult* result = &trip->result;
+    int outcome = result->outcome == TRIP_DIED ? 1 + result->death_cause : 0;
+    reach(trip, POINT_OUTCOME + outcome * 2 + (trip->fort_stops > 0));
+    if (result->outcome == TRIP_ARRIVED) {
+        if (result->food < 0 || result->bullets < 0 || result->clothing < 0 || result->misc_supplies < 0) {
+            reach(trip, POINT_INVARIANT + INVARIANT_RESOURCE_ON_ARRIVAL);
+        }
+        if (result->cash < 0) {
+            reach(trip, POINT_INVARIANT + INVARIANT_CASH_ON_ARRIVAL);
+        }
+    }
+    return 0;
+}
+
+// Reproducer files
+
+void fuzz_write_input(FILE* out, const FuzzInput* input, const char* policy_name) {
+    const PurchasePlan* plan = &input->plan;
+    fprintf(out, "policy %s\n", policy_name);
+    fprintf(out, "seed %u\n", input->seed);
+    fprintf(out, "skill %d\n", plan->shooting_skill);
+    fprintf(out, "buy %d,%d,%d,%d,%d\n", plan->oxen, plan->food, plan->ammunition, plan->clothing,
+            plan->misc_supplies);
+    for (int i = 0; i < input->draw_count; i++) {
+        fprintf(out, "draw %u %u\n", input->draws[i].index, input->draws[i].value);
+    }
+    for (int i = 0; i < input->decision_count; i++) {
+        fprintf(out, "decide %u %u\n", input->decisions[i].index, input->decisions[i].value);
+    }
+}
+
+// Insert or replace an override, keeping the list in index order; a full list
+// gives up its last entry
+static void set_override(FuzzOverride* list, int* count, uint32_t index, uint32_t value) {
+    int at = 0;
+    while (at < *count && list[at].index < index) {
+        at++;
+    }
+    if (at < *count && list[at].index == index) {
+        list[at].value = value;
+        return;
+    }
+    if (*count == FUZZ_MAX_OVERRIDES) {
+        if (at == FUZZ_MAX_OVERRIDES) {
+            return;
+        }
+        (*count)--;
+    }
+    memmove(&list[at + 1], &list[at], (size_t)(*count - at) * sizeof(*list));
+    list[at].index = index;
+    list[at].value = value;
+    (*count)++;
+}
+
+static void remove_override(FuzzOverride* list, int* count, int at) {
+    memmove(&list[at], &list[at + 1], (size_t)(*count - at - 1) * sizeof(*list));
+    (*count)--;
+}
+
+int fuzz_read_input(FILE* in, FuzzInput* input, char* policy_name, size_t policy_size) {
+    char line[256];
+    int have_seed = 0, have_plan = 0;
+
+    memset(input, 0, sizeof(*input));
+    default_purchase_plan(&input->plan);
+    policy_name[0] = '\0';
+    while (fgets(line, sizeof(line), in)) {
+        PurchasePlan* plan = &input->plan;
+        unsigned int index, value;
+        char* newline = strchr(line, '\n');
+        if (newline) {
+            *newline = '\0';
+        }
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+        if (strncmp(line, "policy ", 7) == 0) {
+            snprintf(policy_name, policy_size, "%s", line + 7);
+        } else if (sscanf(line, "seed %u", &input->seed) == 1) {
+            have_seed = 1;
+        } else if (sscanf(line, "skill %d", &plan->shooting_skill) == 1) {
+            continue;
+        } else if (sscanf(line, "buy %d,%d,%d,%d,%d", &plan->oxen, &plan->food, &plan->ammunition,
+                          &plan->clothing, &plan->misc_supplies) == 5) {
+            have_plan = 1;
+        } else if (sscanf(line, "draw %u %u", &index, &value) == 2) {
+            set_override(input->draws, &input->draw_count, index, value);
+        } else if (sscanf(line, "decide %u %u", &index, &value) == 2) {
+            set_override(input->decisions, &input->decision_count, index, value);
+        } else {
+            return -1;
+        }
+    }
+    return have_seed && have_plan ? 0 : -1;
+}
+
+// Fuzzing
+
+// Replace characters a file name should not have
+static void file_name_part(char* name) {
+    for (; *name; name++) {
+        if (!((*name >= 'a' && *name <= 'z') || (*name >= 'A' && *name <= 'Z') ||
+              (*name >= '0' && *name <= '9') || *name == '_')) {
+            *name = '-';
+        }
+    }
+}
+
+// Drop the overrides and plan changes the point does not need
+static void minimize(FuzzTrip* trip, FuzzInput* input, const PurchasePlan* job_plan, int point) {
+    FuzzInput trial;
+
+    for (int i = input->draw_count - 1; i >= 0; i--) {
+        trial = *input;
+        remove_override(trial.draws, &trial.draw_count, i);
+        if (play_input(trip, &trial) == 0 && trip->reached[point]) {
+            *input = trial;
+        }
+    }
+    for (int i = input->decision_count - 1; i >= 0; i--) {
+        trial = *input;
+        remove_override(trial.decisions, &trial.decision_count, i);
+        if (play_input(trip, &trial) == 0 && trip->reached[point]) {
+            *input = trial;
+        }
+    }
+    trial = *input;
+    trial.plan = *job_plan;
+    if (memcmp(&trial.plan, &input->plan, sizeof(trial.plan)) != 0 &&
+        play_input(trip, &trial) == 0 && trip->reached[point]) {
+        *input = trial;
+    }
+}
+
+// Minimize the input that first reached a point, and write it out
+static void report_point(Fuzzer* fuzzer, FuzzTrip* trip, const FuzzInput* found, int point) {
+    const FuzzJob* job = fuzzer->job;
+    int violation = point >= POINT_INVARIANT;
+    FuzzInput input = *found;
+    char name[80];
+
+    point_name(point, name, sizeof(name));
+    minimize(trip, &input, &job->plan, point);
+    if (job->log) {
+        fprintf(job->log, "%7.1f s  %s%s (seed %u, %d draws and %d decisions replaced)\n",
+                now_seconds() - fuzzer->start, violation ? "BROKEN " : "new ", name, input.seed,
+                input.draw_count, input.decision_count);
+    }
+    if (!job->out_dir) {
+        return;
+    }
+
+    char path[4096];
+    char part[80];
+    snprintf(part, sizeof(part), "%s", name);
+    file_name_part(part);
+    snprintf(path, sizeof(path), "%s/%s-%s.repro", job->out_dir, violation ? "violation" : "point", part);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        if (job->log) {
+            fprintf(job->log, "%s: %s\n", path, strerror(errno));
+        }
+        return;
+    }
+    fprintf(file, "# oregon_sim fuzz reproducer: %s\n", name);
+    fuzz_write_input(file, &input, job->policy_name);
+    fclose(file);
+}
+
+// Add the input to the corpus if its trip reached anything new, and report
+// the points it reached first
+static void keep_if_novel(Fuzzer* fuzzer, FuzzTrip* trip, const FuzzInput* input) {
+    int won[POINT_COUNT];
+    int won_count = 0;
+    int novel = 0;
+
+    for (int f = 0; f < trip->feature_count && !novel; f++) {
+        novel = !atomic_load_explicit(&fuzzer->feature_map[trip->features[f]], memory_order_relaxed);
+    }
+    for (int p = 0; p < POINT_COUNT && !novel; p++) {
+        novel = trip->reached[p] && !atomic_load_explicit(&fuzzer->points[p], memory_order_relaxed);
+    }
+    if (!novel) {
+        return;
+    }
+
+    pthread_mutex_lock(&fuzzer->lock);
+    novel = 0;
+    for (int f = 0; f < trip->feature_count; f++) {
+        if (!atomic_exchange_explicit(&fuzzer->feature_map[trip->features[f]], 1, memory_order_relaxed)) {
+            novel = 1;
+        }
+    }
+    for (int p = 0; p < POINT_COUNT; p++) {
+        if (trip->reached[p] && !atomic_exchange_explicit(&fuzzer->points[p], 1, memory_order_relaxed)) {
+            won[won_count++] = p;
+            fuzzer->violations += p >= POINT_INVARIANT;
+        }
+    }
+    if ((novel || won_count) && fuzzer->count == fuzzer->capacity) {
+        size_t capacity = fuzzer->capacity ? fuzzer->capacity * 2 : 1024;
+        CorpusEntry* corpus = realloc(fuzzer->corpus, capacity * sizeof(CorpusEntry));
+        if (corpus) {
+            fuzzer->corpus = corpus;
+            fuzzer->capacity = capacity;
+        }
+    }
+    if ((novel || won_count) && fuzzer->count < fuzzer->capacity) {
+        CorpusEntry* entry = &fuzzer->corpus[fuzzer->count++];
+        entry->input = *input;
+        entry->draws = trip->probe.draws;
+        entry->decisions = trip->decisions;
+    }
+    pthread_mutex_unlock(&fuzzer->lock);
+
+    for (int i = 0; i < won_count; i++) {
+        report_point(fuzzer, trip, input, won[i]);
+    }
+}
+
+// A generator output likely to flip a comparison: the draws are compared with
+// percent and tenth fractions of RANDOM_MAX, or reduced modulo small ranges
+static uint32_t interesting_draw(uint64_t* rng) {
+    uint32_t boundary = (uint32_t)((uint64_t)RANDOM_MAX * rng_below(rng, 101) / 100);
+    switch (rng_below(rng, 4)) {
+        case 0:
+            return (uint32_t)next_rng(rng) & RANDOM_MAX;
+        case 1:
+            return boundary;
+        case 2:
+            return boundary ? boundary - 1 : 0;
+        default:
+            return rng_below(rng, 2) ? 0 : RANDOM_MAX;
+    }
+}
+
+static void mutate_plan(PurchasePlan* plan, uint64_t* rng) {
+    static const int steps[] = {1, 5, 10, 25, 50, 100};
+    PurchasePlan trial = *plan;
+    int* items[5] = {&trial.oxen, &trial.food, &trial.ammunition, &trial.clothing, &trial.misc_supplies};
+    int step = steps[rng_below(rng, 6)];
+    GameState probe;
+
+    switch (rng_below(rng, 3)) {
+        case 0: // Move dollars between two items
+            *items[rng_below(rng, 5)] -= step;
+            *items[rng_below(rng, 5)] += step;
+            break;
+        case 1: // Spend more or keep more cash
+            *items[rng_below(rng, 5)] += rng_below(rng, 2) ? step : -step;
+            break;
+        default:
+            trial.shooting_skill = 1 + (int)rng_below(rng, 5);
+            break;
+    }
+    if (apply_purchase_plan(&probe, &trial) == 0) {
+        *plan = trial;
+    }
+}
+
+static void mutate(FuzzInput* input, const CorpusEntry* parent, uint64_t* rng) {
+    int rounds = 1 + (int)rng_below(rng, 3);
+
+    for (int r = 0; r < rounds; r++) {
+        switch (rng_below(rng, 10)) {
+            case 0:
+                input->seed = (unsigned int)next_rng(rng) & SEED_MASK;
+                break;
+            case 1:
+            case 2:
+            case 3:
+                set_override(input->draws, &input->draw_count, rng_below(rng, parent->draws + 1),
+                             interesting_draw(rng));
+                break;
+            case 4:
+                if (input->draw_count) {
+                    input->draws[rng_below(rng, (uint32_t)input->draw_count)].value = interesting_draw(rng);
+                }
+                break;
+            case 5:
+                if (input->draw_count) {
+                    remove_override(input->draws, &input->draw_count,
+                                    (int)rng_below(rng, (uint32_t)input->draw_count));
+                }
+                break;
+            case 6:
+            case 7:
+                set_override(input->decisions, &input->decision_count,
+                             rng_below(rng, parent->decisions + 1), (uint32_t)(next_rng(rng) >> 33));
+                break;
+            case 8:
+                if (input->decision_count) {
+                    remove_override(input->decisions, &input->decision_count,
+                                    (int)rng_below(rng, (uint32_t)input->decision_count));
+                }
+                break;
+            default:
+                mutate_plan(&input->plan, rng);
+                break;
+        }
+    }
+}
+
+static void* fuzz_worker_main(void* arg) {
+    FuzzWorker* worker = (FuzzWorker*)arg;
+    Fuzzer* fuzzer = worker->fuzzer;
+    const FuzzJob* job = fuzzer->job;
+    uint64_t rng = 0x9e3779b97f4a7c15ull * (uint64_t)(worker->worker + 1);
+    FuzzTrip trip;
+    CorpusEntry parent;
+
+    init_trip(&trip, job->policy);
+    while (!atomic_load_explicit(&fuzzer->stop, memory_order_relaxed)) {
+        pthread_mutex_lock(&fuzzer->lock);
+        parent = fuzzer->corpus[rng_below(&rng, (uint32_t)fuzzer->count)];
+        pthread_mutex_unlock(&fuzzer->lock);
+
+        FuzzInput input = parent.input;
+        mutate(&input, &parent, &rng);
+        if (play_input(&trip, &input) != 0) {
+            continue;
+        }
+        uint64_t execs = atomic_fetch_add_explicit(&fuzzer->execs, 1, memory_order_relaxed) + 1;
+        if (job->execs && execs >= job->execs) {
+            atomic_store(&fuzzer->stop, 1);
+        }
+        keep_if_novel(fuzzer, &trip, &input);
+    }
+    return NULL;
+}
+
+static void fill_report(Fuzzer* fuzzer, FuzzReport* report) {
+    report->execs = atomic_load(&fuzzer->execs);
+    report->points = 0;
+    for (int p = 0; p < POINT_INVARIANT; p++) {
+        report->points += atomic_load_explicit(&fuzzer->points[p], memory_order_relaxed);
+    }
+    report->point_count = POINT_INVARIANT;
+    pthread_mutex_lock(&fuzzer->lock);
+    report->corpus = fuzzer->count;
+    report->violations = fuzzer->violations;
+    pthread_mutex_unlock(&fuzzer->lock);
+    report->seconds = now_seconds() - fuzzer->start;
+}
+
+int fuzz_run(const FuzzJob* job, FuzzReport* report) {
+    Fuzzer fuzzer;
+    FuzzTrip trip;
+    FuzzInput input;
+    GameState probe;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    FILE* log = job->log ? job->log : stderr;
+
+    memset(report, 0, sizeof(*report));
+    if (set_fuzz_probe(NULL) != 0) {
+        fprintf(log, "this engine has no fuzzing probe; build oregon_sim_fuzz (make fuzz)\n");
+        return -1;
+    }
+    if (apply_purchase_plan(&probe, &job->plan) != 0) {
+        fprintf(log, "invalid purchase plan\n");
+        return -1;
+    }
+    if (job->out_dir && mkdir(job->out_dir, 0777) != 0 && errno != EEXIST) {
+        fprintf(log, "%s: %s\n", job->out_dir, strerror(errno));
+        return -1;
+    }
+
+    memset(&fuzzer, 0, sizeof(fuzzer));
+    fuzzer.job = job;
+    fuzzer.start = now_seconds();
+    fuzzer.feature_map = calloc(FUZZ_MAP_SIZE, sizeof(atomic_uchar));
+    FuzzWorker* workers = calloc((size_t)threads, sizeof(FuzzWorker));
+    pthread_t* handles = calloc((size_t)threads, sizeof(pthread_t));
+    if (!fuzzer.feature_map || !workers || !handles) {
+        fprintf(log, "out of memory\n");
+        free(fuzzer.feature_map);
+        free(workers);
+        free(handles);
+        return -1;
+    }
+    pthread_mutex_init(&fuzzer.lock, NULL);
+
+    // The starting corpus: plain trips of consecutive seeds
+    init_trip(&trip, job->policy);
+    memset(&input, 0, sizeof(input));
+    input.plan = job->plan;
+    for (unsigned int i = 0; i < FUZZ_SEED_INPUTS; i++) {
+        input.seed = (job->first_seed + i) & SEED_MASK;
+        if (play_input(&trip, &input) == 0) {
+            atomic_fetch_add(&fuzzer.execs, 1);
+            keep_if_novel(&fuzzer, &trip, &input);
+        }
+    }
+
+    for (int w = 0; w < threads; w++) {
+        workers[w].fuzzer = &fuzzer;
+        workers[w].worker = w;
+    }
+    // Fewer threads than asked only fuzz slower
+    int started = start_worker_threads(handles, threads, fuzz_worker_main, workers, sizeof(FuzzWorker));
+    if (started == 0) {
+        fprintf(log, "cannot start the fuzzing threads\n");
+        atomic_store(&fuzzer.stop, 1);
+    }
+    double next_progress = fuzzer.start + 1.0;
+    while (!atomic_load(&fuzzer.stop)) {
+        struct timespec pause = {0, 50 * 1000 * 1000};
+        nanosleep(&pause, NULL);
+        double now = now_seconds();
+        if (job->seconds > 0 && now - fuzzer.start >= job->seconds) {
+            atomic_store(&fuzzer.stop, 1);
+        }
+        if (job->log && now >= next_progress) {
+            fill_report(&fuzzer, report);
+            fprintf(job->log, "%7.1f s  %llu execs, %.0f/s, corpus %llu, points %d/%d, %d invariants broken\n",
+                    report->seconds, (unsigned long long)report->execs,
+                    (double)report->execs / report->seconds, (unsigned long long)report->corpus,
+                    report->points, report->point_count, report->violations);
+            next_progress += 1.0;
+        }
+    }
+    for (int w = 0; w < started; w++) {
+        pthread_join(handles[w], NULL);
+    }
+
+    fill_report(&fuzzer, report);
+    pthread_mutex_destroy(&fuzzer.lock);
+    free(fuzzer.corpus);
+    free(fuzzer.feature_map);
+    free(workers);
+    free(handles);
+    return started > 0 ? 0 : -1;
+}
+
+int fuzz_replay(const FuzzInput* input, const Policy* policy, FILE* out) {
+    FuzzTrip trip;
+    char name[80];
+
+    if (set_fuzz_probe(NULL) != 0) {
+        fprintf(out, "this engine has no fuzzing probe; build oregon_sim_fuzz (make fuzz)\n");
+        return -1;
+    }
+    init_trip(&trip, policy);
+    trip.trace = out;
+    if (play_input(&trip, input) != 0) {
+        fprintf(out, "invalid purchase plan\n");
+        return -1;
+    }
+
+    const TripResult* result = &trip.result;
+    if (result->outcome == TRIP_ARRIVED) {
+        fprintf(out, "arrived on day %d\n", result->arrival_day);
+    } else {
+        fprintf(out, "died of %s on turn %d at %d miles\n", death_names[result->death_cause],
+                result->turn_number, result->miles_traveled);
+    }
+    fprintf(out, "%u draws, %u decisions, %d fort stops\n", trip.probe.draws, trip.decisions,
+            trip.fort_stops);
+    fprintf(out, "points:\n");
+    for (int p = 0; p < POINT_COUNT; p++) {
+        if (trip.reached[p]) {
+            point_name(p, name, sizeof(name));
+            fprintf(out, "  %s\n", name);
+        }
+    }
+    return 0;
+}
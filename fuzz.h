@@ -0,0 +1,93 @@
+/*
+ * Coverage-guided fuzzer: drives headless trips with mutated generator outputs
+ * and decisions to reach rare game states.
+ *
+ * An input is a seed, a purchase plan and two short override lists: generator
+ * outputs replaced by their index in the trip (see FuzzProbe in oregon.h), and
+ * decisions of the job's policy replaced by their index. Everything else plays
+ * as the plain trip, so a minimized input reads as "this seed, except the 17th
+ * draw and the third decision".
+ *
+ * Coverage of a trip comes in two kinds:
+ *
+ *   points    named, and reported with a reproducer: every game message the
+ *             trip would print (so every branch of handle_event, the rider,
+ *             mountain, illness and fort code), each combination of game flags
+ *             held at the end of a turn, rider hostility by tactic, the
+ *             outcome by whether the party stopped at a fort, and a turn
+ *             starting behind Independence
+ *   features  hashed into a map only: per turn, the event after the one before
+ *             it, and coarse buckets of miles, resources, cash and flags
+ *
+ * An input that reaches a new point or feature joins the corpus. The first
+ * input to reach a point is minimized, overrides dropped one at a time while
+ * the point is still reached, and written to the output directory; fuzz-replay
+ * plays one back.
+ *
+ * Invariants are points too, reached only when broken. At every turn prompt
+ * (after validate_resources and pay_doctor_bill) and on arrival, no resource
+ * or cash may be negative, and no turn may start past the twentieth.
+ *
+ * Only an engine built with OREGON_FUZZ (oregon_sim_fuzz) has the probe.
+ */
+
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "oregon.h"
+
+#define FUZZ_MAX_OVERRIDES 16
+#define FUZZ_MAP_BITS 18            // Feature map of 2^18 entries
+#define FUZZ_SEED_INPUTS 256        // Plain seeds the corpus starts from
+
+typedef struct {
+    uint32_t index;             // Draw or decision number in the trip, from 0
+    uint32_t value;             // Generator output, or decision reduced to its range
+} FuzzOverride;
+
+typedef struct {
+    unsigned int seed;
+    PurchasePlan plan;
+    int draw_count;
+    int decision_count;
+    FuzzOverride draws[FUZZ_MAX_OVERRIDES];      // Ascending index
+    FuzzOverride decisions[FUZZ_MAX_OVERRIDES];  // Ascending index
+} FuzzInput;
+
+typedef struct {
+    const Policy* policy;       // Makes the decisions not overridden
+    const char* policy_name;    // Recorded in reproducers
+    PurchasePlan plan;          // Of the starting inputs
+    unsigned int first_seed;    // Starting inputs play first_seed, first_seed + 1, ...
+    int threads;
+    double seconds;             // Stop after this long, 0 for no limit
+    uint64_t execs;             // Stop after this many trips, 0 for no limit
+    const char* out_dir;        // Reproducers, NULL to write none
+    FILE* log;                  // New points and progress, NULL for none
+} FuzzJob;
+
+typedef struct {
+    uint64_t execs;
+    uint64_t corpus;
+    int points;                 // Points reached, invariants excluded
+    int point_count;
+    int violations;             // Invariants broken
+    double seconds;
+} FuzzReport;
+
+// Fuzz until the job's limit; returns 0, or -1 (message in log) if the engine
+// has no fuzzing probe, the plan is invalid or out_dir cannot be created
+int fuzz_run(const FuzzJob* job, FuzzReport* report);
+
+// Reproducer files, as fuzz_run writes them; policy_name gets the recorded
+// policy. Returns 0, or -1 if the file is not a reproducer.
+int fuzz_read_input(FILE* in, FuzzInput* input, char* policy_name, size_t policy_size);
+void fuzz_write_input(FILE* out, const FuzzInput* input, const char* policy_name);
+
+// Play an input turn by turn onto out, with the points it reaches; returns -1
+// if the engine has no fuzzing probe or the plan is invalid
+int fuzz_replay(const FuzzInput* input, const Policy* policy, FILE* out);
+
+#endif // FUZZ_H
@@ -0,0 +1,769 @@
+/*
+ * Golden-transcript regression runner.
+ */
+
+#include <stdatomic.h>
+#include <time.h>
+#include "golden.h"
+#include "batch.h"
+
+// Cases handed to a worker at a time
+#define GOLDEN_CHUNK 16
+
+// Larger differing regions are shown whole instead of line-diffed
+#define GOLDEN_MAX_DIFF_CELLS (1 << 22)
+#define GOLDEN_DIFF_CONTEXT 2
+
+static const char* const event_names[EVENT_COUNT] = {
+    "wagon breakdown", "ox injury", "daughter breaks arm", "ox wanders off",
+    "son gets lost", "unsafe water", "heavy rains", "bandits attack", "fire in wagon",
+    "lose way in fog", "poisonous snake", "wagon swamped fording", "wild animals attack",
+    "cold weather", "hail storm", "helpful indians"
+};
+
+static const char* const tactic_names[4] = {"run", "attack", "continue", "circle wagons"};
+
+static const char* const death_names[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "winter blizzard", "snakebite", "massacre"
+};
+
+// Death causes show_death_scene knows but no rule of the engine ever picks
+#define UNREACHABLE_DEATHS ((1u << DEATH_EXHAUSTION) | (1u << DEATH_INJURIES))
+
+static const char* const plain_text[TEXT_COUNT] = {
+#define TEXT(id, text) text,
+#include "oregon_text.def"
+#undef TEXT
+};
+
+// Messages that only one side of a branch in the rules prints, at the start of
+// a line or straight after the message that leads into them
+static const struct {
+    int text;                   // TextId
+    int after;                  // TextId printed just before, -1 for a line start
+    const char* name;
+} branches[] = {
+    {TEXT_BANDITS_TAKE_CASH, -1, "bandits, out of bullets"},
+    {TEXT_BANDITS_DRIVEN_OFF, -1, "bandits driven off"},
+    {TEXT_SHOT_IN_LEG, -1, "bandits, shot in the leg"},
+    {TEXT_WOLVES_OVERPOWERED, -1, "wild animals, under 40 bullets"},
+    {TEXT_ANIMALS_DRIVEN_OFF, -1, "wild animals driven off"},
+    {TEXT_ANIMALS_GOT_FOOD, -1, "wild animals, slow on the draw"},
+    {TEXT_WARM_ENOUGH, TEXT_COLD_WEATHER, "cold weather, enough clothing"},
+    {TEXT_NOT_WARM_ENOUGH, TEXT_COLD_WEATHER, "cold weather, not enough clothing"},
+    {TEXT_HUNT_BIG_ONE, -1, "hunting, big one"},
+    {TEXT_HUNT_NICE_SHOT, -1, "hunting, nice shot"},
+    {TEXT_HUNT_MISSED, -1, "hunting, missed"},
+    {TEXT_DROVE_THEM_OFF, -1, "riders driven off"},
+    {TEXT_KINDA_SLOW, -1, "riders, kinda slow"},
+    {TEXT_GOT_KNIFED, -1, "riders, knifed"},
+    {TEXT_MILD_ILLNESS, -1, "mild illness"},
+    {TEXT_BAD_ILLNESS, -1, "bad illness"},
+    {TEXT_SERIOUS_ILLNESS, -1, "serious illness"},
+    {TEXT_OUT_OF_MEDICINE, -1, "illness, out of medicine"},
+    {TEXT_CANT_AFFORD_DOCTOR, -1, "injury, cannot afford a doctor"},
+    {TEXT_LOST_TRAIL, -1, "mountains, lost the trail"},
+    {TEXT_WAGON_DAMAGED, -1, "mountains, wagon damaged"},
+    {TEXT_GOING_GETS_SLOW, -1, "mountains, going gets slow"},
+    {TEXT_BLIZZARD, -1, "blizzard in the pass"},
+};
+
+#define BRANCH_COUNT (int)(sizeof(branches) / sizeof(branches[0]))
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Of a case's input and transcript, for corpora that keep only digests
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t case_digest(const char* input, size_t input_size, const char* output, size_t output_size) {
+    uint64_t sizes[2] = {input_size, output_size};
+    uint64_t hash = fnv1a(0xcbf29ce484222325ull, sizes, sizeof(sizes));
+    hash = fnv1a(hash, input, input_size);
+    return fnv1a(hash, output, output_size);
+}
+
+// Corpus files
+
+static GoldenCase* add_case(GoldenCorpus* corpus) {
+    if (corpus->count == corpus->capacity) {
+        size_t capacity = corpus->capacity ? corpus->capacity * 2 : 256;
+        GoldenCase* cases = realloc(corpus->cases, capacity * sizeof(GoldenCase));
+        if (!cases) {
+            return NULL;
+        }
+        corpus->cases = cases;
+        corpus->capacity = capacity;
+    }
+    GoldenCase* golden = &corpus->cases[corpus->count++];
+    memset(golden, 0, sizeof(*golden));
+    return golden;
+}
+
+static char* read_bytes(FILE* in, size_t size) {
+    char* bytes = malloc(size + 1);
+    if (bytes && fread(bytes, 1, size, in) != size) {
+        free(bytes);
+        return NULL;
+    }
+    if (bytes) {
+        bytes[size] = '\0';
+    }
+    return bytes;
+}
+
+// Layout: a GOLDEN_MAGIC line, then per case
+//   CASE <name> <seed> <input bytes> <output bytes>\n<input><output>\n
+// or a GOLDEN_DIGEST_MAGIC line with " rules <revision>", then per case
+//   CASE <name> <seed> <digest in hex>\n
+int golden_load(GoldenCorpus* corpus, const char* path) {
+    char line[256];
+    memset(corpus, 0, sizeof(*corpus));
+
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        return -1;
+    }
+    if (fgets(line, sizeof(line), in) &&
+        sscanf(line, GOLDEN_DIGEST_MAGIC " rules %d", &corpus->rules_revision) == 1) {
+        corpus->digests_only = 1;
+    } else if (strncmp(line, GOLDEN_MAGIC, strlen(GOLDEN_MAGIC)) != 0) {
+        fclose(in);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), in)) {
+        char name[32];
+        unsigned int seed;
+        unsigned long long digest;
+        size_t input_size, expected_size;
+        if (corpus->digests_only) {
+            GoldenCase* golden = NULL;
+            if (sscanf(line, "CASE %31s %u %16llx", name, &seed, &digest) != 3 || !(golden = add_case(corpus))) {
+                golden_free(corpus);
+                fclose(in);
+                return -1;
+            }
+            memcpy(golden->name, name, sizeof(name));
+            golden->seed = seed;
+            golden->digest = (uint64_t)digest;
+            continue;
+        }
+        if (sscanf(line, "CASE %31s %u %zu %zu", name, &seed, &input_size, &expected_size) != 4) {
+            golden_free(corpus);
+            fclose(in);
+            return -1;
+        }
+        GoldenCase* golden = add_case(corpus);
+        if (!golden) {
+            golden_free(corpus);
+            fclose(in);
+            return -1;
+        }
+        memcpy(golden->name, name, sizeof(name));
+        golden->seed = seed;
+        golden->input_size = input_size;
+        golden->expected_size = expected_size;
+        golden->input = read_bytes(in, input_size);
+        golden->expected = read_bytes(in, expected_size);
+        if (!golden->input || !golden->expected || fgetc(in) != '\n') {
+            golden_free(corpus);
+            fclose(in);
+            return -1;
+        }
+    }
+    fclose(in);
+    return 0;
+}
+
+int golden_save(const GoldenCorpus* corpus, const char* path) {
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        return -1;
+    }
+    fprintf(out, "%s\n", GOLDEN_MAGIC);
+    for (size_t i = 0; i < corpus->count; i++) {
+        const GoldenCase* golden = &corpus->cases[i];
+        fprintf(out, "CASE %s %u %zu %zu\n", golden->name, golden->seed,
+                golden->input_size, golden->expected_size);
+        fwrite(golden->input, 1, golden->input_size, out);
+        fwrite(golden->expected, 1, golden->expected_size, out);
+        fputc('\n', out);
+    }
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+int golden_save_digests(const GoldenCorpus* corpus, const char* path) {
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        return -1;
+    }
+    fprintf(out, "%s rules %d\n", GOLDEN_DIGEST_MAGIC, OREGON_RULES_REVISION);
+    for (size_t i = 0; i < corpus->count; i++) {
+        const GoldenCase* golden = &corpus->cases[i];
+        fprintf(out, "CASE %s %u %016llx\n", golden->name, golden->seed, (unsigned long long)golden->digest);
+    }
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+void golden_free(GoldenCorpus* corpus) {
+    for (size_t i = 0; i < corpus->count; i++) {
+        free(corpus->cases[i].input);
+        free(corpus->cases[i].expected);
+    }
+    free(corpus->cases);
+    memset(corpus, 0, sizeof(*corpus));
+}
+
+// Coverage: the keyboard player, watched
+
+static int watched_turn_action(const GameState* game, int fort_open, void* ctx) {
+    GoldenCoverage* coverage = (GoldenCoverage*)ctx;
+    if (game->last_event >= 0) {
+        coverage->events |= 1u << game->last_event;
+    }
+    coverage->passes |= (uint32_t)game->game_flags & (FLAG_SOUTH_PASS | FLAG_BLUE_MOUNTAINS);
+    return human_policy.turn_action(game, fort_open, human_policy.ctx);
+}
+
+static int watched_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    GoldenCoverage* coverage = (GoldenCoverage*)ctx;
+    int tactic = human_policy.rider_tactic(game, hostile, human_policy.ctx);
+    int counted = (tactic >= TACTIC_RUN && tactic <= TACTIC_CIRCLE_WAGONS) ? tactic : TACTIC_CIRCLE_WAGONS;
+    coverage->tactics[hostile ? 1 : 0] |= (uint8_t)(1u << (counted - 1));
+    return tactic;
+}
+
+static void watch_player(Policy* policy, GoldenCoverage* coverage) {
+    *policy = human_policy;
+    policy->turn_action = watched_turn_action;
+    policy->rider_tactic = watched_rider_tactic;
+    policy->ctx = coverage;
+}
+
+// Whether the transcript has a line starting with text, and after if it leads in
+static int printed_branch(const char* output, const char* after, const char* text) {
+    char needle[256];
+
+    snprintf(needle, sizeof(needle), "%s%s", after, text);
+    for (const char* found = strstr(output, needle); found; found = strstr(found + 1, needle)) {
+        if (found == output || found[-1] == '\n') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void add_outcome(GoldenCoverage* coverage, const GameConsole* console) {
+    const char* output = console->output ? console->output : "";
+
+    for (int b = 0; b < BRANCH_COUNT; b++) {
+        const char* after = branches[b].after >= 0 ? plain_text[branches[b].after] : "";
+        if (!(coverage->branches & (1u << b)) && printed_branch(output, after, plain_text[branches[b].text])) {
+            coverage->branches |= 1u << b;
+        }
+    }
+    if (!console->finished) {
+        coverage->unfinished++;
+    } else if (console->result.outcome == TRIP_ARRIVED) {
+        coverage->arrived++;
+    } else {
+        coverage->deaths |= 1u << console->result.death_cause;
+    }
+}
+
+static void merge_coverage(GoldenCoverage* into, const GoldenCoverage* from) {
+    into->events |= from->events;
+    into->branches |= from->branches;
+    into->tactics[0] |= from->tactics[0];
+    into->tactics[1] |= from->tactics[1];
+    into->passes |= from->passes;
+    into->deaths |= from->deaths;
+    into->arrived += from->arrived;
+    into->unfinished += from->unfinished;
+}
+
+int golden_print_coverage(FILE* out, const GoldenCoverage* coverage) {
+    int missed = 0;
+
+    fprintf(out, "coverage: %llu arrivals, %llu cases ended by their input\n",
+            (unsigned long long)coverage->arrived, (unsigned long long)coverage->unfinished);
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        if (!(coverage->events & (1u << e))) {
+            fprintf(out, "  missed event: %s\n", event_names[e]);
+            missed++;
+        }
+    }
+    for (int b = 0; b < BRANCH_COUNT; b++) {
+        if (!(coverage->branches & (1u << b))) {
+            fprintf(out, "  missed branch: %s\n", branches[b].name);
+            missed++;
+        }
+    }
+    for (int h = 0; h < 2; h++) {
+        for (int t = 0; t < 4; t++) {
+            if (!(coverage->tactics[h] & (1u << t))) {
+                fprintf(out, "  missed tactic: %s against %s riders\n", tactic_names[t],
+                        h ? "hostile" : "friendly");
+                missed++;
+            }
+        }
+    }
+    if (!(coverage->passes & FLAG_SOUTH_PASS)) {
+        fprintf(out, "  missed pass: south pass\n");
+        missed++;
+    }
+    if (!(coverage->passes & FLAG_BLUE_MOUNTAINS)) {
+        fprintf(out, "  missed pass: blue mountains\n");
+        missed++;
+    }
+    for (int d = 0; d < DEATH_CAUSE_COUNT; d++) {
+        if (UNREACHABLE_DEATHS & (1u << d)) {
+            fprintf(out, "  unreachable death: %s\n", death_names[d]);
+        } else if (!(coverage->deaths & (1u << d))) {
+            fprintf(out, "  missed death: %s\n", death_names[d]);
+            missed++;
+        }
+    }
+    if (!missed) {
+        fprintf(out, "  every event, branch, tactic, pass and reachable death cause exercised\n");
+    }
+    return missed;
+}
+
+// Recording: a scripted player that types its answers
+
+typedef struct {
+    uint64_t rng;
+    char* buffer;
+    size_t size;
+    size_t capacity;
+    size_t answered;            // Output size when the last answer was given
+    int lines;
+} ScriptWriter;
+
+static uint32_t script_random(ScriptWriter* script, uint32_t range) {
+    script->rng ^= script->rng >> 12;
+    script->rng ^= script->rng << 25;
+    script->rng ^= script->rng >> 27;
+    return (uint32_t)((script->rng * 0x2545f4914f6cdd1dull) >> 33) % range;
+}
+
+static void script_line(ScriptWriter* script, const char* format, ...) {
+    char line[64];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length < 0 || (size_t)length >= sizeof(line) - 1) {
+        return;
+    }
+    line[length++] = '\n';
+
+    if (script->size + (size_t)length > script->capacity) {
+        size_t capacity = script->capacity ? script->capacity * 2 : 1024;
+        char* buffer = realloc(script->buffer, capacity);
+        if (!buffer) {
+            return;
+        }
+        script->buffer = buffer;
+        script->capacity = capacity;
+    }
+    memcpy(script->buffer + script->size, line, (size_t)length);
+    script->size += (size_t)length;
+    script->lines++;
+}
+
+// Amount in [low, high], now and then something the game has to reject
+static int script_amount(ScriptWriter* script, int low, int high) {
+    switch (script_random(script, 40)) {
+        case 0: return -10;
+        case 1: return high * 10;
+        default: return low + (int)script_random(script, (uint32_t)(high - low + 1));
+    }
+}
+
+// Answer the prompt at the end of the transcript so far
+static int script_refill(GameConsole* console, void* ctx) {
+    ScriptWriter* script = (ScriptWriter*)ctx;
+    const char* output = console->output ? console->output : "";
+    size_t end = console->output_size;
+
+    if (script->lines >= GOLDEN_MAX_INPUT_LINES) {
+        return 0;
+    }
+
+    // The prompt is the last non-empty line printed since the previous answer;
+    // prompts without a newline share a line with the ones before them
+    while (end > script->answered && output[end - 1] == '\n') {
+        end--;
+    }
+    size_t start = end;
+    while (start > script->answered && output[start - 1] != '\n') {
+        start--;
+    }
+    script->answered = console->output_size;
+    char prompt[160];
+    size_t length = end - start < sizeof(prompt) - 1 ? end - start : sizeof(prompt) - 1;
+    memcpy(prompt, output + start, length);
+    prompt[length] = '\0';
+
+    const char* typed = strstr(prompt, "TYPE ");
+    if (strstr(prompt, "INSTRUCTIONS")) {
+        script_line(script, script_random(script, 10) ? "NO" : "YES");
+    } else if (typed) {
+        static const char* const wrong[] = {"BANF", "", "BLAMM", "PO W"};
+        uint32_t roll = script_random(script, 20);
+        if (roll < 14) {
+            script_line(script, "%s", typed + 5);
+        } else if (roll < 16) {
+            char lower[16];
+            size_t i = 0;
+            for (; typed[5 + i] && i < sizeof(lower) - 1; i++) {
+                lower[i] = (char)tolower((unsigned char)typed[5 + i]);
+            }
+            lower[i] = '\0';
+            script_line(script, "%s", lower);
+        } else {
+            script_line(script, "%s", wrong[script_random(script, 4)]);
+        }
+    } else if (strstr(prompt, "FASTER YOU'LL HAVE")) {
+        script_line(script, "%d", (int)script_random(script, 7));
+    } else if (strstr(prompt, "OXEN TEAM")) {
+        script_line(script, "%d", script_amount(script, 190, 310));
+    } else if (strstr(prompt, "HOW MUCH DO YOU WANT TO SPEND ON")) {
+        script_line(script, "%d", script_amount(script, 0, 110));
+    } else if (strstr(prompt, "? ") && (strstr(prompt, "FOOD") || strstr(prompt, "AMMUNITION") ||
+                                       strstr(prompt, "CLOTHING") || strstr(prompt, "SUPPLIES"))) {
+        script_line(script, "%d", script_amount(script, 0, 30));
+    } else if (strstr(prompt, "WOULD YOU LIKE")) {
+        script_line(script, script_random(script, 2) ? "YES" : "no");
+    } else {
+        // A numbered choice; sometimes out of range or not a number at all
+        switch (script_random(script, 30)) {
+            case 0: script_line(script, "x"); break;
+            case 1: script_line(script, "9"); break;
+            case 2: script_line(script, " 2 3"); break;
+            default: script_line(script, "%d", 1 + (int)script_random(script, 4)); break;
+        }
+    }
+
+    console->input = script->buffer;
+    console->input_size = script->size;
+    return 1;
+}
+
+// Worker threads
+
+typedef struct {
+    GoldenCorpus* corpus;
+    size_t first_case;
+    size_t case_count;
+    int recording;
+    atomic_size_t* next_case;
+    uint8_t* failed;            // Per case, when checking
+    char** actual;              // Output of failed cases
+    size_t* actual_size;
+    GoldenCoverage coverage;
+} GoldenWorker;
+
+static void run_case(GoldenWorker* worker, GameConsole* console, GoldenCase* golden, size_t index) {
+    Policy watched;
+    ScriptWriter script;
+
+    watch_player(&watched, &worker->coverage);
+    set_player_policy(&watched);
+
+    // Digest-only cases are replayed by recording them again
+    int scripted = worker->recording || worker->corpus->digests_only;
+    console->seed = golden->seed;
+    console->input_pos = 0;
+    console->output_size = 0;
+    if (scripted) {
+        memset(&script, 0, sizeof(script));
+        script.rng = 0x9e3779b97f4a7c15ull * ((uint64_t)golden->seed + 1);
+        console->input = NULL;
+        console->input_size = 0;
+        console->refill = script_refill;
+        console->refill_ctx = &script;
+    } else {
+        console->input = golden->input;
+        console->input_size = golden->input_size;
+        console->refill = NULL;
+        console->refill_ctx = NULL;
+    }
+
+    play_game_console(console);
+    set_player_policy(NULL);
+    add_outcome(&worker->coverage, console);
+
+    const char* output = console->output ? console->output : "";
+    uint64_t digest = scripted ? case_digest(script.buffer ? script.buffer : "", script.size, output,
+                                             console->output_size) : 0;
+    if (worker->recording) {
+        golden->digest = digest;
+        golden->input = script.buffer ? script.buffer : calloc(1, 1);
+        golden->input_size = script.size;
+        golden->expected = malloc(console->output_size + 1);
+        if (golden->expected) {
+            memcpy(golden->expected, output, console->output_size);
+            golden->expected[console->output_size] = '\0';
+        }
+        golden->expected_size = console->output_size;
+    } else if (scripted) {
+        worker->failed[index] = digest != golden->digest;
+        free(script.buffer);
+    } else if (console->output_size != golden->expected_size ||
+               memcmp(output, golden->expected, golden->expected_size) != 0) {
+        worker->failed[index] = 1;
+        worker->actual[index] = malloc(console->output_size + 1);
+        if (worker->actual[index]) {
+            memcpy(worker->actual[index], output, console->output_size);
+            worker->actual[index][console->output_size] = '\0';
+        }
+        worker->actual_size[index] = console->output_size;
+    }
+}
+
+static void* golden_worker_main(void* arg) {
+    GoldenWorker* worker = (GoldenWorker*)arg;
+    GameConsole console;
+
+    memset(&console, 0, sizeof(console));
+    for (;;) {
+        size_t first = atomic_fetch_add(worker->next_case, GOLDEN_CHUNK);
+        if (first >= worker->case_count) {
+            break;
+        }
+        size_t last = first + GOLDEN_CHUNK < worker->case_count ? first + GOLDEN_CHUNK : worker->case_count;
+        for (size_t i = first; i < last; i++) {
+            run_case(worker, &console, &worker->corpus->cases[worker->first_case + i], i);
+        }
+    }
+    free(console.output);
+    return NULL;
+}
+
+// Returns 0, or -1 if memory runs out
+static int run_workers(GoldenCorpus* corpus, size_t first_case, int recording, int threads,
+                       uint8_t* failed, char** actual, size_t* actual_size, GoldenReport* report) {
+    atomic_size_t next_case;
+    GoldenWorker* workers = calloc((size_t)threads, sizeof(GoldenWorker));
+    if (!workers) {
+        return -1;
+    }
+
+    atomic_init(&next_case, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].corpus = corpus;
+        workers[w].first_case = first_case;
+        workers[w].case_count = corpus->count - first_case;
+        workers[w].recording = recording;
+        workers[w].next_case = &next_case;
+        workers[w].failed = failed;
+        workers[w].actual = actual;
+        workers[w].actual_size = actual_size;
+    }
+    run_worker_threads(golden_worker_main, workers, sizeof(GoldenWorker), threads);
+    for (int w = 0; w < threads; w++) {
+        merge_coverage(&report->coverage, &workers[w].coverage);
+    }
+    free(workers);
+    return 0;
+}
+
+int golden_record(GoldenCorpus* corpus, size_t count, unsigned int first_seed, int threads,
+                  GoldenReport* report) {
+    size_t first_case = corpus->count;
+
+    memset(report, 0, sizeof(*report));
+    for (size_t i = 0; i < count; i++) {
+        GoldenCase* golden = add_case(corpus);
+        if (!golden) {
+            return -1;
+        }
+        golden->seed = (unsigned int)((first_seed + i) & SEED_MASK);
+        snprintf(golden->name, sizeof(golden->name), "case%06zu", first_case + i);
+    }
+
+    double start = now_seconds();
+    if (run_workers(corpus, first_case, 1, threads > 0 ? threads : batch_default_threads(),
+                    NULL, NULL, NULL, report) != 0) {
+        corpus->count = first_case; // Drop the cases that were not recorded
+        return -1;
+    }
+    report->seconds = now_seconds() - start;
+    report->passed = count;
+    return 0;
+}
+
+// Minimal diffs
+
+typedef struct {
+    const char* start;
+    size_t length;
+} Line;
+
+static size_t split_lines(const char* text, size_t size, Line** lines) {
+    size_t count = 0, capacity = 64;
+    *lines = malloc(capacity * sizeof(Line));
+    for (size_t pos = 0; pos < size && *lines;) {
+        const char* newline = memchr(text + pos, '\n', size - pos);
+        size_t length = newline ? (size_t)(newline - (text + pos)) + 1 : size - pos;
+        if (count == capacity) {
+            capacity *= 2;
+            Line* grown = realloc(*lines, capacity * sizeof(Line));
+            if (!grown) {
+                break;
+            }
+            *lines = grown;
+        }
+        (*lines)[count].start = text + pos;
+        (*lines)[count].length = length;
+        count++;
+        pos += length;
+    }
+    return count;
+}
+
+static int same_line(const Line* a, const Line* b) {
+    return a->length == b->length && memcmp(a->start, b->start, a->length) == 0;
+}
+
+static void print_line(FILE* out, char mark, const Line* line) {
+    size_t length = line->length;
+    int newline = length > 0 && line->start[length - 1] == '\n';
+    fprintf(out, "%c%.*s%s", mark, (int)(length - (size_t)newline), line->start,
+            newline ? "\n" : "\n\\ no newline at end\n");
+}
+
+// Shortest edit script between the expected and actual transcripts
+static void print_diff(FILE* out, const char* expected, size_t expected_size,
+                       const char* actual, size_t actual_size) {
+    Line* a;
+    Line* b;
+    size_t n = split_lines(expected, expected_size, &a);
+    size_t m = split_lines(actual, actual_size, &b);
+
+    size_t prefix = 0;
+    while (prefix < n && prefix < m && same_line(&a[prefix], &b[prefix])) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix &&
+           same_line(&a[n - 1 - suffix], &b[m - 1 - suffix])) {
+        suffix++;
+    }
+    size_t rows = n - prefix - suffix, cols = m - prefix - suffix;
+
+    fprintf(out, "@@ -%zu,%zu +%zu,%zu @@\n", prefix + 1, rows, prefix + 1, cols);
+    size_t context = prefix > GOLDEN_DIFF_CONTEXT ? prefix - GOLDEN_DIFF_CONTEXT : 0;
+    for (size_t i = context; i < prefix; i++) {
+        print_line(out, ' ', &a[i]);
+    }
+
+    // LCS table over the differing middle, when small enough
+    uint32_t* table = NULL;
+    if ((rows + 1) * (cols + 1) <= GOLDEN_MAX_DIFF_CELLS) {
+        table = calloc((rows + 1) * (cols + 1), sizeof(uint32_t));
+    }
+    if (table) {
+        for (size_t i = rows; i-- > 0;) {
+            for (size_t j = cols; j-- > 0;) {
+                uint32_t* cell = &table[i * (cols + 1) + j];
+                if (same_line(&a[prefix + i], &b[prefix + j])) {
+                    *cell = table[(i + 1) * (cols + 1) + j + 1] + 1;
+                } else {
+                    uint32_t down = table[(i + 1) * (cols + 1) + j];
+                    uint32_t right = table[i * (cols + 1) + j + 1];
+                    *cell = down > right ? down : right;
+                }
+            }
+        }
+        size_t i = 0, j = 0;
+        while (i < rows || j < cols) {
+            if (i < rows && j < cols && same_line(&a[prefix + i], &b[prefix + j])) {
+                print_line(out, ' ', &a[prefix + i]);
+                i++;
+                j++;
+            } else if (i < rows && (j == cols || table[(i + 1) * (cols + 1) + j] >= table[i * (cols + 1) + j + 1])) {
+                print_line(out, '-', &a[prefix + i++]);
+            } else {
+                print_line(out, '+', &b[prefix + j++]);
+            }
+        }
+        free(table);
+    } else {
+        for (size_t i = 0; i < rows; i++) {
+            print_line(out, '-', &a[prefix + i]);
+        }
+        for (size_t j = 0; j < cols; j++) {
+            print_line(out, '+', &b[prefix + j]);
+        }
+    }
+
+    for (size_t i = n - suffix; i < n && i < n - suffix + GOLDEN_DIFF_CONTEXT; i++) {
+        print_line(out, ' ', &a[i]);
+    }
+    free(a);
+    free(b);
+}
+
+int golden_check(const GoldenCorpus* corpus, int threads, FILE* diff_out, int max_diffs,
+                 GoldenReport* report) {
+    size_t count = corpus->count;
+    uint8_t* failed = calloc(count ? count : 1, 1);
+    char** actual = calloc(count ? count : 1, sizeof(char*));
+    size_t* actual_size = calloc(count ? count : 1, sizeof(size_t));
+
+    memset(report, 0, sizeof(*report));
+    if (!failed || !actual || !actual_size) {
+        free(failed);
+        free(actual);
+        free(actual_size);
+        return -1;
+    }
+
+    double start = now_seconds();
+    if (run_workers((GoldenCorpus*)corpus, 0, 0, threads > 0 ? threads : batch_default_threads(),
+                    failed, actual, actual_size, report) != 0) {
+        free(failed);
+        free(actual);
+        free(actual_size);
+        return -1;
+    }
+    report->seconds = now_seconds() - start;
+
+    int shown = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!failed[i]) {
+            report->passed++;
+            continue;
+        }
+        report->failed++;
+        const GoldenCase* golden = &corpus->cases[i];
+        if (diff_out && shown < max_diffs && corpus->digests_only) {
+            fprintf(diff_out, "FAIL %s (seed %u): transcript digest differs\n", golden->name, golden->seed);
+            shown++;
+        } else if (diff_out && shown < max_diffs && actual[i]) {
+            fprintf(diff_out, "FAIL %s (seed %u)\n", golden->name, golden->seed);
+            print_diff(diff_out, golden->expected, golden->expected_size, actual[i], actual_size[i]);
+            shown++;
+        }
+        free(actual[i]);
+    }
+    free(failed);
+    free(actual);
+    free(actual_size);
+    return 0;
+}
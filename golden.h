@@ -0,0 +1,96 @@
+/*
+ * Golden-transcript regression runner.
+ *
+ * A corpus is a file of cases, each a fixed seed, the exact bytes typed on
+ * stdin and the exact stdout the interactive game produced for them. Checking
+ * replays every case in-process on an in-memory GameConsole, spread over
+ * worker threads, and compares the output byte for byte; failures are shown as
+ * minimal line diffs.
+ *
+ * Recording writes new cases: a scripted player answers each prompt with a
+ * mix of sensible, out-of-range and malformed input, chosen from the prompt
+ * text and a per-case random stream, and the transcript it produces becomes
+ * the expected output.
+ *
+ * Since the script depends only on the seed and the prompts, a corpus can
+ * also keep just each case's seed and a digest of its input and transcript.
+ * Checking such a corpus records every case again and compares digests, so
+ * it fails without a diff; recording the failing seeds on a good build and on
+ * the new one gives transcripts to diff. The repository's corpus
+ * (GOLDEN_DEFAULT_CORPUS) is of this kind, and golden-check reads it when
+ * given no file.
+ *
+ * Both directions report coverage: the events, both sides of the rules that
+ * branch (bandits, wild animals with under 40 bullets or more, cold weather
+ * with enough clothing or not, ...), rider tactics under each hostility,
+ * mountain passes and outcomes the corpus exercised. A check that misses any
+ * of them fails. Exhaustion and injuries are listed as unreachable: the
+ * engine has the messages but no rule that ends a trip with them.
+ */
+
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "oregon.h"
+
+#define GOLDEN_MAGIC "ORGOLDEN 1"
+#define GOLDEN_DIGEST_MAGIC "ORGOLDEN DIGESTS 1"
+#define GOLDEN_DEFAULT_CORPUS "golden/corpus.digests"
+#define GOLDEN_MAX_INPUT_LINES 400     // Recording stops feeding input after this
+#define GOLDEN_DEFAULT_CASES 5000
+
+typedef struct {
+    char name[32];
+    unsigned int seed;
+    char* input;
+    size_t input_size;
+    char* expected;
+    size_t expected_size;
+    uint64_t digest;            // Of the input and the transcript
+} GoldenCase;
+
+typedef struct {
+    GoldenCase* cases;
+    size_t count;
+    size_t capacity;
+    int digests_only;           // Cases have a seed and a digest but no transcript
+    int rules_revision;         // OREGON_RULES_REVISION a digest corpus was recorded under
+} GoldenCorpus;
+
+typedef struct {
+    uint32_t events;            // Bit per EventType seen at a following turn
+    uint32_t branches;          // Bit per branch message printed (see golden.c)
+    uint8_t tactics[2];         // Bit per tactic, [0] friendly and [1] hostile riders
+    uint32_t passes;            // FLAG_SOUTH_PASS | FLAG_BLUE_MOUNTAINS
+    uint32_t deaths;            // Bit per DeathCause
+    uint64_t arrived;
+    uint64_t unfinished;        // Cases whose input ran out before the trip ended
+} GoldenCoverage;
+
+typedef struct {
+    size_t passed;
+    size_t failed;
+    GoldenCoverage coverage;
+    double seconds;
+} GoldenReport;
+
+int golden_load(GoldenCorpus* corpus, const char* path);
+int golden_save(const GoldenCorpus* corpus, const char* path);
+int golden_save_digests(const GoldenCorpus* corpus, const char* path);
+void golden_free(GoldenCorpus* corpus);
+
+// Append count recorded cases with seeds first_seed, first_seed + 1, ...
+int golden_record(GoldenCorpus* corpus, size_t count, unsigned int first_seed, int threads,
+                  GoldenReport* report);
+
+// Replay every case; diffs for up to max_diffs failures go to diff_out
+int golden_check(const GoldenCorpus* corpus, int threads, FILE* diff_out, int max_diffs,
+                 GoldenReport* report);
+
+// List what the corpus exercised and what it missed; returns how many
+// reachable points it missed
+int golden_print_coverage(FILE* out, const GoldenCoverage* coverage);
+
+#endif // GOLDEN_H
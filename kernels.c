@@ -0,0 +1,28 @@
+/*
+ * Trip kernel lookup.
+ */
+
+#include "kernels.h"
+#include "policy.h"
+
+// Defined by the kernel objects, see the Makefile
+int trip_kernel_CONTINUE_1(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+int trip_kernel_CONTINUE_2(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+int trip_kernel_CONTINUE_3(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+int trip_kernel_CONTINUE_4(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+int trip_kernel_CONTINUE_5(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+
+static const TripKernel continue_kernels[] = {
+    trip_kernel_CONTINUE_1,
+    trip_kernel_CONTINUE_2,
+    trip_kernel_CONTINUE_3,
+    trip_kernel_CONTINUE_4,
+    trip_kernel_CONTINUE_5,
+};
+
+TripKernel find_trip_kernel(const Policy* policy, int shooting_skill) {
+    if (policy != &continue_policy || shooting_skill < 1 || shooting_skill > 5) {
+        return NULL;
+    }
+    return continue_kernels[shooting_skill - 1];
+}
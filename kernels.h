@@ -0,0 +1,29 @@
+/*
+ * Trip kernels: the engine compiled once per fixed policy and shooting skill.
+ *
+ * A kernel is oregon.c built with OREGON_KERNEL naming a policy whose every
+ * decision is a constant in policy.h (only "continue" so far) and
+ * OREGON_KERNEL_SKILL a shooting skill. The decision calls through the Policy
+ * table fold away, the console output is compiled out, and -fwhole-program
+ * leaves the compiler free to inline and specialize the whole trip, whose one
+ * global symbol is the kernel entry. A kernel plays exactly the trip
+ * simulate_trip plays for the same plan and seed.
+ *
+ * The batch runner and the library's batch API pick a kernel for each trip
+ * they can, and fall back to simulate_trip for the other policies and for
+ * jobs with a turn hook.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "oregon.h"
+
+// simulate_trip with the kernel's policy and no hook; the plan's shooting
+// skill must be the kernel's
+typedef int (*TripKernel)(const PurchasePlan* plan, unsigned int seed, TripResult* result);
+
+// The kernel for a policy and shooting skill, NULL if there is none
+TripKernel find_trip_kernel(const Policy* policy, int shooting_skill);
+
+#endif // KERNELS_H
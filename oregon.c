@@ -19,9 +19,19 @@
  */
 
 #include "oregon.h"
+#include "trail.h"
+#ifdef OREGON_KERNEL
+#include "policy.h"
+#endif
+#ifdef OREGON_TUI
+#include "tui.h"
+#endif
+#ifdef OREGON_SCORES
+#include "scores.h"
+#endif
 
 // Platform-specific string copy
-#ifdef UNIVAC
+#ifndef WINDOWS_CONSOLE
 #define SAFE_STRCPY(dest, src, size) do { strncpy(dest, src, (size)-1); (dest)[(size)-1] = '\0'; } while(0)
 #else
 #define SAFE_STRCPY(dest, src, size) strcpy_s(dest, size, src)
@@ -32,53 +42,234 @@ const int event_probabilities[15] = {
     6, 11, 13, 15, 17, 22, 32, 35, 37, 42, 44, 54, 64, 69, 95
 };
 
-// Date strings for each turn
-static const char* date_strings[] = {
-    "MARCH 29", "APRIL 12", "APRIL 26", "MAY 10", "MAY 24", "JUNE 7",
-    "JUNE 21", "JULY 5", "JULY 19", "AUGUST 2", "AUGUST 16", "AUGUST 31",
-    "SEPTEMBER 13", "SEPTEMBER 27", "OCTOBER 11", "OCTOBER 25",
-    "NOVEMBER 8", "NOVEMBER 22", "DECEMBER 6", "DECEMBER 20"
-};
-
 // Shooting words for hunting mini-game
 static const char* shooting_words[] = {"BANG", "BLAM", "POW", "WHAM"};
 
-// Global random state
-static unsigned int g_rand_seed = 0;
+// Global random state (per thread, so headless trips can run in parallel)
+static OREGON_THREAD_LOCAL_HOT unsigned int g_rand_seed = 0;
+static OREGON_THREAD_LOCAL unsigned int* g_event_counts = NULL;   // Draws per EventType, for sensitivity.h
+
+#ifdef OREGON_FUZZ
+static OREGON_THREAD_LOCAL FuzzProbe* g_fuzz = NULL;
+#define FUZZ_TEXT(id) do { if (g_fuzz) g_fuzz->text_seen[id] = 1; } while (0)
+#else
+#define FUZZ_TEXT(id) ((void)0)
+#endif
+
+// Headless trip in progress on this thread, NULL for interactive play
+typedef struct {
+    const Policy* policy;
+    TripResult* result;
+    jmp_buf* trip_exit;
+    TurnHook on_turn;
+    void* hook_ctx;
+    int last_hooked_turn;
+} GameSession;
+
+static OREGON_THREAD_LOCAL_HOT GameSession* g_session = NULL;
+
+// Trip kernels only ever run headless
+#ifdef OREGON_KERNEL
+#define HEADLESS 1
+#else
+#define HEADLESS (g_session != NULL)
+#endif
+
+// In-memory console for an interactive game played in-process, NULL for stdio
+static OREGON_THREAD_LOCAL_HOT GameConsole* g_console = NULL;
+static OREGON_THREAD_LOCAL_HOT jmp_buf* g_console_exit = NULL;
+
+static void console_vprintf(const char* format, va_list args);
+
+// Called when an interactive or console game ends
+static TripRecorder g_trip_recorder = NULL;
+static void* g_trip_recorder_ctx = NULL;
+
+// Decision maker for interactive play
+static OREGON_THREAD_LOCAL_HOT const Policy* g_player = &human_policy;
+
+// Policy decisions. A trip kernel (see kernels.h) is this file compiled with
+// OREGON_KERNEL naming a fixed policy and OREGON_KERNEL_SKILL a shooting
+// skill, which fold every decision to that policy's constants from policy.h;
+// otherwise each goes through the session's policy.
+#ifdef OREGON_KERNEL
+#define KERNEL_PASTE(policy, decision) policy##_##decision
+#define KERNEL_CONSTANT(policy, decision) KERNEL_PASTE(policy, decision)
+#define DECIDE(decision, ...) KERNEL_CONSTANT(OREGON_KERNEL, decision)
+#define SHOT_RESULT BOT_SHOT_RESULT(OREGON_KERNEL_SKILL)
+#else
+#define DECIDE(decision, ...) decide_##decision(current_policy(), __VA_ARGS__)
+#define SHOT_RESULT decide_shot_result(current_policy(), skill_level, word)
+
+static inline const Policy* current_policy(void) {
+    return g_session ? g_session->policy : g_player;
+}
+
+static inline int decide_TURN_ACTION(const Policy* policy, const GameState* game, int fort_open) {
+    return policy->turn_action(game, fort_open, policy->ctx);
+}
+
+static inline int decide_EATING_LEVEL(const Policy* policy, const GameState* game) {
+    return policy->eating_level(game, policy->ctx);
+}
+
+static inline int decide_RIDER_TACTIC(const Policy* policy, const GameState* game, int hostile) {
+    return policy->rider_tactic(game, hostile, policy->ctx);
+}
+
+static inline int decide_FORT_PURCHASE(const Policy* policy, const GameState* game, int item) {
+    return policy->fort_purchase(game, item, policy->ctx);
+}
+
+static inline int decide_shot_result(const Policy* policy, int skill_level, const char* word) {
+    return policy->shot_result(skill_level, word, policy->ctx);
+}
+#endif
 
 // Initialize random number generator
 void init_random(void) {
 #ifdef UNIVAC
     g_rand_seed = 0x12345678; // Fixed seed for UNIVAC compatibility
 #else
-    g_rand_seed = (unsigned int)time(NULL);
+    const char* fixed_seed = getenv("OREGON_SEED"); // Reproducible games
+    if (g_console) {
+        g_rand_seed = g_console->seed;
+    } else if (fixed_seed) {
+        g_rand_seed = (unsigned int)strtoul(fixed_seed, NULL, 0);
+    } else {
+        g_rand_seed = (unsigned int)time(NULL);
+    }
 #endif
 }
 
+// Restart the generator from a known seed (headless trips)
+void seed_random(unsigned int seed) {
+    g_rand_seed = seed;
+}
+
+// Current generator state, so a trip can later be resumed from this point
+unsigned int get_random_state(void) {
+    return g_rand_seed;
+}
+
+// Step the generator; returns its output
+static inline unsigned int next_random(void) {
+    g_rand_seed = (g_rand_seed * 1103515245 + 12345) & 0x7fffffff;
+#ifdef OREGON_FUZZ
+    if (g_fuzz) {
+        return g_fuzz->draw(g_fuzz->draws++, g_rand_seed, g_fuzz->ctx) & RANDOM_MAX;
+    }
+#endif
+    return g_rand_seed;
+}
+
 // Generate random integer in range [min, max]
 int random_int(int min, int max) {
-    g_rand_seed = (g_rand_seed * 1103515245 + 12345) & 0x7fffffff;
-    return min + (g_rand_seed % (max - min + 1));
+    return min + (int)(next_random() % (unsigned int)(max - min + 1));
+}
+
+// Generate random Q31 fraction: value / RANDOM_MAX in range [0, 1]
+int random_q31(void) {
+    return (int)next_random();
 }
 
+int fixed_point_engine(void) {
+#ifdef OREGON_FIXED_POINT
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+int set_fuzz_probe(FuzzProbe* probe) {
+#ifdef OREGON_FUZZ
+    g_fuzz = probe;
+    return 0;
+#else
+    (void)probe;
+    return -1;
+#endif
+}
+
+void set_event_counts(unsigned int* counts) {
+    g_event_counts = counts;
+}
+
+#ifndef OREGON_FIXED_POINT
 // Generate random double in range [0.0, 1.0)
 double random_double(void) {
-    g_rand_seed = (g_rand_seed * 1103515245 + 12345) & 0x7fffffff;
-    return (double)g_rand_seed / (double)0x7fffffff;
+    return (double)random_q31() / (double)RANDOM_MAX;
 }
+#endif
+
+// Chance draws. The fixed-point build keeps the Q31 draw and compares
+// draw * scale against num / den exactly in 64-bit integers; over every
+// generator output this decides the same as the double arithmetic.
+#ifdef OREGON_FIXED_POINT
+typedef int Draw;
+#define random_draw() random_q31()
+#define DRAW_BELOW(draw, scale, num, den) \
+    ((int64_t)(draw) * (scale) * (den) < (int64_t)(num) * RANDOM_MAX)
+#define DRAW_AT_MOST(draw, scale, num, den) \
+    ((int64_t)(draw) * (scale) * (den) <= (int64_t)(num) * RANDOM_MAX)
+#define DRAW_SCALED(draw, scale) ((int)((int64_t)(draw) * (scale) / RANDOM_MAX))
+#else
+typedef double Draw;
+#define random_draw() random_double()
+#define DRAW_BELOW(draw, scale, num, den) ((draw) * (scale) < (double)(num) / (den))
+#define DRAW_AT_MOST(draw, scale, num, den) ((draw) * (scale) <= (double)(num) / (den))
+#define DRAW_SCALED(draw, scale) ((int)((draw) * (scale)))
+#endif
 
-// Main entry point
-int main(void) {
-#ifndef UNIVAC
+// Main entry point (tools that link the engine build with OREGON_NO_MAIN)
+#ifndef OREGON_NO_MAIN
+int main(int argc, char** argv) {
+#ifdef WINDOWS_CONSOLE
     console_setup();
 #endif
+#ifdef OREGON_SCORES
+    // Server deployments set this to log every finished trip
+    const char* score_log = getenv("OREGON_SCORE_LOG");
+    if (score_log && *score_log && score_log_record_games(score_log) != 0) {
+        fprintf(stderr, "%s: cannot open score log\n", score_log);
+    }
+#endif
+    static Trail trail;
+    char error[80];
+    int tui = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trail") == 0 && i + 1 < argc) {
+            i++;
+            if (trail_load(&trail, argv[i], error, sizeof(error)) != 0) {
+                fprintf(stderr, "%s: %s\n", argv[i], error);
+                return 1;
+            }
+            set_trail(&trail);
+        } else if (strcmp(argv[i], "--tui") == 0) {
+            tui = 1;
+        }
+    }
+#ifdef OREGON_TUI
+    if (tui) {
+        return tui_play();
+    }
+#else
+    (void)tui;
+#endif
     
+    play_game();
+    return 0;
+}
+#endif
+
+// One interactive game, from the instructions prompt to the end of the trip
+void play_game(void) {
     GameState game;
     init_game(&game);
     
-    printf("DO YOU NEED INSTRUCTIONS (YES/NO)? ");
+    game_print_text(TEXT_INSTRUCTIONS_PROMPT);
     char response[MAX_INPUT_LEN];
-    fgets(response, sizeof(response), stdin);
+    game_read_line(response, sizeof(response));
     to_uppercase(response);
     
     if (strstr(response, "YES") != NULL) {
@@ -87,118 +278,74 @@ int main(void) {
     
     setup_initial_purchases(&game);
     main_game_loop(&game);
-    
-    return 0;
 }
 
 // Initialize game state
 void init_game(GameState* game) {
     init_random();
+    init_game_seeded(game, g_rand_seed);
+}
+
+// Initialize game state with a known random seed
+void init_game_seeded(GameState* game, unsigned int seed) {
+    seed_random(seed);
     
     memset(game, 0, sizeof(GameState));
     game->cash = AVAILABLE_MONEY;
     game->fort_available = -1; // Start with fort option available
+    game->last_event = -1;
     game->rand_seed = g_rand_seed;
 }
 
 // Show game instructions
 void show_instructions(void) {
-    printf("\n");
-    printf("THIS PROGRAM SIMULATES A TRIP OVER THE OREGON TRAIL FROM\n");
-    printf("INDEPENDENCE, MISSOURI TO OREGON CITY, OREGON IN 1847.\n");
-    printf("YOUR FAMILY OF FIVE WILL COVER THE 2040 MILE OREGON TRAIL\n");
-    printf("IN 5-6 MONTHS --- IF YOU MAKE IT ALIVE.\n");
-    printf("\n");
-    printf("YOU HAD SAVED $900 TO SPEND FOR THE TRIP, AND YOU'VE JUST\n");
-    printf("   PAID $200 FOR A WAGON.\n");
-    printf("YOU WILL NEED TO SPEND THE REST OF YOUR MONEY ON THE\n");
-    printf("   FOLLOWING ITEMS:\n");
-    printf("\n");
-    printf("     OXEN - YOU CAN SPEND $200-$300 ON YOUR TEAM\n");
-    printf("            THE MORE YOU SPEND, THE FASTER YOU'LL GO\n");
-    printf("               BECAUSE YOU'LL HAVE BETTER ANIMALS\n");
-    printf("\n");
-    printf("     FOOD - THE MORE YOU HAVE, THE LESS CHANCE THERE\n");
-    printf("               IS OF GETTING SICK\n");
-    printf("\n");
-    printf("     AMMUNITION - $1 BUYS A BELT OF 50 BULLETS\n");
-    printf("            YOU WILL NEED BULLETS FOR ATTACKS BY ANIMALS\n");
-    printf("               AND BANDITS, AND FOR HUNTING FOOD\n");
-    printf("\n");
-    printf("     CLOTHING - THIS IS ESPECIALLY IMPORTANT FOR THE COLD\n");
-    printf("               WEATHER YOU WILL ENCOUNTER WHEN CROSSING\n");
-    printf("               THE MOUNTAINS\n");
-    printf("\n");
-    printf("     MISCELLANEOUS SUPPLIES - THIS INCLUDES MEDICINE AND\n");
-    printf("              OTHER THINGS YOU WILL NEED FOR SICKNESS\n");
-    printf("              AND EMERGENCY REPAIRS\n");
-    printf("\n");
-    printf("YOU CAN SPEND ALL YOUR MONEY BEFORE YOU START YOUR TRIP -\n");
-    printf("OR YOU CAN SAVE SOME OF YOUR CASH TO SPEND AT FORTS ALONG\n");
-    printf("THE WAY WHEN YOU RUN LOW. HOWEVER, ITEMS COST MORE AT\n");
-    printf("THE FORTS. YOU CAN ALSO GO HUNTING ALONG THE WAY TO GET\n");
-    printf("MORE FOOD.\n");
-    printf("WHENEVER YOU HAVE TO USE YOUR TRUSTY RIFLE ALONG THE WAY,\n");
-    printf("YOU WILL BE TOLD TO TYPE IN THAT WORD (ONE THAT SOUNDS LIKE A\n");
-    printf("GUN SHOT). THE FASTER YOU TYPE IN THAT WORD AND HIT THE\n");
-    printf("\"RETURN\" KEY, THE BETTER LUCK YOU'LL HAVE WITH YOUR GUN.\n");
-    printf("\n");
-    printf("AT EACH TURN, ALL ITEMS ARE SHOWN IN DOLLAR AMOUNTS\n");
-    printf("EXCEPT BULLETS\n");
-    printf("WHEN ASKED TO ENTER MONEY AMOUNTS, DON'T USE A \"$\".\n");
-    printf("\n");
-    printf("GOOD LUCK!!!\n");
-    printf("\n");
+    game_print_text(TEXT_INSTRUCTIONS);
 }
 
 // Set up initial purchases
 void setup_initial_purchases(GameState* game) {
     int total_spent;
     
-    printf("HOW GOOD A SHOT ARE YOU WITH YOUR RIFLE?\n");
-    printf("  (1) ACE MARKSMAN,  (2) GOOD SHOT,  (3) FAIR TO MIDDLIN'\n");
-    printf("         (4) NEED MORE PRACTICE,  (5) SHAKY KNEES\n");
-    printf("ENTER ONE OF THE ABOVE -- THE BETTER YOU CLAIM YOU ARE, THE\n");
-    printf("FASTER YOU'LL HAVE TO BE WITH YOUR GUN TO BE SUCCESSFUL.\n");
+    game_print_text(TEXT_SKILL_PROMPT);
     
     game->shooting_skill = get_user_choice("", 1, 5);
     
     do {
-        printf("\n");
+        game_printf("\n");
         
         // Oxen
         do {
-            printf("HOW MUCH DO YOU WANT TO SPEND ON YOUR OXEN TEAM? ");
-            scanf("%d", &game->oxen_cost);
+            game_print_text(TEXT_SPEND_ON_OXEN);
+            game_scan_int(&game->oxen_cost);
             clear_input_buffer();
             
             if (game->oxen_cost < 200) {
-                printf("NOT ENOUGH\n");
+                game_print_text(TEXT_NOT_ENOUGH);
             } else if (game->oxen_cost > 300) {
-                printf("TOO MUCH\n");
+                game_print_text(TEXT_TOO_MUCH);
             }
         } while (game->oxen_cost < 200 || game->oxen_cost > 300);
         
         // Food
         do {
-            printf("HOW MUCH DO YOU WANT TO SPEND ON FOOD? ");
-            scanf("%d", &game->food);
+            game_print_text(TEXT_SPEND_ON_FOOD);
+            game_scan_int(&game->food);
             clear_input_buffer();
             
             if (game->food < 0) {
-                printf("IMPOSSIBLE\n");
+                game_print_text(TEXT_IMPOSSIBLE);
             }
         } while (game->food < 0);
         
         // Ammunition
         do {
-            printf("HOW MUCH DO YOU WANT TO SPEND ON AMMUNITION? ");
+            game_print_text(TEXT_SPEND_ON_AMMUNITION);
             int ammo_cost;
-            scanf("%d", &ammo_cost);
+            game_scan_int(&ammo_cost);
             clear_input_buffer();
             
             if (ammo_cost < 0) {
-                printf("IMPOSSIBLE\n");
+                game_print_text(TEXT_IMPOSSIBLE);
             } else {
                 game->bullets = ammo_cost * 50; // $1 buys 50 bullets
                 break;
@@ -207,23 +354,23 @@ void setup_initial_purchases(GameState* game) {
         
         // Clothing
         do {
-            printf("HOW MUCH DO YOU WANT TO SPEND ON CLOTHING? ");
-            scanf("%d", &game->clothing);
+            game_print_text(TEXT_SPEND_ON_CLOTHING);
+            game_scan_int(&game->clothing);
             clear_input_buffer();
             
             if (game->clothing < 0) {
-                printf("IMPOSSIBLE\n");
+                game_print_text(TEXT_IMPOSSIBLE);
             }
         } while (game->clothing < 0);
         
         // Miscellaneous supplies
         do {
-            printf("HOW MUCH DO YOU WANT TO SPEND ON MISCELLANEOUS SUPPLIES? ");
-            scanf("%d", &game->misc_supplies);
+            game_print_text(TEXT_SPEND_ON_MISC_SUPPLIES);
+            game_scan_int(&game->misc_supplies);
             clear_input_buffer();
             
             if (game->misc_supplies < 0) {
-                printf("IMPOSSIBLE\n");
+                game_print_text(TEXT_IMPOSSIBLE);
             }
         } while (game->misc_supplies < 0);
         
@@ -233,31 +380,34 @@ void setup_initial_purchases(GameState* game) {
         game->cash = AVAILABLE_MONEY - total_spent;
         
         if (game->cash < 0) {
-            printf("YOU OVERSPENT--YOU ONLY HAD $%d TO SPEND. BUY AGAIN\n", AVAILABLE_MONEY);
+            game_textf(TEXT_OVERSPENT, AVAILABLE_MONEY);
             // Reset for retry
             game->food = game->bullets = game->clothing = game->misc_supplies = 0;
         }
         
     } while (game->cash < 0);
     
-    printf("AFTER ALL YOUR PURCHASES, YOU NOW HAVE $%d DOLLARS LEFT\n", game->cash);
-    printf("\n");
-    printf("MONDAY MARCH 29 1847\n");
-    printf("\n");
+    game_textf(TEXT_CASH_LEFT, game->cash);
+    game_print_text(TEXT_FIRST_DATE);
 }
 
 // Main game loop
 void main_game_loop(GameState* game) {
-    while (game->miles_traveled < TOTAL_DISTANCE) {
+    int length = current_trail()->length;
+    while (game->miles_traveled < length) {
         // Check if too much time has passed (winter death)
         if (game->turn_number >= 20) {
-            printf("YOU HAVE BEEN ON THE TRAIL TOO LONG ------\n");
-            printf("YOUR FAMILY DIES IN THE FIRST BLIZZARD OF WINTER\n");
+            game_print_text(TEXT_TRAIL_TOO_LONG);
             handle_death(game, DEATH_WINTER_BLIZZARD);
             return;
         }
         
         process_turn(game);
+        
+        if (g_session && g_session->on_turn) {
+            g_session->on_turn(game, g_session->hook_ctx);
+            g_session->last_hooked_turn = game->turn_number;
+        }
     }
     
     // Victory!
@@ -266,13 +416,20 @@ void main_game_loop(GameState* game) {
 
 // Process a single turn
 void process_turn(GameState* game) {
+    start_turn(game);
+    choose_turn_action(game);
+}
+
+// Turn bookkeeping up to the action prompt; uses no random numbers
+void start_turn(GameState* game) {
     game->turn_number++;
     game->miles_previous_turn = game->miles_traveled;
     
     // Print date
-    printf("MONDAY ");
+    game_print_text(TEXT_MONDAY);
+    game_printf(" ");
     print_current_date(game->turn_number);
-    printf("1847\n\n");
+    game_printf("1847\n\n");
     
     // Validate and fix negative resources
     validate_resources(game);
@@ -285,34 +442,61 @@ void process_turn(GameState* game) {
     
     // Check for low food warning
     if (game->food < 13) {
-        printf("YOU'D BETTER DO SOME HUNTING OR BUY FOOD SOON!!!!\n");
+        game_print_text(TEXT_HUNT_OR_BUY_FOOD);
     }
-    
-    // Get player choice for this turn
-    int choice;
-    if (game->fort_available == -1) {
-        printf("DO YOU WANT TO (1) STOP AT THE NEXT FORT, (2) HUNT, OR (3) CONTINUE\n");
-        choice = get_user_choice("", 1, 3);
+}
+
+// Ask for this turn's action and play the rest of the turn
+void choose_turn_action(GameState* game) {
+    play_turn_action(game, ask_turn_action(game));
+}
+
+// Offer this turn's actions; returns the valid choice
+int ask_turn_action(GameState* game) {
+    const Trail* trail = current_trail();
+    if (!trail->alternate_forts) {
+        // A fort within reach that the party has not stopped at yet
+        int fort = trail_segment(trail, game->miles_traveled)->fort;
+        game->fort_available = (fort >= 0 && !(game->forts_visited & (1 << fort))) ? -1 : 1;
+    }
+    int fort_open = (game->fort_available == -1);
+    if (fort_open) {
+        game_print_text(TEXT_TURN_PROMPT_FORT);
     } else {
-        printf("DO YOU WANT TO (1) HUNT, OR (2) CONTINUE\n");
-        choice = get_user_choice("", 1, 2);
-        choice++; // Adjust for missing fort option
+        game_print_text(TEXT_TURN_PROMPT);
     }
     
+    int choice = DECIDE(TURN_ACTION, game, fort_open);
+    if (choice < (fort_open ? ACTION_FORT : ACTION_HUNT) || choice > ACTION_CONTINUE) {
+        choice = ACTION_CONTINUE; // Default to last valid option
+    }
+    return choice;
+}
+
+// The rest of the turn after the action prompt
+void play_turn_action(GameState* game, int choice) {
     handle_turn_choice(game, choice);
-    game->fort_available *= -1; // Toggle fort availability
+    if (current_trail()->alternate_forts) {
+        game->fort_available *= -1; // Toggle fort availability
+    }
 }
 
 // Display current game status
 void display_status(GameState* game) {
-    if (game->miles_traveled < 950) {
-        printf("TOTAL MILEAGE IS %d\n", game->miles_traveled);
+    if (g_console && g_console->show_status) {
+        g_console->show_status(g_console, game);
+        return;
+    }
+    
+    const Trail* trail = current_trail();
+    if (!(trail_segment(trail, game->miles_traveled)->flags & TRAIL_HIDE_MILEAGE)) {
+        game_textf(TEXT_TOTAL_MILEAGE, game->miles_traveled);
     } else {
-        printf("TOTAL MILEAGE IS 950\n"); // Hide actual mileage in mountains
+        game_textf(TEXT_TOTAL_MILEAGE, trail->shown_mileage); // Hide actual mileage in mountains
     }
     
-    printf("FOOD\t\tBULLETS\t\tCLOTHING\tMISC. SUPP.\tCASH\n");
-    printf("%d\t\t%d\t\t%d\t\t%d\t\t%d\n", 
+    game_print_text(TEXT_SUPPLIES_HEADER);
+    game_printf("%d\t\t%d\t\t%d\t\t%d\t\t%d\n", 
            game->food, game->bullets, game->clothing, game->misc_supplies, game->cash);
 }
 
@@ -326,7 +510,7 @@ void handle_turn_choice(GameState* game, int choice) {
             
         case 2: // Hunt
             if (game->bullets < 40) {
-                printf("TOUGH---YOU NEED MORE BULLETS TO GO HUNTING\n");
+                game_print_text(TEXT_NEED_MORE_BULLETS);
                 return;
             }
             go_hunting(game);
@@ -343,46 +527,53 @@ void handle_turn_choice(GameState* game, int choice) {
 
 // Visit a fort for supplies
 void visit_fort(GameState* game) {
-    printf("ENTER WHAT YOU WISH TO SPEND ON THE FOLLOWING\n");
+    const Trail* trail = current_trail();
+    int num = trail->alternate_num;
+    int den = trail->alternate_den;
+    if (!trail->alternate_forts) {
+        int fort = trail_segment(trail, game->miles_traveled)->fort;
+        num = trail->forts[fort].rate_num;
+        den = trail->forts[fort].rate_den;
+        game->forts_visited |= 1 << fort;
+    }
     
-    // Food (2/3 efficiency due to higher fort prices)
-    int amount = get_purchase_amount("FOOD", game->cash);
-    game->food += (amount * 2) / 3;
+    game_print_text(TEXT_FORT_PROMPT);
+    
+    // Food (num/den efficiency due to higher fort prices, 2/3 on the default trail)
+    int amount = get_purchase_amount(game, ITEM_FOOD);
+    game->food += (amount * num) / den;
     game->cash -= amount;
     
-    // Ammunition (2/3 efficiency, $1 = 50 bullets normally)
-    amount = get_purchase_amount("AMMUNITION", game->cash);
-    game->bullets += ((amount * 2) / 3) * 50;
+    // Ammunition ($1 = 50 bullets normally)
+    amount = get_purchase_amount(game, ITEM_AMMUNITION);
+    game->bullets += ((amount * num) / den) * 50;
     game->cash -= amount;
     
-    // Clothing (2/3 efficiency)
-    amount = get_purchase_amount("CLOTHING", game->cash);
-    game->clothing += (amount * 2) / 3;
+    // Clothing
+    amount = get_purchase_amount(game, ITEM_CLOTHING);
+    game->clothing += (amount * num) / den;
     game->cash -= amount;
     
-    // Miscellaneous supplies (2/3 efficiency)
-    amount = get_purchase_amount("MISCELLANEOUS SUPPLIES", game->cash);
-    game->misc_supplies += (amount * 2) / 3;
+    // Miscellaneous supplies
+    amount = get_purchase_amount(game, ITEM_MISC_SUPPLIES);
+    game->misc_supplies += (amount * num) / den;
     game->cash -= amount;
 }
 
 // Get purchase amount with validation
-int get_purchase_amount(const char* item_name, int max_money) {
+int get_purchase_amount(GameState* game, int item) {
     int amount;
     
-    do {
-        printf("%s? ", item_name);
-        scanf("%d", &amount);
-        clear_input_buffer();
-        
-        if (amount < 0) {
-            amount = 0;
-        } else if (amount > max_money) {
-            printf("YOU DON'T HAVE THAT MUCH--KEEP YOUR SPENDING DOWN\n");
-            printf("YOU MISS YOUR CHANCE TO SPEND ON THAT ITEM\n");
-            amount = 0;
-        }
-    } while (amount > max_money);
+    game_print_text(TEXT_FOOD + item);
+    game_printf("? ");
+    amount = DECIDE(FORT_PURCHASE, game, item);
+    
+    if (amount < 0) {
+        amount = 0;
+    } else if (amount > game->cash) {
+        game_print_text(TEXT_OVERSPENT_AT_FORT);
+        amount = 0;
+    }
     
     return amount;
 }
@@ -390,22 +581,21 @@ int get_purchase_amount(const char* item_name, int max_money) {
 // Go hunting mini-game
 void go_hunting(GameState* game) {
     if (game->bullets < 40) {
-        printf("TOUGH---YOU NEED MORE BULLETS TO GO HUNTING\n");
+        game_print_text(TEXT_NEED_MORE_BULLETS);
         return;
     }
     
     int shooting_result = shooting_minigame(game->shooting_skill);
     
     if (shooting_result <= 1) {
-        printf("RIGHT BETWEEN THE EYES---YOU GOT A BIG ONE!!!!\n");
-        printf("FULL BELLIES TONIGHT!\n");
+        game_print_text(TEXT_HUNT_BIG_ONE);
         game->food += 52 + random_int(0, 6);
         game->bullets -= 10 + random_int(0, 4);
-    } else if (random_double() * 100 < 13 * shooting_result) {
-        printf("YOU MISSED---AND YOUR DINNER GOT AWAY.....\n");
+    } else if (DRAW_BELOW(random_draw(), 100, 13 * shooting_result, 1)) {
+        game_print_text(TEXT_HUNT_MISSED);
         game->bullets -= 10 + 3 * shooting_result;
     } else {
-        printf("NICE SHOT--RIGHT ON TARGET--GOOD EATIN' TONIGHT!!\n");
+        game_print_text(TEXT_HUNT_NICE_SHOT);
         game->food += 48 - 2 * shooting_result;
         game->bullets -= 10 + 3 * shooting_result;
     }
@@ -413,26 +603,11 @@ void go_hunting(GameState* game) {
 
 // Shooting mini-game implementation
 int shooting_minigame(int skill_level) {
-    char word_buffer[10];
-    char input[MAX_INPUT_LEN];
-    int word_index = random_int(0, 3);
-    
-    strcpy(word_buffer, shooting_words[word_index]);
-    printf("TYPE %s\n", word_buffer);
+    const char* word = shooting_words[random_int(0, 3)];
     
-    // Simple timing - in a real implementation you'd measure actual response time
-    fgets(input, sizeof(input), stdin);
+    game_textf(TEXT_TYPE_WORD, word);
     
-    // Remove newline
-    input[strcspn(input, "\n")] = '\0';
-    to_uppercase(input);
-    
-    // Check if word matches - adjust result based on skill level
-    if (strcmp(input, word_buffer) == 0) {
-        return skill_level > 3 ? skill_level - 2 : 1; // Better skill = better result
-    } else {
-        return 9; // Miss due to wrong word
-    }
+    return SHOT_RESULT;
 }
 
 // Travel segment and events
@@ -457,36 +632,46 @@ void travel_segment(GameState* game) {
     process_random_events(game);
     
     // Handle mountain travel if in mountain region
-    if (game->miles_traveled > 950) {
+    if (trail_segment(current_trail(), game->miles_traveled)->flags & TRAIL_MOUNTAINS) {
         mountain_travel(game);
     }
 }
 
 // Check for rider encounters
 void check_for_riders(GameState* game) {
+#ifdef OREGON_FIXED_POINT
+    // The chance below is 600000 / ((miles - 400)^2 + 120000)
+    int64_t offset = game->miles_traveled - 400;
+    if (!DRAW_AT_MOST(random_draw(), 10, 600000, offset * offset + 120000)) {
+        return; // No riders
+    }
+#else
     double attack_chance = pow((game->miles_traveled / 100.0 - 4), 2) + 72;
     attack_chance = attack_chance / (attack_chance - 60) - 1;
     
     if (random_double() * 10 > attack_chance) {
         return; // No riders
     }
+#endif
     
-    printf("RIDERS AHEAD. THEY ");
+    game_print_text(TEXT_RIDERS_AHEAD);
     
-    int hostile = (random_double() < 0.8) ? 0 : 1;
-    if (random_double() > 0.2) {
+    int hostile = DRAW_BELOW(random_draw(), 1, 8, 10) ? 0 : 1;
+    if (!DRAW_AT_MOST(random_draw(), 1, 2, 10)) {
         hostile = 1 - hostile; // Flip hostility randomly
     }
     
     if (!hostile) {
-        printf("DON'T ");
+        game_print_text(TEXT_DONT);
     }
-    printf("LOOK HOSTILE\n");
+    game_print_text(TEXT_LOOK_HOSTILE);
     
-    printf("TACTICS\n");
-    printf("(1) RUN  (2) ATTACK  (3) CONTINUE  (4) CIRCLE WAGONS\n");
+    game_print_text(TEXT_TACTICS_PROMPT);
     
-    int tactic = get_user_choice("", 1, 4);
+    int tactic = DECIDE(RIDER_TACTIC, game, hostile);
+    if (tactic < TACTIC_RUN || tactic > TACTIC_CIRCLE_WAGONS) {
+        tactic = TACTIC_CIRCLE_WAGONS; // Default to last valid option
+    }
     handle_rider_encounter(game, hostile);
     
     // Handle tactic results based on hostility
@@ -507,7 +692,7 @@ void check_for_riders(GameState* game) {
                 game->miles_traveled -= 20;
                 break;
         }
-        printf("RIDERS WERE FRIENDLY, BUT CHECK FOR POSSIBLE LOSSES\n");
+        game_print_text(TEXT_RIDERS_FRIENDLY);
     } else {
         // Hostile riders
         switch (tactic) {
@@ -523,19 +708,19 @@ void check_for_riders(GameState* game) {
                     game->bullets -= shooting_result * 40 + 80;
                     
                     if (shooting_result <= 1) {
-                        printf("NICE SHOOTING---YOU DROVE THEM OFF\n");
+                        game_print_text(TEXT_DROVE_THEM_OFF);
                     } else if (shooting_result <= 4) {
-                        printf("KINDA SLOW WITH YOUR COLT .45\n");
+                        game_print_text(TEXT_KINDA_SLOW);
                     } else {
-                        printf("LOUSY SHOT---YOU GOT KNIFED\n");
+                        game_print_text(TEXT_GOT_KNIFED);
                         game->game_flags |= FLAG_INJURY;
-                        printf("YOU HAVE TO SEE OL' DOC BLANCHARD\n");
+                        game_print_text(TEXT_SEE_DOC_BLANCHARD);
                     }
                 }
                 break;
             case 3: // Continue
-                if (random_double() > 0.8) {
-                    printf("THEY DID NOT ATTACK\n");
+                if (!DRAW_AT_MOST(random_draw(), 1, 8, 10)) {
+                    game_print_text(TEXT_DID_NOT_ATTACK);
                     return;
                 }
                 game->bullets -= 150;
@@ -549,12 +734,12 @@ void check_for_riders(GameState* game) {
                 }
                 break;
         }
-        printf("RIDERS WERE HOSTILE--CHECK FOR LOSSES\n");
+        game_print_text(TEXT_RIDERS_HOSTILE);
     }
     
     // Check if ran out of bullets
     if (game->bullets < 0) {
-        printf("YOU RAN OUT OF BULLETS AND GOT MASSACRED BY THE RIDERS\n");
+        game_print_text(TEXT_MASSACRED);
         handle_death(game, DEATH_MASSACRE);
     }
 }
@@ -567,66 +752,200 @@ void handle_rider_encounter(GameState* game, int hostile) {
     (void)hostile; // Suppress unused parameter warning
 }
 
+// The event a draw 0..99 picks: the first threshold at or above it, and past
+// the last threshold helpful indians (line 3590 of the BASIC). Before rules
+// revision 2 (OREGON_RULES_REVISION) draws 96..99 fell through to wagon
+// breakdown; trips that roll them play differently from older builds
+int event_for_draw(int draw) {
+    for (int i = 0; i < 15; i++) {
+        if (draw <= event_probabilities[i]) {
+            return i;
+        }
+    }
+    return EVENT_HELPFUL_INDIANS;
+}
+
 // Process random events
 void process_random_events(GameState* game) {
-    int random_val = (int)(random_double() * 100);
-    int event_index = 0;
+    int event_index = event_for_draw(DRAW_SCALED(random_draw(), 100));
+
+    game->last_event = event_index;
+    if (g_event_counts) {
+        g_event_counts[event_index]++;
+    }
+    handle_event(game, (EventType)event_index);
+}
+
+#ifndef OREGON_EVENT_SWITCH
+// Events that branch or ask the player: run after the message and the deltas
+
+static void event_bandits(GameState* game) {
+    int shooting_result = shooting_minigame(game->shooting_skill);
+    game->bullets -= 20 * shooting_result;
     
-    // Find which event occurs based on probability table
-    for (int i = 0; i < 15; i++) {
-        if (random_val <= event_probabilities[i]) {
-            event_index = i;
-            break;
+    if (game->bullets < 0) {
+        game_print_text(TEXT_BANDITS_TAKE_CASH);
+        game->cash /= 3;
+    } else if (shooting_result <= 1) {
+        game_print_text(TEXT_BANDITS_DRIVEN_OFF);
+    } else {
+        game_print_text(TEXT_SHOT_IN_LEG);
+        game->game_flags |= FLAG_INJURY;
+        game_print_text(TEXT_SEE_DOC_FOR_WOUND);
+        game->misc_supplies -= 5;
+        game->oxen_cost -= 20;
+    }
+}
+
+static void event_snakebite(GameState* game) {
+    if (game->misc_supplies < 0) {
+        game_print_text(TEXT_SNAKEBITE_DEATH);
+        handle_death(game, DEATH_SNAKEBITE);
+    }
+}
+
+static void event_wild_animals(GameState* game) {
+    int shooting_result = shooting_minigame(game->shooting_skill);
+    
+    if (game->bullets < 40) {
+        game_print_text(TEXT_WOLVES_OVERPOWERED);
+        game->game_flags |= FLAG_INJURY;
+        handle_illness(game);
+    } else {
+        if (shooting_result <= 2) {
+            game_print_text(TEXT_ANIMALS_DRIVEN_OFF);
+        } else {
+            game_print_text(TEXT_ANIMALS_GOT_FOOD);
         }
+        
+        game->bullets -= 20 * shooting_result;
+        game->clothing -= shooting_result * 4;
+        game->food -= shooting_result * 8;
     }
+}
+
+static void event_cold_weather(GameState* game) {
+    if (game->clothing > 22 + random_int(1, 4) * 4) {
+        game_print_text(TEXT_WARM_ENOUGH);
+    } else {
+        game_print_text(TEXT_NOT_WARM_ENOUGH);
+        handle_illness(game);
+    }
+}
+
+#define NO_TERM {-1, 0, 0, 0}
+
+// Per event: text, need_region, skip_region,
+//   {miles, food, bullets, clothing, misc supplies, oxen cost}, {random terms}, hook
+const EventEffect event_effects[EVENT_COUNT] = {
+    {TEXT_WAGON_BREAKS_DOWN,   0,              0,
+     {0,     0,    0,      0,    -8,    0},     {{EFFECT_MILES, 5, 15, 5}, NO_TERM},                    NULL},
+    {TEXT_OX_INJURES_LEG,      0,              0,
+     {-25,   0,    0,      0,     0,  -20},     {NO_TERM, NO_TERM},                                     NULL},
+    {TEXT_DAUGHTER_BROKE_ARM,  0,              0,
+     {0,     0,    0,      0,     0,    0},     {{EFFECT_MILES, 4, 5, 4}, {EFFECT_MISC_SUPPLIES, 3, 2, 3}}, NULL},
+    {TEXT_OX_WANDERS_OFF,      0,              0,
+     {-17,   0,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     NULL},
+    {TEXT_SON_GETS_LOST,       0,              0,
+     {-10,   0,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     NULL},
+    {TEXT_UNSAFE_WATER,        0,              0,
+     {0,     0,    0,      0,     0,    0},     {{EFFECT_MILES, 10, 2, 10}, NO_TERM},                   NULL},
+    {TEXT_HEAVY_RAINS,         0,              TRAIL_MOUNTAINS,
+     {0,   -10, -500,      0,   -15,    0},     {{EFFECT_MILES, 10, 5, 10}, NO_TERM},                   NULL},
+    {TEXT_BANDITS_ATTACK,      0,              0,
+     {0,     0,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     event_bandits},
+    {TEXT_FIRE_IN_WAGON,       0,              0,
+     {-15, -40, -400,      0,     0,    0},     {{EFFECT_MISC_SUPPLIES, 8, 3, 8}, NO_TERM},             NULL},
+    {TEXT_LOST_IN_FOG,         0,              0,
+     {0,     0,    0,      0,     0,    0},     {{EFFECT_MILES, 5, 10, 5}, NO_TERM},                    NULL},
+    {TEXT_SNAKE_BITE,          0,              0,
+     {0,     0,  -10,      0,    -5,    0},     {NO_TERM, NO_TERM},                                     event_snakebite},
+    {TEXT_WAGON_SWAMPED,       TRAIL_RIVER,    0,
+     {0,   -30,    0,    -20,     0,    0},     {{EFFECT_MILES, 20, 20, 20}, NO_TERM},                  NULL},
+    {TEXT_WILD_ANIMALS_ATTACK, 0,              0,
+     {0,     0,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     event_wild_animals},
+    {TEXT_COLD_WEATHER,        TRAIL_MOUNTAINS, 0,
+     {0,     0,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     event_cold_weather},
+    {TEXT_HAIL_STORM,          0,              0,
+     {0,     0, -200,      0,     0,    0},     {{EFFECT_MILES, 10, 5, 10}, {EFFECT_MISC_SUPPLIES, 3, 4, 3}}, NULL},
+    {TEXT_HELPFUL_INDIANS,     0,              0,
+     {0,    14,    0,      0,     0,    0},     {NO_TERM, NO_TERM},                                     NULL},
+};
+
+// Handle specific events: the message, the deltas with their random terms
+// drawn in order, then the hook
+void handle_event(GameState* game, EventType event) {
+    const EventEffect* effect = &event_effects[event];
+    int delta[EFFECT_FIELD_COUNT];
     
-    if (event_index == 15) {
-        event_index = 15; // Helpful Indians (last event)
+    if (effect->need_region | effect->skip_region) {
+        int region = trail_segment(current_trail(), game->miles_traveled)->flags;
+        if ((region & effect->need_region) != effect->need_region || (region & effect->skip_region)) {
+            return;
+        }
     }
+    game_print_text(effect->text);
     
-    handle_event(game, (EventType)event_index);
+    for (int f = 0; f < EFFECT_FIELD_COUNT; f++) {
+        delta[f] = effect->delta[f];
+    }
+    for (int t = 0; t < EFFECT_RANDOM_TERMS; t++) {
+        const EffectTerm* term = &effect->random[t];
+        if (term->field >= 0) {
+            delta[term->field] -= term->base + random_int(1, term->count) * term->step;
+        }
+    }
+    game->miles_traveled += delta[EFFECT_MILES];
+    game->food += delta[EFFECT_FOOD];
+    game->bullets += delta[EFFECT_BULLETS];
+    game->clothing += delta[EFFECT_CLOTHING];
+    game->misc_supplies += delta[EFFECT_MISC_SUPPLIES];
+    game->oxen_cost += delta[EFFECT_OXEN_COST];
+    
+    if (effect->hook) {
+        effect->hook(game);
+    }
 }
-
-// Handle specific events
+#else
+// The original switch, the reference make verify-events checks the table against
 void handle_event(GameState* game, EventType event) {
     switch (event) {
         case EVENT_WAGON_BREAKDOWN:
-            printf("WAGON BREAKS DOWN--LOSE TIME AND SUPPLIES FIXING IT\n");
+            game_print_text(TEXT_WAGON_BREAKS_DOWN);
             game->miles_traveled -= 15 + random_int(1, 5) * 5;
             game->misc_supplies -= 8;
             break;
             
         case EVENT_OX_INJURY:
-            printf("OX INJURES LEG---SLOWS YOU DOWN REST OF TRIP\n");
+            game_print_text(TEXT_OX_INJURES_LEG);
             game->miles_traveled -= 25;
             game->oxen_cost -= 20;
             break;
             
         case EVENT_DAUGHTER_BREAKS_ARM:
-            printf("BAD LUCK---YOUR DAUGHTER BROKE HER ARM\n");
-            printf("YOU HAD TO STOP AND USE SUPPLIES TO MAKE A SLING\n");
+            game_print_text(TEXT_DAUGHTER_BROKE_ARM);
             game->miles_traveled -= 5 + random_int(1, 4) * 4;
             game->misc_supplies -= 2 + random_int(1, 3) * 3;
             break;
             
         case EVENT_OX_WANDERS_OFF:
-            printf("OX WANDERS OFF---SPEND TIME LOOKING FOR IT\n");
+            game_print_text(TEXT_OX_WANDERS_OFF);
             game->miles_traveled -= 17;
             break;
             
         case EVENT_SON_GETS_LOST:
-            printf("YOUR SON GETS LOST---SPEND HALF THE DAY LOOKING FOR HIM\n");
+            game_print_text(TEXT_SON_GETS_LOST);
             game->miles_traveled -= 10;
             break;
             
         case EVENT_UNSAFE_WATER:
-            printf("UNSAFE WATER--LOSE TIME LOOKING FOR CLEAN SPRING\n");
+            game_print_text(TEXT_UNSAFE_WATER);
             game->miles_traveled -= random_int(1, 10) * 10 + 2;
             break;
             
         case EVENT_HEAVY_RAINS:
-            if (game->miles_traveled <= 950) {
-                printf("HEAVY RAINS---TIME AND SUPPLIES LOST\n");
+            if (!(trail_segment(current_trail(), game->miles_traveled)->flags & TRAIL_MOUNTAINS)) {
+                game_print_text(TEXT_HEAVY_RAINS);
                 game->food -= 10;
                 game->bullets -= 500;
                 game->misc_supplies -= 15;
@@ -635,21 +954,20 @@ void handle_event(GameState* game, EventType event) {
             break;
             
         case EVENT_BANDITS_ATTACK:
-            printf("BANDITS ATTACK\n");
+            game_print_text(TEXT_BANDITS_ATTACK);
             {
                 int shooting_result = shooting_minigame(game->shooting_skill);
                 game->bullets -= 20 * shooting_result;
                 
                 if (game->bullets < 0) {
-                    printf("YOU RAN OUT OF BULLETS---THEY GET LOTS OF CASH\n");
+                    game_print_text(TEXT_BANDITS_TAKE_CASH);
                     game->cash /= 3;
                 } else if (shooting_result <= 1) {
-                    printf("QUICKEST DRAW OUTSIDE OF DODGE CITY!!!\n");
-                    printf("YOU GOT 'EM!\n");
+                    game_print_text(TEXT_BANDITS_DRIVEN_OFF);
                 } else {
-                    printf("YOU GOT SHOT IN THE LEG AND THEY TOOK ONE OF YOUR OXEN\n");
+                    game_print_text(TEXT_SHOT_IN_LEG);
                     game->game_flags |= FLAG_INJURY;
-                    printf("BETTER HAVE A DOC LOOK AT YOUR WOUND\n");
+                    game_print_text(TEXT_SEE_DOC_FOR_WOUND);
                     game->misc_supplies -= 5;
                     game->oxen_cost -= 20;
                 }
@@ -657,7 +975,7 @@ void handle_event(GameState* game, EventType event) {
             break;
             
         case EVENT_FIRE_IN_WAGON:
-            printf("THERE WAS A FIRE IN YOUR WAGON--FOOD AND SUPPLIES DAMAGE!\n");
+            game_print_text(TEXT_FIRE_IN_WAGON);
             game->food -= 40;
             game->bullets -= 400;
             game->misc_supplies -= random_int(1, 8) * 8 + 3;
@@ -665,42 +983,43 @@ void handle_event(GameState* game, EventType event) {
             break;
             
         case EVENT_LOSE_WAY_IN_FOG:
-            printf("LOSE YOUR WAY IN HEAVY FOG---TIME IS LOST\n");
+            game_print_text(TEXT_LOST_IN_FOG);
             game->miles_traveled -= 10 + random_int(1, 5) * 5;
             break;
             
         case EVENT_POISONOUS_SNAKE:
-            printf("YOU KILLED A POISONOUS SNAKE AFTER IT BIT YOU\n");
+            game_print_text(TEXT_SNAKE_BITE);
             game->bullets -= 10;
             game->misc_supplies -= 5;
             if (game->misc_supplies < 0) {
-                printf("YOU DIE OF SNAKEBITE SINCE YOU HAVE NO MEDICINE\n");
+                game_print_text(TEXT_SNAKEBITE_DEATH);
                 handle_death(game, DEATH_SNAKEBITE);
             }
             break;
             
         case EVENT_WAGON_SWAMPED_FORDING:
-            printf("WAGON GETS SWAMPED FORDING RIVER--LOSE FOOD AND CLOTHES\n");
-            game->food -= 30;
-            game->clothing -= 20;
-            game->miles_traveled -= 20 + random_int(1, 20) * 20;
+            if (trail_segment(current_trail(), game->miles_traveled)->flags & TRAIL_RIVER) {
+                game_print_text(TEXT_WAGON_SWAMPED);
+                game->food -= 30;
+                game->clothing -= 20;
+                game->miles_traveled -= 20 + random_int(1, 20) * 20;
+            }
             break;
             
         case EVENT_WILD_ANIMALS_ATTACK:
-            printf("WILD ANIMALS ATTACK!\n");
+            game_print_text(TEXT_WILD_ANIMALS_ATTACK);
             {
                 int shooting_result = shooting_minigame(game->shooting_skill);
                 
                 if (game->bullets < 40) {
-                    printf("YOU WERE TOO LOW ON BULLETS--\n");
-                    printf("THE WOLVES OVERPOWERED YOU\n");
+                    game_print_text(TEXT_WOLVES_OVERPOWERED);
                     game->game_flags |= FLAG_INJURY;
                     handle_illness(game);
                 } else {
                     if (shooting_result <= 2) {
-                        printf("NICE SHOOTIN' PARDNER---THEY DIDN'T GET MUCH\n");
+                        game_print_text(TEXT_ANIMALS_DRIVEN_OFF);
                     } else {
-                        printf("SLOW ON THE DRAW---THEY GOT AT YOUR FOOD AND CLOTHES\n");
+                        game_print_text(TEXT_ANIMALS_GOT_FOOD);
                     }
                     
                     game->bullets -= 20 * shooting_result;
@@ -711,51 +1030,61 @@ void handle_event(GameState* game, EventType event) {
             break;
             
         case EVENT_COLD_WEATHER:
-            if (game->miles_traveled > 950) {
-                printf("COLD WEATHER---BRRRRRRR!--YOU ");
+            if (trail_segment(current_trail(), game->miles_traveled)->flags & TRAIL_MOUNTAINS) {
+                game_print_text(TEXT_COLD_WEATHER);
                 if (game->clothing > 22 + random_int(1, 4) * 4) {
-                    printf("HAVE ENOUGH CLOTHING TO KEEP YOU WARM\n");
+                    game_print_text(TEXT_WARM_ENOUGH);
                 } else {
-                    printf("DON'T HAVE ENOUGH CLOTHING TO KEEP YOU WARM\n");
+                    game_print_text(TEXT_NOT_WARM_ENOUGH);
                     handle_illness(game);
                 }
             }
             break;
             
         case EVENT_HAIL_STORM:
-            printf("HAIL STORM---SUPPLIES DAMAGED\n");
+            game_print_text(TEXT_HAIL_STORM);
             game->miles_traveled -= 5 + random_int(1, 10) * 10;
             game->bullets -= 200;
             game->misc_supplies -= 4 + random_int(1, 3) * 3;
             break;
             
         case EVENT_HELPFUL_INDIANS:
-            printf("HELPFUL INDIANS SHOW YOU WHERE TO FIND MORE FOOD\n");
+            game_print_text(TEXT_HELPFUL_INDIANS);
             game->food += 14;
             break;
     }
 }
 
+#endif
+
 // Handle mountain travel
 void mountain_travel(GameState* game) {
+#ifdef OREGON_FIXED_POINT
+    // The bound below is (8 y + 360000) / (y + 120000), y = (miles - 1500)^2
+    int64_t offset = game->miles_traveled - 1500;
+    if (DRAW_AT_MOST(random_draw(), 10, 8 * offset * offset + 360000, offset * offset + 120000)) {
+        return;
+    }
+#else
     if (random_double() * 10 <= 9 - (pow(game->miles_traveled / 100.0 - 15, 2) + 72) / 
         (pow(game->miles_traveled / 100.0 - 15, 2) + 12)) {
         return;
     }
+#endif
     
-    printf("RUGGED MOUNTAINS\n");
+    game_print_text(TEXT_RUGGED_MOUNTAINS);
     
-    if (random_double() <= 0.1) {
-        printf("YOU GOT LOST---LOSE VALUABLE TIME TRYING TO FIND TRAIL!\n");
+    if (DRAW_AT_MOST(random_draw(), 1, 1, 10)) {
+        game_print_text(TEXT_LOST_TRAIL);
         game->miles_traveled -= 60;
-    } else if (random_double() <= 0.11) {
-        printf("WAGON DAMAGED!---LOSE TIME AND SUPPLIES\n");
+    } else if (DRAW_AT_MOST(random_draw(), 1, 11, 100)) {
+        game_print_text(TEXT_WAGON_DAMAGED);
         game->misc_supplies -= 5;
         game->bullets -= 200;
         game->miles_traveled -= 20 + random_int(1, 30) * 30;
     } else {
-        printf("THE GOING GETS SLOW\n");
-        game->miles_traveled -= 45 + (int)(random_double() / 0.02);
+        game_print_text(TEXT_GOING_GETS_SLOW);
+        game->miles_traveled -= 45 + DRAW_SCALED(random_draw(), 50);
     }
     
     // Check for mountain pass events
@@ -764,22 +1093,25 @@ void mountain_travel(GameState* game) {
 
 // Check for mountain-specific events
 void check_mountain_events(GameState* game) {
+    int region = trail_segment(current_trail(), game->miles_traveled)->flags;
+    
     // South Pass
-    if (!(game->game_flags & FLAG_SOUTH_PASS) && random_double() < 0.8) {
-        printf("YOU MADE IT SAFELY THROUGH SOUTH PASS--NO SNOW\n");
+    if (!(game->game_flags & FLAG_SOUTH_PASS) && (region & TRAIL_SOUTH_PASS) &&
+        DRAW_BELOW(random_draw(), 1, 8, 10)) {
+        game_print_text(TEXT_SOUTH_PASS);
         game->game_flags |= FLAG_SOUTH_PASS;
         return;
     }
     
     // Blue Mountains  
-    if (game->miles_traveled >= 1700 && !(game->game_flags & FLAG_BLUE_MOUNTAINS) && 
-        random_double() < 0.7) {
+    if ((region & TRAIL_BLUE_MOUNTAINS) && !(game->game_flags & FLAG_BLUE_MOUNTAINS) && 
+        DRAW_BELOW(random_draw(), 1, 7, 10)) {
         game->game_flags |= FLAG_BLUE_MOUNTAINS;
         return;
     }
     
     // Blizzard
-    printf("BLIZZARD IN MOUNTAIN PASS--TIME AND SUPPLIES LOST\n");
+    game_print_text(TEXT_BLIZZARD);
     game->game_flags |= FLAG_BLIZZARD;
     game->food -= 25;
     game->misc_supplies -= 10;
@@ -793,15 +1125,17 @@ void check_mountain_events(GameState* game) {
 
 // Check eating and health
 void check_eating_and_health(GameState* game) {
-    printf("DO YOU WANT TO EAT (1) POORLY (2) MODERATELY\n");
-    printf("OR (3) WELL? ");
+    game_print_text(TEXT_EATING_PROMPT);
     
-    game->eating_level = get_user_choice("", 1, 3);
+    game->eating_level = DECIDE(EATING_LEVEL, game);
+    if (game->eating_level < 1 || game->eating_level > 3) {
+        game->eating_level = 3; // Default to last valid option
+    }
     
     int food_consumed = 8 + 5 * game->eating_level;
     
     if (game->food < food_consumed) {
-        printf("YOU CAN'T EAT THAT WELL\n");
+        game_print_text(TEXT_CANT_EAT_THAT_WELL);
         game->eating_level = 1; // Force poor eating
         food_consumed = 13;
     }
@@ -811,37 +1145,38 @@ void check_eating_and_health(GameState* game) {
     // Check for illness based on eating level
     if (game->eating_level != 1) {
         // Check illness probability
-        if (random_double() * 100 < 10 + 35 * (game->eating_level - 1)) {
+        if (DRAW_BELOW(random_draw(), 100, 10 + 35 * (game->eating_level - 1), 1)) {
             return; // No illness
         }
     }
     
-    if (random_double() * 100 < 100 - (40 / pow(4, game->eating_level - 1))) {
+    int eating_odds = 1 << (2 * (game->eating_level - 1)); // 4^(level - 1)
+    if (DRAW_BELOW(random_draw(), 100, 100 * eating_odds - 40, eating_odds)) {
         handle_illness(game);
     }
 }
 
 // Handle illness
 void handle_illness(GameState* game) {
-    double illness_roll = random_double() * 100;
+    Draw illness_roll = random_draw();
+    int eating_odds = 1 << (2 * (game->eating_level - 1)); // 4^(level - 1)
     
-    if (illness_roll < 10 + 35 * (game->eating_level - 1)) {
-        printf("MILD ILLNESS---MEDICINE USED\n");
+    if (DRAW_BELOW(illness_roll, 100, 10 + 35 * (game->eating_level - 1), 1)) {
+        game_print_text(TEXT_MILD_ILLNESS);
         game->miles_traveled -= 5;
         game->misc_supplies -= 2;
-    } else if (illness_roll < 100 - (40 / pow(4, game->eating_level - 1))) {
-        printf("BAD ILLNESS---MEDICINE USED\n");
+    } else if (DRAW_BELOW(illness_roll, 100, 100 * eating_odds - 40, eating_odds)) {
+        game_print_text(TEXT_BAD_ILLNESS);
         game->miles_traveled -= 5;
         game->misc_supplies -= 2;
     } else {
-        printf("SERIOUS ILLNESS---\n");
-        printf("YOU MUST STOP FOR MEDICAL ATTENTION\n");
+        game_print_text(TEXT_SERIOUS_ILLNESS);
         game->misc_supplies -= 10;
         game->game_flags |= FLAG_ILLNESS;
     }
     
     if (game->misc_supplies < 0) {
-        printf("YOU RAN OUT OF MEDICAL SUPPLIES\n");
+        game_print_text(TEXT_OUT_OF_MEDICINE);
         handle_death(game, DEATH_DISEASE);
     }
 }
@@ -860,162 +1195,353 @@ void pay_doctor_bill(GameState* game) {
         game->cash -= 20;
         if (game->cash < 0) {
             game->cash = 0;
-            printf("YOU CAN'T AFFORD A DOCTOR\n");
+            game_print_text(TEXT_CANT_AFFORD_DOCTOR);
             handle_death(game, DEATH_DISEASE);
             return;
         }
-        printf("DOCTOR'S BILL IS $20\n");
+        game_print_text(TEXT_DOCTORS_BILL);
         game->game_flags &= ~(FLAG_ILLNESS | FLAG_INJURY); // Clear flags
     }
 }
 
 // Check victory condition
 void check_victory_condition(GameState* game) {
-    if (game->miles_traveled >= TOTAL_DISTANCE) {
+    if (game->miles_traveled >= current_trail()->length) {
         show_victory_scene(game);
     }
 }
 
 // Handle death scenarios
 void handle_death(GameState* game, DeathCause cause) {
-    (void)game; // Suppress unused parameter warning
+    // Headless trips have nobody to hold a funeral for
+    if (HEADLESS) {
+        end_trip(game, TRIP_DIED, cause);
+    }
     
     show_death_scene(cause);
     
-    printf("\n");
-    printf("DUE TO YOUR UNFORTUNATE SITUATION, THERE ARE A FEW\n");
-    printf("FORMALITIES WE MUST GO THROUGH\n");
-    printf("\n");
+    game_print_text(TEXT_FUNERAL_FORMALITIES);
     
-    if (get_yes_no_input("WOULD YOU LIKE A MINISTER? ")) {
+    if (get_yes_no_input(TEXT_MINISTER_PROMPT)) {
         // Minister selected
     }
     
-    if (get_yes_no_input("WOULD YOU LIKE A FANCY FUNERAL? ")) {
+    if (get_yes_no_input(TEXT_FUNERAL_PROMPT)) {
         // Fancy funeral selected  
     }
     
-    if (get_yes_no_input("WOULD YOU LIKE US TO INFORM YOUR NEXT OF KIN? ")) {
-        printf("THAT WILL BE $50 FOR THE TELEGRAPH CHARGE.\n");
+    if (get_yes_no_input(TEXT_NEXT_OF_KIN_PROMPT)) {
+        game_print_text(TEXT_TELEGRAPH_CHARGE);
     } else {
-        printf("BUT YOUR AUNT SADIE IN ST. LOUIS IS REALLY WORRIED ABOUT YOU\n");
+        game_print_text(TEXT_AUNT_SADIE);
     }
     
-    printf("\n");
-    printf("WE THANK YOU FOR THIS INFORMATION AND WE ARE SORRY YOU\n");
-    printf("DIDN'T MAKE IT TO THE GREAT TERRITORY OF OREGON\n");
-    printf("BETTER LUCK NEXT TIME\n");
-    printf("\n");
-    printf("\t\t\tSINCERELY\n");
-    printf("\n");
-    printf("\t\tTHE OREGON CITY CHAMBER OF COMMERCE\n");
+    game_print_text(TEXT_CONDOLENCES);
     
-    exit(0);
+    end_trip(game, TRIP_DIED, cause);
 }
 
 // Show death message based on cause
 void show_death_scene(DeathCause cause) {
     switch (cause) {
         case DEATH_STARVATION:
-            printf("YOU RAN OUT OF FOOD AND STARVED TO DEATH\n");
+            game_print_text(TEXT_STARVED);
             break;
         case DEATH_EXHAUSTION:
-            printf("YOU DIED OF EXHAUSTION\n");
+            game_print_text(TEXT_DIED_OF_EXHAUSTION);
             break;
         case DEATH_DISEASE:
-            printf("YOU DIED OF PNEUMONIA\n");
+            game_print_text(TEXT_DIED_OF_PNEUMONIA);
             break;
         case DEATH_INJURIES:
-            printf("YOU DIED OF INJURIES\n");
+            game_print_text(TEXT_DIED_OF_INJURIES);
             break;
         case DEATH_WINTER_BLIZZARD:
-            printf("YOUR FAMILY DIES IN THE FIRST BLIZZARD OF WINTER\n");
+            game_print_text(TEXT_BLIZZARD_DEATH);
             break;
         case DEATH_SNAKEBITE:
-            printf("YOU DIE OF SNAKEBITE SINCE YOU HAVE NO MEDICINE\n");
+            game_print_text(TEXT_SNAKEBITE_DEATH);
             break;
         case DEATH_MASSACRE:
-            printf("YOU RAN OUT OF BULLETS AND GOT MASSACRED BY THE RIDERS\n");
+            game_print_text(TEXT_MASSACRED);
             break;
     }
 }
 
 // Show victory scene
 void show_victory_scene(GameState* game) {
-    printf("\n");
-    printf("YOU FINALLY ARRIVED AT OREGON CITY\n");
-    printf("AFTER 2040 LONG MILES---HOORAY!!!!!\n");
-    printf("A REAL PIONEER!\n");
-    printf("\n");
+    if (HEADLESS) {
+        end_trip(game, TRIP_ARRIVED, -1);
+    }
+    
+    game_print_text(TEXT_ARRIVED);
     
     calculate_final_date(game);
     
-    printf("\n");
-    printf("FOOD\t\tBULLETS\t\tCLOTHING\tMISC. SUPP.\tCASH\n");
+    game_printf("\n");
+    game_print_text(TEXT_SUPPLIES_HEADER);
     validate_resources(game);
-    printf("%d\t\t%d\t\t%d\t\t%d\t\t%d\n", 
+    game_printf("%d\t\t%d\t\t%d\t\t%d\t\t%d\n", 
            game->food, game->bullets, game->clothing, game->misc_supplies, game->cash);
     
-    printf("\n");
-    printf("\t\tPRESIDENT JAMES K. POLK SENDS YOU HIS\n");
-    printf("\t\t\tHEARTIEST CONGRATULATIONS\n");
-    printf("\n");
-    printf("\t\tAND WISHES YOU A PROSPEROUS LIFE AHEAD\n");
-    printf("\n");
-    printf("\t\t\tAT YOUR NEW HOME\n");
+    game_print_text(TEXT_CONGRATULATIONS);
     
-    exit(0);
+    end_trip(game, TRIP_ARRIVED, -1);
 }
 
-// Calculate and display final arrival date
-void calculate_final_date(GameState* game) {
-    double fraction = (double)(TOTAL_DISTANCE - game->miles_previous_turn) / 
+// Days after March 29 on which the party reached Oregon City
+int compute_arrival_day(const GameState* game) {
+#ifdef OREGON_FIXED_POINT
+    int days_into_turn = 14 * (current_trail()->length - game->miles_previous_turn) /
+                         (game->miles_traveled - game->miles_previous_turn);
+#else
+    double fraction = (double)(current_trail()->length - game->miles_previous_turn) / 
                      (double)(game->miles_traveled - game->miles_previous_turn);
     
     // Calculate final supplies (not used for display but kept for completeness)
     // int final_food = game->food + (int)((1 - fraction) * (8 + 5 * game->eating_level));
     int days_into_turn = (int)(fraction * 14);
-    int total_days = game->turn_number * 14 + days_into_turn;
+#endif
+    return game->turn_number * 14 + days_into_turn;
+}
+
+// Calculate and display final arrival date
+void calculate_final_date(GameState* game) {
+    int total_days = compute_arrival_day(game);
     
     // Calculate day of week (starting from Monday = 0)
     int day_of_week = (total_days + 1) % 7;
-    const char* day_names[] = {"MONDAY", "TUESDAY", "WEDNESDAY", "THURSDAY", 
-                              "FRIDAY", "SATURDAY", "SUNDAY"};
     
-    printf("%s ", day_names[day_of_week]);
+    game_print_text(TEXT_MONDAY + day_of_week);
+    game_printf(" ");
     
     // Calculate date
     if (total_days <= 124) {
-        printf("JULY %d 1847\n", total_days - 93);
+        game_textf(TEXT_JULY_DATE, total_days - 93);
     } else if (total_days <= 155) {
-        printf("AUGUST %d 1847\n", total_days - 124);
+        game_textf(TEXT_AUGUST_DATE, total_days - 124);
     } else if (total_days <= 185) {
-        printf("SEPTEMBER %d 1847\n", total_days - 155);
+        game_textf(TEXT_SEPTEMBER_DATE, total_days - 155);
     } else if (total_days <= 216) {
-        printf("OCTOBER %d 1847\n", total_days - 185);
+        game_textf(TEXT_OCTOBER_DATE, total_days - 185);
     } else if (total_days <= 246) {
-        printf("NOVEMBER %d 1847\n", total_days - 216);
+        game_textf(TEXT_NOVEMBER_DATE, total_days - 216);
     } else {
-        printf("DECEMBER %d 1847\n", total_days - 246);
+        game_textf(TEXT_DECEMBER_DATE, total_days - 246);
     }
 }
 
+static void fill_trip_result(TripResult* result, const GameState* game, int outcome, int cause) {
+    result->outcome = outcome;
+    result->death_cause = cause;
+    result->turn_number = game->turn_number;
+    result->arrival_day = (outcome == TRIP_ARRIVED) ? compute_arrival_day(game) : 0;
+    result->miles_traveled = game->miles_traveled;
+    result->food = game->food;
+    result->bullets = game->bullets;
+    result->clothing = game->clothing;
+    result->misc_supplies = game->misc_supplies;
+    result->cash = game->cash;
+}
+
+void set_trip_recorder(TripRecorder recorder, void* ctx) {
+    g_trip_recorder = recorder;
+    g_trip_recorder_ctx = ctx;
+}
+
+// Finish the trip: interactive games exit, headless trips return to simulate_trip
+// and console games to play_game_console
+void end_trip(GameState* game, int outcome, int cause) {
+    TripResult finished;
+    
+    // Report the turn the party died on, unless the hook has already seen it
+    if (g_session && g_session->on_turn && game->turn_number > g_session->last_hooked_turn) {
+        g_session->on_turn(game, g_session->hook_ctx);
+    }
+    
+    if (outcome == TRIP_ARRIVED) {
+        validate_resources(game); // Same clamping the victory screen shows
+    }
+    
+    TripResult* result = g_session ? g_session->result : g_console ? &g_console->result : &finished;
+    fill_trip_result(result, game, outcome, cause);
+    
+    if (g_session) {
+        longjmp(*g_session->trip_exit, 1);
+    }
+    if (g_trip_recorder) {
+        g_trip_recorder(game, result, g_trip_recorder_ctx);
+    }
+    if (g_console) {
+        g_console->finished = 1;
+        longjmp(*g_console_exit, 1);
+    }
+    exit(0);
+}
+
+// Stop the headless trip in progress from one of its policy or hook calls;
+// simulate_trip returns TRIP_ABANDONED with the state at this point
+void abandon_trip(const GameState* game) {
+    if (!g_session) {
+        return;
+    }
+    fill_trip_result(g_session->result, game, TRIP_ABANDONED, -1);
+    longjmp(*g_session->trip_exit, 1);
+}
+
+// Apply initial purchases without prompting; returns 0, or -1 if the plan is invalid
+int apply_purchase_plan(GameState* game, const PurchasePlan* plan) {
+    if (plan->shooting_skill < 1 || plan->shooting_skill > 5 ||
+        plan->oxen < 200 || plan->oxen > 300 ||
+        plan->food < 0 || plan->ammunition < 0 ||
+        plan->clothing < 0 || plan->misc_supplies < 0) {
+        return -1;
+    }
+    
+    int total_spent = plan->oxen + plan->food + plan->ammunition +
+                      plan->clothing + plan->misc_supplies;
+    if (total_spent > AVAILABLE_MONEY) {
+        return -1;
+    }
+    
+    game->shooting_skill = plan->shooting_skill;
+    game->oxen_cost = plan->oxen;
+    game->food = plan->food;
+    game->bullets = plan->ammunition * 50; // $1 buys 50 bullets
+    game->clothing = plan->clothing;
+    game->misc_supplies = plan->misc_supplies;
+    game->cash = AVAILABLE_MONEY - total_spent;
+    return 0;
+}
+
+// Run game headless until the trip ends, starting at the turn-action prompt if resuming
+static void run_session(GameState* game, int resuming, const Policy* policy,
+                        TurnHook on_turn, void* hook_ctx, TripResult* result) {
+    GameSession session;
+    jmp_buf trip_exit;
+    
+    session.policy = policy;
+    session.result = result;
+    session.trip_exit = &trip_exit;
+    session.on_turn = on_turn;
+    session.hook_ctx = hook_ctx;
+    session.last_hooked_turn = resuming ? game->turn_number - 1 : 0;
+    
+    g_session = &session;
+    if (setjmp(trip_exit) == 0) {
+        if (resuming) {
+            choose_turn_action(game);
+            if (on_turn) {
+                on_turn(game, hook_ctx);
+                session.last_hooked_turn = game->turn_number;
+            }
+        }
+        main_game_loop(game);
+    }
+    g_session = NULL;
+}
+
+// Play one whole trip without any console I/O; returns 0, or -1 if the plan is invalid
+int simulate_trip(const PurchasePlan* plan, const Policy* policy, unsigned int seed,
+                  TurnHook on_turn, void* hook_ctx, TripResult* result) {
+    GameState game;
+    
+    init_game_seeded(&game, seed);
+    if (apply_purchase_plan(&game, plan) != 0) {
+        return -1;
+    }
+    
+    run_session(&game, 0, policy, on_turn, hook_ctx, result);
+    return 0;
+}
+
+#ifdef OREGON_KERNEL
+// The kernel's one global symbol (kernels.h), e.g. trip_kernel_CONTINUE_2;
+// the plan's shooting skill must be OREGON_KERNEL_SKILL
+#define KERNEL_NAME(policy, skill) trip_kernel_##policy##_##skill
+#define KERNEL_ENTRY(policy, skill) KERNEL_NAME(policy, skill)
+
+__attribute__((externally_visible))
+int KERNEL_ENTRY(OREGON_KERNEL, OREGON_KERNEL_SKILL)(const PurchasePlan* plan, unsigned int seed,
+                                                     TripResult* result) {
+    return simulate_trip(plan, &KERNEL_CONSTANT(OREGON_KERNEL, POLICY), seed, NULL, NULL, result);
+}
+#endif
+
+// One step of a stepped trip, under a session like run_session; returns 1 if
+// the trip ended
+static int run_step(GameState* game, const Policy* policy, int finishing, int* choice,
+                    TripResult* result) {
+    GameSession session;
+    jmp_buf trip_exit;
+    int ended = 1;
+    
+    memset(&session, 0, sizeof(session));
+    session.policy = policy;
+    session.result = result;
+    session.trip_exit = &trip_exit;
+    session.last_hooked_turn = game->turn_number;
+    
+    g_session = &session;
+    if (setjmp(trip_exit) == 0) {
+        int length = current_trail()->length;
+        if (!finishing) {
+            // As main_game_loop does before each turn
+            if (game->turn_number >= 20) {
+                game_print_text(TEXT_TRAIL_TOO_LONG);
+                handle_death(game, DEATH_WINTER_BLIZZARD);
+            }
+            start_turn(game);
+            *choice = ask_turn_action(game);
+        } else {
+            play_turn_action(game, *choice);
+            if (game->miles_traveled >= length) {
+                check_victory_condition(game);
+            }
+        }
+        ended = 0;
+    }
+    g_session = NULL;
+    return ended;
+}
+
+// Stepped trip: the turn up to the action prompt, with the policy's answer
+int begin_turn(GameState* game, const Policy* policy, int* choice, TripResult* result) {
+    return run_step(game, policy, 0, choice, result);
+}
+
+// Stepped trip: the rest of the turn with the given answer
+int finish_turn(GameState* game, int choice, const Policy* policy, TripResult* result) {
+    return run_step(game, policy, 1, &choice, result);
+}
+
+// Play on, headless, from a state captured at the turn-action prompt together
+// with the generator state at that moment
+void resume_trip(const GameState* at_prompt, unsigned int random_state, const Policy* policy,
+                 TripResult* result) {
+    GameState game = *at_prompt;
+    
+    seed_random(random_state);
+    run_session(&game, 1, policy, NULL, NULL, result);
+}
+
 // Print current date for turn
 void print_current_date(int turn_number) {
     if (turn_number > 0 && turn_number <= 20) {
-        printf("%s ", date_strings[turn_number - 1]);
+        game_print_text(TEXT_MARCH_29 + turn_number - 1);
+        game_printf(" ");
     }
 }
 
 // Get user choice with validation
 int get_user_choice(const char* prompt, int min_choice, int max_choice) {
-    int choice;
+    int choice = 0; // Unreadable input falls back to the default below
     
     do {
         if (strlen(prompt) > 0) {
-            printf("%s", prompt);
+            game_printf("%s", prompt);
         }
-        scanf("%d", &choice);
+        game_scan_int(&choice);
         clear_input_buffer();
         
         if (choice < min_choice || choice > max_choice) {
@@ -1026,32 +1552,360 @@ int get_user_choice(const char* prompt, int min_choice, int max_choice) {
     return choice;
 }
 
+// Keyboard player: the prompts themselves are printed by the game
+static int human_turn_action(const GameState* game, int fort_open, void* ctx) {
+    (void)game;
+    (void)ctx;
+    if (fort_open) {
+        return get_user_choice("", 1, 3);
+    }
+    return get_user_choice("", 1, 2) + 1; // Adjust for missing fort option
+}
+
+static int human_eating_level(const GameState* game, void* ctx) {
+    (void)game;
+    (void)ctx;
+    return get_user_choice("", 1, 3);
+}
+
+static int human_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    (void)game;
+    (void)hostile;
+    (void)ctx;
+    return get_user_choice("", 1, 4);
+}
+
+static int human_fort_purchase(const GameState* game, int item, void* ctx) {
+    int amount = 0;
+    (void)game;
+    (void)item;
+    (void)ctx;
+    game_scan_int(&amount);
+    clear_input_buffer();
+    return amount;
+}
+
+static int human_shot_result(int skill_level, const char* word, void* ctx) {
+    char input[MAX_INPUT_LEN];
+    (void)ctx;
+    
+    // Simple timing - in a real implementation you'd measure actual response time
+    if (game_read_line(input, sizeof(input)) == NULL) {
+        input[0] = '\0';
+    }
+    
+    // Remove newline
+    input[strcspn(input, "\n")] = '\0';
+    to_uppercase(input);
+    
+    // Check if word matches - adjust result based on skill level
+    if (strcmp(input, word) == 0) {
+        return skill_level > 3 ? skill_level - 2 : 1; // Better skill = better result
+    } else {
+        return 9; // Miss due to wrong word
+    }
+}
+
+const Policy human_policy = {
+    "human",
+    human_turn_action,
+    human_eating_level,
+    human_rider_tactic,
+    human_fort_purchase,
+    human_shot_result,
+    NULL
+};
+
+void set_player_policy(const Policy* policy) {
+    g_player = policy ? policy : &human_policy;
+}
+
 // Get yes/no input
-int get_yes_no_input(const char* prompt) {
+int get_yes_no_input(int prompt) {
     char response[MAX_INPUT_LEN];
     
-    printf("%s", prompt);
-    fgets(response, sizeof(response), stdin);
+    game_print_text(prompt);
+    game_read_line(response, sizeof(response));
     to_uppercase(response);
     
     return (strstr(response, "YES") != NULL) ? 1 : 0;
 }
 
+static void game_vprintf(const char* format, va_list args) {
+    if (g_console) {
+        console_vprintf(format, args);
+    } else {
+        vprintf(format, args);
+    }
+}
+
+// Print game text; headless trips run silently
+void game_printf(const char* format, ...) {
+    va_list args;
+    
+    if (HEADLESS) {
+        return;
+    }
+    
+    va_start(args, format);
+    game_vprintf(format, args);
+    va_end(args);
+}
+
+#ifdef OREGON_PACKED_TEXT
+#include "oregon_text_packed.h"
+
+#define TEXT_CHUNK 64
+
+// Next character of a message, from the canonical Huffman code; bit_pos
+// advances past it
+static int unpack_text_char(uint32_t* bit_pos) {
+    int code = 0, first = 0, index = 0;
+    
+    for (int length = 1; length <= PACKED_TEXT_MAX_BITS; length++) {
+        code |= (packed_text_bits[*bit_pos >> 3] >> (7 - (*bit_pos & 7))) & 1;
+        (*bit_pos)++;
+        int count = packed_text_counts[length];
+        if (code - first < count) {
+            return packed_text_symbols[index + code - first];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return 0; // Not a code; ends the message
+}
+
+// Print a message, decoded a chunk at a time
+void game_print_text(int id) {
+    char chunk[TEXT_CHUNK];
+    uint32_t bit_pos = packed_text_offsets[id];
+    int length = 0;
+    
+    FUZZ_TEXT(id);
+    if (HEADLESS) {
+        return;
+    }
+    
+    for (int c = unpack_text_char(&bit_pos); c != 0; c = unpack_text_char(&bit_pos)) {
+        chunk[length++] = (char)c;
+        if (length == TEXT_CHUNK - 1) {
+            chunk[length] = '\0';
+            game_printf("%s", chunk);
+            length = 0;
+        }
+    }
+    chunk[length] = '\0';
+    game_printf("%s", chunk);
+}
+
+void game_textf(int id, ...) {
+    char format[PACKED_TEXT_FORMAT_SIZE];
+    uint32_t bit_pos = packed_text_offsets[id];
+    va_list args;
+    int length = 0;
+    
+    FUZZ_TEXT(id);
+    if (HEADLESS) {
+        return;
+    }
+    
+    // textpack checks every format fits
+    for (int c = unpack_text_char(&bit_pos); c != 0 && length < PACKED_TEXT_FORMAT_SIZE - 1;
+         c = unpack_text_char(&bit_pos)) {
+        format[length++] = (char)c;
+    }
+    format[length] = '\0';
+    
+    va_start(args, id);
+    game_vprintf(format, args);
+    va_end(args);
+}
+#else
+static const char* const game_text[TEXT_COUNT] = {
+#define TEXT(id, text) text,
+#include "oregon_text.def"
+#undef TEXT
+};
+
+void game_print_text(int id) {
+    FUZZ_TEXT(id);
+    game_printf("%s", game_text[id]);
+}
+
+void game_textf(int id, ...) {
+    va_list args;
+    
+    FUZZ_TEXT(id);
+    if (HEADLESS) {
+        return;
+    }
+    
+    va_start(args, id);
+    game_vprintf(game_text[id], args);
+    va_end(args);
+}
+#endif
+
+// Append to the console transcript
+static void console_vprintf(const char* format, va_list args) {
+    va_list copy;
+    
+    va_copy(copy, args);
+    int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if (length < 0) {
+        return;
+    }
+    
+    size_t needed = g_console->output_size + (size_t)length + 1;
+    if (needed > g_console->output_capacity) {
+        size_t capacity = g_console->output_capacity ? g_console->output_capacity : 4096;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        char* output = realloc(g_console->output, capacity);
+        if (!output) {
+            return;
+        }
+        g_console->output = output;
+        g_console->output_capacity = capacity;
+    }
+    vsnprintf(g_console->output + g_console->output_size, (size_t)length + 1, format, args);
+    g_console->output_size += (size_t)length;
+}
+
+// Next console input byte, EOF once the script (and any refill) is used up
+static int console_getc(void) {
+    if (g_console->input_pos >= g_console->input_size &&
+        !(g_console->refill && g_console->refill(g_console, g_console->refill_ctx) &&
+          g_console->input_pos < g_console->input_size)) {
+        return EOF;
+    }
+    return (unsigned char)g_console->input[g_console->input_pos++];
+}
+
+// A read that starts with no input left ends a console game; stdin would
+// loop forever or read garbage from here
+static void console_require_input(void) {
+    int c = console_getc();
+    if (c == EOF) {
+        longjmp(*g_console_exit, 1);
+    }
+    g_console->input_pos--;
+}
+
+// scanf("%d", value) on either stdin or the console, with the same results
+int game_scan_int(int* value) {
+    int c;
+    int negative = 0;
+    long number = 0;
+    
+    if (!g_console) {
+        return scanf("%d", value);
+    }
+    
+    console_require_input();
+    do {
+        c = console_getc();
+    } while (c != EOF && isspace(c));
+    if (c == EOF) {
+        return EOF;
+    }
+    
+    if (c == '+' || c == '-') {
+        negative = (c == '-');
+        c = console_getc();
+    }
+    if (c == EOF || !isdigit(c)) {
+        if (c != EOF) {
+            g_console->input_pos--; // Pushed back, as scanf does
+        }
+        return 0;
+    }
+    
+    int saturated = 0;
+    while (c != EOF && isdigit(c)) {
+        if (number > (LONG_MAX - (c - '0')) / 10) {
+            saturated = 1; // Out of range saturates like strtol
+        } else {
+            number = number * 10 + (c - '0');
+        }
+        c = console_getc();
+    }
+    if (c != EOF) {
+        g_console->input_pos--;
+    }
+    
+    long result = negative ? -(long)number : (long)number;
+    if (saturated) {
+        result = negative ? LONG_MIN : LONG_MAX;
+    }
+    *value = (int)result;
+    return 1;
+}
+
+// fgets(buffer, size, stdin) on either stdin or the console
+char* game_read_line(char* buffer, int size) {
+    int length = 0;
+    
+    if (!g_console) {
+        return fgets(buffer, size, stdin);
+    }
+    
+    console_require_input();
+    while (length < size - 1) {
+        int c = console_getc();
+        if (c == EOF) {
+            break;
+        }
+        buffer[length++] = (char)c;
+        if (c == '\n') {
+            break;
+        }
+    }
+    buffer[length] = '\0';
+    return buffer;
+}
+
+// getchar() on either stdin or the console
+int game_getchar(void) {
+    if (!g_console) {
+        return getchar();
+    }
+    console_require_input();
+    return console_getc();
+}
+
+// Play one interactive game on an in-memory console, on this thread
+void play_game_console(GameConsole* console) {
+    jmp_buf console_exit;
+    
+    console->finished = 0;
+    g_console = console;
+    g_console_exit = &console_exit;
+    if (setjmp(console_exit) == 0) {
+        play_game();
+    }
+    g_console = NULL;
+    g_console_exit = NULL;
+}
+
 // Clear input buffer
 void clear_input_buffer(void) {
     int c;
-    while ((c = getchar()) != '\n' && c != EOF);
+    while ((c = game_getchar()) != '\n' && c != EOF);
 }
 
 // Wait for keypress
 void wait_for_keypress(void) {
-    printf("Press Enter to continue...\n");
+    game_print_text(TEXT_PRESS_ENTER);
     clear_input_buffer();
 }
 
 // Print separator line
 void print_separator(void) {
-    printf("========================================\n");
+    game_printf("========================================\n");
 }
 
 // Convert string to uppercase
@@ -1062,7 +1916,7 @@ void to_uppercase(char* str) {
 }
 
 // Console setup for Windows
-#ifndef UNIVAC
+#ifdef WINDOWS_CONSOLE
 void console_setup(void) {
     // Enable ANSI escape codes on Windows 10+
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
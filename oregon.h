@@ -27,19 +27,61 @@
 #include <ctype.h>
 #include <time.h>
 #include <math.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <limits.h>
+#include <stdint.h>
 
-// Platform-specific includes
-#ifndef UNIVAC
+// Platform-specific includes (the Windows console build is the default on Windows)
+#if defined(_WIN32) && !defined(UNIVAC)
+#define WINDOWS_CONSOLE
 #include <windows.h>
 #endif
 
+// Integer-only arithmetic for targets without floating-point hardware; the
+// UNIVAC build always uses it
+#if defined(UNIVAC) && !defined(OREGON_FIXED_POINT)
+#define OREGON_FIXED_POINT
+#endif
+
+// Huffman-coded game text to save memory; the UNIVAC build uses it unless
+// OREGON_PLAIN_TEXT is defined
+#if defined(UNIVAC) && !defined(OREGON_PLAIN_TEXT) && !defined(OREGON_PACKED_TEXT)
+#define OREGON_PACKED_TEXT
+#endif
+
+// Per-thread storage so headless trips can run on several threads at once
+#if defined(_MSC_VER)
+#define OREGON_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define OREGON_THREAD_LOCAL __thread
+#else
+#define OREGON_THREAD_LOCAL
+#endif
+
+// Small per-thread variables the engine reads all the time. The shared library
+// build (OREGON_SHARED_LIB) keeps them in the static TLS block, where a read
+// is one load rather than a __tls_get_addr call
+#if defined(OREGON_SHARED_LIB) && defined(__GNUC__)
+#define OREGON_THREAD_LOCAL_HOT __thread __attribute__((tls_model("initial-exec")))
+#else
+#define OREGON_THREAD_LOCAL_HOT OREGON_THREAD_LOCAL
+#endif
+
 // Constants
 #define MAX_INPUT_LEN 50
+#define RANDOM_MAX 0x7fffffff   // Largest generator output
 #define TOTAL_DISTANCE 2040
 #define STARTING_MONEY 700
 #define WAGON_COST 200
 #define AVAILABLE_MONEY (STARTING_MONEY - WAGON_COST + 200)  // 700 total available
 
+// Raised by every fix that changes how trips play out, so results stored by
+// older builds can be told apart:
+//   2  draws past the last event threshold pick helpful indians; revision 1
+//      sent them to wagon breakdown, so helpful indians never happened
+#define OREGON_RULES_REVISION 2
+
 // Game state flags
 #define FLAG_ILLNESS 1
 #define FLAG_INJURY 2
@@ -73,11 +115,21 @@ typedef struct {
     // Flags and state
     int game_flags;     // Bit flags for various states
     int fort_available; // Whether fort option is available this turn (X1 in original)
+    int forts_visited;  // Bit per trail fort stopped at (trails with fixed forts)
+    int last_event;     // EventType fired this turn, -1 before the first event
     
     // Random state for consistent gameplay
     unsigned int rand_seed;
 } GameState;
 
+// Game text ids (see oregon_text.def)
+typedef enum {
+#define TEXT(id, text) id,
+#include "oregon_text.def"
+#undef TEXT
+    TEXT_COUNT
+} TextId;
+
 // Event types
 typedef enum {
     EVENT_WAGON_BREAKDOWN = 0,
@@ -98,6 +150,43 @@ typedef enum {
     EVENT_HELPFUL_INDIANS
 } EventType;
 
+#define EVENT_COUNT 16
+
+// Event effects, applied by handle_event: the message, then a delta to each
+// field, less up to two random terms of base + random_int(1, count) * step,
+// drawn in order. The events that branch or ask the player (bandits, wild
+// animals, the snake and cold weather) finish in a hook. An event only
+// happens on trail segments with all of need_region and none of skip_region.
+typedef enum {
+    EFFECT_MILES,
+    EFFECT_FOOD,
+    EFFECT_BULLETS,
+    EFFECT_CLOTHING,
+    EFFECT_MISC_SUPPLIES,
+    EFFECT_OXEN_COST,
+    EFFECT_FIELD_COUNT
+} EffectField;
+
+#define EFFECT_RANDOM_TERMS 2
+
+typedef struct {
+    signed char field;          // EffectField, -1 for no term
+    unsigned char count;
+    short base;
+    short step;
+} EffectTerm;
+
+typedef struct {
+    short text;                 // TextId
+    unsigned char need_region;  // TRAIL_* segment flags (trail.h)
+    unsigned char skip_region;
+    short delta[EFFECT_FIELD_COUNT];
+    EffectTerm random[EFFECT_RANDOM_TERMS];
+    void (*hook)(GameState* game);
+} EventEffect;
+
+extern const EventEffect event_effects[EVENT_COUNT];
+
 // Death causes
 typedef enum {
     DEATH_STARVATION,
@@ -109,10 +198,125 @@ typedef enum {
     DEATH_MASSACRE
 } DeathCause;
 
+#define DEATH_CAUSE_COUNT 7
+
+// Turn choices (on the default trail the fort is only offered every other turn)
+#define ACTION_FORT 1
+#define ACTION_HUNT 2
+#define ACTION_CONTINUE 3
+
+// Rider tactics
+#define TACTIC_RUN 1
+#define TACTIC_ATTACK 2
+#define TACTIC_CONTINUE 3
+#define TACTIC_CIRCLE_WAGONS 4
+
+// Fort purchase items, in the order visit_fort asks for them
+#define ITEM_FOOD 0
+#define ITEM_AMMUNITION 1
+#define ITEM_CLOTHING 2
+#define ITEM_MISC_SUPPLIES 3
+#define ITEM_COUNT 4
+
+// Decision maker for every prompt during the trip. The interactive game uses
+// human_policy, which reads the answers from the keyboard; headless trips and
+// AI players supply their own functions. Out-of-range answers fall back to the
+// same default the keyboard prompt uses (the last option).
+typedef struct {
+    const char* name;
+    int (*turn_action)(const GameState* game, int fort_open, void* ctx);   // ACTION_*
+    int (*eating_level)(const GameState* game, void* ctx);                 // 1-3
+    int (*rider_tactic)(const GameState* game, int hostile, void* ctx);    // TACTIC_*
+    int (*fort_purchase)(const GameState* game, int item, void* ctx);      // dollars, ITEM_*
+    int (*shot_result)(int skill_level, const char* word, void* ctx);      // 1 is best, 9 a miss
+    void* ctx;
+} Policy;
+
+extern const Policy human_policy;
+
+// Let a computer player make the interactive game's trip decisions (NULL restores
+// the keyboard); setup and the closing formalities still read the keyboard
+void set_player_policy(const Policy* policy);
+
+// Initial purchases for a headless trip, in dollars (ammunition buys 50 bullets per $1)
+typedef struct {
+    int shooting_skill;
+    int oxen;
+    int food;
+    int ammunition;
+    int clothing;
+    int misc_supplies;
+} PurchasePlan;
+
+// Trip outcomes
+#define TRIP_ARRIVED 0
+#define TRIP_DIED 1
+#define TRIP_ABANDONED 2    // Stopped early by abandon_trip
+
+// Final state of a finished trip
+typedef struct {
+    int outcome;        // TRIP_ARRIVED, TRIP_DIED or TRIP_ABANDONED
+    int death_cause;    // DeathCause when outcome is TRIP_DIED, -1 otherwise
+    int turn_number;    // Turns started before the trip ended
+    int arrival_day;    // Days after March 29 (see calculate_final_date), 0 if died
+    int miles_traveled;
+    int food;
+    int bullets;
+    int clothing;
+    int misc_supplies;
+    int cash;
+} TripResult;
+
+// Called after every completed turn of a headless trip, and once more for the
+// turn on which the party died
+typedef void (*TurnHook)(const GameState* game, void* ctx);
+
+// Called when an interactive or console game ends (not for headless trips), with
+// the final state and result, before the game exits or play_game_console returns
+typedef void (*TripRecorder)(const GameState* game, const TripResult* result, void* ctx);
+
+// Fuzzing probe (fuzz.h), for engines built with OREGON_FUZZ. While one is set
+// on a thread, every message a trip there would print is marked in text_seen,
+// even headless, and every generator output passes through draw, which may
+// replace it; draws counts the outputs so far. The generator state itself
+// runs on unchanged, so a replaced output does not shift the later ones.
+typedef struct {
+    unsigned char* text_seen;   // TEXT_COUNT entries
+    unsigned int (*draw)(unsigned int index, unsigned int value, void* ctx);
+    void* ctx;
+    unsigned int draws;
+} FuzzProbe;
+
+// In-memory console: runs the interactive game in-process, reading a script
+// instead of stdin and appending to a buffer instead of stdout. Each thread
+// can run its own.
+typedef struct GameConsole GameConsole;
+struct GameConsole {
+    unsigned int seed;          // Replaces the clock seed
+    const char* input;
+    size_t input_size;
+    size_t input_pos;
+    // Called when the input runs out; may extend input and return 1, or return 0
+    // to end the game at this read
+    int (*refill)(GameConsole* console, void* ctx);
+    void* refill_ctx;
+    char* output;               // Grown with realloc, owned by the caller
+    size_t output_size;
+    size_t output_capacity;
+    int finished;               // 1 if the trip ended, 0 if the input did
+    TripResult result;          // Set when finished
+    // Shows the status in place of the printed supplies table, for front ends
+    // with a status panel; NULL prints the table
+    void (*show_status)(GameConsole* console, const GameState* game);
+};
+
 // Function declarations
 
 // Game initialization and main loop
 void init_game(GameState* game);
+void init_game_seeded(GameState* game, unsigned int seed);
+void play_game(void);
+void play_game_console(GameConsole* console);
 void show_instructions(void);
 void setup_initial_purchases(GameState* game);
 void main_game_loop(GameState* game);
@@ -123,13 +327,17 @@ const char* get_date_string(int turn_number);
 
 // Turn mechanics
 void process_turn(GameState* game);
+void start_turn(GameState* game);
+void choose_turn_action(GameState* game);
+int ask_turn_action(GameState* game);
+void play_turn_action(GameState* game, int choice);
 void display_status(GameState* game);
 int get_user_choice(const char* prompt, int min_choice, int max_choice);
 void handle_turn_choice(GameState* game, int choice);
 
 // Fort interactions
 void visit_fort(GameState* game);
-int get_purchase_amount(const char* item_name, int max_money);
+int get_purchase_amount(GameState* game, int item);
 
 // Hunting
 void go_hunting(GameState* game);
@@ -141,6 +349,7 @@ void travel_segment(GameState* game);
 void check_for_riders(GameState* game);
 void handle_rider_encounter(GameState* game, int hostile);
 void process_random_events(GameState* game);
+int event_for_draw(int draw);
 void handle_event(GameState* game, EventType event);
 
 // Mountain travel
@@ -164,21 +373,54 @@ void handle_death(GameState* game, DeathCause cause);
 void show_death_scene(DeathCause cause);
 void show_victory_scene(GameState* game);
 void calculate_final_date(GameState* game);
+int compute_arrival_day(const GameState* game);
+void end_trip(GameState* game, int outcome, int cause);
+void set_trip_recorder(TripRecorder recorder, void* ctx);   // Before any game starts
+
+// Headless play
+int apply_purchase_plan(GameState* game, const PurchasePlan* plan);
+int simulate_trip(const PurchasePlan* plan, const Policy* policy, unsigned int seed,
+                  TurnHook on_turn, void* hook_ctx, TripResult* result);
+void resume_trip(const GameState* at_prompt, unsigned int random_state, const Policy* policy,
+                 TripResult* result);
+void abandon_trip(const GameState* game);
+
+// Stepped play, a turn at a time, for running many trips side by side (see
+// world.h). begin_turn plays a turn up to the action prompt and returns the
+// policy's answer in *choice; finish_turn plays the rest of it with that
+// answer. Both use this thread's generator and return 1, with result set, if
+// the trip ended. A stepped trip plays exactly as simulate_trip would.
+int begin_turn(GameState* game, const Policy* policy, int* choice, TripResult* result);
+int finish_turn(GameState* game, int choice, const Policy* policy, TripResult* result);
 
 // Random number generation
 void init_random(void);
+void seed_random(unsigned int seed);
+unsigned int get_random_state(void);
 int random_int(int min, int max);
+int random_q31(void);
+int fixed_point_engine(void);  // 1 if built with OREGON_FIXED_POINT
+int set_fuzz_probe(FuzzProbe* probe);   // This thread, NULL to detach; -1 without OREGON_FUZZ
+void set_event_counts(unsigned int* counts);    // Count this thread's event draws by EventType; NULL to detach
+#ifndef OREGON_FIXED_POINT
 double random_double(void);
+#endif
 
 // Utility functions
+void game_printf(const char* format, ...);
+void game_print_text(int id);   // TextId
+void game_textf(int id, ...);   // TextId of a format, then its arguments
+int game_scan_int(int* value);
+char* game_read_line(char* buffer, int size);
+int game_getchar(void);
 void clear_input_buffer(void);
 void wait_for_keypress(void);
 void print_separator(void);
-int get_yes_no_input(const char* prompt);
+int get_yes_no_input(int prompt);   // TextId
 void to_uppercase(char* str);
 
 // Platform-specific functions
-#ifndef UNIVAC
+#ifdef WINDOWS_CONSOLE
 void console_setup(void);
 #endif
 
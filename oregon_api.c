@@ -0,0 +1,161 @@
+/*
+ * liboregon - batch simulation over caller-owned arrays.
+ */
+
+#include <stdatomic.h>
+#include "oregon_api.h"
+#include "oregon.h"
+#include "policy.h"
+#include "batch.h"
+#include "kernels.h"
+#include "trail.h"
+
+// Rows handed to a worker at a time
+#define API_CHUNK 1024
+
+typedef struct {
+    const OregonBatchInput* input;
+    const OregonBatchOutput* output;
+    const Policy* policy;
+    atomic_uint_fast64_t* next_row;
+    int64_t invalid;
+} ApiWorker;
+
+#define STORE(column, row, value) \
+    do { \
+        if (output->column) { \
+            output->column[row] = (value); \
+        } \
+    } while (0)
+
+static void store_result(const OregonBatchOutput* output, uint32_t row, const TripResult* result) {
+    STORE(outcome, row, result->outcome);
+    STORE(death_cause, row, result->death_cause);
+    STORE(turn_number, row, result->turn_number);
+    STORE(arrival_day, row, result->arrival_day);
+    STORE(miles_traveled, row, result->miles_traveled);
+    STORE(food, row, result->food);
+    STORE(bullets, row, result->bullets);
+    STORE(clothing, row, result->clothing);
+    STORE(misc_supplies, row, result->misc_supplies);
+    STORE(cash, row, result->cash);
+}
+
+static void* api_worker_main(void* arg) {
+    ApiWorker* worker = (ApiWorker*)arg;
+    const OregonBatchInput* input = worker->input;
+    PurchasePlan plan;
+    TripResult result;
+
+    default_purchase_plan(&plan);
+    for (;;) {
+        uint64_t first = atomic_fetch_add(worker->next_row, API_CHUNK);
+        if (first >= input->count) {
+            break;
+        }
+        uint64_t last = first + API_CHUNK < input->count ? first + API_CHUNK : input->count;
+
+        for (uint32_t row = (uint32_t)first; row < last; row++) {
+            if (input->purchases) {
+                const int32_t* buy = &input->purchases[(size_t)row * OREGON_BUY_COLUMNS];
+                plan.oxen = buy[OREGON_BUY_OXEN];
+                plan.food = buy[OREGON_BUY_FOOD];
+                plan.ammunition = buy[OREGON_BUY_AMMUNITION];
+                plan.clothing = buy[OREGON_BUY_CLOTHING];
+                plan.misc_supplies = buy[OREGON_BUY_MISC];
+            }
+            if (input->shooting_skill) {
+                plan.shooting_skill = input->shooting_skill[row];
+            }
+            TripKernel kernel = find_trip_kernel(worker->policy, plan.shooting_skill);
+            unsigned int seed = input->seeds[row] & SEED_MASK;
+            int status = kernel ? kernel(&plan, seed, &result)
+                                : simulate_trip(&plan, worker->policy, seed, NULL, NULL, &result);
+            if (status != 0) {
+                memset(&result, 0, sizeof(result));
+                result.outcome = OREGON_INVALID_PLAN;
+                result.death_cause = -1;
+                worker->invalid++;
+            }
+            store_result(worker->output, row, &result);
+        }
+    }
+    return NULL;
+}
+
+int oregon_api_version(void) {
+    return OREGON_API_VERSION;
+}
+
+int oregon_policy_count(void) {
+    return policy_count();
+}
+
+const char* oregon_policy_name(int policy) {
+    const Policy* found = policy_by_id(policy);
+    return found ? found->name : NULL;
+}
+
+int oregon_set_trail_file(const char* path, char* error, int error_size) {
+    static Trail trail;
+    Trail loaded;
+    char message[80];
+
+    if (!path) {
+        set_trail(NULL);
+        return 0;
+    }
+    // A file that fails to load leaves the trail in use untouched
+    if (trail_load(&loaded, path, message, sizeof(message)) != 0) {
+        if (error && error_size > 0) {
+            snprintf(error, (size_t)error_size, "%s", message);
+        }
+        return -1;
+    }
+    trail = loaded;
+    set_trail(&trail);
+    return 0;
+}
+
+int64_t oregon_simulate_batch(const OregonBatchInput* input, const OregonBatchOutput* output) {
+    atomic_uint_fast64_t next_row;
+
+    if (!input || !output || input->struct_size != sizeof(OregonBatchInput) ||
+        output->struct_size != sizeof(OregonBatchOutput) || (!input->seeds && input->count)) {
+        return OREGON_ERROR_ARGUMENTS;
+    }
+    const Policy* policy = policy_by_id(input->policy);
+    if (!policy) {
+        return OREGON_ERROR_POLICY;
+    }
+    int threads = input->threads > 0 ? input->threads : batch_default_threads();
+    uint64_t most = ((uint64_t)input->count + API_CHUNK - 1) / API_CHUNK;
+    if ((uint64_t)threads > most) {
+        threads = most ? (int)most : 1; // No idle workers on small batches
+    }
+
+    ApiWorker* workers = calloc((size_t)threads, sizeof(ApiWorker));
+    if (!workers) {
+        return OREGON_ERROR_MEMORY;
+    }
+
+    atomic_init(&next_row, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].input = input;
+        workers[w].output = output;
+        workers[w].policy = policy;
+        workers[w].next_row = &next_row;
+    }
+    if (threads == 1) {
+        api_worker_main(&workers[0]);
+    } else {
+        run_worker_threads(api_worker_main, workers, sizeof(ApiWorker), threads);
+    }
+
+    int64_t invalid = 0;
+    for (int w = 0; w < threads; w++) {
+        invalid += workers[w].invalid;
+    }
+    free(workers);
+    return invalid;
+}
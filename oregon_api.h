@@ -0,0 +1,98 @@
+/*
+ * liboregon - batch simulation over caller-owned arrays.
+ *
+ * A stable C ABI for driving the headless engine from other languages
+ * (python/oregon_trail.py wraps it with ctypes and NumPy). One call plays a
+ * whole batch of trips: the caller passes column arrays of seeds, initial
+ * purchases and shooting skills, and column arrays for the results, and the
+ * library fills them in place on its own worker threads. Nothing is copied
+ * and nothing is allocated per trip, and the call never touches the caller's
+ * interpreter, so wrappers can drop their global lock around it (ctypes does).
+ *
+ * Row i of every array belongs to trip i. Arrays are plain int32/uint32
+ * columns, so NumPy arrays of those dtypes can be passed as they are. Output
+ * pointers may be NULL for columns the caller does not want.
+ *
+ * The ABI only grows: new functions and new trailing struct fields come with a
+ * new OREGON_API_VERSION, and the struct_size fields tell the library which
+ * version the caller was built against.
+ */
+
+#ifndef OREGON_API_H
+#define OREGON_API_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define OREGON_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define OREGON_API __attribute__((visibility("default")))
+#else
+#define OREGON_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OREGON_API_VERSION 1
+
+// Columns of the purchases array, in dollars, as PurchasePlan
+#define OREGON_BUY_OXEN 0
+#define OREGON_BUY_FOOD 1
+#define OREGON_BUY_AMMUNITION 2
+#define OREGON_BUY_CLOTHING 3
+#define OREGON_BUY_MISC 4
+#define OREGON_BUY_COLUMNS 5
+
+// Outcomes; the rest are TRIP_ARRIVED, TRIP_DIED and TRIP_ABANDONED
+#define OREGON_INVALID_PLAN -1      // The row's purchases or skill were refused
+
+// Errors returned by oregon_simulate_batch
+#define OREGON_ERROR_ARGUMENTS -1   // A required array is NULL or struct_size is wrong
+#define OREGON_ERROR_POLICY -2      // No built-in policy has that ID
+#define OREGON_ERROR_MEMORY -3
+
+typedef struct {
+    uint32_t struct_size;           // sizeof(OregonBatchInput)
+    uint32_t count;                 // Trips, rows in every array
+    const uint32_t* seeds;          // Required
+    const int32_t* purchases;       // count x OREGON_BUY_COLUMNS, row-major; NULL for the default buy
+    const int32_t* shooting_skill;  // 1-5; NULL for the default skill
+    int32_t policy;                 // Built-in policy ID, see oregon_policy_name
+    int32_t threads;                // 0 picks the number of online CPUs
+} OregonBatchInput;
+
+typedef struct {
+    uint32_t struct_size;           // sizeof(OregonBatchOutput)
+    int32_t* outcome;               // TRIP_* or OREGON_INVALID_PLAN
+    int32_t* death_cause;           // DeathCause, -1 unless the party died
+    int32_t* turn_number;
+    int32_t* arrival_day;           // Days after March 29, 0 unless arrived
+    int32_t* miles_traveled;
+    int32_t* food;
+    int32_t* bullets;
+    int32_t* clothing;
+    int32_t* misc_supplies;
+    int32_t* cash;
+} OregonBatchOutput;
+
+OREGON_API int oregon_api_version(void);
+
+// Built-in policies: IDs run from 0 to oregon_policy_count() - 1 and never change
+OREGON_API int oregon_policy_count(void);
+OREGON_API const char* oregon_policy_name(int policy);
+
+// Use a trail file for every batch from here on (NULL for the default trail);
+// returns 0, or -1 with a message in error. Not while a batch is running.
+OREGON_API int oregon_set_trail_file(const char* path, char* error, int error_size);
+
+// Play every trip of the batch and fill the output columns; returns the
+// number of rows refused as OREGON_INVALID_PLAN, or an OREGON_ERROR_*
+OREGON_API int64_t oregon_simulate_batch(const OregonBatchInput* input, const OregonBatchOutput* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OREGON_API_H
@@ -0,0 +1,2662 @@
+/*
+ * oregon_sim - headless batch tools for the Oregon Trail engine.
+ *
+ * Usage: oregon_sim <command> [options]
+ * Run "oregon_sim help" for the command list.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "oregon.h"
+#include "policy.h"
+#include "batch.h"
+#include "trace_archive.h"
+#include "trace_index.h"
+#include "qlearn.h"
+#include "advisor.h"
+#include "golden.h"
+#include "seedscan.h"
+#include "scores.h"
+#include "trail.h"
+#include "world.h"
+#include "shard.h"
+#include "checkpoint.h"
+#include "fuzz.h"
+#include "scenario.h"
+#include "surrogate.h"
+#include "tournament.h"
+#include "packed.h"
+#include "sensitivity.h"
+#include "cache.h"
+#include "telemetry.h"
+
+// Options shared by every command
+typedef struct {
+    BatchJob job;
+    const char* policy_name;
+    QTable* ai_table;           // Learned player loaded with --ai
+    Policy ai_policy;
+    uint64_t ai_digest;         // Of the --ai checkpoint's contents, 0 without one
+} SimOptions;
+
+typedef struct {
+    const char* name;
+    int (*run)(int argc, char** argv);
+    const char* help;
+} SimCommand;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// FNV-1a of a file's contents, 0 if it cannot be read
+static uint64_t file_digest(const char* path) {
+    unsigned char buffer[4096];
+    uint64_t hash = 0xcbf29ce484222325ull;
+    size_t size;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ buffer[i]) * 0x100000001b3ull;
+        }
+    }
+    fclose(file);
+    return hash;
+}
+
+static void set_default_options(SimOptions* options) {
+    memset(options, 0, sizeof(*options));
+    default_purchase_plan(&options->job.plan);
+    options->job.policy = &continue_policy;
+    options->job.first_seed = 1;
+    options->job.trips = 1000000;
+    options->job.threads = batch_default_threads();
+    options->policy_name = continue_policy.name;
+}
+
+// Parse one shared option at argv[*i]; returns 1 if consumed, 0 if not ours, -1 on error
+static int parse_common_option(SimOptions* options, int argc, char** argv, int* i) {
+    const char* arg = argv[*i];
+    const char* value = (*i + 1 < argc) ? argv[*i + 1] : NULL;
+
+    if (strcmp(arg, "--trips") == 0 && value) {
+        options->job.trips = strtoull(value, NULL, 10);
+    } else if (strcmp(arg, "--seed") == 0 && value) {
+        options->job.first_seed = (unsigned int)strtoul(value, NULL, 0);
+    } else if (strcmp(arg, "--threads") == 0 && value) {
+        options->job.threads = atoi(value);
+        if (options->job.threads < 1) {
+            options->job.threads = 1;
+        }
+    } else if (strcmp(arg, "--policy") == 0 && value) {
+        options->job.policy = find_policy(value);
+        options->policy_name = value;
+        if (!options->job.policy) {
+            fprintf(stderr, "unknown policy '%s'; built-in policies:\n", value);
+            list_policies(stderr);
+            return -1;
+        }
+    } else if (strcmp(arg, "--ai") == 0 && value) {
+        qtable_destroy(options->ai_table);
+        options->ai_table = qtable_load(value);
+        if (!options->ai_table) {
+            fprintf(stderr, "%s: not a learned policy checkpoint\n", value);
+            return -1;
+        }
+        qlearn_policy(options->ai_table, &options->ai_policy);
+        options->ai_digest = file_digest(value);
+        options->job.policy = &options->ai_policy;
+        options->policy_name = value;
+    } else if (strcmp(arg, "--trail") == 0 && value) {
+        static Trail trail;
+        char error[80];
+        if (trail_load(&trail, value, error, sizeof(error)) != 0) {
+            fprintf(stderr, "%s: %s\n", value, error);
+            return -1;
+        }
+        set_trail(&trail);
+    } else if (strcmp(arg, "--skill") == 0 && value) {
+        options->job.plan.shooting_skill = atoi(value);
+    } else if (strcmp(arg, "--generic") == 0) {
+        options->job.generic = 1;
+        return 1; // Takes no value
+    } else if (strcmp(arg, "--buy") == 0 && value) {
+        PurchasePlan* plan = &options->job.plan;
+        if (sscanf(value, "%d,%d,%d,%d,%d", &plan->oxen, &plan->food, &plan->ammunition,
+                   &plan->clothing, &plan->misc_supplies) != 5) {
+            fprintf(stderr, "--buy expects OXEN,FOOD,AMMUNITION,CLOTHING,MISC in dollars\n");
+            return -1;
+        }
+    } else {
+        return 0;
+    }
+
+    (*i)++;
+    return 1;
+}
+
+// Parse all options; positional arguments are collected into positional[]
+static int parse_options(SimOptions* options, int argc, char** argv,
+                         const char** positional, int max_positional, int* positional_count) {
+    *positional_count = 0;
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(options, argc, argv, &i);
+        if (status < 0) {
+            return -1;
+        }
+        if (status > 0) {
+            continue;
+        }
+        if (argv[i][0] == '-' || *positional_count >= max_positional) {
+            fprintf(stderr, "unexpected argument '%s'\n", argv[i]);
+            return -1;
+        }
+        positional[(*positional_count)++] = argv[i];
+    }
+    return 0;
+}
+
+static void format_job(const SimOptions* options, char* out, size_t size) {
+    const PurchasePlan* plan = &options->job.plan;
+    snprintf(out, size, "policy %s, skill %d, buy %d,%d,%d,%d,%d, seeds %u+%llu, %d threads",
+             options->policy_name, plan->shooting_skill, plan->oxen, plan->food,
+             plan->ammunition, plan->clothing, plan->misc_supplies,
+             options->job.first_seed, (unsigned long long)options->job.trips,
+             options->job.threads);
+}
+
+static void print_job(const SimOptions* options) {
+    char text[256];
+    format_job(options, text, sizeof(text));
+    fprintf(stderr, "%s\n", text);
+}
+
+// run: play a batch and print the outcome statistics
+static void on_stop_signal(int sig) {
+    (void)sig;
+    checkpoint_request_stop();
+}
+
+static int run_checkpointed(SimOptions* options, const char* path, double interval) {
+    CheckpointReport report;
+    BatchStats stats;
+
+    signal(SIGINT, on_stop_signal);
+    signal(SIGTERM, on_stop_signal);
+    if (run_batch_checkpointed(&options->job, path, interval, &stats, &report, stderr) != 0) {
+        return 1;
+    }
+    if (report.resumed_trips) {
+        fprintf(stderr, "resumed from %s with %llu trips done\n", path,
+                (unsigned long long)report.resumed_trips);
+    }
+    if (report.stopped) {
+        fprintf(stderr, "stopped with %llu of %llu trips done; run again to resume\n",
+                (unsigned long long)stats.trips, (unsigned long long)options->job.trips);
+        return 3;
+    }
+    batch_stats_print(stdout, &stats);
+    fprintf(stderr, "%.3f s, %.0f trips/s, %llu checkpoints\n", report.seconds,
+            (double)report.played_trips / report.seconds, (unsigned long long)report.checkpoints);
+    return 0;
+}
+
+static int run_cached(SimOptions* options, const char* dir) {
+    CacheReport report;
+    BatchStats stats;
+
+    if (run_batch_cached(&options->job, options->ai_digest, dir, &stats, &report, stderr) != 0) {
+        return 2;
+    }
+    batch_stats_print(stdout, &stats);
+    fprintf(stderr, "%.3f s, cache key %016llx: %llu of %llu pieces cached (%llu trips), %llu trips played\n",
+            report.seconds, (unsigned long long)report.key, (unsigned long long)report.cached_pieces,
+            (unsigned long long)report.pieces, (unsigned long long)report.cached_trips,
+            (unsigned long long)report.played_trips);
+    return 0;
+}
+
+static int command_run(int argc, char** argv) {
+    SimOptions options;
+    BatchStats stats;
+    Telemetry telemetry;
+    const char* checkpoint = NULL;
+    const char* cache = NULL;
+    const char* telemetry_name = NULL;
+    double interval = 10.0;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache = argv[++i];
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetry_name = argv[++i];
+        } else {
+            fprintf(stderr, "unexpected argument '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    if ((checkpoint != NULL) + (cache != NULL) + (telemetry_name != NULL) > 1) {
+        fprintf(stderr, "--checkpoint, --cache and --telemetry cannot be combined\n");
+        return 2;
+    }
+    print_job(&options);
+    if (checkpoint) {
+        return run_checkpointed(&options, checkpoint, interval);
+    }
+    if (cache) {
+        return run_cached(&options, cache);
+    }
+
+    if (telemetry_name) {
+        char description[256];
+        format_job(&options, description, sizeof(description));
+        if (telemetry_create(&telemetry, telemetry_name, &options.job, description, stderr) != 0) {
+            return 2;
+        }
+        fprintf(stderr, "telemetry in %s; oregon_sim telemetry %s to watch\n", telemetry.name, telemetry_name);
+    }
+
+    double start = now_seconds();
+    int status = run_batch(&options.job, &stats);
+    double elapsed = now_seconds() - start;
+    if (telemetry_name) {
+        telemetry_finish(&telemetry);
+        telemetry_close(&telemetry);
+    }
+    if (status != 0) {
+        fprintf(stderr, "invalid purchase plan\n");
+        return 2;
+    }
+
+    batch_stats_print(stdout, &stats);
+    fprintf(stderr, "%.3f s, %.0f trips/s\n", elapsed, (double)stats.trips / elapsed);
+    return 0;
+}
+
+// telemetry: attach to a running batch (run --telemetry NAME) and render it
+#define TELEMETRY_STALL_SECONDS 2.0     // At least this long without a write, and
+#define TELEMETRY_STALL_CHUNKS 10.0     // this many of the worker's mean chunk times
+
+static const char* const telemetry_cause_names[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "winter blizzard", "snakebite", "massacre"
+};
+
+typedef struct {
+    uint64_t trips;
+    uint64_t ns;
+} TelemetryMark;
+
+// The batch's process has exited without finishing
+static int telemetry_writer_gone(const TelemetryView* view) {
+    return kill((pid_t)view->pid, 0) != 0 && errno == ESRCH;
+}
+
+static void render_telemetry(FILE* out, const TelemetryView* view, TelemetryWorker* workers,
+                             TelemetryMark* marks, int frame) {
+    BatchStats total;
+    uint64_t handed_out = 0;
+    uint64_t now = telemetry_now_ns();
+    uint64_t finished_ns = telemetry_finished_ns(view);
+    int torn = 0;
+
+    memset(&total, 0, sizeof(total));
+    for (int w = 0; w < view->workers; w++) {
+        torn += telemetry_read_worker(view, w, &workers[w]) != 0;
+        batch_stats_merge(&total, &workers[w].stats);
+        if (workers[w].handed_out > handed_out) {
+            handed_out = workers[w].handed_out;
+        }
+    }
+
+    double elapsed = (double)((finished_ns ? finished_ns : now) - view->started_ns) / 1e9;
+    double n = total.trips ? (double)total.trips : 1.0;
+    double p = (double)total.arrived / n;
+    uint64_t queued = view->trips - handed_out;
+    double rate = elapsed > 0.0 ? (double)total.trips / elapsed : 0.0;
+
+    fprintf(out, "%s\n", view->description);
+    fprintf(out, "pid %ld, %.1f s, %s\n", view->pid, elapsed,
+            finished_ns ? "finished" : telemetry_writer_gone(view) ? "gone" : "running");
+    fprintf(out, "trips            %llu of %llu (%.1f%%), %.0f trips/s", (unsigned long long)total.trips,
+            (unsigned long long)view->trips, 100.0 * (double)total.trips / (double)(view->trips ? view->trips : 1),
+            rate);
+    if (!finished_ns && rate > 0.0) {
+        fprintf(out, ", %.0f s left", (double)(view->trips - total.trips) / rate);
+    }
+    fprintf(out, "\nqueue            %llu trips not handed out (%llu chunks), %llu in workers' hands\n",
+            (unsigned long long)queued, (unsigned long long)((queued + 1023) / 1024),
+            (unsigned long long)(handed_out - total.trips));
+    fprintf(out, "survival rate    %.4f +- %.4f (95%%)\n", p, 1.96 * sqrt(p * (1.0 - p) / n));
+    if (total.arrived > 1) {
+        double arrived = (double)total.arrived;
+        double mean = (double)total.arrival_day_sum / arrived;
+        double variance = ((double)total.arrival_day_sq_sum / arrived - mean * mean) * arrived / (arrived - 1.0);
+        fprintf(out, "mean arrival day %.3f +- %.3f (95%%)\n", mean,
+                1.96 * sqrt(variance > 0.0 ? variance / arrived : 0.0));
+    }
+    for (int i = 0; i < DEATH_CAUSE_COUNT; i++) {
+        fprintf(out, "died of %-16s %llu (%.4f)\n", telemetry_cause_names[i],
+                (unsigned long long)total.deaths[i], (double)total.deaths[i] / n);
+    }
+
+    fprintf(out, "worker        trips    trips/s  last write  state\n");
+    for (int w = 0; w < view->workers; w++) {
+        const TelemetryWorker* worker = &workers[w];
+        double since = worker->updated_ns ? (double)(now - worker->updated_ns) / 1e9 : 0.0;
+        double busy = worker->updated_ns > view->started_ns ? (double)(worker->updated_ns - view->started_ns) / 1e9 : 0.0;
+        const char* state = worker->finished ? "finished" : worker->updated_ns ? "running" : "not started";
+
+        // Rate since the last frame, or over the worker's whole run on the first
+        double worker_rate = busy > 0.0 ? (double)worker->stats.trips / busy : 0.0;
+        if (frame > 0 && worker->updated_ns > marks[w].ns) {
+            worker_rate = (double)(worker->stats.trips - marks[w].trips) / ((double)(worker->updated_ns - marks[w].ns) / 1e9);
+        } else if (frame > 0 && !worker->finished) {
+            worker_rate = 0.0;
+        }
+        double chunk_seconds = worker->stats.trips ? busy * 1024.0 / (double)worker->stats.trips : 0.0;
+        if (!worker->finished && worker->updated_ns && !finished_ns && since > TELEMETRY_STALL_SECONDS &&
+            since > TELEMETRY_STALL_CHUNKS * chunk_seconds) {
+            state = "STALLED";
+        }
+        fprintf(out, "%6d %12llu %10.0f %9.1f s  %s\n", w, (unsigned long long)worker->stats.trips, worker_rate,
+                since, state);
+        marks[w].trips = worker->stats.trips;
+        marks[w].ns = worker->updated_ns;
+    }
+    if (torn) {
+        fprintf(out, "%d slots half written (a worker died while writing)\n", torn);
+    }
+}
+
+static int command_telemetry(int argc, char** argv) {
+    TelemetryView view;
+    const char* name = NULL;
+    double interval = 1.0;
+    int once = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--once") == 0) {
+            once = 1;
+        } else if (argv[i][0] != '-' && !name) {
+            name = argv[i];
+        } else {
+            fprintf(stderr, "unexpected argument '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    if (!name || interval <= 0.0) {
+        fprintf(stderr, "usage: oregon_sim telemetry NAME [--interval S] [--once]\n");
+        return 2;
+    }
+    if (telemetry_attach(&view, name, stderr) != 0) {
+        return 1;
+    }
+
+    TelemetryWorker* workers = calloc((size_t)view.workers, sizeof(TelemetryWorker));
+    TelemetryMark* marks = calloc((size_t)view.workers, sizeof(TelemetryMark));
+    if (!workers || !marks) {
+        fprintf(stderr, "out of memory\n");
+        free(workers);
+        free(marks);
+        telemetry_detach(&view);
+        return 1;
+    }
+    int redraw = isatty(fileno(stdout));
+    for (int frame = 0;; frame++) {
+        if (redraw) {
+            fputs("\033[H\033[J", stdout);
+        } else if (frame > 0) {
+            fputc('\n', stdout);
+        }
+        render_telemetry(stdout, &view, workers, marks, frame);
+        fflush(stdout);
+        if (once || telemetry_finished_ns(&view) || telemetry_writer_gone(&view)) {
+            break;
+        }
+        struct timespec pause = {(time_t)interval, (long)((interval - (double)(time_t)interval) * 1e9)};
+        nanosleep(&pause, NULL);
+    }
+    free(workers);
+    free(marks);
+    telemetry_detach(&view);
+    return 0;
+}
+
+// arith-record / arith-compare: per-trip outcomes of one engine build, checked
+// against another build (the floating-point and OREGON_FIXED_POINT engines)
+#define ARITH_MAGIC "ORARITH 1"
+#define ARITH_CHI2_Z 3.09        // One-sided 0.999 normal quantile
+#define ARITH_MAX_TURNS 24
+#define ARITH_MAX_DAYS (ARITH_MAX_TURNS * 14)
+
+typedef struct {
+    unsigned int first_seed;
+    TripResult* results;        // Indexed by seed - first_seed
+} ArithRecording;
+
+static void arith_trip_hook(int worker, unsigned int seed, const TripResult* result, void* ctx) {
+    ArithRecording* recording = (ArithRecording*)ctx;
+    recording->results[(seed - recording->first_seed) & SEED_MASK] = *result;
+}
+
+// Play the job and keep every trip's result; returns trips per second, or -1
+static double arith_play(SimOptions* options, TripResult* results) {
+    ArithRecording recording = {options->job.first_seed, results};
+    void** worker_ctx = malloc((size_t)options->job.threads * sizeof(void*));
+    BatchStats stats;
+
+    for (int w = 0; w < options->job.threads; w++) {
+        worker_ctx[w] = &recording;
+    }
+    options->job.on_trip = arith_trip_hook;
+    options->job.worker_ctx = worker_ctx;
+    double start = now_seconds();
+    int status = run_batch(&options->job, &stats);
+    double elapsed = now_seconds() - start;
+    free(worker_ctx);
+    return status == 0 ? (double)stats.trips / elapsed : -1.0;
+}
+
+static const char* arith_name(int fixed_point) {
+    return fixed_point ? "fixed-point" : "floating-point";
+}
+
+// Outcome class of a trip: 0 arrived, 1 + DeathCause otherwise
+static int arith_class(const TripResult* result) {
+    return result->outcome == TRIP_ARRIVED ? 0 : 1 + result->death_cause;
+}
+
+// Chi-square homogeneity test of two histograms; returns the statistic
+static double chi_square(const uint64_t* a, const uint64_t* b, int bins, uint64_t total_a,
+                         uint64_t total_b, int* df) {
+    double chi2 = 0.0;
+    *df = -1;
+    for (int i = 0; i < bins; i++) {
+        double column = (double)(a[i] + b[i]);
+        if (column == 0.0) {
+            continue;
+        }
+        double expect_a = column * (double)total_a / (double)(total_a + total_b);
+        double expect_b = column * (double)total_b / (double)(total_a + total_b);
+        chi2 += ((double)a[i] - expect_a) * ((double)a[i] - expect_a) / expect_a;
+        chi2 += ((double)b[i] - expect_b) * ((double)b[i] - expect_b) / expect_b;
+        (*df)++;
+    }
+    return chi2;
+}
+
+// Wilson-Hilferty approximation of the chi-square 0.999 quantile
+static double chi_square_critical(int df) {
+    double k = 2.0 / (9.0 * df);
+    double root = 1.0 - k + ARITH_CHI2_Z * sqrt(k);
+    return df * root * root * root;
+}
+
+static void print_chi_square(const char* what, const uint64_t* a, const uint64_t* b, int bins,
+                             uint64_t total_a, uint64_t total_b) {
+    int df;
+    double chi2 = chi_square(a, b, bins, total_a, total_b, &df);
+    if (df < 1) {
+        printf("%-18s one class only, identical\n", what);
+        return;
+    }
+    double critical = chi_square_critical(df);
+    printf("%-18s chi2 %.2f, %d df, 0.999 critical %.2f: %s\n", what, chi2, df, critical,
+           chi2 <= critical ? "same distribution" : "DIFFERENT");
+}
+
+static int arith_usage(const char* command) {
+    fprintf(stderr, "usage: oregon_sim %s FILE [options]\n", command);
+    return 2;
+}
+
+// arith-record FILE: play a batch and store every trip's result
+static int command_arith_record(int argc, char** argv) {
+    SimOptions options;
+    const char* path;
+    int positional_count;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, &path, 1, &positional_count) != 0 ||
+        positional_count != 1) {
+        return arith_usage("arith-record");
+    }
+    print_job(&options);
+
+    TripResult* results = calloc(options.job.trips ? options.job.trips : 1, sizeof(TripResult));
+    if (!results) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    double rate = arith_play(&options, results);
+    if (rate < 0) {
+        fprintf(stderr, "invalid purchase plan\n");
+        free(results);
+        return 2;
+    }
+
+    FILE* out = fopen(path, "wb");
+    int failed = !out;
+    if (out) {
+        fprintf(out, "%s %s %s %u %llu %d %.1f\n", ARITH_MAGIC, arith_name(fixed_point_engine()),
+                options.policy_name, options.job.first_seed,
+                (unsigned long long)options.job.trips, options.job.threads, rate);
+        failed = fwrite(results, sizeof(TripResult), options.job.trips, out) != options.job.trips;
+        failed |= fclose(out) != 0;
+    }
+    free(results);
+    if (failed) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "%s engine, %.0f trips/s\n", arith_name(fixed_point_engine()), rate);
+    return 0;
+}
+
+// arith-compare FILE: replay the recorded seeds with this build and compare
+// trip by trip and as outcome distributions
+static int command_arith_compare(int argc, char** argv) {
+    SimOptions options;
+    const char* path;
+    int positional_count;
+    char mode[32], policy[256];
+    unsigned int first_seed;
+    unsigned long long trips;
+    int threads;
+    double recorded_rate;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, &path, 1, &positional_count) != 0 ||
+        positional_count != 1) {
+        return arith_usage("arith-compare");
+    }
+
+    FILE* in = fopen(path, "rb");
+    if (!in || fscanf(in, ARITH_MAGIC " %31s %255s %u %llu %d %lf", mode, policy, &first_seed,
+                      &trips, &threads, &recorded_rate) != 6 || fgetc(in) != '\n') {
+        fprintf(stderr, "%s: not an arith-record file\n", path);
+        if (in) {
+            fclose(in);
+        }
+        return 1;
+    }
+    TripResult* recorded = malloc((trips ? trips : 1) * sizeof(TripResult));
+    TripResult* replayed = calloc(trips ? trips : 1, sizeof(TripResult));
+    if (!recorded || !replayed || fread(recorded, sizeof(TripResult), trips, in) != trips) {
+        fprintf(stderr, "%s: truncated\n", path);
+        fclose(in);
+        free(recorded);
+        free(replayed);
+        return 1;
+    }
+    fclose(in);
+
+    // Same job as the recording unless the options say otherwise
+    if (strcmp(options.policy_name, continue_policy.name) == 0 && strcmp(policy, continue_policy.name) != 0) {
+        options.job.policy = find_policy(policy);
+        options.policy_name = policy;
+        if (!options.job.policy) {
+            fprintf(stderr, "recorded with policy '%s'; pass it with --policy or --ai\n", policy);
+            free(recorded);
+            free(replayed);
+            return 2;
+        }
+    }
+    int paired = 1;
+    for (int i = 0; i < argc; i++) {
+        paired &= strcmp(argv[i], "--seed") != 0;
+    }
+    if (paired) {
+        options.job.first_seed = first_seed;
+    }
+    options.job.trips = trips;
+    print_job(&options);
+
+    double rate = arith_play(&options, replayed);
+    if (rate < 0) {
+        fprintf(stderr, "invalid purchase plan\n");
+        free(recorded);
+        free(replayed);
+        return 2;
+    }
+
+    uint64_t classes[2][1 + DEATH_CAUSE_COUNT] = {{0}};
+    uint64_t turns[2][ARITH_MAX_TURNS + 2] = {{0}};
+    uint64_t days[2][ARITH_MAX_DAYS] = {{0}};
+    uint64_t identical = 0;
+    int shown = 0;
+    for (uint64_t t = 0; t < trips; t++) {
+        const TripResult* pair[2] = {&recorded[t], &replayed[t]};
+        for (int b = 0; b < 2; b++) {
+            int turn = pair[b]->turn_number;
+            int day = pair[b]->arrival_day;
+            classes[b][arith_class(pair[b])]++;
+            turns[b][turn < 0 ? 0 : turn > ARITH_MAX_TURNS ? ARITH_MAX_TURNS + 1 : turn]++;
+            if (pair[b]->outcome == TRIP_ARRIVED && day >= 0 && day < ARITH_MAX_DAYS) {
+                days[b][day]++;
+            }
+        }
+        if (!paired) {
+            continue;
+        }
+        if (memcmp(pair[0], pair[1], sizeof(TripResult)) == 0) {
+            identical++;
+        } else if (shown++ < 5) {
+            printf("seed %u differs: %s %d turns %d miles vs %s %d turns %d miles\n",
+                   (unsigned int)((first_seed + t) & SEED_MASK),
+                   pair[0]->outcome == TRIP_ARRIVED ? "arrived" : "died", pair[0]->turn_number,
+                   pair[0]->miles_traveled, pair[1]->outcome == TRIP_ARRIVED ? "arrived" : "died",
+                   pair[1]->turn_number, pair[1]->miles_traveled);
+        }
+    }
+
+    printf("recorded %s engine, replayed on the %s engine, %llu trips\n", mode,
+           arith_name(fixed_point_engine()), trips);
+    if (paired) {
+        printf("identical trips    %llu of %llu\n", (unsigned long long)identical, trips);
+    }
+    double survival[2] = {(double)classes[0][0] / (double)trips, (double)classes[1][0] / (double)trips};
+    printf("survival rate      %.5f vs %.5f\n", survival[0], survival[1]);
+    print_chi_square("outcome classes", classes[0], classes[1], 1 + DEATH_CAUSE_COUNT, trips, trips);
+    print_chi_square("turns played", turns[0], turns[1], ARITH_MAX_TURNS + 2, trips, trips);
+    print_chi_square("arrival day", days[0], days[1], ARITH_MAX_DAYS, classes[0][0], classes[1][0]);
+    printf("speed              %.0f vs %.0f trips/s (%d vs %d threads), %.2fx\n", recorded_rate,
+           rate, threads, options.job.threads, rate / recorded_rate);
+
+    free(recorded);
+    free(replayed);
+    return paired && identical != trips ? 1 : 0;
+}
+
+// trace-write FILE: play a batch and archive every turn
+static int command_trace_write(int argc, char** argv) {
+    SimOptions options;
+    BatchStats stats;
+    const char* path;
+    int positional_count;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, &path, 1, &positional_count) != 0 ||
+        positional_count != 1) {
+        fprintf(stderr, "usage: oregon_sim trace-write FILE [options]\n");
+        return 2;
+    }
+    print_job(&options);
+
+    TraceWriter* writer = trace_writer_open(path);
+    if (!writer) {
+        perror(path);
+        return 1;
+    }
+
+    int threads = options.job.threads;
+    TraceWorkerBuffers* buffers = calloc((size_t)threads, sizeof(TraceWorkerBuffers));
+    void** worker_ctx = calloc((size_t)threads, sizeof(void*));
+    int ready = buffers && worker_ctx;
+    for (int w = 0; ready && w < threads; w++) {
+        buffers[w].turns = trace_builder_create(writer, TRACE_TABLE_TURNS);
+        buffers[w].trips = trace_builder_create(writer, TRACE_TABLE_TRIPS);
+        worker_ctx[w] = &buffers[w];
+        ready = buffers[w].turns && buffers[w].trips;
+    }
+    if (!ready) {
+        fprintf(stderr, "out of memory\n");
+        for (int w = 0; buffers && w < threads; w++) {
+            trace_builder_destroy(buffers[w].turns);
+            trace_builder_destroy(buffers[w].trips);
+        }
+        free(buffers);
+        free(worker_ctx);
+        trace_writer_close(writer);
+        return 1;
+    }
+    options.job.on_turn = trace_turn_hook;
+    options.job.on_trip = trace_trip_hook;
+    options.job.worker_ctx = worker_ctx;
+
+    double start = now_seconds();
+    int status = run_batch(&options.job, &stats);
+    for (int w = 0; w < threads; w++) {
+        if (trace_builder_flush(buffers[w].turns) != 0 ||
+            trace_builder_flush(buffers[w].trips) != 0) {
+            status = -1;
+        }
+        trace_builder_destroy(buffers[w].turns);
+        trace_builder_destroy(buffers[w].trips);
+    }
+    free(buffers);
+    free(worker_ctx);
+    if (trace_writer_close(writer) != 0 || status != 0) {
+        fprintf(stderr, "failed to write %s\n", path);
+        return 1;
+    }
+    double elapsed = now_seconds() - start;
+
+    TraceReader reader;
+    if (trace_reader_open(&reader, path) == 0) {
+        fprintf(stderr, "%llu trips, %llu turns, %llu blocks, %.2f bytes/turn, %.3f s\n",
+                (unsigned long long)stats.trips, (unsigned long long)reader.row_count,
+                (unsigned long long)reader.block_count,
+                reader.row_count ? (double)reader.size / (double)reader.row_count : 0.0,
+                elapsed);
+        trace_reader_close(&reader);
+    }
+    return 0;
+}
+
+// trace-scan FILE: decode every column of every block in parallel
+typedef struct {
+    const TraceReader* reader;
+    atomic_uint_fast64_t* next_block;
+    int64_t sums[TRACE_COLUMN_COUNT];
+    int32_t mins[TRACE_COLUMN_COUNT];
+    int32_t maxs[TRACE_COLUMN_COUNT];
+} ScanWorker;
+
+static void* scan_worker_main(void* arg) {
+    ScanWorker* worker = (ScanWorker*)arg;
+    const TraceReader* reader = worker->reader;
+    int32_t values[TRACE_BLOCK_ROWS];
+
+    for (int c = 0; c < TRACE_COLUMN_COUNT; c++) {
+        worker->mins[c] = INT32_MAX;
+        worker->maxs[c] = INT32_MIN;
+    }
+
+    for (;;) {
+        uint64_t block = atomic_fetch_add(worker->next_block, 1);
+        if (block >= reader->block_count) {
+            break;
+        }
+        uint32_t rows = trace_block_rows(reader, block);
+        for (int c = 0; c < TRACE_COLUMN_COUNT; c++) {
+            int64_t sum = 0;
+            int32_t min = worker->mins[c], max = worker->maxs[c];
+            trace_decode_column(reader, block, c, values);
+            for (uint32_t r = 0; r < rows; r++) {
+                sum += values[r];
+                min = values[r] < min ? values[r] : min;
+                max = values[r] > max ? values[r] : max;
+            }
+            worker->sums[c] += sum;
+            worker->mins[c] = min;
+            worker->maxs[c] = max;
+        }
+    }
+    return NULL;
+}
+
+static int command_trace_scan(int argc, char** argv) {
+    SimOptions options;
+    TraceReader reader;
+    const char* path;
+    int positional_count;
+    atomic_uint_fast64_t next_block;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, &path, 1, &positional_count) != 0 ||
+        positional_count != 1) {
+        fprintf(stderr, "usage: oregon_sim trace-scan FILE [--threads N]\n");
+        return 2;
+    }
+    if (trace_reader_open(&reader, path) != 0) {
+        fprintf(stderr, "%s: not a trace archive\n", path);
+        return 1;
+    }
+
+    int threads = options.job.threads;
+    ScanWorker* workers = calloc((size_t)threads, sizeof(ScanWorker));
+    if (!workers) {
+        fprintf(stderr, "out of memory\n");
+        trace_reader_close(&reader);
+        return 1;
+    }
+    atomic_init(&next_block, 0);
+
+    double start = now_seconds();
+    for (int w = 0; w < threads; w++) {
+        workers[w].reader = &reader;
+        workers[w].next_block = &next_block;
+    }
+    run_worker_threads(scan_worker_main, workers, sizeof(ScanWorker), threads);
+    double elapsed = now_seconds() - start;
+
+    printf("%-16s %14s %12s %12s\n", "column", "mean", "min", "max");
+    for (int c = 0; c < TRACE_COLUMN_COUNT; c++) {
+        int64_t sum = 0;
+        int32_t min = INT32_MAX, max = INT32_MIN;
+        for (int w = 0; w < threads; w++) {
+            sum += workers[w].sums[c];
+            min = workers[w].mins[c] < min ? workers[w].mins[c] : min;
+            max = workers[w].maxs[c] > max ? workers[w].maxs[c] : max;
+        }
+        printf("%-16s %14.3f %12d %12d\n", trace_column_names[c],
+               reader.row_count ? (double)sum / (double)reader.row_count : 0.0, min, max);
+    }
+    fprintf(stderr, "%llu turns in %.3f s: %.0f turns/s, %.2f GB/s decoded, %.2f GB/s mapped\n",
+            (unsigned long long)reader.row_count, elapsed, (double)reader.row_count / elapsed,
+            (double)reader.row_count * TRACE_COLUMN_COUNT * sizeof(int32_t) / elapsed / 1e9,
+            (double)reader.size / elapsed / 1e9);
+
+    free(workers);
+    trace_reader_close(&reader);
+    return 0;
+}
+
+// trace-index ARCHIVE INDEX: build the query index for an archive
+static int command_trace_index(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: oregon_sim trace-index ARCHIVE INDEX\n");
+        return 2;
+    }
+    double start = now_seconds();
+    if (trace_index_build(argv[0], argv[1]) != 0) {
+        fprintf(stderr, "%s: cannot index into %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    fprintf(stderr, "indexed %s in %.3f s\n", argv[0], now_seconds() - start);
+    return 0;
+}
+
+// query INDEX TERM... [--quantile FIELD]: filtered counts, survival rate and quantiles
+static int command_query(int argc, char** argv) {
+    TraceIndex index;
+    TraceQuery query;
+    QueryResult result;
+
+    if (argc < 1) {
+        fprintf(stderr, "usage: oregon_sim query INDEX [TERM...] [--quantile FIELD]\n");
+        return 2;
+    }
+    trace_query_init(&query);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quantile") == 0 && i + 1 < argc) {
+            i++;
+            for (int f = 0; f < QUERY_FIELD_COUNT; f++) {
+                if (strcmp(argv[i], query_field_names[f]) == 0) {
+                    query.quantile_field = f;
+                }
+            }
+            if (query.quantile_field < 0) {
+                fprintf(stderr, "unknown field '%s'\n", argv[i]);
+                return 2;
+            }
+        } else if (trace_query_parse_term(&query, argv[i]) != 0) {
+            fprintf(stderr, "bad query term '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    if (trace_index_open(&index, argv[0]) != 0) {
+        fprintf(stderr, "%s: not a trace index\n", argv[0]);
+        return 1;
+    }
+
+    double start = now_seconds();
+    if (trace_query_run(&index, &query, &result) != 0) {
+        fprintf(stderr, "out of memory\n");
+        trace_index_close(&index);
+        return 1;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("matched %llu %s, %llu on trips that arrived (%.2f%%)\n",
+           (unsigned long long)result.matched, result.trip_level ? "trips" : "turns",
+           (unsigned long long)result.survived,
+           result.matched ? 100.0 * (double)result.survived / (double)result.matched : 0.0);
+    if (query.quantile_field >= 0 && result.matched) {
+        printf("%s quantiles:", query_field_names[query.quantile_field]);
+        for (int q = 0; q < QUERY_QUANTILES; q++) {
+            printf(" p%.0f=%.0f", query_quantile_points[q] * 100.0, result.quantiles[q]);
+        }
+        printf("\n");
+    }
+    fprintf(stderr, "%.3f ms, %llu cells, %llu bitmap predicates\n", elapsed * 1e3,
+            (unsigned long long)result.cells_visited, (unsigned long long)result.bitmap_filters);
+
+    trace_index_close(&index);
+    return 0;
+}
+
+// scan TERM...: sweep the seed space for trips matching every term
+typedef struct {
+    uint64_t limit;
+    uint64_t printed;
+} ScanOutput;
+
+static int print_scan_match(const ScanMatch* match, void* ctx) {
+    ScanOutput* output = (ScanOutput*)ctx;
+    scan_print_match(stdout, match);
+    output->printed++;
+    return output->limit && output->printed >= output->limit;
+}
+
+static int command_scan(int argc, char** argv) {
+    SimOptions options;
+    ScanPredicate predicate;
+    ScanOutput output = {0, 0};
+    ScanReport report;
+
+    set_default_options(&options);
+    options.job.first_seed = 0;
+    options.job.trips = (uint64_t)SEED_MASK + 1;
+    scan_predicate_init(&predicate);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        }
+        if (status > 0) {
+            continue;
+        }
+        if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            output.limit = strtoull(argv[++i], NULL, 10);
+        } else if (scan_predicate_parse_term(&predicate, argv[i]) != 0) {
+            fprintf(stderr, "usage: oregon_sim scan TERM... [--limit N] [options]\n");
+            fprintf(stderr, "bad scan term '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    if (options.job.trips > (uint64_t)SEED_MASK + 1) {
+        options.job.trips = (uint64_t)SEED_MASK + 1; // Every seed once
+    }
+
+    print_job(&options);
+    if (scan_seeds(&options.job, &predicate, print_scan_match, &output, stderr, &report) != 0) {
+        fprintf(stderr, "invalid purchase plan, or out of memory\n");
+        return 1;
+    }
+    fprintf(stderr, "%llu seeds in %.1f s, %llu matched, %llu abandoned early\n",
+            (unsigned long long)report.scanned, report.seconds,
+            (unsigned long long)report.matched, (unsigned long long)report.abandoned);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+// scores-record LOG: play a batch and append every trip to a score log
+#define SCORES_BUFFER 4096          // Records per worker between appends
+
+typedef struct {
+    ScoreLog* log;
+    int shooting_skill;
+    uint32_t time;
+    ScoreRecord records[SCORES_BUFFER];
+    size_t count;
+    int failed;
+} ScoreWriter;
+
+static void score_writer_flush(ScoreWriter* writer) {
+    if (writer->count && score_log_append(writer->log, writer->records, writer->count) != 0) {
+        writer->failed = 1;
+    }
+    writer->count = 0;
+}
+
+static void score_trip_hook(int worker, unsigned int seed, const TripResult* result, void* ctx) {
+    ScoreWriter* writer = (ScoreWriter*)ctx;
+    (void)worker;
+    score_record_fill(&writer->records[writer->count++], result, seed, writer->shooting_skill,
+                      writer->time);
+    if (writer->count == SCORES_BUFFER) {
+        score_writer_flush(writer);
+    }
+}
+
+static int command_scores_record(int argc, char** argv) {
+    SimOptions options;
+    ScoreLog log;
+    BatchStats stats;
+    const char* path;
+    int positional_count;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, &path, 1, &positional_count) != 0 ||
+        positional_count != 1) {
+        fprintf(stderr, "usage: oregon_sim scores-record LOG [options]\n");
+        return 2;
+    }
+    if (score_log_open(&log, path) != 0) {
+        fprintf(stderr, "%s: cannot open score log\n", path);
+        return 1;
+    }
+    print_job(&options);
+
+    int threads = options.job.threads;
+    ScoreWriter* writers = calloc((size_t)threads, sizeof(ScoreWriter));
+    void** worker_ctx = malloc((size_t)threads * sizeof(void*));
+    if (!writers || !worker_ctx) {
+        fprintf(stderr, "out of memory\n");
+        free(writers);
+        free(worker_ctx);
+        score_log_close(&log);
+        return 1;
+    }
+    for (int w = 0; w < threads; w++) {
+        writers[w].log = &log;
+        writers[w].shooting_skill = options.job.plan.shooting_skill;
+        writers[w].time = (uint32_t)time(NULL);
+        worker_ctx[w] = &writers[w];
+    }
+    options.job.on_trip = score_trip_hook;
+    options.job.worker_ctx = worker_ctx;
+
+    double start = now_seconds();
+    int status = run_batch(&options.job, &stats);
+    int failed = 0;
+    for (int w = 0; w < threads; w++) {
+        score_writer_flush(&writers[w]);
+        failed |= writers[w].failed;
+    }
+    failed |= score_log_sync(&log) != 0;
+    double elapsed = now_seconds() - start;
+    free(writers);
+    free(worker_ctx);
+    score_log_close(&log);
+    qtable_destroy(options.ai_table);
+
+    if (status != 0) {
+        fprintf(stderr, "invalid purchase plan\n");
+        return 2;
+    }
+    if (failed) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "recorded %llu trips in %.1f s\n", (unsigned long long)stats.trips, elapsed);
+    return 0;
+}
+
+// scores-index LOG: build LOG.idx
+static int command_scores_index(int argc, char** argv) {
+    if (argc != 1) {
+        fprintf(stderr, "usage: oregon_sim scores-index LOG\n");
+        return 2;
+    }
+    double start = now_seconds();
+    if (score_index_build(argv[0]) != 0) {
+        fprintf(stderr, "%s: cannot index score log\n", argv[0]);
+        return 1;
+    }
+    fprintf(stderr, "indexed %s in %.3f s\n", argv[0], now_seconds() - start);
+    return 0;
+}
+
+static int parse_score_board(const char* name) {
+    for (int b = 0; b < SCORE_BOARD_COUNT; b++) {
+        if (strcmp(name, score_board_names[b]) == 0) {
+            return b;
+        }
+    }
+    fprintf(stderr, "unknown board '%s' (arrival, cash or miles)\n", name);
+    return -1;
+}
+
+static int open_score_store(ScoreStore* store, const char* path) {
+    if (score_store_open(store, path) != 0) {
+        fprintf(stderr, "%s: no score log with a matching index (run scores-index)\n", path);
+        return -1;
+    }
+    if (store->log_records > store->index->records) {
+        fprintf(stderr, "%s: %llu records since the index was built are not ranked\n", path,
+                (unsigned long long)(store->log_records - store->index->records));
+    }
+    return 0;
+}
+
+// scores-top LOG BOARD [--skill K] [--top N]: a leaderboard
+static int command_scores_top(int argc, char** argv) {
+    ScoreStore store;
+    int skill = 0;
+    size_t k = 10;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--skill") == 0 && i + 1 < argc) {
+            skill = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            k = strtoull(argv[++i], NULL, 10);
+        } else {
+            argc = 0;
+        }
+    }
+    if (argc < 2 || skill < 0 || skill > SCORE_SKILLS) {
+        fprintf(stderr, "usage: oregon_sim scores-top LOG BOARD [--skill K] [--top N]\n");
+        return 2;
+    }
+    int board = parse_score_board(argv[1]);
+    if (board < 0) {
+        return 2;
+    }
+    if (open_score_store(&store, argv[0]) != 0) {
+        return 1;
+    }
+
+    ScoreEntry* top = malloc((k ? k : 1) * sizeof(ScoreEntry));
+    if (!top) {
+        fprintf(stderr, "out of memory\n");
+        score_store_close(&store);
+        return 1;
+    }
+    double start = now_seconds();
+    size_t count = score_top(&store, board, skill, top, k);
+    double elapsed = now_seconds() - start;
+
+    printf("%s, %s: %llu entries\n", score_board_names[board], skill ? "one skill" : "all skills",
+           (unsigned long long)score_board_size(&store, board, skill));
+    for (size_t i = 0; i < count; i++) {
+        printf("%6zu  ", i + 1);
+        score_print_record(stdout, &store, top[i].record);
+    }
+    fprintf(stderr, "%.1f us\n", elapsed * 1e6);
+    free(top);
+    score_store_close(&store);
+    return 0;
+}
+
+// scores-rank LOG BOARD SEED [--skill K]: where a seed's trips stand
+#define SCORES_MAX_MATCHES 16
+
+static int command_scores_rank(int argc, char** argv) {
+    ScoreStore store;
+    uint32_t records[SCORES_MAX_MATCHES];
+    int skill = 0;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--skill") == 0 && i + 1 < argc) {
+            skill = atoi(argv[++i]);
+        } else {
+            argc = 0;
+        }
+    }
+    if (argc < 3 || skill < 0 || skill > SCORE_SKILLS) {
+        fprintf(stderr, "usage: oregon_sim scores-rank LOG BOARD SEED [--skill K]\n");
+        return 2;
+    }
+    int board = parse_score_board(argv[1]);
+    if (board < 0) {
+        return 2;
+    }
+    uint32_t seed = (uint32_t)strtoul(argv[2], NULL, 0);
+    if (open_score_store(&store, argv[0]) != 0) {
+        return 1;
+    }
+
+    double start = now_seconds();
+    size_t found = score_find_seed(&store, seed, records, SCORES_MAX_MATCHES);
+    size_t shown = found < SCORES_MAX_MATCHES ? found : SCORES_MAX_MATCHES;
+    uint64_t ranks[SCORES_MAX_MATCHES];
+    for (size_t i = 0; i < shown; i++) {
+        ranks[i] = score_rank(&store, board, skill, records[i]);
+    }
+    double elapsed = now_seconds() - start;
+
+    if (found == 0) {
+        printf("seed %u: no indexed trips\n", seed);
+    }
+    uint64_t size = score_board_size(&store, board, skill);
+    for (size_t i = 0; i < shown; i++) {
+        if (ranks[i]) {
+            printf("rank %llu of %llu  ", (unsigned long long)ranks[i], (unsigned long long)size);
+        } else {
+            printf("not on the board  ");
+        }
+        score_print_record(stdout, &store, records[i]);
+    }
+    if (found > shown) {
+        printf("(%zu more trips of this seed)\n", found - shown);
+    }
+    fprintf(stderr, "%.1f us\n", elapsed * 1e6);
+    score_store_close(&store);
+    return 0;
+}
+
+// train FILE: self-play training rounds, checkpointing the table after each
+#define TRAIN_EVAL_SEED 0x40000000u     // Evaluation seeds, well away from the training ones
+#define TRAIN_STABLE_ROUNDS 4
+
+static int command_train(int argc, char** argv) {
+    SimOptions options;
+    const char* path = NULL;
+    const char* resume = NULL;
+    uint64_t round_trips = 100000;
+    uint64_t eval_trips = 20000;
+    double epsilon = 0.2;
+    double history[TRAIN_STABLE_ROUNDS];
+
+    set_default_options(&options);
+    options.job.trips = 3000000;
+    for (int i = 0; i < argc; i++) {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--round") == 0 && value) {
+            round_trips = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--eval") == 0 && value) {
+            eval_trips = strtoull(value, NULL, 10);
+        } else if (strcmp(argv[i], "--epsilon") == 0 && value) {
+            epsilon = atof(value);
+        } else if (strcmp(argv[i], "--resume") == 0 && value) {
+            resume = value;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+            continue;
+        } else {
+            path = NULL;
+            break;
+        }
+        i++;
+    }
+    if (!path || round_trips == 0) {
+        fprintf(stderr, "usage: oregon_sim train FILE [--resume FILE] [--round N] [--eval N] "
+                        "[--epsilon E] [options]\n");
+        return 2;
+    }
+
+    QTable* table = resume ? qtable_load(resume) : qtable_create();
+    if (!table) {
+        fprintf(stderr, "%s: not a learned policy checkpoint\n", resume ? resume : path);
+        return 1;
+    }
+
+    TrainJob train;
+    train.plan = options.job.plan;
+    train.threads = options.job.threads;
+    train.epsilon = epsilon;
+
+    BatchJob eval = options.job;
+    qlearn_policy(table, &options.ai_policy);
+    eval.policy = &options.ai_policy;
+    eval.first_seed = TRAIN_EVAL_SEED;
+    eval.trips = eval_trips;
+
+    options.policy_name = "learning";
+    print_job(&options);
+
+    double start = now_seconds();
+    uint64_t done = 0;
+    for (int round = 0; done < options.job.trips; round++) {
+        TrainStats stats;
+        BatchStats eval_stats;
+
+        train.first_seed = (unsigned int)((options.job.first_seed + done) & SEED_MASK);
+        train.trips = options.job.trips - done < round_trips ? options.job.trips - done : round_trips;
+        if (qlearn_train(table, &train, &stats) != 0) {
+            fprintf(stderr, "invalid purchase plan, or out of memory or threads\n");
+            qtable_destroy(table);
+            return 2;
+        }
+        done += stats.trips;
+        qtable_decay(table);
+
+        run_batch(&eval, &eval_stats);
+        double survival = eval_stats.trips ? (double)eval_stats.arrived / (double)eval_stats.trips : 0.0;
+        if (qtable_save(table, path) != 0) {
+            perror(path);
+            qtable_destroy(table);
+            return 1;
+        }
+        printf("round %3d  trips %9llu  epsilon %.3f  exploring %.4f  greedy %.4f  states %llu  %.1f s\n",
+               round + 1, (unsigned long long)done, train.epsilon,
+               (double)stats.arrived / (double)stats.trips, survival,
+               (unsigned long long)qtable_visited_states(table), now_seconds() - start);
+        fflush(stdout);
+
+        // Stop once the greedy survival rate has settled
+        history[round % TRAIN_STABLE_ROUNDS] = survival;
+        if (round + 1 >= TRAIN_STABLE_ROUNDS) {
+            double low = history[0], high = history[0];
+            for (int r = 1; r < TRAIN_STABLE_ROUNDS; r++) {
+                low = history[r] < low ? history[r] : low;
+                high = history[r] > high ? history[r] : high;
+            }
+            if (high - low < 0.003) {
+                printf("survival stable over %d rounds\n", TRAIN_STABLE_ROUNDS);
+                break;
+            }
+        }
+        train.epsilon = train.epsilon * 0.85 > 0.02 ? train.epsilon * 0.85 : 0.02;
+    }
+
+    qtable_destroy(table);
+    return 0;
+}
+
+// Computer player for the interactive game that types its answers, so the
+// transcript reads as if someone had entered them
+static int announce(int answer) {
+    printf("%d\n", answer);
+    return answer;
+}
+
+static int announced_turn_action(const GameState* game, int fort_open, void* ctx) {
+    const Policy* player = (const Policy*)ctx;
+    int action = player->turn_action(game, fort_open, player->ctx);
+    return announce(fort_open ? action : action - 1) + (fort_open ? 0 : 1);
+}
+
+static int announced_eating_level(const GameState* game, void* ctx) {
+    const Policy* player = (const Policy*)ctx;
+    return announce(player->eating_level(game, player->ctx));
+}
+
+static int announced_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    const Policy* player = (const Policy*)ctx;
+    return announce(player->rider_tactic(game, hostile, player->ctx));
+}
+
+static int announced_fort_purchase(const GameState* game, int item, void* ctx) {
+    const Policy* player = (const Policy*)ctx;
+    return announce(player->fort_purchase(game, item, player->ctx));
+}
+
+static int announced_shot_result(int skill_level, const char* word, void* ctx) {
+    const Policy* player = (const Policy*)ctx;
+    printf("%s\n", word);
+    return player->shot_result(skill_level, word, player->ctx);
+}
+
+// play: the interactive game with a computer player making the trip decisions,
+// or with the keyboard player and a hint from the advisor at every prompt
+static int command_play(int argc, char** argv) {
+    SimOptions options;
+    int advise = 0;
+    int computer = 0;
+    double budget = ADVISOR_DEFAULT_BUDGET;
+    const char* scores = NULL;
+    const char* odds = NULL;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            computer |= strcmp(argv[i - 1], "--policy") == 0 || strcmp(argv[i - 1], "--ai") == 0;
+        } else if (strcmp(argv[i], "--advise") == 0) {
+            advise = 1;
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = atof(argv[++i]) / 1e3;
+        } else if (strcmp(argv[i], "--scores") == 0 && i + 1 < argc) {
+            scores = argv[++i];
+        } else if (strcmp(argv[i], "--odds") == 0 && i + 1 < argc) {
+            odds = argv[++i];
+        } else {
+            fprintf(stderr, "usage: oregon_sim play [--policy NAME | --ai FILE] [--advise [--budget MS]] "
+                    "[--odds TABLE] [--scores LOG]\n");
+            return 2;
+        }
+    }
+
+    const Policy* player = &human_policy;
+    Policy announced = {
+        options.job.policy->name, announced_turn_action, announced_eating_level,
+        announced_rider_tactic, announced_fort_purchase, announced_shot_result,
+        (void*)options.job.policy
+    };
+    if (computer) {
+        player = &announced;
+    }
+
+    Advisor* advisor = NULL;
+    Policy advised;
+    if (advise) {
+        // Rollouts beyond the tree follow the learned player when one is loaded
+        advisor = advisor_create(options.job.threads, budget,
+                                 options.ai_table ? &options.ai_policy : &cautious_policy);
+        if (!advisor) {
+            fprintf(stderr, "cannot start the advisor\n");
+            return 1;
+        }
+        advisor_wrap_policy(advisor, player, &advised);
+        player = &advised;
+    }
+
+    // Odds from a prebuilt table: no search, no startup work beyond the mapping
+    SurrogateTable table;
+    SurrogateHint hint;
+    Policy hinted;
+    if (odds) {
+        char error[80];
+        if (surrogate_open(&table, odds, error, sizeof(error)) != 0) {
+            fprintf(stderr, "%s: %s\n", odds, error);
+            return 1;
+        }
+        surrogate_wrap_policy(&hint, &table, player, &hinted);
+        player = &hinted;
+    }
+
+    if (scores && score_log_record_games(scores) != 0) {
+        fprintf(stderr, "%s: cannot open score log\n", scores);
+        return 1;
+    }
+    set_player_policy(player);
+    play_game(); // Exits when the trip ends
+    advisor_destroy(advisor);
+    return 0;
+}
+
+// text-dump: every game text message as this build prints it, for comparing
+// the plain and packed text tables
+static int command_text_dump(int argc, char** argv) {
+    if (argc != 0) {
+        fprintf(stderr, "usage: oregon_sim text-dump\n");
+        return 2;
+    }
+    for (int id = 0; id < TEXT_COUNT; id++) {
+        printf("%d:", id);
+        game_print_text(id);
+        printf("\n");
+    }
+    return 0;
+}
+
+// trail-dump [FILE]: the compiled segment table of a trail, or of the default
+static int command_trail_dump(int argc, char** argv) {
+    static Trail trail;
+    char error[80];
+
+    if (argc > 1) {
+        fprintf(stderr, "usage: oregon_sim trail-dump [FILE]\n");
+        return 2;
+    }
+    if (argc == 0) {
+        trail_parse(&trail, trail_default_text, error, sizeof(error));
+    } else if (trail_load(&trail, argv[0], error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", argv[0], error);
+        return 1;
+    }
+    trail_print(stdout, &trail);
+    return 0;
+}
+
+// golden-record FILE: record a corpus of scripted interactive games
+static int command_golden_record(int argc, char** argv) {
+    SimOptions options;
+    GoldenCorpus corpus;
+    GoldenReport report;
+    const char* path = NULL;
+    size_t cases = GOLDEN_DEFAULT_CASES;
+    int digests = 0;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            cases = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--digests") == 0) {
+            digests = 1;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: oregon_sim golden-record FILE [--cases N] [--seed S] [--digests] [--threads N]\n");
+        return 2;
+    }
+
+    memset(&corpus, 0, sizeof(corpus));
+    if (golden_record(&corpus, cases, options.job.first_seed, options.job.threads, &report) != 0 ||
+        (digests ? golden_save_digests(&corpus, path) : golden_save(&corpus, path)) != 0) {
+        perror(path);
+        golden_free(&corpus);
+        return 1;
+    }
+    printf("recorded %zu cases in %.3f s\n", corpus.count, report.seconds);
+    golden_print_coverage(stdout, &report.coverage);
+    golden_free(&corpus);
+    return 0;
+}
+
+// golden-check [FILE]: replay a corpus and diff every transcript against it
+static int command_golden_check(int argc, char** argv) {
+    SimOptions options;
+    GoldenCorpus corpus;
+    GoldenReport report;
+    const char* path = GOLDEN_DEFAULT_CORPUS;
+    int have_path = 0;
+    int max_diffs = 10;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--diffs") == 0 && i + 1 < argc) {
+            max_diffs = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !have_path) {
+            path = argv[i];
+            have_path = 1;
+        } else {
+            fprintf(stderr, "usage: oregon_sim golden-check [FILE] [--diffs N] [--threads N]\n");
+            return 2;
+        }
+    }
+
+    if (golden_load(&corpus, path) != 0) {
+        fprintf(stderr, "%s: not a golden transcript corpus\n", path);
+        return 1;
+    }
+    if (corpus.digests_only && corpus.rules_revision != OREGON_RULES_REVISION) {
+        printf("%s was recorded under rules revision %d, these are revision %d: expect failures\n", path,
+               corpus.rules_revision, OREGON_RULES_REVISION);
+    }
+    if (golden_check(&corpus, options.job.threads, stdout, max_diffs, &report) != 0) {
+        fprintf(stderr, "out of memory\n");
+        golden_free(&corpus);
+        return 1;
+    }
+    printf("%zu passed, %zu failed in %.3f s (%d threads)\n", report.passed, report.failed,
+           report.seconds, options.job.threads);
+    int missed = golden_print_coverage(stdout, &report.coverage);
+    golden_free(&corpus);
+    return report.failed || missed ? 1 : 0;
+}
+
+// world: many wagons on one trail at once, sharing finite fort inventories
+#define WORLD_DEFAULT_STOCK 4       // Goods of each item per wagon a fort holds
+static void print_world_forts(const World* world, int limited) {
+    static const char* const item_names[ITEM_COUNT] = {"food", "ammunition", "clothing", "misc"};
+
+    printf("%-24s %-10s %10s %12s %8s\n", "fort", "item", "stock", "sold", "price");
+    for (int f = 0; f < world_fort_count(world); f++) {
+        const WorldFort* fort = world_fort(world, f);
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            char stock[24] = "-";
+            if (limited) {
+                snprintf(stock, sizeof(stock), "%lld", (long long)fort->stock[item]);
+            }
+            printf("%-24s %-10s %10s %12llu %8.3f\n", item ? "" : fort->name, item_names[item],
+                   stock, (unsigned long long)fort->sold[item],
+                   (double)fort->price[item] / WORLD_PRICE_ONE);
+        }
+        printf("%-24s %llu stops, %llu item bids rationed\n", "", (unsigned long long)fort->visits,
+               (unsigned long long)fort->rationed);
+    }
+}
+
+static int command_world(int argc, char** argv) {
+    SimOptions options;
+    WorldConfig config;
+    WorldTickReport report;
+    BatchStats stats;
+    long long wagons = 100000, stock = -1, restock = -1;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--wagons") == 0 && i + 1 < argc) {
+            wagons = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--stock") == 0 && i + 1 < argc) {
+            stock = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--restock") == 0 && i + 1 < argc) {
+            restock = atoll(argv[++i]);
+        } else {
+            wagons = 0;
+            break;
+        }
+    }
+    if (wagons < 1 || wagons > (long long)SEED_MASK) {
+        fprintf(stderr, "usage: oregon_sim world [--wagons N] [--stock N] [--restock N] [options]\n");
+        return 2;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.plan = options.job.plan;
+    config.policy = options.job.policy;
+    config.first_seed = options.job.first_seed;
+    config.wagons = (uint32_t)wagons;
+    config.threads = options.job.threads;
+    config.stock = stock >= 0 ? stock : WORLD_DEFAULT_STOCK * wagons;
+    config.restock = restock >= 0 ? restock : config.stock / 8;
+    options.job.trips = (uint64_t)wagons;
+    print_job(&options);
+    if (config.stock > 0) {
+        fprintf(stderr, "fort stock %lld per item, restocked %lld per turn\n", (long long)config.stock,
+                (long long)config.restock);
+    } else {
+        fprintf(stderr, "fort stock unlimited\n");
+    }
+
+    World* world = world_create(&config);
+    if (!world) {
+        fprintf(stderr, "invalid purchase plan, or out of memory\n");
+        return 1;
+    }
+    double seconds = 0.0;
+    int status;
+    do {
+        status = world_tick(world, &report);
+        if (status < 0) {
+            fprintf(stderr, "out of memory\n");
+            world_destroy(world);
+            return 1;
+        }
+        seconds += report.seconds;
+        fprintf(stderr, "turn %2u: %8u traveling, %8u arrived, %8u died, %7u fort stops, "
+                "%9llu goods sold, %3llu rationed, %.1f ms\n",
+                report.tick, report.traveling, report.arrived, report.died, report.fort_stops,
+                (unsigned long long)report.goods_sold, (unsigned long long)report.rationed,
+                report.seconds * 1000.0);
+    } while (status > 0);
+
+    world_stats(world, &stats);
+    batch_stats_print(stdout, &stats);
+    print_world_forts(world, config.stock > 0);
+    printf("digest %016llx\n", (unsigned long long)world_digest(world));
+    fprintf(stderr, "%.3f s, %.0f wagon turns/s\n", seconds, (double)stats.turn_sum / seconds);
+    world_destroy(world);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+// shard-worker / shard-run: a batch split over worker processes
+#define SHARD_MAX_COMMANDS 64
+#define SHARD_COMMAND_SIZE 4096
+
+static const char* g_program = "oregon_sim";    // argv[0], to start local workers
+
+// Append a word to a sh command line, single-quoted
+static int append_shell_word(char* command, size_t size, const char* word) {
+    size_t length = strlen(command);
+    if (length + 3 >= size) {
+        return -1;
+    }
+    if (length) {
+        command[length++] = ' ';
+    }
+    command[length++] = '\'';
+    for (; *word; word++) {
+        const char* piece = *word == '\'' ? "'\\''" : NULL;
+        size_t piece_length = piece ? 4 : 1;
+        if (length + piece_length + 2 >= size) {
+            return -1;
+        }
+        memcpy(command + length, piece ? piece : word, piece_length);
+        length += piece_length;
+    }
+    command[length++] = '\'';
+    command[length] = '\0';
+    return 0;
+}
+
+static int command_shard_worker(int argc, char** argv) {
+    SimOptions options;
+    int die_after = 0;
+
+    set_default_options(&options);
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--die-after") == 0 && i + 1 < argc) {
+            die_after = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: oregon_sim shard-worker [--die-after N] [options]\n");
+            return 2;
+        }
+    }
+    int status = shard_worker(&options.job, stdin, stdout, die_after);
+    qtable_destroy(options.ai_table);
+    return status;
+}
+
+static int command_shard_run(int argc, char** argv) {
+    SimOptions options;
+    ShardJob job;
+    ShardReport report;
+    BatchStats stats;
+    const char* commands[SHARD_MAX_COMMANDS];
+    char forwarded[SHARD_COMMAND_SIZE] = "";
+    char* lines[SHARD_MAX_COMMANDS];
+    int command_count = 0, die_after = 0;
+
+    set_default_options(&options);
+    memset(&job, 0, sizeof(job));
+    job.workers = 2;
+    job.max_failures = -1;
+    for (int i = 0; i < argc; i++) {
+        int first = i;
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            // Workers play the same job: pass the shared options on
+            for (int k = first; k <= i; k++) {
+                if (append_shell_word(forwarded, sizeof(forwarded), argv[k]) != 0) {
+                    fprintf(stderr, "options too long\n");
+                    return 2;
+                }
+            }
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            job.workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--worker-cmd") == 0 && i + 1 < argc &&
+                   command_count < SHARD_MAX_COMMANDS) {
+            commands[command_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--shard-trips") == 0 && i + 1 < argc) {
+            job.shard_trips = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--retries") == 0 && i + 1 < argc) {
+            job.max_failures = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            job.shard_timeout = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--die-after") == 0 && i + 1 < argc) {
+            die_after = atoi(argv[++i]);
+        } else {
+            job.workers = 0;
+            break;
+        }
+    }
+    if (job.workers < 1) {
+        fprintf(stderr, "usage: oregon_sim shard-run [--workers N] [--worker-cmd CMD]... "
+                "[--shard-trips N] [--retries N] [--timeout S] [options]\n");
+        return 2;
+    }
+    if (command_count == 0) {
+        commands[command_count++] = NULL; // This program, started locally
+    }
+    if (job.max_failures < 0) {
+        job.max_failures = job.workers;
+    }
+
+    // Each worker command line: CMD shard-worker OPTIONS
+    for (int c = 0; c < command_count; c++) {
+        lines[c] = malloc(SHARD_COMMAND_SIZE);
+        if (!lines[c]) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        lines[c][0] = '\0';
+        if (commands[c]) {
+            snprintf(lines[c], SHARD_COMMAND_SIZE, "%s", commands[c]);
+        } else {
+            append_shell_word(lines[c], SHARD_COMMAND_SIZE, g_program);
+        }
+        size_t length = strlen(lines[c]);
+        int written = snprintf(lines[c] + length, SHARD_COMMAND_SIZE - length, " shard-worker%s%s",
+                               forwarded[0] ? " " : "", forwarded);
+        if (die_after > 0 && written > 0) {
+            length += (size_t)written;
+            snprintf(lines[c] + length, SHARD_COMMAND_SIZE - length, " --die-after %d", die_after);
+        }
+        commands[c] = lines[c];
+    }
+    job.job = options.job;
+    job.worker_commands = commands;
+    job.command_count = command_count;
+    job.log = stderr;
+
+    print_job(&options);
+    fprintf(stderr, "%d workers: %s\n", job.workers, commands[0]);
+    int status = shard_coordinate(&job, &stats, &report);
+    for (int c = 0; c < command_count; c++) {
+        free(lines[c]);
+    }
+    if (status != 0) {
+        return 1;
+    }
+
+    batch_stats_print(stdout, &stats);
+    fprintf(stderr, "%llu shards, %llu reassigned, %d workers lost, %.3f s, %.0f trips/s\n",
+            (unsigned long long)report.shards, (unsigned long long)report.reassigned,
+            report.failures, report.seconds, (double)stats.trips / report.seconds);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+// fuzz / fuzz-replay: coverage-guided search for rare states and broken invariants
+static int command_fuzz(int argc, char** argv) {
+    SimOptions options;
+    FuzzJob job;
+    FuzzReport report;
+
+    set_default_options(&options);
+    memset(&job, 0, sizeof(job));
+    job.seconds = 10.0;
+    job.out_dir = "fuzz-out";
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            job.seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--execs") == 0 && i + 1 < argc) {
+            job.execs = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            job.out_dir = argv[++i];
+        } else {
+            fprintf(stderr, "unexpected argument '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    job.policy = options.job.policy;
+    job.policy_name = options.policy_name;
+    job.plan = options.job.plan;
+    job.first_seed = options.job.first_seed;
+    job.threads = options.job.threads;
+    job.log = stderr;
+
+    print_job(&options);
+    if (fuzz_run(&job, &report) != 0) {
+        return 2;
+    }
+    printf("%llu execs in %.1f s (%.0f/s), corpus %llu, points %d of %d, %d invariants broken\n",
+           (unsigned long long)report.execs, report.seconds, (double)report.execs / report.seconds,
+           (unsigned long long)report.corpus, report.points, report.point_count, report.violations);
+    qtable_destroy(options.ai_table);
+    return report.violations ? 1 : 0;
+}
+
+static int command_fuzz_replay(int argc, char** argv) {
+    SimOptions options;
+    const char* paths[64];
+    int path_count;
+    int status = 0;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, paths, 64, &path_count) != 0 || path_count == 0) {
+        fprintf(stderr, "usage: oregon_sim fuzz-replay FILE... [--ai FILE] [--trail FILE]\n");
+        return 2;
+    }
+    for (int i = 0; i < path_count; i++) {
+        FuzzInput input;
+        char policy_name[256];
+        FILE* file = fopen(paths[i], "r");
+        if (!file) {
+            fprintf(stderr, "%s: cannot open\n", paths[i]);
+            return 2;
+        }
+        int read = fuzz_read_input(file, &input, policy_name, sizeof(policy_name));
+        fclose(file);
+        if (read != 0) {
+            fprintf(stderr, "%s: not a fuzz reproducer\n", paths[i]);
+            return 2;
+        }
+
+        // A built-in policy by its recorded name; a learned one needs --ai
+        const Policy* policy = find_policy(policy_name);
+        if (!policy) {
+            policy = options.job.policy;
+            if (strcmp(policy_name, options.policy_name) != 0) {
+                fprintf(stderr, "%s: recorded with policy %s, replaying with %s\n", paths[i],
+                        policy_name, options.policy_name);
+            }
+        }
+        printf("%s%s\n", i ? "\n" : "", paths[i]);
+        if (fuzz_replay(&input, policy, stdout) != 0) {
+            status = 2;
+        }
+    }
+    qtable_destroy(options.ai_table);
+    return status;
+}
+
+// scenarios: a plan of many batches streamed from a file, results in input order
+static int command_scenarios(int argc, char** argv) {
+    SimOptions options;
+    ScenarioRun run;
+    ScenarioReport report;
+    const char* in_path = NULL;
+    const char* out_path = NULL;
+
+    set_default_options(&options);
+    memset(&run, 0, sizeof(run));
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            run.window = atoi(argv[++i]);
+        } else if (!in_path && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            in_path = argv[i];
+        } else {
+            in_path = NULL;
+            break;
+        }
+    }
+    if (!in_path || run.window < 0) {
+        fprintf(stderr, "usage: oregon_sim scenarios FILE|- [--out FILE] [--window N] [options]\n");
+        return 2;
+    }
+    FILE* in = strcmp(in_path, "-") == 0 ? stdin : fopen(in_path, "r");
+    if (!in) {
+        fprintf(stderr, "%s: cannot open\n", in_path);
+        return 2;
+    }
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "%s: cannot create\n", out_path);
+        return 2;
+    }
+    run.defaults = options.job;
+
+    print_job(&options);
+    int status = run_scenarios(in, out, &run, &report);
+    if (status != 0) {
+        fprintf(stderr, "cannot set up the scenario threads\n");
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "%s: write failed\n", out_path);
+        status = -1;
+    }
+    if (status != 0) {
+        return 2;
+    }
+    fprintf(stderr, "%llu scenarios, %llu errors, %llu trips in %.3f s, %.0f trips/s\n",
+            (unsigned long long)report.scenarios, (unsigned long long)report.errors,
+            (unsigned long long)report.trips, report.seconds, (double)report.trips / report.seconds);
+    qtable_destroy(options.ai_table);
+    return report.errors ? 1 : 0;
+}
+
+// surrogate-build / surrogate-odds: the precomputed odds table behind play --odds
+static int command_surrogate_build(int argc, char** argv) {
+    SimOptions options;
+    SurrogateJob job;
+    SurrogateReport report;
+    const char* path = NULL;
+
+    set_default_options(&options);
+    options.job.policy = &cautious_policy; // As the advisor's rollouts
+    options.policy_name = cautious_policy.name;
+    options.job.trips = 20000;
+    memset(&job, 0, sizeof(job));
+    job.rollouts = 4;
+    job.min_rollouts = 24;
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--rollouts") == 0 && i + 1 < argc) {
+            job.rollouts = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-rollouts") == 0 && i + 1 < argc) {
+            job.min_rollouts = atoi(argv[++i]);
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path || job.rollouts < 1 || job.min_rollouts < 1) {
+        fprintf(stderr, "usage: oregon_sim surrogate-build FILE [--trips N] [--rollouts R] "
+                "[--min-rollouts N] [options]\n");
+        return 2;
+    }
+    job.policy = options.job.policy;
+    job.policy_name = options.policy_name;
+    job.shooting_skill = options.job.plan.shooting_skill;
+    job.first_seed = options.job.first_seed;
+    job.trips = options.job.trips;
+    job.threads = options.job.threads;
+
+    fprintf(stderr, "rollouts by %s, skill %d, %llu sampled trips from seed %u, %d rollouts per action\n",
+            options.policy_name, job.shooting_skill, (unsigned long long)job.trips, job.first_seed,
+            job.rollouts);
+    if (surrogate_build(&job, path, &report) != 0) {
+        fprintf(stderr, "%s: cannot build the table\n", path);
+        return 1;
+    }
+    printf("%llu prompts, %llu rollouts, %llu states known, %.1f s (%.0f rollouts/s)\n",
+           (unsigned long long)report.prompts, (unsigned long long)report.rollouts,
+           (unsigned long long)report.known_states, report.seconds,
+           (double)report.rollouts / report.seconds);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+static int command_surrogate_odds(int argc, char** argv) {
+    static const char* const names[SURROGATE_ACTIONS] = {"fort", "hunt", "continue"};
+    SurrogateTable table;
+    GameState game;
+    SimOptions options;
+    int fort_open = 0;
+    char error[80];
+
+    if (argc < 1) {
+        fprintf(stderr, "usage: oregon_sim surrogate-odds TABLE [turn=N] [miles=N] [food=N] [bullets=N] "
+                "[clothing=N] [misc=N] [cash=N] [fort=0|1] [--trail FILE]\n");
+        return 2;
+    }
+    set_default_options(&options);
+    memset(&game, 0, sizeof(game));
+    for (int i = 1; i < argc; i++) {
+        char key[16];
+        int value;
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue; // --trail picks the trail the table must have been built on
+        }
+        if (sscanf(argv[i], "%15[a-z]=%d", key, &value) != 2) {
+            fprintf(stderr, "expected key=value, got '%s'\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(key, "turn") == 0) {
+            game.turn_number = value;
+        } else if (strcmp(key, "miles") == 0) {
+            game.miles_traveled = value;
+        } else if (strcmp(key, "food") == 0) {
+            game.food = value;
+        } else if (strcmp(key, "bullets") == 0) {
+            game.bullets = value;
+        } else if (strcmp(key, "clothing") == 0) {
+            game.clothing = value;
+        } else if (strcmp(key, "misc") == 0) {
+            game.misc_supplies = value;
+        } else if (strcmp(key, "cash") == 0) {
+            game.cash = value;
+        } else if (strcmp(key, "fort") == 0) {
+            fort_open = value != 0;
+        } else {
+            fprintf(stderr, "unknown key '%s'\n", key);
+            return 2;
+        }
+    }
+    if (surrogate_open(&table, argv[0], error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", argv[0], error);
+        return 1;
+    }
+    game.shooting_skill = (int)table.header->shooting_skill;
+
+    printf("table: rollouts by %s, skill %u, %llu trips, %llu rollouts\n", table.header->policy,
+           table.header->shooting_skill, (unsigned long long)table.header->trips,
+           (unsigned long long)table.header->rollouts);
+    for (int action = fort_open ? ACTION_FORT : ACTION_HUNT; action <= ACTION_CONTINUE; action++) {
+        SurrogateOdds odds;
+        surrogate_odds(&table, &game, action, &odds);
+        if (!odds.known) {
+            printf("%-9s no estimate\n", names[action - ACTION_FORT]);
+            continue;
+        }
+        printf("%-9s survival %.3f, arrival turn %.1f%s\n", names[action - ACTION_FORT], odds.survival,
+               odds.arrival_turn, odds.known == 1 ? " (coarse: turn and miles only)" : "");
+    }
+    surrogate_close(&table);
+    return 0;
+}
+
+// tournament: race players and purchase splits, dropping the clearly beaten
+static const char* const tournament_splits[] = {
+    "250,180,50,110,60", "220,200,40,100,80", "300,150,40,100,60",
+    "200,250,60,90,50", "280,120,80,100,70", "250,100,50,150,100"
+};
+
+#define TOURNAMENT_SPLIT_COUNT (int)(sizeof(tournament_splits) / sizeof(tournament_splits[0]))
+
+// An entry POLICY[:O,F,A,C,M], where POLICY is built in or "learned" for --ai
+static int parse_tournament_entry(const SimOptions* options, const char* text, TournamentEntry* entry) {
+    char name[32];
+    const char* colon = strchr(text, ':');
+    size_t length = colon ? (size_t)(colon - text) : strlen(text);
+
+    memset(entry, 0, sizeof(*entry));
+    if (length >= sizeof(name)) {
+        return -1;
+    }
+    memcpy(name, text, length);
+    name[length] = '\0';
+    entry->policy = strcmp(name, "learned") == 0 && options->ai_table ? &options->ai_policy : find_policy(name);
+    entry->plan = options->job.plan;
+    if (!entry->policy) {
+        return -1;
+    }
+    if (colon) {
+        PurchasePlan* plan = &entry->plan;
+        if (sscanf(colon + 1, "%d,%d,%d,%d,%d", &plan->oxen, &plan->food, &plan->ammunition,
+                   &plan->clothing, &plan->misc_supplies) != 5) {
+            return -1;
+        }
+    }
+    snprintf(entry->name, sizeof(entry->name), "%s %d,%d,%d,%d,%d", name, entry->plan.oxen,
+             entry->plan.food, entry->plan.ammunition, entry->plan.clothing, entry->plan.misc_supplies);
+    return 0;
+}
+
+static int command_tournament(int argc, char** argv) {
+    SimOptions options;
+    TournamentJob job;
+    TournamentReport report;
+    static TournamentEntry entries[TOURNAMENT_MAX_ENTRIES];
+    const char* texts[TOURNAMENT_MAX_ENTRIES];
+    int text_count = 0;
+
+    set_default_options(&options);
+    options.job.trips = 200000;
+    memset(&job, 0, sizeof(job));
+    job.delta = 0.05;
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc) {
+            job.block = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--delta") == 0 && i + 1 < argc) {
+            job.delta = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && text_count < TOURNAMENT_MAX_ENTRIES) {
+            texts[text_count++] = argv[i];
+        } else {
+            job.delta = 0.0;
+            break;
+        }
+    }
+    if (job.delta <= 0.0 || job.delta >= 1.0) {
+        fprintf(stderr, "usage: oregon_sim tournament [POLICY[:O,F,A,C,M]]... [--block N] [--delta D] "
+                "[--trips N] [options]\n");
+        return 2;
+    }
+
+    // Without entries: every built-in policy with each of a few purchase splits
+    int count = 0;
+    if (text_count == 0) {
+        for (int p = 0; p < policy_count(); p++) {
+            for (int k = 0; k < TOURNAMENT_SPLIT_COUNT; k++) {
+                char text[64];
+                snprintf(text, sizeof(text), "%s:%s", policy_by_id(p)->name, tournament_splits[k]);
+                parse_tournament_entry(&options, text, &entries[count++]);
+            }
+        }
+    }
+    for (int t = 0; t < text_count; t++) {
+        if (parse_tournament_entry(&options, texts[t], &entries[count]) != 0 ||
+            apply_purchase_plan(&(GameState){0}, &entries[count].plan) != 0) {
+            fprintf(stderr, "%s: expected POLICY[:OXEN,FOOD,AMMUNITION,CLOTHING,MISC] with a valid plan\n",
+                    texts[t]);
+            return 2;
+        }
+        count++;
+    }
+    job.entries = entries;
+    job.entry_count = count;
+    job.first_seed = options.job.first_seed;
+    job.max_trips = options.job.trips;
+    job.threads = options.job.threads;
+    job.generic = options.job.generic;
+    job.log = stderr;
+
+    fprintf(stderr, "%d entries, skill %d, seeds from %u, at most %llu trips each, delta %g\n", count,
+            options.job.plan.shooting_skill, job.first_seed, (unsigned long long)job.max_trips, job.delta);
+    if (run_tournament(&job, &report) != 0) {
+        fprintf(stderr, "cannot run the tournament\n");
+        return 1;
+    }
+
+    printf("rank  %-32s %9s  %-17s  %-15s  %s\n", "entry", "trips", "survival (95%)", "arrival day",
+           "standing");
+    for (int rank = 1; rank <= count; rank++) {
+        const TournamentEntry* entry = NULL;
+        for (int e = 0; e < count && !entry; e++) {
+            entry = entries[e].rank == rank ? &entries[e] : NULL;
+        }
+        const BatchStats* stats = &entry->stats;
+        double p = (double)stats->arrived / (double)stats->trips;
+        printf("%4d  %-32s %9llu  %.4f +- %.4f  ", rank, entry->name, (unsigned long long)stats->trips, p,
+               1.96 * sqrt(p * (1.0 - p) / (double)stats->trips));
+        if (stats->arrived > 1) {
+            double n = (double)stats->arrived;
+            double mean = (double)stats->arrival_day_sum / n;
+            double variance = ((double)stats->arrival_day_sq_sum - n * mean * mean) / (n - 1.0);
+            printf("%6.1f +- %-5.1f  ", mean, 1.96 * sqrt(variance > 0.0 ? variance / n : 0.0));
+        } else {
+            printf("%-15s  ", "-");
+        }
+        if (entry->dropped_round) {
+            printf("dropped in round %d, beaten by %s\n", entry->dropped_round,
+                   entries[entry->dropped_by].name);
+        } else if (rank < count) {
+            printf("above #%d with confidence %.3f\n", rank + 1, entry->confidence);
+        } else {
+            printf("finished\n");
+        }
+    }
+    printf("%llu trips in %d rounds, %.1f s; a fixed design plays %llu (%.0f%% saved); "
+           "every drop holds with confidence %.3f\n",
+           (unsigned long long)report.trips, report.rounds, report.seconds,
+           (unsigned long long)report.fixed_trips,
+           100.0 * (1.0 - (double)report.trips / (double)report.fixed_trips), 1.0 - job.delta);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+// packed-bench: a population in the struct layout and in packed states, its
+// memory, scan and gather times, and cache misses where perf counters allow
+typedef struct {
+    int fd;                     // -1 if hardware counters are unavailable
+} CacheCounter;
+
+static void cache_counter_open(CacheCounter* counter) {
+    counter->fd = -1;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counter->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void cache_counter_start(CacheCounter* counter) {
+#ifdef __linux__
+    if (counter->fd >= 0) {
+        ioctl(counter->fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter->fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    (void)counter;
+}
+
+// Misses since cache_counter_start, -1 if not counted
+static long long cache_counter_stop(CacheCounter* counter) {
+    long long misses = -1;
+#ifdef __linux__
+    if (counter->fd >= 0) {
+        ioctl(counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter->fd, &misses, sizeof(misses)) != (ssize_t)sizeof(misses)) {
+            misses = -1;
+        }
+    }
+#endif
+    (void)counter;
+    return misses;
+}
+
+// Run one layout's totals passes; prints the rate and misses per state
+static void bench_totals(const char* name, const PackedPopulation* population, const uint32_t* index,
+                         int passes, CacheCounter* counter, StateTotals* totals) {
+    size_t count = (size_t)population->count;
+    size_t state_bytes = population->states ? sizeof(PackedGameState) : sizeof(GameState);
+    double best = 0.0;
+    long long misses = -1;
+
+    for (int pass = 0; pass < passes; pass++) {
+        memset(totals, 0, sizeof(*totals));
+        cache_counter_start(counter);
+        double start = now_seconds();
+        if (population->states) {
+            packed_totals(population->states, index, count, totals);
+        } else {
+            game_state_totals(population->plain, index, count, totals);
+        }
+        double elapsed = now_seconds() - start;
+        long long pass_misses = cache_counter_stop(counter);
+        if (pass == 0 || elapsed < best) {
+            best = elapsed;
+            misses = pass_misses;
+        }
+    }
+    fprintf(stderr, "  %-8s %-7s %8.1f ms, %6.0f Mstates/s, %6.2f GB/s of states",
+            name, index ? "gather" : "scan", best * 1000.0, (double)count / best / 1e6,
+            (double)count * (double)state_bytes / best / 1e9);
+    if (misses >= 0) {
+        fprintf(stderr, ", %.3f cache misses/state", (double)misses / (double)count);
+    }
+    fprintf(stderr, "\n");
+}
+
+static int command_packed_bench(int argc, char** argv) {
+    SimOptions options;
+    PackedPopulation populations[2];
+    BatchStats stats[2], batch;
+    StateTotals totals[2][2];
+    const char* layout_names[2] = {"struct", "packed"};
+    double step_seconds[2] = {0.0, 0.0};
+    CacheCounter counter;
+    int turns = 6, passes = 3;
+
+    set_default_options(&options);
+    options.job.trips = 16000000;
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--turns") == 0 && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else {
+            passes = 0;
+            break;
+        }
+    }
+    if (passes < 1 || turns < 0 || options.job.trips < 1 || options.job.trips > UINT32_MAX) {
+        fprintf(stderr, "usage: oregon_sim packed-bench [--trips N] [--turns T] [--passes P] [options]\n");
+        return 2;
+    }
+    options.job.generic = 1;
+    print_job(&options);
+
+    for (int layout = 0; layout < 2; layout++) {
+        if (packed_population_init(&populations[layout], &options.job.plan, options.job.first_seed,
+                                   options.job.trips, layout == 0) != 0) {
+            fprintf(stderr, "invalid purchase plan, or out of memory\n");
+            packed_population_free(&populations[0]);
+            return 1;
+        }
+        memset(&stats[layout], 0, sizeof(BatchStats));
+    }
+    fprintf(stderr, "%llu trips: struct %zu MB, packed %zu MB (%zu and %zu bytes a state)\n",
+            (unsigned long long)options.job.trips, packed_population_bytes(&populations[0]) >> 20,
+            packed_population_bytes(&populations[1]) >> 20, sizeof(GameState), sizeof(PackedGameState));
+
+    // Step both to the snapshot turn, measure the queries there, then play on to the end
+    uint32_t* index = malloc((size_t)options.job.trips * sizeof(uint32_t));
+    int status = index ? 1 : -1;
+    for (int turn = 0; status > 0; turn++) {
+        if (turn == turns) {
+            uint64_t state = 0x9e3779b97f4a7c15ull;
+            size_t count = (size_t)options.job.trips;
+            for (size_t i = 0; i < count; i++) {
+                index[i] = (uint32_t)i;
+            }
+            for (size_t i = count - 1; i > 0; i--) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                size_t j = (size_t)((state >> 33) % (i + 1));
+                uint32_t swap = index[i];
+                index[i] = index[j];
+                index[j] = swap;
+            }
+            cache_counter_open(&counter);
+            fprintf(stderr, "totals over every state after turn %d, best of %d passes%s:\n", turns, passes,
+                    counter.fd >= 0 ? "" : " (no hardware cache counters here)");
+            for (int order = 0; order < 2; order++) {
+                for (int layout = 0; layout < 2; layout++) {
+                    bench_totals(layout_names[layout], &populations[layout], order ? index : NULL, passes,
+                                 &counter, &totals[order][layout]);
+                }
+            }
+            if (counter.fd >= 0) {
+                close(counter.fd);
+            }
+            fprintf(stderr, "%llu states, %llu with a fort open\n", (unsigned long long)totals[0][1].states,
+                    (unsigned long long)totals[0][1].fort_open);
+        }
+        int traveling = 0;
+        for (int layout = 0; layout < 2 && status > 0; layout++) {
+            double start = now_seconds();
+            int step = packed_population_step(&populations[layout], options.job.policy, options.job.threads,
+                                              &stats[layout]);
+            step_seconds[layout] += now_seconds() - start;
+            status = step < 0 ? -1 : status;
+            traveling |= step > 0;
+        }
+        status = status < 0 ? -1 : traveling;
+    }
+    free(index);
+    if (status < 0) {
+        fprintf(stderr, "out of memory\n");
+        packed_population_free(&populations[0]);
+        packed_population_free(&populations[1]);
+        return 1;
+    }
+    for (int layout = 0; layout < 2; layout++) {
+        fprintf(stderr, "%-8s stepped to the end in %.3f s, %.0f turns/s\n", layout_names[layout],
+                step_seconds[layout], (double)stats[layout].turn_sum / step_seconds[layout]);
+    }
+
+    options.job.trips = populations[0].count;
+    run_batch(&options.job, &batch);
+    batch_stats_print(stdout, &stats[1]);
+    int same = memcmp(&stats[0], &stats[1], sizeof(BatchStats)) == 0 &&
+               memcmp(&stats[1], &batch, sizeof(BatchStats)) == 0 &&
+               memcmp(&totals[0][0], &totals[0][1], sizeof(StateTotals)) == 0 &&
+               memcmp(&totals[1][0], &totals[1][1], sizeof(StateTotals)) == 0;
+    printf("%llu states did not pack\n", (unsigned long long)populations[1].overflows);
+    printf("packed, struct and batch statistics and totals %s\n", same ? "identical" : "differ");
+    packed_population_free(&populations[0]);
+    packed_population_free(&populations[1]);
+    qtable_destroy(options.ai_table);
+    return same && populations[1].overflows == 0 ? 0 : 1;
+}
+
+// sensitivity: survival per dollar of each purchase, per skill level and per
+// point of each event threshold, from one pass over the seeds
+static int command_sensitivity(int argc, char** argv) {
+    SimOptions options;
+    SensitivityJob job;
+    SensitivityReport report;
+    int step = 10;
+
+    set_default_options(&options);
+    options.job.trips = 200000;
+    for (int i = 0; i < argc; i++) {
+        int status = parse_common_option(&options, argc, argv, &i);
+        if (status < 0) {
+            return 2;
+        } else if (status > 0) {
+            continue;
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            step = atoi(argv[++i]);
+        } else {
+            step = 0;
+            break;
+        }
+    }
+    if (step < 1) {
+        fprintf(stderr, "usage: oregon_sim sensitivity [--step DOLLARS] [options]\n");
+        return 2;
+    }
+    print_job(&options);
+
+    memset(&job, 0, sizeof(job));
+    job.plan = options.job.plan;
+    job.policy = options.job.policy;
+    job.first_seed = options.job.first_seed;
+    job.trips = options.job.trips;
+    job.step = step;
+    job.threads = options.job.threads;
+    if (run_sensitivity(&job, &report) != 0) {
+        fprintf(stderr, "invalid purchase plan or step, or out of memory\n");
+        return 2;
+    }
+
+    printf("survival %.4f +- %.4f over %llu seeds\n", report.survival, report.survival_error,
+           (unsigned long long)report.trips);
+    printf("%-51s %5s %9s %12s %10s %7s\n", "parameter", "value", "range", "d survival", "std error", "z");
+    for (int r = 0; r < report.row_count; r++) {
+        const SensitivityRow* row = &report.rows[r];
+        const char* kind = r < SENSITIVITY_DIFFERENCES - 1 ? "buy " : r < SENSITIVITY_DIFFERENCES ? "" : "threshold ";
+        char range[24], name[64];
+        snprintf(name, sizeof(name), "%s%s", kind, row->name);
+        snprintf(range, sizeof(range), "%d..%d", row->low, row->high);
+        if (row->low == row->high) {
+            printf("%-51s %5d %9s %12s\n", name, row->value, range, "-");
+            continue;
+        }
+        printf("%-51s %5d %9s %+12.6f %10.6f %+7.1f  per %s\n", name, row->value, range, row->derivative,
+               row->std_error, row->std_error > 0.0 ? row->derivative / row->std_error : 0.0, row->unit);
+    }
+    fprintf(stderr, "%llu trips in %.3f s, %.0f trips/s\n", (unsigned long long)report.played, report.seconds,
+            (double)report.played / report.seconds);
+    qtable_destroy(options.ai_table);
+    return 0;
+}
+
+// kernel-bench: the job on its trip kernel and on the generic engine
+static int command_kernel_bench(int argc, char** argv) {
+    SimOptions options;
+    BatchStats stats[2];
+    double rate[2];
+    const char* path_names[2] = {"kernel", "generic"};
+    int positional_count;
+
+    set_default_options(&options);
+    if (parse_options(&options, argc, argv, NULL, 0, &positional_count) != 0) {
+        return 2;
+    }
+    options.job.generic = 0;
+    if (!batch_job_kernel(&options.job)) {
+        fprintf(stderr, "no trip kernel for policy %s at skill %d; kernels: continue at skill 1-5\n",
+                options.policy_name, options.job.plan.shooting_skill);
+        return 2;
+    }
+    print_job(&options);
+
+    for (int path = 0; path < 2; path++) {
+        options.job.generic = path;
+        double start = now_seconds();
+        if (run_batch(&options.job, &stats[path]) != 0) {
+            fprintf(stderr, "invalid purchase plan\n");
+            return 2;
+        }
+        double elapsed = now_seconds() - start;
+        rate[path] = (double)stats[path].trips / elapsed;
+        fprintf(stderr, "%-8s %.3f s, %.0f trips/s\n", path_names[path], elapsed, rate[path]);
+    }
+
+    batch_stats_print(stdout, &stats[0]);
+    if (memcmp(&stats[0], &stats[1], sizeof(stats[0])) != 0) {
+        printf("kernel and generic statistics differ\n");
+        batch_stats_print(stdout, &stats[1]);
+        return 1;
+    }
+    printf("kernel and generic statistics identical, kernel %.2fx\n", rate[0] / rate[1]);
+    return 0;
+}
+
+static int command_help(int argc, char** argv);
+
+static const SimCommand commands[] = {
+    {"run", command_run, "play a batch of trips and print outcome statistics; --checkpoint FILE "
+        "[--checkpoint-every S] to resume after a crash or stop, or --cache DIR to answer from "
+        "and store into a result cache, or --telemetry NAME to publish live progress"},
+    {"telemetry", command_telemetry, "NAME [--interval S] [--once]: watch a run --telemetry NAME as it plays: "
+        "progress, queue, per-worker rates and stalls, survival with its interval, causes of death"},
+    {"trace-write", command_trace_write, "FILE: play a batch and archive every turn"},
+    {"trace-scan", command_trace_scan, "FILE: decode a trace archive and summarise each column"},
+    {"trace-index", command_trace_index, "ARCHIVE INDEX: build the query index for an archive"},
+    {"query", command_query, "INDEX TERM...: count matching turns, e.g. turn=8 miles=900..999 food<40"},
+    {"scan", command_scan, "TERM...: find seeds whose trip matches, e.g. turns<=12 riders>=950 south_pass=1"},
+    {"train", command_train, "FILE: self-play training of a learned player (see --ai)"},
+    {"play", command_play, "the interactive game; --policy/--ai to watch a computer player, --advise for hints, "
+        "--odds TABLE for precomputed odds, --scores LOG"},
+    {"arith-record", command_arith_record, "FILE: store every trip's result, for arith-compare"},
+    {"arith-compare", command_arith_compare, "FILE: replay a recording on this engine build and compare outcomes"},
+    {"text-dump", command_text_dump, "print every game text message, one per entry"},
+    {"trail-dump", command_trail_dump, "[FILE]: print a trail's compiled segment table (default trail without FILE)"},
+    {"golden-record", command_golden_record, "FILE: record scripted interactive games as a regression corpus"},
+    {"golden-check", command_golden_check, "[FILE]: replay a corpus (" GOLDEN_DEFAULT_CORPUS " by default) and diff the transcripts (exit 1 on failure or missed coverage)"},
+    {"scores-record", command_scores_record, "LOG: play a batch and append every trip to a score log"},
+    {"scores-index", command_scores_index, "LOG: build the leaderboard index LOG.idx"},
+    {"scores-top", command_scores_top, "LOG BOARD [--skill K] [--top N]: best trips on arrival, cash or miles"},
+    {"scores-rank", command_scores_rank, "LOG BOARD SEED [--skill K]: rank of a seed's trips on a board"},
+    {"world", command_world, "many wagons at once sharing fort stock [--wagons N] [--stock N] [--restock N]"},
+    {"shard-run", command_shard_run, "a batch split into seed shards over worker processes (--workers N, --worker-cmd CMD)"},
+    {"shard-worker", command_shard_worker, "play shards for shard-run over stdin and stdout"},
+    {"fuzz", command_fuzz, "coverage-guided search for rare states and broken invariants (oregon_sim_fuzz) "
+        "[--seconds S] [--execs N] [--out DIR]"},
+    {"fuzz-replay", command_fuzz_replay, "FILE...: play fuzz reproducers turn by turn"},
+    {"scenarios", command_scenarios, "FILE|-: stream a plan of batches, one per line (name= policy= skill= buy= "
+        "seed= trips= trail=), results in input order [--out FILE] [--window N]"},
+    {"surrogate-build", command_surrogate_build, "FILE: precompute the odds table for play --odds "
+        "[--trips N] [--rollouts R] [--min-rollouts N]"},
+    {"surrogate-odds", command_surrogate_odds, "TABLE [turn=N miles=N food=N ...]: look up a state's odds"},
+    {"tournament", command_tournament, "[POLICY[:O,F,A,C,M]]...: race players on shared seeds, dropping "
+        "the clearly beaten [--block N] [--delta D]"},
+    {"packed-bench", command_packed_bench, "a population in 64-byte structs and in 16-byte packed states: memory, "
+        "scan and gather times, checked identical [--turns T] [--passes P]"},
+    {"sensitivity", command_sensitivity, "survival per extra dollar of each purchase and per point of each event "
+        "threshold, with standard errors, in one pass [--step DOLLARS]"},
+    {"kernel-bench", command_kernel_bench, "the job on its trip kernel and on the generic engine, checked identical"},
+    {"help", command_help, "show this list"},
+};
+
+#define COMMAND_COUNT (int)(sizeof(commands) / sizeof(commands[0]))
+
+static int command_help(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    printf("usage: oregon_sim <command> [options]\n\ncommands:\n");
+    for (int i = 0; i < COMMAND_COUNT; i++) {
+        printf("  %-14s %s\n", commands[i].name, commands[i].help);
+    }
+    printf("\nshared options:\n");
+    printf("  --trips N          trips to play (default 1000000)\n");
+    printf("  --seed S           first trip seed (default 1)\n");
+    printf("  --threads N        worker threads (default: online CPUs)\n");
+    printf("  --policy NAME      computer player (default continue)\n");
+    printf("  --ai FILE          learned player from a train checkpoint\n");
+    printf("  --trail FILE       trail map (default: the original trail, see trails/)\n");
+    printf("  --skill K          shooting skill 1-5 (default 2)\n");
+    printf("  --buy O,F,A,C,M    initial purchases in dollars (default 250,180,50,110,60)\n");
+    printf("  --generic          never use a trip kernel (see kernel-bench)\n");
+    printf("\npolicies:\n");
+    list_policies(stdout);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    g_program = argv[0];
+    if (argc < 2) {
+        command_help(0, NULL);
+        return 2;
+    }
+    for (int i = 0; i < COMMAND_COUNT; i++) {
+        if (strcmp(argv[1], commands[i].name) == 0) {
+            return commands[i].run(argc - 2, argv + 2);
+        }
+    }
+    fprintf(stderr, "unknown command '%s'\n", argv[1]);
+    return 2;
+}
@@ -0,0 +1,357 @@
+// Generated by textpack from oregon_text.def; do not edit.
+// 131 messages, 6482 bytes of text in 3764 bytes of code.
+
+#define PACKED_TEXT_MAX_BITS 13
+#define PACKED_TEXT_FORMAT_SIZE 57   // Longest format, with its terminator
+
+static const uint8_t packed_text_counts[PACKED_TEXT_MAX_BITS + 1] = {
+    0x00, 0x00, 0x00, 0x01, 0x07, 0x07, 0x09, 0x02, 0x09, 0x0a, 0x03, 0x08,
+    0x01, 0x06,
+};
+
+static const uint8_t packed_text_symbols[63] = {
+    0x20, 0x41, 0x45, 0x49, 0x4e, 0x4f, 0x53, 0x54, 0x0a, 0x44, 0x48, 0x4c,
+    0x52, 0x55, 0x59, 0x00, 0x2d, 0x42, 0x43, 0x46, 0x47, 0x4d, 0x50, 0x57,
+    0x4b, 0x56, 0x09, 0x21, 0x27, 0x28, 0x29, 0x2c, 0x2e, 0x31, 0x32, 0x24,
+    0x25, 0x30, 0x34, 0x37, 0x38, 0x3f, 0x4a, 0x58, 0x64, 0x33, 0x35, 0x5a,
+    0x22, 0x36, 0x39, 0x65, 0x6e, 0x6f, 0x73, 0x74, 0x72, 0x2f, 0x3a, 0x51,
+    0x63, 0x69, 0x75,
+};
+
+static const uint16_t packed_text_offsets[TEXT_COUNT] = {
+    0, 172, 7519, 8755, 8978, 9032, 9080, 9258,
+    9316, 9520, 9717, 9976, 10229, 10500, 10638, 11060,
+    11300, 11633, 11835, 11935, 12163, 12367, 12571, 12992,
+    13323, 13539, 13777, 13830, 13920, 13954, 14018, 14334,
+    14578, 14746, 14899, 15035, 15194, 15287, 15466, 15710,
+    15954, 16169, 16572, 16778, 17034, 17261, 17434, 17508,
+    17722, 17987, 18227, 18396, 18663, 18856, 19060, 19274,
+    19535, 19640, 19904, 20120, 20359, 20516, 20695, 20902,
+    21050, 21272, 21356, 21614, 21807, 21901, 22114, 22351,
+    22643, 22755, 22895, 23030, 23278, 23426, 23551, 23665,
+    24040, 24256, 24524, 25346, 25526, 25635, 25738, 25839,
+    26070, 26512, 27144, 27238, 27336, 27449, 27552, 27662,
+    27772, 28032, 28160, 28314, 28529, 28554, 28605, 28649,
+    28755, 28809, 28858, 28910, 28951, 28992, 29032, 29079,
+    29122, 29174, 29219, 29275, 29330, 29400, 29469, 29527,
+    29587, 29645, 29710, 29770, 29836, 29870, 29907, 29954,
+    29997, 30032, 30074,
+};
+
+static const uint8_t packed_text_bits[3764] = {
+    0x9b, 0x0c, 0x35, 0xc2, 0x99, 0xcc, 0x22, 0xbc, 0x5a, 0xfa, 0xc2, 0x32,
+    0xb8, 0xf3, 0xc1, 0xbf, 0xfe, 0x95, 0xbd, 0x3f, 0x03, 0x29, 0x45, 0x11,
+    0xc7, 0x36, 0x6d, 0xec, 0x5c, 0x07, 0x4e, 0x2f, 0x52, 0x83, 0x70, 0x42,
+    0x2c, 0x9c, 0x86, 0xee, 0x76, 0x11, 0x43, 0x0d, 0x63, 0xdd, 0x94, 0x45,
+    0x89, 0x2a, 0x36, 0xb3, 0x71, 0x24, 0x59, 0x9f, 0x26, 0xb3, 0x35, 0xd4,
+    0xfd, 0x47, 0x08, 0xee, 0xd7, 0xb2, 0x08, 0x60, 0xd6, 0x3d, 0xd9, 0x46,
+    0xa9, 0x18, 0xf5, 0x0d, 0x63, 0xdd, 0x94, 0x22, 0x8f, 0x7f, 0xbf, 0xd7,
+    0xed, 0xed, 0x2c, 0x35, 0xec, 0x36, 0x2e, 0x12, 0xb8, 0x0d, 0xb0, 0xd9,
+    0x3b, 0x98, 0xe9, 0x2b, 0x51, 0xab, 0x77, 0x3b, 0x08, 0xa1, 0x8f, 0x8f,
+    0xa7, 0xd7, 0xe8, 0x38, 0x4a, 0x98, 0x6b, 0x1e, 0xec, 0xa2, 0x2c, 0x49,
+    0x59, 0x22, 0x8f, 0xe7, 0x3f, 0xee, 0x38, 0x65, 0x8a, 0x38, 0xcf, 0x3c,
+    0xc2, 0x6c, 0x30, 0xd7, 0x1c, 0x17, 0x63, 0x09, 0x00, 0xaa, 0x9d, 0xcf,
+    0xda, 0x52, 0xc3, 0x5c, 0x50, 0xa6, 0x1c, 0xbb, 0x9c, 0xc7, 0xcb, 0xfc,
+    0x7d, 0x3e, 0x82, 0x18, 0x3f, 0x26, 0xb3, 0x1b, 0x35, 0x84, 0x50, 0xc4,
+    0x59, 0x39, 0xf5, 0x04, 0xb3, 0x18, 0x6b, 0xf9, 0x77, 0x31, 0xf9, 0xbb,
+    0xc4, 0x80, 0x1c, 0x92, 0x4c, 0x7c, 0xbe, 0x3e, 0x9f, 0x41, 0xb3, 0x58,
+    0x10, 0xe8, 0xb7, 0x65, 0xf6, 0x96, 0x1a, 0xe3, 0xa4, 0xad, 0x42, 0x99,
+    0xcc, 0x43, 0x07, 0xe4, 0xd6, 0x62, 0x28, 0x62, 0xc6, 0xf0, 0x1b, 0x61,
+    0x86, 0xbd, 0x87, 0x0c, 0xa7, 0x80, 0xca, 0x22, 0x87, 0x20, 0x06, 0xcd,
+    0x5a, 0xb7, 0x48, 0xbb, 0x84, 0x83, 0xe1, 0xff, 0xf7, 0x29, 0x00, 0x00,
+    0x6f, 0xd1, 0xa8, 0xcc, 0x61, 0xae, 0x35, 0x25, 0x0f, 0xc9, 0xac, 0xc7,
+    0xcb, 0xe3, 0xe9, 0xf4, 0xcf, 0xe5, 0xfc, 0x7d, 0x3e, 0x81, 0x94, 0x61,
+    0xaf, 0x61, 0x06, 0x5c, 0x48, 0x00, 0x00, 0x00, 0x00, 0x22, 0x86, 0x38,
+    0x6b, 0x18, 0xc3, 0x5c, 0x3f, 0x26, 0xb3, 0xf5, 0x11, 0x43, 0x1b, 0x13,
+    0xc1, 0xd8, 0x61, 0xaf, 0xe5, 0x5a, 0x8d, 0xda, 0x40, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xd0, 0xf5, 0x2b, 0xb9, 0x8c, 0x35, 0xfc, 0xab, 0x51, 0x42,
+    0xee, 0x63, 0x43, 0x88, 0x3b, 0x02, 0x54, 0xe0, 0xaa, 0xf2, 0x90, 0x00,
+    0x0d, 0x99, 0xa6, 0x33, 0x11, 0x43, 0x1c, 0x35, 0x8c, 0x61, 0xae, 0x28,
+    0x5d, 0xcf, 0xd4, 0x45, 0x0c, 0x54, 0xdd, 0xc6, 0xb4, 0x25, 0xd4, 0xc4,
+    0x50, 0xec, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x38, 0x6d, 0x86,
+    0xe7, 0x10, 0x8b, 0xb8, 0x74, 0xd7, 0xb4, 0xa4, 0x00, 0x00, 0xb8, 0xe2,
+    0xea, 0x90, 0x8c, 0xa3, 0x31, 0xf2, 0xf7, 0x1a, 0x5f, 0x0e, 0x08, 0x68,
+    0x75, 0x80, 0xdb, 0x0f, 0xe7, 0xe8, 0x34, 0xbd, 0x6a, 0x70, 0xf2, 0x00,
+    0x00, 0x00, 0x00, 0x0c, 0x35, 0xc7, 0x49, 0x5a, 0x85, 0x33, 0x98, 0xd2,
+    0xf5, 0xa9, 0xc3, 0x8d, 0x9a, 0xc0, 0xa2, 0x0b, 0x5e, 0xce, 0x34, 0xc0,
+    0x25, 0x4e, 0x0a, 0xaf, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0xcc,
+    0x68, 0x4b, 0x34, 0x87, 0xf5, 0x04, 0xb3, 0x1b, 0x35, 0x85, 0x2e, 0xb0,
+    0x8b, 0xb8, 0xd9, 0x9a, 0x72, 0x90, 0x00, 0x0d, 0x6a, 0xd1, 0x44, 0x5d,
+    0xc6, 0x62, 0x28, 0x8e, 0x11, 0xc1, 0xbf, 0x27, 0xaa, 0x15, 0x6b, 0x80,
+    0x9c, 0x72, 0xd6, 0x82, 0x58, 0x1b, 0x35, 0x84, 0x50, 0xc6, 0xad, 0x59,
+    0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1d, 0x19, 0x45, 0x0e, 0xc3, 0x0d,
+    0x71, 0xd2, 0x56, 0xa0, 0xd7, 0x56, 0xba, 0xc1, 0xd8, 0x75, 0x43, 0x51,
+    0xad, 0x99, 0xdd, 0x17, 0x79, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x28,
+    0x63, 0x86, 0xba, 0xc1, 0x22, 0xbc, 0xa4, 0x00, 0x03, 0x84, 0x7d, 0x4e,
+    0xb5, 0x25, 0x36, 0xbb, 0x87, 0xbf, 0x3c, 0xd5, 0x0d, 0xc6, 0x62, 0x28,
+    0x8e, 0x11, 0x75, 0xad, 0xe6, 0x6e, 0x38, 0x39, 0xa6, 0xa8, 0xa6, 0x09,
+    0x67, 0x20, 0x00, 0x00, 0x00, 0x00, 0x01, 0xa2, 0x87, 0x61, 0x14, 0x45,
+    0xdd, 0xc6, 0x1a, 0xe3, 0xa4, 0xad, 0x42, 0x99, 0xcc, 0x6c, 0xd6, 0x0e,
+    0x9a, 0xf6, 0x53, 0x77, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4b, 0x30,
+    0x7c, 0x1d, 0xb7, 0x35, 0xd7, 0x02, 0xc7, 0xc9, 0x25, 0x9e, 0x52, 0xc3,
+    0x5c, 0x6a, 0x4a, 0x1f, 0x93, 0x59, 0x82, 0xad, 0x46, 0x1a, 0xf6, 0x1c,
+    0x32, 0x9e, 0x06, 0x87, 0xb3, 0x58, 0xc6, 0x1a, 0xe1, 0xe0, 0xad, 0x03,
+    0x0d, 0x7b, 0x08, 0xb2, 0x72, 0x33, 0x93, 0x58, 0x61, 0xae, 0x35, 0x25,
+    0x0e, 0x5d, 0xcc, 0x3b, 0x70, 0x61, 0xb6, 0x18, 0x6b, 0xd8, 0x6a, 0x4f,
+    0x41, 0x0c, 0x1f, 0x93, 0x59, 0x82, 0x81, 0xb3, 0x5a, 0x1c, 0x15, 0x59,
+    0x77, 0x94, 0x50, 0xc7, 0x45, 0x81, 0xd5, 0x0d, 0x46, 0x1a, 0xe2, 0xd7,
+    0x51, 0x56, 0xeb, 0xd8, 0x51, 0xba, 0x3e, 0xe7, 0x6f, 0x50, 0x90, 0x7c,
+    0x38, 0xd5, 0x9e, 0x07, 0x0d, 0x63, 0x05, 0x12, 0x8a, 0x18, 0xd9, 0xad,
+    0x0f, 0xec, 0x30, 0xd7, 0x1a, 0x92, 0x82, 0xab, 0xb0, 0xdd, 0x85, 0x2e,
+    0xb0, 0x8b, 0xb8, 0x2a, 0xb2, 0xee, 0x22, 0x86, 0x3a, 0x2c, 0x08, 0x61,
+    0xb9, 0xc4, 0xb8, 0x6b, 0x18, 0xd9, 0x9a, 0x7e, 0xd2, 0xea, 0x86, 0xa7,
+    0xdc, 0xec, 0x30, 0xd7, 0x14, 0x2e, 0xe6, 0x21, 0x85, 0xdc, 0xc6, 0x1a,
+    0xf6, 0x11, 0x6b, 0xbc, 0x60, 0x59, 0x36, 0xa9, 0x82, 0xab, 0x2e, 0xe2,
+    0x28, 0x63, 0xa2, 0xc7, 0xac, 0xb0, 0xd7, 0x1d, 0x25, 0x6a, 0x34, 0x31,
+    0x0d, 0x59, 0x88, 0x61, 0x18, 0xe4, 0xc2, 0x28, 0x8a, 0x14, 0x0e, 0x9a,
+    0xd3, 0x1e, 0x6c, 0xa6, 0x22, 0x85, 0x01, 0xda, 0xeb, 0x37, 0x15, 0x4e,
+    0xc6, 0x0a, 0x5b, 0xdd, 0x43, 0xd1, 0xa3, 0xd3, 0xd8, 0x45, 0x0c, 0x6c,
+    0x4f, 0x07, 0x61, 0x86, 0xb8, 0x8c, 0x72, 0x61, 0x14, 0x45, 0x0a, 0x07,
+    0x4d, 0x69, 0x82, 0x59, 0x8a, 0x24, 0x08, 0xa1, 0xcb, 0xfb, 0x58, 0xe2,
+    0xf6, 0x5f, 0xec, 0x3b, 0x1e, 0x3d, 0x44, 0x50, 0xc6, 0x87, 0x10, 0x76,
+    0x15, 0xbe, 0xbd, 0x86, 0x1a, 0xfe, 0x55, 0xa8, 0xa1, 0x77, 0x31, 0xd2,
+    0x45, 0x06, 0x1a, 0xf6, 0x1b, 0xdd, 0x7d, 0xa5, 0x22, 0x80, 0x65, 0xad,
+    0x04, 0x5e, 0xcb, 0xea, 0x0a, 0xb5, 0x09, 0x07, 0xc3, 0x82, 0xb1, 0x87,
+    0xa3, 0x74, 0xa1, 0x14, 0x4d, 0xab, 0x52, 0xb0, 0x2e, 0x1a, 0xeb, 0x0f,
+    0x23, 0xfd, 0x6a, 0x7c, 0xc0, 0xd2, 0xf5, 0xa9, 0xc3, 0xcb, 0xaa, 0x1a,
+    0x82, 0x7e, 0xc7, 0x31, 0x0c, 0x0d, 0x60, 0xec, 0x38, 0x65, 0x3c, 0x02,
+    0xe1, 0xae, 0xb0, 0xfe, 0xa2, 0x6c, 0xbe, 0x50, 0x2e, 0xe6, 0x08, 0x7f,
+    0x6f, 0x97, 0xf6, 0xf6, 0x94, 0xb7, 0x66, 0x98, 0xad, 0xf5, 0xed, 0xe3,
+    0xe3, 0xe3, 0x29, 0x65, 0x46, 0xe8, 0x6e, 0xcd, 0x30, 0x41, 0xe8, 0xd0,
+    0x0a, 0xc6, 0x30, 0xd7, 0x1d, 0x24, 0x50, 0x61, 0xaf, 0x61, 0x64, 0xda,
+    0xa7, 0xf8, 0x90, 0x1e, 0x7e, 0xfe, 0x80, 0xb5, 0x31, 0xc1, 0x5b, 0xb3,
+    0xf0, 0x4b, 0xea, 0x07, 0x9f, 0xc7, 0xa0, 0xdd, 0x9a, 0x61, 0xe8, 0xd1,
+    0xea, 0x07, 0x9f, 0xf1, 0xe8, 0x36, 0x24, 0xb0, 0x86, 0x1c, 0x24, 0xe7,
+    0x54, 0x5f, 0x29, 0x00, 0x00, 0x00, 0x0f, 0x3f, 0xaf, 0xa0, 0x53, 0x39,
+    0x8e, 0x1a, 0xc6, 0x39, 0xb1, 0x6b, 0x09, 0xa9, 0xfa, 0x81, 0xe7, 0xfc,
+    0xfa, 0x07, 0xa1, 0x76, 0xc0, 0xec, 0xa6, 0x6f, 0x23, 0x58, 0x3b, 0x06,
+    0x53, 0x0d, 0xb0, 0x8a, 0x18, 0x2d, 0x1b, 0xb9, 0x8c, 0xf3, 0x11, 0x43,
+    0x1a, 0x1c, 0x41, 0xd8, 0x61, 0xae, 0x35, 0xa9, 0x27, 0x03, 0x0d, 0x70,
+    0x56, 0x3f, 0x51, 0x14, 0x39, 0x6c, 0x4f, 0x07, 0x61, 0x86, 0xbf, 0x95,
+    0x6a, 0x28, 0x5d, 0xcc, 0x43, 0x0d, 0x0c, 0x74, 0x91, 0x41, 0x86, 0xbd,
+    0x86, 0xf7, 0x51, 0x0c, 0x34, 0x30, 0xf7, 0xd7, 0x53, 0x77, 0xda, 0xf5,
+    0xf6, 0x96, 0x54, 0x6e, 0x87, 0x17, 0xd6, 0x82, 0x6c, 0x30, 0xd7, 0x1d,
+    0x12, 0xc0, 0x86, 0x0f, 0xc9, 0xac, 0xc3, 0x28, 0xc3, 0x5e, 0xc1, 0xbf,
+    0x46, 0xa2, 0x0c, 0xb8, 0xfc, 0x0c, 0x95, 0xa0, 0x1a, 0xb5, 0xf7, 0xa4,
+    0xb2, 0x86, 0x61, 0xc5, 0xf5, 0xa4, 0xb2, 0xa3, 0x74, 0x38, 0xbe, 0xb4,
+    0x13, 0x61, 0x86, 0xb8, 0xe8, 0x96, 0x04, 0x30, 0x7e, 0x4d, 0x66, 0x19,
+    0x46, 0xcc, 0xd3, 0xfc, 0x0c, 0x93, 0x8e, 0x59, 0xdd, 0x34, 0xa9, 0xcb,
+    0x2a, 0x37, 0x43, 0x8b, 0xeb, 0x41, 0x36, 0x18, 0x6b, 0x8e, 0x89, 0x60,
+    0x43, 0x07, 0xe4, 0xd6, 0x61, 0x94, 0x17, 0x1c, 0x5d, 0x52, 0x11, 0x97,
+    0xf0, 0x32, 0xa3, 0x74, 0x38, 0xbe, 0xb4, 0x13, 0x61, 0x86, 0xb8, 0xe8,
+    0x96, 0x04, 0x30, 0x7e, 0x4d, 0x66, 0x19, 0x46, 0xb5, 0x68, 0xa2, 0x2e,
+    0xff, 0x81, 0x95, 0x1b, 0xa1, 0xc5, 0xf5, 0xa0, 0x9b, 0x0c, 0x35, 0xc7,
+    0x44, 0xb0, 0x21, 0x83, 0xf2, 0x6b, 0x30, 0xca, 0x38, 0x47, 0xd4, 0xeb,
+    0x52, 0x53, 0x6b, 0xb8, 0x7b, 0xf3, 0xcd, 0x50, 0xdf, 0xf0, 0x32, 0xc3,
+    0x5c, 0x37, 0x73, 0xb3, 0xf2, 0x6b, 0x19, 0xe7, 0x86, 0xb8, 0x65, 0xae,
+    0x05, 0x0a, 0x63, 0xe5, 0xf3, 0xfd, 0x88, 0x60, 0xfc, 0x9a, 0xcf, 0xd8,
+    0x69, 0x7c, 0x02, 0xdc, 0x91, 0x65, 0x91, 0x6d, 0x07, 0x60, 0x55, 0xa8,
+    0xc3, 0x5e, 0xc3, 0x9b, 0xdb, 0x5a, 0x13, 0x9b, 0xfa, 0x8c, 0x35, 0xc2,
+    0xb7, 0x42, 0x85, 0xdc, 0xc7, 0xcb, 0xe7, 0xfb, 0x13, 0x6a, 0xd4, 0xac,
+    0xe2, 0xa7, 0xb4, 0x4b, 0x29, 0x70, 0xcb, 0x32, 0xc0, 0xe0, 0xad, 0xad,
+    0x07, 0xc7, 0xf8, 0x1e, 0xff, 0x7f, 0xaf, 0xda, 0x52, 0xcb, 0x0d, 0x71,
+    0x42, 0xee, 0x63, 0x43, 0x35, 0x0c, 0xa2, 0x28, 0x62, 0x2c, 0x49, 0x51,
+    0x0c, 0xc2, 0xac, 0xbb, 0x8c, 0xf3, 0xcf, 0x3c, 0xf3, 0x96, 0x1a, 0xf6,
+    0x1b, 0x17, 0x09, 0x5c, 0x09, 0xa1, 0xb8, 0x45, 0x11, 0x43, 0x1b, 0x25,
+    0x9e, 0x06, 0x95, 0x4f, 0xeb, 0xfa, 0x2b, 0x4c, 0x36, 0xc3, 0xa4, 0x58,
+    0x3b, 0x4b, 0x2c, 0x35, 0xfc, 0xa6, 0x34, 0x38, 0x83, 0xb0, 0x9b, 0x07,
+    0x6e, 0x0c, 0x52, 0xeb, 0x08, 0xbb, 0x86, 0xb0, 0xd2, 0xf8, 0x1b, 0x33,
+    0x4c, 0x3b, 0x32, 0xf8, 0xf8, 0xf8, 0xf8, 0xcb, 0x29, 0xb0, 0xc3, 0x5c,
+    0x74, 0x4b, 0x02, 0x18, 0x79, 0xfb, 0xfa, 0x07, 0x86, 0xe4, 0x14, 0x08,
+    0xa1, 0x85, 0x3f, 0xd4, 0x0d, 0x9a, 0xd1, 0xea, 0x3c, 0xfe, 0x3d, 0x05,
+    0x2e, 0xb1, 0xea, 0x1a, 0xc3, 0xcf, 0xf8, 0xf4, 0x1a, 0xb2, 0xc2, 0x2d,
+    0xce, 0x59, 0x4d, 0x86, 0x1a, 0xe3, 0xa2, 0x58, 0x10, 0xc3, 0xcf, 0xdf,
+    0xd0, 0x52, 0xeb, 0x1e, 0xa1, 0xac, 0x3c, 0xfe, 0x3d, 0x06, 0xac, 0xb0,
+    0x8b, 0x73, 0x96, 0x50, 0xd0, 0x55, 0x1c, 0x25, 0x4c, 0xb7, 0x30, 0x8e,
+    0x3e, 0x7f, 0xb9, 0x65, 0xb3, 0x34, 0xfc, 0x3c, 0x34, 0xbd, 0x6a, 0x70,
+    0xfe, 0x1e, 0x1a, 0xd5, 0xa2, 0x88, 0xbb, 0xf8, 0x70, 0x8f, 0xaf, 0xb0,
+    0x7b, 0xf3, 0xcf, 0xb7, 0x86, 0xa4, 0xf4, 0x96, 0x50, 0xd7, 0xde, 0x99,
+    0xe7, 0x9e, 0x1a, 0xe1, 0x4c, 0xe6, 0x38, 0x6b, 0x18, 0xd2, 0xf5, 0xa9,
+    0xc3, 0x88, 0x61, 0xbb, 0x0a, 0x5d, 0x61, 0x17, 0x79, 0x64, 0x6b, 0x07,
+    0x61, 0xd5, 0x0a, 0x06, 0x1a, 0xe3, 0xa4, 0x7a, 0x08, 0x60, 0xfc, 0x9a,
+    0xcc, 0x32, 0x88, 0xa1, 0x8d, 0x9a, 0xb5, 0x6e, 0x91, 0x77, 0x96, 0x58,
+    0x6b, 0x89, 0xb2, 0xf9, 0x40, 0xa1, 0x77, 0x31, 0x14, 0x28, 0x1c, 0x5f,
+    0x5a, 0x67, 0x9f, 0x63, 0x3e, 0x46, 0x1a, 0xf6, 0x0f, 0xc9, 0xac, 0xd1,
+    0x77, 0x13, 0x6e, 0x96, 0x58, 0x6b, 0x8e, 0x11, 0xdc, 0x61, 0xaf, 0x61,
+    0xad, 0x09, 0x75, 0x31, 0x0c, 0x1f, 0x93, 0x59, 0x86, 0x51, 0x14, 0x28,
+    0x09, 0x07, 0xc4, 0xb2, 0xb2, 0x6f, 0x48, 0x1a, 0x1c, 0x74, 0x66, 0xa2,
+    0x28, 0x60, 0xf0, 0x6f, 0x9e, 0x79, 0xe1, 0xae, 0x37, 0x68, 0x04, 0x34,
+    0x4d, 0xc3, 0x29, 0xf8, 0xf8, 0xf8, 0xf8, 0xcb, 0x6b, 0xd6, 0xa3, 0x43,
+    0xad, 0x50, 0xdc, 0x43, 0x2a, 0x6f, 0x48, 0xf1, 0x96, 0x58, 0x6b, 0x8e,
+    0x11, 0xdc, 0xe7, 0x9e, 0x79, 0x92, 0xcc, 0x61, 0xaf, 0x61, 0x34, 0x55,
+    0x3b, 0x0d, 0xda, 0x01, 0x74, 0x58, 0xf6, 0xf6, 0xf6, 0xf6, 0xf6, 0x96,
+    0x4a, 0x9a, 0x98, 0x7a, 0x34, 0x67, 0x9d, 0x93, 0x7a, 0x40, 0x65, 0x10,
+    0x56, 0xdc, 0xe3, 0x3c, 0xf7, 0x66, 0x98, 0x32, 0x84, 0x5f, 0x21, 0x0c,
+    0xa9, 0xbd, 0x23, 0xc7, 0xc6, 0x59, 0x46, 0x39, 0x31, 0xf3, 0xff, 0x92,
+    0xca, 0xc9, 0x33, 0xb3, 0x82, 0xa1, 0x94, 0xfd, 0x84, 0x50, 0xf0, 0x32,
+    0x9b, 0x2f, 0x94, 0x0c, 0xaa, 0xcd, 0xd8, 0x51, 0x9e, 0x12, 0xa7, 0x2c,
+    0xa0, 0xb5, 0x84, 0xd5, 0xe5, 0xe7, 0xef, 0xe8, 0x2d, 0x75, 0x03, 0xcf,
+    0xe3, 0xd0, 0x14, 0x41, 0x6b, 0xd8, 0x0f, 0x3f, 0xe3, 0xd0, 0x6a, 0xcb,
+    0x08, 0xb7, 0x30, 0x3c, 0xfe, 0xbe, 0x83, 0x54, 0xb6, 0xb5, 0x31, 0xd1,
+    0x6e, 0xca, 0xf2, 0xca, 0xc9, 0x33, 0xb3, 0x8e, 0x8e, 0xc6, 0x36, 0xb2,
+    0x1a, 0xce, 0xb8, 0xf5, 0x1a, 0x5e, 0x06, 0xb4, 0x3d, 0x7b, 0x0d, 0x9a,
+    0xc3, 0x96, 0x77, 0x4d, 0x2a, 0x62, 0xac, 0xee, 0x6f, 0x2c, 0x95, 0x35,
+    0x30, 0xf4, 0x66, 0x84, 0x5d, 0xf3, 0xcf, 0x3c, 0x35, 0xc4, 0xec, 0xdd,
+    0xcc, 0x45, 0x0f, 0x80, 0xdb, 0x6d, 0x2c, 0xbb, 0x22, 0xcc, 0x83, 0xd5,
+    0xba, 0x1d, 0x24, 0x50, 0x61, 0xaf, 0x61, 0xab, 0x56, 0x07, 0xb7, 0xd7,
+    0xf9, 0x96, 0x55, 0x6b, 0xbe, 0x03, 0xd1, 0xa3, 0x3c, 0xf3, 0xc3, 0x5c,
+    0x6e, 0xd0, 0x3b, 0x2a, 0x6c, 0x73, 0x96, 0x58, 0x6b, 0x8a, 0x17, 0x73,
+    0x10, 0xc1, 0xcc, 0xc3, 0x57, 0xc8, 0x4d, 0xb5, 0x1a, 0x54, 0x97, 0x5a,
+    0x15, 0xa7, 0x2c, 0xa2, 0x87, 0x81, 0x34, 0x98, 0x56, 0x80, 0x51, 0x05,
+    0xaf, 0x69, 0x65, 0x64, 0x99, 0xd9, 0xc7, 0x47, 0x63, 0x14, 0x67, 0x84,
+    0xa9, 0xe7, 0x9e, 0xb4, 0x3d, 0x7b, 0x0d, 0x9a, 0xc2, 0xac, 0xee, 0x6f,
+    0x2c, 0xb0, 0xd7, 0x16, 0x25, 0x0d, 0x78, 0x0d, 0xb0, 0xd2, 0xf5, 0xa9,
+    0xc3, 0x82, 0x59, 0x8d, 0xda, 0x07, 0x04, 0xee, 0x5a, 0xd8, 0xe6, 0x34,
+    0xc0, 0x8a, 0x18, 0xb2, 0x4c, 0xec, 0xf2, 0xcb, 0xa2, 0xdd, 0x94, 0x69,
+    0x63, 0x2e, 0xce, 0x26, 0xdd, 0x2e, 0x79, 0xd5, 0x9c, 0xc4, 0x27, 0x06,
+    0x09, 0x66, 0x1e, 0xfc, 0xf3, 0x54, 0x37, 0x1b, 0x27, 0xe9, 0x17, 0x70,
+    0x91, 0x2c, 0x9b, 0xf4, 0x11, 0x7f, 0x37, 0xb1, 0xb8, 0xa9, 0xef, 0x9e,
+    0x79, 0xbd, 0x5b, 0xa7, 0x18, 0x6b, 0x89, 0xb7, 0x4a, 0x2c, 0x6f, 0x01,
+    0xb6, 0x11, 0x64, 0xe6, 0x59, 0x68, 0x53, 0x15, 0xbe, 0xbd, 0xb3, 0xcf,
+    0x3c, 0x35, 0xec, 0x26, 0x57, 0xde, 0x90, 0x76, 0x1a, 0x59, 0xbb, 0x18,
+    0xa1, 0xd8, 0x15, 0xb8, 0x96, 0x1a, 0xe2, 0x85, 0x31, 0x0c, 0x1e, 0x1b,
+    0x90, 0x4b, 0x31, 0x77, 0x30, 0xf7, 0xe7, 0x9a, 0xa1, 0xb8, 0x86, 0x1c,
+    0x17, 0x63, 0x04, 0x1e, 0xa8, 0xbb, 0xcb, 0x26, 0xfd, 0x0e, 0x89, 0x66,
+    0x76, 0x70, 0xdb, 0x6d, 0x9e, 0x79, 0xbf, 0x26, 0xb3, 0x10, 0x9c, 0x18,
+    0xab, 0x37, 0x64, 0x5d, 0xc6, 0xcd, 0x60, 0x91, 0x2c, 0xb0, 0xd7, 0xb0,
+    0x76, 0x51, 0xb9, 0xc3, 0x8a, 0xb3, 0xc6, 0x79, 0xe6, 0xfc, 0x9a, 0xcc,
+    0x50, 0xab, 0xb0, 0x8a, 0x18, 0x99, 0x60, 0x55, 0x9b, 0xb2, 0x2e, 0xe3,
+    0x66, 0xb0, 0xa2, 0x71, 0x2c, 0xae, 0xae, 0x5b, 0x18, 0xe8, 0xa0, 0xed,
+    0x9e, 0x75, 0x67, 0x31, 0x09, 0xc1, 0x8a, 0xb3, 0x76, 0x45, 0xdc, 0x6c,
+    0xd6, 0x1a, 0xd4, 0xc9, 0x43, 0xf3, 0x64, 0x5d, 0xe5, 0x95, 0x0c, 0xbb,
+    0xe0, 0x58, 0x91, 0x5f, 0x3c, 0xf3, 0x84, 0xe0, 0xc1, 0x2c, 0xc3, 0xdf,
+    0x9e, 0x6a, 0x86, 0xe2, 0xac, 0xf1, 0x2c, 0xb4, 0x25, 0x9a, 0x43, 0x82,
+    0x88, 0x2d, 0x7b, 0x4b, 0x2c, 0x35, 0xc5, 0x89, 0x43, 0x5e, 0x03, 0x6c,
+    0x34, 0xbd, 0x6a, 0x70, 0xf9, 0xe7, 0x9c, 0x50, 0xf0, 0x37, 0x38, 0x15,
+    0x68, 0x70, 0xdb, 0x0d, 0x49, 0xe9, 0x2c, 0xbf, 0xf9, 0x74, 0xd7, 0xb1,
+    0xbc, 0x09, 0xd8, 0xba, 0x0d, 0x78, 0x74, 0x99, 0x86, 0xd8, 0x4d, 0xa7,
+    0xb9, 0x8d, 0x52, 0x31, 0xe3, 0xe3, 0xe3, 0x2c, 0x35, 0xc6, 0xed, 0x03,
+    0xc8, 0xf8, 0xf1, 0x96, 0x58, 0x6b, 0x8d, 0xda, 0x03, 0xd1, 0xa0, 0x22,
+    0x88, 0xa1, 0x8a, 0x9e, 0xe0, 0x96, 0x62, 0x28, 0x78, 0x10, 0xcd, 0xd8,
+    0x32, 0x98, 0x6d, 0x86, 0x1a, 0xf6, 0x0d, 0xfa, 0x35, 0x96, 0x5a, 0x1c,
+    0x41, 0xd8, 0x50, 0xbb, 0x98, 0x21, 0x36, 0xd4, 0x55, 0x9b, 0xb0, 0x28,
+    0x18, 0x6b, 0xd8, 0x74, 0xd7, 0x59, 0xcb, 0x28, 0xa1, 0xd8, 0xc7, 0x44,
+    0xe0, 0x86, 0xc9, 0x63, 0x08, 0xa3, 0x0d, 0x7b, 0x0e, 0x8b, 0x76, 0x5c,
+    0xf3, 0xd9, 0x9a, 0x60, 0x96, 0x61, 0xef, 0xcf, 0x35, 0x43, 0x71, 0x32,
+    0xe0, 0xb7, 0x3f, 0x19, 0x65, 0x56, 0x73, 0x18, 0x6b, 0xd8, 0x74, 0x58,
+    0x08, 0xa2, 0x86, 0x5d, 0xf0, 0x36, 0x6d, 0xf3, 0xcf, 0x38, 0x4e, 0x0c,
+    0x23, 0x8a, 0xb3, 0xc4, 0xb2, 0xc3, 0x5c, 0x76, 0x4a, 0xd4, 0xe6, 0x08,
+    0x72, 0xc8, 0xec, 0xad, 0x77, 0x0e, 0xa5, 0xd8, 0xc1, 0x6d, 0x07, 0x60,
+    0x90, 0x34, 0x48, 0x18, 0x6b, 0xcb, 0x2c, 0x35, 0xc4, 0xd0, 0xc3, 0x6c,
+    0x1d, 0x4b, 0xb1, 0xe8, 0x90, 0x61, 0xd1, 0x75, 0x31, 0x86, 0xb8, 0xa1,
+    0x77, 0x30, 0xac, 0x38, 0x39, 0xa6, 0xa8, 0xa7, 0x2c, 0xba, 0x2d, 0xd9,
+    0x46, 0xe7, 0x0e, 0x1f, 0xa2, 0xe3, 0x93, 0x98, 0xd9, 0xad, 0x34, 0x5d,
+    0xc5, 0x93, 0xb9, 0xdb, 0x3c, 0xea, 0xce, 0x63, 0x66, 0x69, 0x82, 0x59,
+    0x8d, 0x6a, 0xd1, 0x43, 0x79, 0x65, 0xd2, 0x56, 0x60, 0x95, 0x38, 0x2a,
+    0xb8, 0x28, 0x82, 0xd7, 0xb7, 0x8c, 0xb2, 0xc3, 0x5c, 0x74, 0x76, 0x31,
+    0x0c, 0xc2, 0xad, 0xd0, 0x65, 0x1a, 0x5e, 0xb5, 0x38, 0x7c, 0xf3, 0x94,
+    0x50, 0xc7, 0x4d, 0x5e, 0xe6, 0xe1, 0xbb, 0x9d, 0xb9, 0x6e, 0x8e, 0xc7,
+    0x31, 0x86, 0xbc, 0xb2, 0x54, 0xd4, 0xc3, 0xd1, 0x9a, 0x11, 0x7c, 0x87,
+    0x25, 0x69, 0xa9, 0xdb, 0x3c, 0xf3, 0x8a, 0x1e, 0x04, 0xd2, 0x6b, 0xe5,
+    0x03, 0x73, 0x81, 0xc5, 0xf5, 0xa4, 0xb2, 0x7a, 0xb7, 0x41, 0x94, 0x45,
+    0x0c, 0x4e, 0xc5, 0xd6, 0x79, 0xe7, 0x14, 0x3c, 0x0d, 0xda, 0x01, 0x40,
+    0xc3, 0x5e, 0xc3, 0x66, 0x69, 0x82, 0x59, 0x8d, 0x6a, 0xd1, 0x43, 0x79,
+    0x65, 0xab, 0x56, 0x63, 0xa3, 0x28, 0xa1, 0xdb, 0x3c, 0xf3, 0xd2, 0xd6,
+    0xb5, 0xad, 0x6b, 0x78, 0xe7, 0x9e, 0x1a, 0xe3, 0x2a, 0x17, 0x73, 0x06,
+    0xad, 0x7d, 0xe8, 0x35, 0xab, 0x45, 0x11, 0x77, 0x10, 0xc3, 0xb1, 0x9f,
+    0x23, 0x0d, 0x71, 0xd1, 0x5b, 0x89, 0x65, 0x36, 0x5f, 0x28, 0x14, 0x2e,
+    0xe6, 0x0d, 0x5a, 0xfb, 0xd0, 0x6b, 0x56, 0x8a, 0x22, 0xee, 0x21, 0x87,
+    0x63, 0x3e, 0x46, 0x1a, 0xe3, 0xa2, 0xb7, 0x12, 0xca, 0x84, 0x95, 0x0f,
+    0x0d, 0x6e, 0x33, 0xcf, 0x37, 0xbf, 0x3c, 0xd5, 0x0d, 0xc4, 0xcb, 0x82,
+    0xdc, 0xe7, 0x2c, 0xa8, 0x75, 0xe7, 0x6b, 0xd4, 0x22, 0xcd, 0x09, 0x5c,
+    0x3d, 0x1b, 0xa1, 0x86, 0xb8, 0xea, 0x87, 0x63, 0x10, 0xc3, 0x64, 0x59,
+    0x8e, 0x1a, 0xc6, 0x36, 0x66, 0x9c, 0xb2, 0xb5, 0xf7, 0xdc, 0xe6, 0x38,
+    0x6b, 0xac, 0x12, 0x2b, 0xcb, 0x2c, 0x35, 0xc6, 0xed, 0x02, 0xac, 0xf1,
+    0x9e, 0x79, 0xd5, 0x9c, 0xc7, 0x72, 0xad, 0xcb, 0x4a, 0x98, 0x84, 0xe0,
+    0xc4, 0x5b, 0x08, 0xbb, 0x88, 0x61, 0xb2, 0x2c, 0xc4, 0x58, 0x92, 0xbe,
+    0x32, 0xcb, 0xa2, 0xdd, 0x94, 0x4c, 0xb8, 0x2d, 0xce, 0x7e, 0x39, 0xe7,
+    0x9d, 0x59, 0xcc, 0x42, 0x70, 0x60, 0x96, 0x61, 0xef, 0xcf, 0x35, 0x43,
+    0x79, 0x65, 0x14, 0x31, 0xbb, 0x22, 0xee, 0x37, 0x38, 0x70, 0xf5, 0x6e,
+    0xa5, 0x96, 0x1a, 0xe3, 0x82, 0x99, 0x84, 0x80, 0xe5, 0xb1, 0xd7, 0x02,
+    0x29, 0x66, 0xbe, 0xf4, 0x0e, 0xd7, 0x8a, 0x0e, 0x49, 0xdf, 0x3c, 0xd5,
+    0x83, 0xab, 0x75, 0x2c, 0xb4, 0xaa, 0x7f, 0x5f, 0xd1, 0x5a, 0x61, 0x14,
+    0x70, 0xd7, 0x58, 0x24, 0x51, 0xc9, 0x3b, 0xe7, 0x9c, 0x27, 0x06, 0x09,
+    0x66, 0x1e, 0xfc, 0xf3, 0x54, 0x37, 0x15, 0x67, 0x89, 0x65, 0x36, 0x18,
+    0x6b, 0x8e, 0x89, 0x60, 0x43, 0x03, 0x28, 0x1e, 0x7e, 0xfe, 0x83, 0x96,
+    0x6b, 0x57, 0x03, 0xcf, 0xe3, 0xd0, 0x70, 0xd3, 0x3b, 0x14, 0x1d, 0x71,
+    0x26, 0xb0, 0xf3, 0xfe, 0x3d, 0x07, 0x47, 0x5a, 0xfe, 0x06, 0x58, 0x6b,
+    0x8d, 0x49, 0x7c, 0xa0, 0x19, 0x40, 0x8a, 0x14, 0x0e, 0x8e, 0xb5, 0x96,
+    0x5c, 0x25, 0x66, 0x12, 0xb5, 0x53, 0x77, 0xcf, 0x3c, 0xf8, 0x39, 0xa6,
+    0xa8, 0xa6, 0x2e, 0xe7, 0x39, 0x65, 0xa1, 0x4c, 0x25, 0x6a, 0xa6, 0xef,
+    0x9e, 0x79, 0xf0, 0x73, 0x4d, 0x51, 0x4c, 0x5d, 0xce, 0x72, 0xc9, 0xce,
+    0xc8, 0xd7, 0x70, 0x95, 0xaa, 0x9b, 0xbe, 0x79, 0xe7, 0x2c, 0x35, 0xc7,
+    0x17, 0x78, 0x0f, 0x0d, 0xc8, 0xd9, 0xac, 0x38, 0x39, 0xa6, 0xa5, 0x50,
+    0x51, 0x06, 0xb0, 0x8c, 0xb2, 0xcb, 0x0d, 0x71, 0x62, 0x50, 0xd7, 0x80,
+    0xdb, 0x0e, 0x0e, 0x69, 0xa9, 0x54, 0x3d, 0xf9, 0xe6, 0xa8, 0x6f, 0x2c,
+    0xb0, 0xd7, 0x1a, 0x92, 0xf9, 0x40, 0x2d, 0xb6, 0x6b, 0x4c, 0x10, 0x9b,
+    0x6b, 0x0d, 0x69, 0x65, 0x36, 0xd6, 0x1a, 0xde, 0x4e, 0x34, 0x4a, 0xd4,
+    0x23, 0x8f, 0x97, 0xc7, 0xd2, 0x59, 0x4a, 0x77, 0x31, 0x0c, 0x30, 0xd7,
+    0xb0, 0xba, 0xec, 0xd6, 0x8b, 0xa9, 0x41, 0x87, 0x48, 0xb9, 0x42, 0x32,
+    0xfa, 0x88, 0xa1, 0xd8, 0xc1, 0x58, 0xc1, 0x0d, 0x8f, 0xa9, 0x6c, 0xd6,
+    0xe0, 0xaa, 0x90, 0x86, 0xe3, 0xa3, 0x1c, 0x5d, 0xe0, 0x6e, 0xc2, 0x29,
+    0x66, 0xbe, 0xf4, 0x94, 0xb2, 0x8a, 0x14, 0x0e, 0x92, 0xb5, 0x1a, 0x18,
+    0xf9, 0x7f, 0x3f, 0x41, 0xb3, 0x58, 0x45, 0x0c, 0x41, 0xd4, 0xf7, 0xb1,
+    0x73, 0x41, 0xad, 0x0a, 0xdb, 0x9f, 0xb4, 0xb2, 0xd2, 0xf0, 0x30, 0xd7,
+    0xb0, 0x2b, 0xac, 0x07, 0x29, 0xa1, 0x84, 0x50, 0xf1, 0xec, 0x2a, 0xd7,
+    0x47, 0x08, 0xe2, 0xc6, 0x55, 0xae, 0x07, 0x4d, 0x6b, 0x21, 0xcc, 0x16,
+    0x8d, 0x78, 0x18, 0x6b, 0xcb, 0x29, 0x74, 0x62, 0x28, 0x4b, 0xd8, 0x61,
+    0xae, 0x36, 0x6b, 0x08, 0xa2, 0x38, 0x45, 0xd9, 0xad, 0xc1, 0x42, 0x32,
+    0x82, 0x59, 0x8e, 0x8c, 0x15, 0x8c, 0x3b, 0x5a, 0xd8, 0x18, 0x6b, 0xca,
+    0x69, 0x35, 0xf2, 0x81, 0xc1, 0x76, 0x30, 0x90, 0x21, 0x84, 0x50, 0xc6,
+    0xf6, 0x32, 0x81, 0x07, 0x6b, 0x24, 0x35, 0xb0, 0x1b, 0x60, 0xd6, 0x3d,
+    0xd9, 0x65, 0xa1, 0xc4, 0x1d, 0x85, 0x6f, 0xaf, 0x60, 0xa7, 0xfa, 0x81,
+    0x09, 0xc1, 0xca, 0x5e, 0x1e, 0x1e, 0x0e, 0x8b, 0xa9, 0xd8, 0xeb, 0x89,
+    0x4b, 0xc3, 0xc2, 0x28, 0x61, 0xac, 0x7b, 0xb2, 0x8d, 0x52, 0x30, 0x35,
+    0xa1, 0x71, 0xa1, 0xd8, 0x36, 0xc3, 0x56, 0xe3, 0x83, 0xb6, 0xa7, 0x2c,
+    0xb0, 0xd7, 0x16, 0x25, 0x0d, 0x78, 0x0d, 0xb0, 0xd9, 0x9a, 0x60, 0x96,
+    0x61, 0xe0, 0xad, 0xdc, 0xe6, 0x21, 0x84, 0xcc, 0xa2, 0x92, 0xcb, 0x0d,
+    0x71, 0x34, 0x39, 0x86, 0xd8, 0x1f, 0xea, 0x85, 0x77, 0x84, 0x65, 0x96,
+    0x58, 0x6b, 0x89, 0xa1, 0xcc, 0x36, 0xc3, 0x95, 0x3b, 0xf0, 0xca, 0x85,
+    0x2c, 0xb0, 0xd7, 0x13, 0x43, 0x98, 0x6d, 0x82, 0x2f, 0xe6, 0xf6, 0x43,
+    0x79, 0x65, 0x86, 0xbd, 0x86, 0xc5, 0xc2, 0x57, 0x02, 0x68, 0x6e, 0x11,
+    0x44, 0x50, 0xc6, 0xc9, 0x67, 0x81, 0xa5, 0x53, 0xfa, 0xfe, 0x8a, 0xd3,
+    0x0d, 0xb0, 0xe9, 0x16, 0x0e, 0xd2, 0xca, 0x58, 0x6b, 0x8d, 0x91, 0x4a,
+    0xb5, 0xc0, 0x2b, 0x59, 0x3b, 0x9c, 0xc1, 0x40, 0x6b, 0x1e, 0xec, 0xa3,
+    0x54, 0x8c, 0x48, 0xb6, 0x83, 0xb0, 0xf8, 0xfa, 0x7d, 0x7e, 0x82, 0xac,
+    0xbb, 0x8e, 0x12, 0xa6, 0xf9, 0xe7, 0x9d, 0x19, 0xac, 0x58, 0xf1, 0xf1,
+    0xf1, 0xf1, 0xf1, 0x91, 0x0b, 0x19, 0x54, 0x72, 0x8c, 0xa6, 0x76, 0xf1,
+    0x94, 0xb2, 0x97, 0x87, 0x87, 0x36, 0x37, 0x49, 0x9a, 0xc0, 0xfc, 0x97,
+    0x06, 0xe3, 0xb7, 0xb0, 0xe5, 0xab, 0xd8, 0x39, 0xac, 0xdc, 0x61, 0xae,
+    0x28, 0x8f, 0x2f, 0x0f, 0x0f, 0x0a, 0x19, 0x5a, 0x10, 0xde, 0x06, 0xac,
+    0xbb, 0xd8, 0xa2, 0xf5, 0x28, 0x46, 0x57, 0x94, 0xbc, 0x3c, 0x09, 0x66,
+    0x3a, 0x47, 0xa1, 0xb8, 0xc3, 0x5c, 0x10, 0xe6, 0xcc, 0xfc, 0x9d, 0x9a,
+    0xee, 0x2a, 0x9b, 0x18, 0x2a, 0x19, 0x4e, 0x52, 0xf0, 0xf0, 0xf0, 0x28,
+    0x18, 0x6b, 0xd8, 0x29, 0xf4, 0x28, 0xdc, 0x1c, 0xb2, 0xfc, 0xde, 0xb8,
+    0x1f, 0x3f, 0xd8, 0xf7, 0xfb, 0xfd, 0x7e, 0xd2, 0xc8, 0xaf, 0xbd, 0xde,
+    0x07, 0xcf, 0xf6, 0x3d, 0xfe, 0xff, 0x5f, 0xb4, 0xb2, 0x73, 0xe6, 0x0f,
+    0x8d, 0x0e, 0xc3, 0xe7, 0xfb, 0x1e, 0xff, 0x7f, 0xaf, 0xda, 0x59, 0x36,
+    0xb0, 0xda, 0x1d, 0x87, 0xcf, 0xf6, 0x3d, 0xfe, 0xff, 0x5f, 0xb4, 0xb2,
+    0x56, 0xee, 0x7c, 0x68, 0x76, 0x1f, 0x3f, 0xd8, 0xf7, 0xfb, 0xfd, 0x7e,
+    0xd2, 0xca, 0x67, 0xa9, 0xf1, 0xa1, 0xd8, 0x7c, 0xff, 0x63, 0xdf, 0xef,
+    0xf5, 0xfb, 0x4b, 0x2e, 0x7f, 0xf3, 0xfc, 0xff, 0xcf, 0xf8, 0x0f, 0xfd,
+    0x7f, 0xdf, 0xf3, 0xff, 0x83, 0xfe, 0xff, 0xb1, 0xff, 0xdf, 0xf7, 0xfe,
+    0xbf, 0xef, 0xff, 0xbf, 0xd7, 0xff, 0xff, 0xcf, 0xb7, 0xb7, 0xb4, 0xb2,
+    0xe9, 0xaf, 0x59, 0x8c, 0x35, 0xc5, 0x53, 0xb1, 0x82, 0x1c, 0x22, 0xa3,
+    0xc1, 0xdb, 0xf0, 0x32, 0xe9, 0xaf, 0x59, 0x8c, 0x35, 0xc5, 0x53, 0xb1,
+    0x82, 0x1b, 0x12, 0xeb, 0x81, 0xb5, 0xd4, 0xec, 0x55, 0xfc, 0x0c, 0xba,
+    0x6b, 0xd6, 0x63, 0x0d, 0x71, 0x54, 0xec, 0x62, 0xee, 0x21, 0x82, 0x2e,
+    0xcd, 0x6e, 0x06, 0x1a, 0xf6, 0x0a, 0x7f, 0xa8, 0x0d, 0xb0, 0xec, 0x8b,
+    0xf8, 0x19, 0x6c, 0xcd, 0x3c, 0x8b, 0x8e, 0x2e, 0xa9, 0x08, 0xcb, 0x96,
+    0xb5, 0x68, 0xa2, 0x2e, 0xf9, 0x70, 0x8f, 0xa9, 0xd6, 0xa4, 0xa6, 0xd7,
+    0x70, 0xf7, 0xe7, 0x9a, 0xa1, 0xbe, 0x5c, 0x15, 0xb5, 0xa0, 0xf8, 0xff,
+    0x19, 0x17, 0x36, 0x4a, 0x8f, 0x7f, 0x8c, 0x8b, 0x9b, 0x25, 0x47, 0xc7,
+    0xf7, 0xcb, 0x82, 0xc0, 0xf7, 0xfa, 0x65, 0xc1, 0x60, 0x7c, 0x7d, 0x72,
+    0xfc, 0xdd, 0x4c, 0x7d, 0xb2, 0xfc, 0xdd, 0x4c, 0x7c, 0x7b, 0xe5, 0xf9,
+    0xbd, 0x70, 0x3f, 0x9c, 0xbf, 0x37, 0xae, 0x07, 0xbf, 0xf8, 0xc8, 0xaf,
+    0xbd, 0xde, 0x07, 0xc6, 0x45, 0x7d, 0xee, 0xf0, 0x3d, 0xff, 0xbe, 0x45,
+    0x7d, 0xee, 0xf0, 0x3f, 0x8f, 0x7c, 0x9c, 0xf9, 0x83, 0xe3, 0x43, 0xb0,
+    0xf7, 0xfe, 0x32, 0x73, 0xe6, 0x0f, 0x8d, 0x0e, 0xc3, 0xe3, 0xed, 0x93,
+    0x6b, 0x0d, 0xa1, 0xd8, 0x7b, 0xfb, 0xe4, 0xda, 0xc3, 0x68, 0x76, 0x1f,
+    0x1f, 0xce, 0x4a, 0xdd, 0xcf, 0x8d, 0x0e, 0xc3, 0xef, 0x92, 0xb7, 0x73,
+    0xe3, 0x43, 0xb0, 0xf8, 0xf8, 0xca, 0x67, 0xa9, 0xf1, 0xa1, 0xd8, 0x7f,
+    0x7c, 0xa6, 0x7a, 0x9f, 0x1a, 0x1d, 0x87, 0xc7, 0xd3, 0x2e, 0x19, 0x66,
+    0x58, 0xca, 0x2e, 0x6f, 0x32, 0xc6, 0x5d, 0x1c, 0xd4, 0xde, 0x65, 0x8c,
+    0xa2, 0x97, 0xb3, 0xcc, 0xb1, 0x96, 0xd6, 0x49, 0x96, 0x32, 0x72, 0x8b,
+    0xda, 0x65, 0x8c, 0x9e, 0xeb, 0x32, 0xc6, 0x40,
+};
+
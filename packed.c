@@ -0,0 +1,258 @@
+/*
+ * Packed 16-byte game states and populations of them.
+ */
+
+#include <stdatomic.h>
+#include "packed.h"
+
+// Trips handed to a worker at a time
+#define PACKED_CHUNK 4096
+
+// States a gather fetches ahead of the one it reads
+#define GATHER_AHEAD 16
+
+#if defined(__GNUC__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
+
+int pack_game_state(PackedGameState* packed, const GameState* game) {
+    uint64_t word[2] = {0, 0};
+    uint64_t overflow = 0;
+
+#define PACK_FIELD(field, w, shift, bits, low) \
+    { \
+        uint64_t value = (uint64_t)((int64_t)game->field - (low)); \
+        overflow |= value >> (bits); \
+        word[w] |= value << (shift); \
+    }
+    PACKED_FIELDS(PACK_FIELD)
+#undef PACK_FIELD
+
+    if (overflow) {
+        return -1;
+    }
+    packed->word[0] = word[0];
+    packed->word[1] = word[1];
+    return 0;
+}
+
+void unpack_game_state(GameState* game, const PackedGameState* packed) {
+#define UNPACK_FIELD(field, w, shift, bits, low) game->field = packed_##field(packed);
+    PACKED_FIELDS(UNPACK_FIELD)
+#undef UNPACK_FIELD
+    game->rand_seed = 0;
+}
+
+size_t pack_game_states(PackedGameState* packed, const GameState* games, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (pack_game_state(&packed[i], &games[i]) != 0) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void unpack_game_states(GameState* games, const PackedGameState* packed, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        unpack_game_state(&games[i], &packed[i]);
+    }
+}
+
+// Sums the stored values, and takes the low bounds off once at the end: a
+// gather is bound by the misses it keeps in flight, so the loop stays short
+void packed_totals(const PackedGameState* packed, const uint32_t* index, size_t count, StateTotals* totals) {
+    const PackedGameState zero = {{0, 0}};  // Every field at its low bound
+    uint64_t food = 0, bullets = 0, clothing = 0, misc_supplies = 0, cash = 0, miles = 0, fort_open = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t k = i;
+        if (index) {
+            if (i + GATHER_AHEAD < count) {
+                PREFETCH(&packed[index[i + GATHER_AHEAD]]);
+            }
+            k = index[i];
+        }
+        const PackedGameState* state = &packed[k];
+        food += packed_raw_food(state);
+        bullets += packed_raw_bullets(state);
+        clothing += packed_raw_clothing(state);
+        misc_supplies += packed_raw_misc_supplies(state);
+        cash += packed_raw_cash(state);
+        miles += packed_raw_miles_traveled(state);
+        fort_open += packed_raw_fort_available(state) == 0;     // Stored 0 for -1, open
+    }
+    totals->food += (int64_t)food + (int64_t)count * packed_food(&zero);
+    totals->bullets += (int64_t)bullets + (int64_t)count * packed_bullets(&zero);
+    totals->clothing += (int64_t)clothing + (int64_t)count * packed_clothing(&zero);
+    totals->misc_supplies += (int64_t)misc_supplies + (int64_t)count * packed_misc_supplies(&zero);
+    totals->cash += (int64_t)cash + (int64_t)count * packed_cash(&zero);
+    totals->miles_traveled += (int64_t)miles + (int64_t)count * packed_miles_traveled(&zero);
+    totals->fort_open += fort_open;
+    totals->states += count;
+}
+
+void game_state_totals(const GameState* games, const uint32_t* index, size_t count, StateTotals* totals) {
+    for (size_t i = 0; i < count; i++) {
+        size_t k = i;
+        if (index) {
+            if (i + GATHER_AHEAD < count) {
+                PREFETCH(&games[index[i + GATHER_AHEAD]]);
+            }
+            k = index[i];
+        }
+        const GameState* state = &games[k];
+        totals->food += state->food;
+        totals->bullets += state->bullets;
+        totals->clothing += state->clothing;
+        totals->misc_supplies += state->misc_supplies;
+        totals->cash += state->cash;
+        totals->miles_traveled += state->miles_traveled;
+        totals->fort_open += state->fort_available == -1;
+    }
+    totals->states += count;
+}
+
+int packed_population_init(PackedPopulation* population, const PurchasePlan* plan, unsigned int first_seed,
+                           uint64_t count, int plain) {
+    GameState game;
+
+    memset(population, 0, sizeof(*population));
+    if (apply_purchase_plan(&game, plan) != 0) {
+        return -1;
+    }
+    size_t trips = count ? (size_t)count : 1;
+    if (plain) {
+        population->plain = malloc(trips * sizeof(GameState));
+    } else {
+        population->states = malloc(trips * sizeof(PackedGameState));
+    }
+    population->rng = malloc(trips * sizeof(unsigned int));
+    population->status = calloc(trips, 1);
+    if ((!population->plain && !population->states) || !population->rng || !population->status) {
+        packed_population_free(population);
+        return -1;
+    }
+
+    population->count = count;
+    for (uint64_t i = 0; i < count; i++) {
+        init_game_seeded(&game, (unsigned int)((first_seed + i) & SEED_MASK));
+        apply_purchase_plan(&game, plan);
+        population->rng[i] = get_random_state();
+        if (plain) {
+            population->plain[i] = game;
+        } else if (pack_game_state(&population->states[i], &game) != 0) {
+            population->status[i] = PACKED_OVERFLOW;
+            population->overflows++;
+            continue;
+        }
+        population->traveling++;
+    }
+    return 0;
+}
+
+void packed_population_free(PackedPopulation* population) {
+    free(population->states);
+    free(population->plain);
+    free(population->rng);
+    free(population->status);
+    memset(population, 0, sizeof(*population));
+}
+
+size_t packed_population_bytes(const PackedPopulation* population) {
+    size_t state = population->states ? sizeof(PackedGameState) : sizeof(GameState);
+    return (size_t)population->count * (state + sizeof(unsigned int) + 1);
+}
+
+typedef struct {
+    PackedPopulation* population;
+    const Policy* policy;
+    atomic_uint_fast64_t* next;
+    BatchStats stats;
+    uint64_t finished;
+    uint64_t overflows;
+} PackedWorker;
+
+// One turn of trip i; returns its new status. A trip that ends keeps the state
+// it had before the turn, in either layout
+static int step_trip(PackedPopulation* population, uint64_t i, const Policy* policy, BatchStats* stats) {
+    GameState game;
+    TripResult result;
+    int choice = ACTION_CONTINUE;
+
+    if (population->plain) {
+        game = population->plain[i];
+    } else {
+        unpack_game_state(&game, &population->states[i]);
+    }
+    seed_random(population->rng[i]);
+    int ended = begin_turn(&game, policy, &choice, &result) || finish_turn(&game, choice, policy, &result);
+    population->rng[i] = get_random_state();
+    if (ended) {
+        batch_stats_add(stats, &result);
+        return PACKED_FINISHED;
+    }
+    if (population->plain) {
+        population->plain[i] = game;
+    } else if (pack_game_state(&population->states[i], &game) != 0) {
+        return PACKED_OVERFLOW;
+    }
+    return PACKED_TRAVELING;
+}
+
+static void* packed_worker_main(void* arg) {
+    PackedWorker* worker = (PackedWorker*)arg;
+    PackedPopulation* population = worker->population;
+
+    for (;;) {
+        uint64_t first = atomic_fetch_add(worker->next, PACKED_CHUNK);
+        if (first >= population->count) {
+            break;
+        }
+        uint64_t last = first + PACKED_CHUNK < population->count ? first + PACKED_CHUNK : population->count;
+        for (uint64_t i = first; i < last; i++) {
+            if (population->status[i] != PACKED_TRAVELING) {
+                continue;
+            }
+            int status = step_trip(population, i, worker->policy, &worker->stats);
+            population->status[i] = (uint8_t)status;
+            worker->finished += status == PACKED_FINISHED;
+            worker->overflows += status == PACKED_OVERFLOW;
+        }
+    }
+    return NULL;
+}
+
+int packed_population_step(PackedPopulation* population, const Policy* policy, int threads,
+                           BatchStats* stats) {
+    atomic_uint_fast64_t next;
+
+    if (threads <= 0) {
+        threads = batch_default_threads();
+    }
+    PackedWorker* workers = calloc((size_t)threads, sizeof(PackedWorker));
+    if (!workers) {
+        return -1;
+    }
+
+    atomic_init(&next, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].population = population;
+        workers[w].policy = policy;
+        workers[w].next = &next;
+    }
+    if (threads == 1) {
+        packed_worker_main(&workers[0]);
+    } else {
+        run_worker_threads(packed_worker_main, workers, sizeof(PackedWorker), threads);
+    }
+
+    for (int w = 0; w < threads; w++) {
+        batch_stats_merge(stats, &workers[w].stats);
+        population->traveling -= workers[w].finished + workers[w].overflows;
+        population->overflows += workers[w].overflows;
+    }
+    free(workers);
+    return population->traveling > 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Packed game state: a GameState in 16 bytes, for holding tens of millions
+ * of trips in memory (snapshot pools, tables over states, populations
+ * stepped a turn at a time).
+ *
+ * Each field is stored offset-binary, value minus the field's low bound, in
+ * a fixed run of bits of one of two 64-bit words (PACKED_FIELDS). Resources
+ * and miles get 11 to 16 bits, the counters and flags what their ranges
+ * need. Packing checks every field and refuses a state that does not fit,
+ * so an unpacked state is always the one that was packed.
+ *
+ * Two fields are narrower than the struct's: forts_visited keeps 7 bits, so
+ * a state that has stopped at a trail's eighth fort or later does not pack,
+ * and rand_seed, the trip's starting seed, is not stored at all (unpacking
+ * sets it to 0; the engine never reads it during play). Keep the seed beside
+ * the state where it matters.
+ *
+ * A population is one packed state, generator state and status per trip;
+ * packed_population_step plays one turn of every trip still traveling, on
+ * threads, unpacking and repacking around the engine's stepped play. The
+ * accessors and packed_totals read fields straight from the packed words.
+ */
+
+#ifndef PACKED_H
+#define PACKED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "oregon.h"
+#include "batch.h"
+
+typedef struct {
+    uint64_t word[2];
+} PackedGameState;
+
+// X(field, word, shift, bits, low bound); the two words are full
+#define PACKED_FIELDS(X) \
+    X(food,                0,  0, 13, -4096) \
+    X(bullets,             0, 13, 16, -32768) \
+    X(clothing,            0, 29, 11, -1024) \
+    X(misc_supplies,       0, 40, 11, -1024) \
+    X(cash,                0, 51, 11, -1024) \
+    X(eating_level,        0, 62,  2, 0) \
+    X(miles_traveled,      1,  0, 13, -4096) \
+    X(miles_previous_turn, 1, 13, 13, -4096) \
+    X(oxen_cost,           1, 26, 10, -512) \
+    X(turn_number,         1, 36,  5, 0) \
+    X(shooting_skill,      1, 41,  3, 0) \
+    X(game_flags,          1, 44,  6, 0) \
+    X(fort_available,      1, 50,  2, -1) \
+    X(last_event,          1, 52,  5, -1) \
+    X(forts_visited,       1, 57,  7, 0)
+
+// packed_food(p), packed_miles_traveled(p), ...: one field without unpacking;
+// packed_raw_food(p), ...: the stored value, the field less its low bound
+#define PACKED_ACCESSOR(field, w, shift, bits, low) \
+    static inline uint64_t packed_raw_##field(const PackedGameState* packed) { \
+        return (packed->word[w] >> (shift)) & ((UINT64_C(1) << (bits)) - 1); \
+    } \
+    static inline int packed_##field(const PackedGameState* packed) { \
+        return (int)packed_raw_##field(packed) + (low); \
+    }
+PACKED_FIELDS(PACKED_ACCESSOR)
+#undef PACKED_ACCESSOR
+
+// Returns 0, or -1 with packed unchanged if a field is out of its range
+int pack_game_state(PackedGameState* packed, const GameState* game);
+void unpack_game_state(GameState* game, const PackedGameState* packed);
+
+// Returns the number packed: count, or the index of the first state that does not fit
+size_t pack_game_states(PackedGameState* packed, const GameState* games, size_t count);
+void unpack_game_states(GameState* games, const PackedGameState* packed, size_t count);
+
+// Sums over states, for queries across a pool
+typedef struct {
+    uint64_t states;
+    int64_t food;
+    int64_t bullets;
+    int64_t clothing;
+    int64_t misc_supplies;
+    int64_t cash;
+    int64_t miles_traveled;
+    uint64_t fort_open;         // States with a fort open to stop at (fort_available -1)
+} StateTotals;
+
+// Add count states to totals, read in the order of index (NULL for array order)
+void packed_totals(const PackedGameState* packed, const uint32_t* index, size_t count, StateTotals* totals);
+void game_state_totals(const GameState* games, const uint32_t* index, size_t count, StateTotals* totals);
+
+// Population status, per trip
+#define PACKED_TRAVELING 0
+#define PACKED_FINISHED 1
+#define PACKED_OVERFLOW 2           // A turn left a state that does not pack; dropped
+
+typedef struct {
+    PackedGameState* states;
+    GameState* plain;           // The struct layout instead, when states is NULL (for comparison)
+    unsigned int* rng;          // Generator state between turns
+    uint8_t* status;
+    uint64_t count;
+    uint64_t traveling;
+    uint64_t overflows;
+} PackedPopulation;
+
+// Trip i plays seed first_seed + i; plain picks the struct layout. Returns 0,
+// or -1 if the plan is invalid or memory runs out
+int packed_population_init(PackedPopulation* population, const PurchasePlan* plan, unsigned int first_seed,
+                           uint64_t count, int plain);
+void packed_population_free(PackedPopulation* population);
+
+// Bytes the population holds
+size_t packed_population_bytes(const PackedPopulation* population);
+
+// Play one turn of every traveling trip on threads (0 picks the number of
+// online CPUs), adding trips that end to stats; returns 1 while any trip is
+// still traveling, 0 when all have finished, -1 if memory runs out
+int packed_population_step(PackedPopulation* population, const Policy* policy, int threads,
+                           BatchStats* stats);
+
+#endif // PACKED_H
@@ -0,0 +1,137 @@
+/*
+ * Built-in computer players for headless trips.
+ */
+
+#include "policy.h"
+#include "trail.h"
+
+// Shooting result for a bot that always types the word correctly
+int bot_shot_result(int skill_level, const char* word, void* ctx) {
+    (void)word;
+    (void)ctx;
+    return BOT_SHOT_RESULT(skill_level); // Same scoring as a correct word
+}
+
+// "continue": never stops, eats moderately, circles the wagons
+static int continue_turn_action(const GameState* game, int fort_open, void* ctx) {
+    (void)game;
+    (void)fort_open;
+    (void)ctx;
+    return CONTINUE_TURN_ACTION;
+}
+
+static int continue_eating_level(const GameState* game, void* ctx) {
+    (void)game;
+    (void)ctx;
+    return CONTINUE_EATING_LEVEL;
+}
+
+static int continue_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    (void)game;
+    (void)hostile;
+    (void)ctx;
+    return CONTINUE_RIDER_TACTIC;
+}
+
+static int no_fort_purchase(const GameState* game, int item, void* ctx) {
+    (void)game;
+    (void)item;
+    (void)ctx;
+    return CONTINUE_FORT_PURCHASE;
+}
+
+const Policy continue_policy = {
+    "continue",
+    continue_turn_action,
+    continue_eating_level,
+    continue_rider_tactic,
+    no_fort_purchase,
+    bot_shot_result,
+    NULL
+};
+
+// "cautious": keeps food above a safety margin and fights only hostile riders
+static int cautious_turn_action(const GameState* game, int fort_open, void* ctx) {
+    (void)ctx;
+    if (fort_open && game->cash >= 20 && (game->food < 60 || game->misc_supplies < 15)) {
+        return ACTION_FORT;
+    }
+    if (game->food < 60 && game->bullets >= 400) {
+        return ACTION_HUNT;
+    }
+    return ACTION_CONTINUE;
+}
+
+static int cautious_eating_level(const GameState* game, void* ctx) {
+    (void)ctx;
+    if (game->food >= 100) {
+        return 3;
+    }
+    return game->food >= 40 ? 2 : 1;
+}
+
+static int cautious_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    (void)game;
+    (void)ctx;
+    return hostile ? TACTIC_ATTACK : TACTIC_CONTINUE;
+}
+
+int cautious_fort_purchase(const GameState* game, int item, void* ctx) {
+    (void)ctx;
+    switch (item) {
+        case ITEM_FOOD:
+            return game->food < 100 ? game->cash / 2 : 0;
+        case ITEM_AMMUNITION:
+            return game->bullets < 500 ? game->cash / 4 : 0;
+        case ITEM_CLOTHING:
+            return game->clothing < 30 && !(trail_segment(current_trail(), game->miles_traveled)->flags &
+                                            TRAIL_HIDE_MILEAGE) ? game->cash / 3 : 0;
+        case ITEM_MISC_SUPPLIES:
+            return game->misc_supplies < 15 ? game->cash / 2 : 0;
+    }
+    return 0;
+}
+
+const Policy cautious_policy = {
+    "cautious",
+    cautious_turn_action,
+    cautious_eating_level,
+    cautious_rider_tactic,
+    cautious_fort_purchase,
+    bot_shot_result,
+    NULL
+};
+
+// The position in this list is a policy's ID in the library API; append only
+static const Policy* const builtin_policies[] = {
+    &continue_policy,
+    &cautious_policy
+};
+
+#define BUILTIN_POLICY_COUNT (int)(sizeof(builtin_policies) / sizeof(builtin_policies[0]))
+
+int policy_count(void) {
+    return BUILTIN_POLICY_COUNT;
+}
+
+// Built-in policy by its position in the list, NULL if out of range
+const Policy* policy_by_id(int id) {
+    return id >= 0 && id < BUILTIN_POLICY_COUNT ? builtin_policies[id] : NULL;
+}
+
+// Look up a built-in policy by name, NULL if unknown
+const Policy* find_policy(const char* name) {
+    for (int i = 0; i < BUILTIN_POLICY_COUNT; i++) {
+        if (strcmp(builtin_policies[i]->name, name) == 0) {
+            return builtin_policies[i];
+        }
+    }
+    return NULL;
+}
+
+// Print the names of the built-in policies
+void list_policies(FILE* out) {
+    for (int i = 0; i < BUILTIN_POLICY_COUNT; i++) {
+        fprintf(out, "  %s\n", builtin_policies[i]->name);
+    }
+}
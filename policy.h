@@ -0,0 +1,43 @@
+/*
+ * Built-in computer players for headless trips.
+ *
+ * Every policy here is stateless, so one instance can be shared by any number
+ * of threads running trips at the same time.
+ */
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "oregon.h"
+
+// Always continue, eat moderately, circle the wagons, never shop
+extern const Policy continue_policy;
+
+// The continue policy's decisions as constants, for trip kernels (kernels.h)
+#define CONTINUE_TURN_ACTION ACTION_CONTINUE
+#define CONTINUE_EATING_LEVEL 2
+#define CONTINUE_RIDER_TACTIC TACTIC_CIRCLE_WAGONS
+#define CONTINUE_FORT_PURCHASE 0
+#define CONTINUE_POLICY continue_policy
+
+// Shop when low, hunt when hungry, fight hostile riders
+extern const Policy cautious_policy;
+
+// The cautious policy's fort shopping, for players that only learn the other choices
+int cautious_fort_purchase(const GameState* game, int item, void* ctx);
+
+// Shooting result for a bot that always types the word correctly
+#define BOT_SHOT_RESULT(skill_level) ((skill_level) > 3 ? (skill_level) - 2 : 1)
+int bot_shot_result(int skill_level, const char* word, void* ctx);
+
+// Look up a built-in policy by name, NULL if unknown
+const Policy* find_policy(const char* name);
+
+// Built-in policies by ID, 0 .. policy_count() - 1 (see oregon_api.h)
+int policy_count(void);
+const Policy* policy_by_id(int id);
+
+// Print the names of the built-in policies
+void list_policies(FILE* out);
+
+#endif // POLICY_H
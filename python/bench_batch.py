@@ -0,0 +1,69 @@
+"""Throughput of liboregon through the Python wrapper against oregon_sim run.
+
+    python3 python/bench_batch.py [--trips N] [--threads N] [--policy NAME]
+
+Plays the same seeds both ways, checks the survival rate agrees, and prints
+trips per second for each. Run from the repository root after make lib.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import oregon_trail  # noqa: E402
+
+
+def native(trips, threads, policy, seed):
+    binary = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "oregon_sim")
+    run = subprocess.run([binary, "run", "--trips", str(trips), "--threads", str(threads),
+                          "--policy", policy, "--seed", str(seed)],
+                         capture_output=True, text=True, check=True)
+    survival = float(re.search(r"survival rate\s+(\S+)", run.stdout).group(1))
+    rate = float(re.search(r"([\d.]+) trips/s", run.stderr).group(1))
+    return survival, rate
+
+
+def wrapped(trips, threads, policy, seed):
+    if oregon_trail.np is not None:
+        seeds = oregon_trail.np.arange(seed, seed + trips, dtype=oregon_trail.np.uint32)
+    else:
+        seeds = oregon_trail.array.array("I", range(seed, seed + trips))
+    start = time.perf_counter()
+    result = oregon_trail.simulate(seeds, policy=policy, threads=threads)
+    elapsed = time.perf_counter() - start
+    arrived = sum(1 for outcome in result["outcome"] if outcome == oregon_trail.ARRIVED)
+    return arrived / trips, trips / elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--trips", type=int, default=2000000)
+    parser.add_argument("--threads", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--policy", default="cautious")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--repeat", type=int, default=3, help="best of N runs each way")
+    args = parser.parse_args()
+
+    job = (args.trips, args.threads, args.policy, args.seed)
+    native_runs = [native(*job) for _ in range(args.repeat)]
+    wrapped_runs = [wrapped(*job) for _ in range(args.repeat)]
+    native_rate = max(rate for _, rate in native_runs)
+    wrapped_rate = max(rate for _, rate in wrapped_runs)
+
+    print("%d trips, policy %s, %d threads, %s columns" % (
+        args.trips, args.policy, args.threads, "NumPy" if oregon_trail.np is not None else "array"))
+    print("oregon_sim run   %10.0f trips/s  survival %.4f" % (native_rate, native_runs[0][0]))
+    print("python wrapper   %10.0f trips/s  survival %.4f" % (wrapped_rate, wrapped_runs[0][0]))
+    print("wrapper/native   %10.3f" % (wrapped_rate / native_rate))
+    if "%.4f" % native_runs[0][0] != "%.4f" % wrapped_runs[0][0]:
+        print("survival rates differ")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,178 @@
+"""Batch simulation of Oregon Trail trips through liboregon (see oregon_api.h).
+
+    import numpy as np
+    import oregon_trail
+
+    seeds = np.arange(1, 1_000_001, dtype=np.uint32)
+    trips = oregon_trail.simulate(seeds, policy="cautious")
+    survival = (trips["outcome"] == oregon_trail.ARRIVED).mean()
+
+Inputs that are already C-contiguous arrays of the right dtype (uint32 seeds,
+int32 purchases and skills) are passed to the library without a copy, and the
+result columns are allocated once and filled in place. ctypes releases the GIL
+for the length of the call, and the library plays the batch on its own
+threads.
+
+NumPy is optional: without it, array.array columns ('I' seeds, 'i' the rest)
+work the same way and the results come back as array.array.
+"""
+
+import array
+import ctypes
+import os
+
+try:
+    import numpy as np
+except ImportError:  # array.array columns only
+    np = None
+
+API_VERSION = 1
+
+ARRIVED = 0
+DIED = 1
+ABANDONED = 2
+INVALID_PLAN = -1
+
+DEATH_CAUSES = ("starvation", "exhaustion", "disease", "injuries",
+                "winter blizzard", "snakebite", "massacre")
+
+BUY_COLUMNS = 5  # oxen, food, ammunition, clothing, misc, in dollars
+
+RESULT_COLUMNS = ("outcome", "death_cause", "turn_number", "arrival_day", "miles_traveled",
+                  "food", "bullets", "clothing", "misc_supplies", "cash")
+
+_int32_p = ctypes.POINTER(ctypes.c_int32)
+
+
+class _BatchInput(ctypes.Structure):
+    _fields_ = [
+        ("struct_size", ctypes.c_uint32),
+        ("count", ctypes.c_uint32),
+        ("seeds", ctypes.POINTER(ctypes.c_uint32)),
+        ("purchases", _int32_p),
+        ("shooting_skill", _int32_p),
+        ("policy", ctypes.c_int32),
+        ("threads", ctypes.c_int32),
+    ]
+
+
+class _BatchOutput(ctypes.Structure):
+    _fields_ = [("struct_size", ctypes.c_uint32)] + [(name, _int32_p) for name in RESULT_COLUMNS]
+
+
+class OregonError(RuntimeError):
+    pass
+
+
+_lib = None
+
+
+def load(path=None):
+    """Load liboregon.so; by default from OREGON_LIB or the repository root."""
+    global _lib
+    if path is None:
+        path = os.environ.get("OREGON_LIB") or os.path.join(
+            os.path.dirname(os.path.abspath(__file__)), os.pardir, "liboregon.so")
+    lib = ctypes.CDLL(path)
+    lib.oregon_api_version.restype = ctypes.c_int
+    lib.oregon_policy_count.restype = ctypes.c_int
+    lib.oregon_policy_name.argtypes = [ctypes.c_int]
+    lib.oregon_policy_name.restype = ctypes.c_char_p
+    lib.oregon_set_trail_file.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]
+    lib.oregon_set_trail_file.restype = ctypes.c_int
+    lib.oregon_simulate_batch.argtypes = [ctypes.POINTER(_BatchInput), ctypes.POINTER(_BatchOutput)]
+    lib.oregon_simulate_batch.restype = ctypes.c_int64
+    if lib.oregon_api_version() != API_VERSION:
+        raise OregonError("%s has API version %d, expected %d"
+                          % (path, lib.oregon_api_version(), API_VERSION))
+    _lib = lib
+    return lib
+
+
+def _library():
+    return _lib if _lib is not None else load()
+
+
+def policies():
+    """Names of the built-in policies, indexed by policy ID."""
+    lib = _library()
+    return [lib.oregon_policy_name(i).decode() for i in range(lib.oregon_policy_count())]
+
+
+def set_trail(path):
+    """Play every later batch on a trail file (None for the original trail)."""
+    error = ctypes.create_string_buffer(80)
+    if _library().oregon_set_trail_file(path.encode() if path else None, error, len(error)) != 0:
+        raise OregonError("%s: %s" % (path, error.value.decode()))
+
+
+def _column(values, typecode):
+    """A C-contiguous column ('I' uint32 or 'i' int32), copied only if it is not one already."""
+    if np is not None and not isinstance(values, array.array):
+        return np.ascontiguousarray(values, dtype=np.uint32 if typecode == "I" else np.int32)
+    if isinstance(values, array.array) and values.typecode == typecode:
+        return values
+    return array.array(typecode, values)
+
+
+def _pointer(column, pointer_type):
+    if isinstance(column, array.array):
+        address, _ = column.buffer_info()
+        return ctypes.cast(address, pointer_type)
+    return column.ctypes.data_as(pointer_type)
+
+
+def _empty(count):
+    if np is not None:
+        return np.empty(count, dtype=np.int32)
+    return array.array("i", bytes(4 * count))
+
+
+def simulate(seeds, purchases=None, shooting_skill=None, policy="continue", threads=0,
+             columns=RESULT_COLUMNS):
+    """Play one trip per seed and return a dict of result columns.
+
+    purchases is an (n, 5) array of dollars (oxen, food, ammunition, clothing,
+    misc), or None for the default 250,180,50,110,60; shooting_skill is an n
+    array of 1-5, or None for 2. policy is a name or an ID. Only the named
+    result columns are filled; "invalid" counts rows whose purchases were
+    refused (their outcome is INVALID_PLAN).
+    """
+    lib = _library()
+    if isinstance(policy, str):
+        names = policies()
+        if policy not in names:
+            raise OregonError("unknown policy %r; built-in policies: %s" % (policy, ", ".join(names)))
+        policy = names.index(policy)
+
+    seeds = _column(seeds, "I")
+    count = len(seeds)
+    batch_in = _BatchInput(ctypes.sizeof(_BatchInput), count, _pointer(seeds, ctypes.POINTER(ctypes.c_uint32)),
+                           None, None, policy, threads)
+    if purchases is not None:
+        if np is None and not isinstance(purchases, array.array):
+            purchases = [dollars for row in purchases for dollars in row]
+        purchases = _column(purchases, "i")
+        if isinstance(purchases, array.array):
+            shaped = len(purchases) == count * BUY_COLUMNS
+        else:
+            shaped = purchases.shape == (count, BUY_COLUMNS)
+        if not shaped:
+            raise OregonError("purchases must have %d rows of %d columns" % (count, BUY_COLUMNS))
+        batch_in.purchases = _pointer(purchases, _int32_p)
+    if shooting_skill is not None:
+        shooting_skill = _column(shooting_skill, "i")
+        if len(shooting_skill) != count:
+            raise OregonError("shooting_skill must have %d rows" % count)
+        batch_in.shooting_skill = _pointer(shooting_skill, _int32_p)
+
+    results = {name: _empty(count) for name in columns}
+    batch_out = _BatchOutput(ctypes.sizeof(_BatchOutput))
+    for name, column in results.items():
+        setattr(batch_out, name, _pointer(column, _int32_p))
+
+    invalid = lib.oregon_simulate_batch(ctypes.byref(batch_in), ctypes.byref(batch_out))
+    if invalid < 0:
+        raise OregonError("oregon_simulate_batch failed with error %d" % invalid)
+    results["invalid"] = invalid
+    return results
@@ -0,0 +1,393 @@
+/*
+ * Self-play reinforcement learning for the turn decisions.
+ */
+
+#include "qlearn.h"
+#include "policy.h"
+#include "batch.h"
+
+// Trips handed to a training worker at a time
+#define TRAIN_CHUNK 1024
+
+// More decisions than the longest trip can ask for
+#define QLEARN_MAX_DECISIONS 96
+
+// Bucket limits: a value falls in the bucket of the first limit it is below
+static const int food_limits[] = {13, 40, 60, 100, 150};
+static const int bullet_limits[] = {40, 200, 400, 1000};
+static const int misc_limits[] = {5, 15, 30};
+static const int cash_limits[] = {20, 100};
+static const int clothing_limits[] = {10, 30};
+static const int turn_limits[] = {9, 15};
+
+#define LIMIT_COUNT(limits) (int)(sizeof(limits) / sizeof(limits[0]))
+
+static int bucket(int value, const int* limits, int count) {
+    int b = 0;
+    while (b < count && value >= limits[b]) {
+        b++;
+    }
+    return b;
+}
+
+// Mixed-radix state index: index * (count + 1) + bucket
+#define ADD_FEATURE(index, value, limits) \
+    ((index) * (LIMIT_COUNT(limits) + 1) + bucket((value), (limits), LIMIT_COUNT(limits)))
+
+static int mileage_stage(const GameState* game) {
+    int stage = game->miles_traveled / 500;
+    if (stage < 0) return 0;
+    return stage > 4 ? 4 : stage;
+}
+
+static int turn_state(const GameState* game, int fort_open) {
+    int index = fort_open ? 1 : 0;
+    index = ADD_FEATURE(index, game->food, food_limits);
+    index = ADD_FEATURE(index, game->bullets, bullet_limits);
+    index = ADD_FEATURE(index, game->misc_supplies, misc_limits);
+    index = ADD_FEATURE(index, game->cash, cash_limits);
+    index = index * 5 + mileage_stage(game);
+    index = ADD_FEATURE(index, game->turn_number, turn_limits);
+    return index;
+}
+
+static int eat_state(const GameState* game) {
+    int index = bucket(game->food, food_limits, LIMIT_COUNT(food_limits));
+    index = ADD_FEATURE(index, game->clothing, clothing_limits);
+    index = ADD_FEATURE(index, game->misc_supplies, misc_limits);
+    index = index * 5 + mileage_stage(game);
+    return QLEARN_TURN_STATES + index;
+}
+
+static int rider_state(const GameState* game, int hostile) {
+    int index = hostile ? 1 : 0;
+    index = ADD_FEATURE(index, game->bullets, bullet_limits);
+    index = ADD_FEATURE(index, game->misc_supplies, misc_limits);
+    return QLEARN_TURN_STATES + QLEARN_EAT_STATES + index;
+}
+
+QTable* qtable_create(void) {
+    QTable* table = malloc(sizeof(QTable));
+    if (!table) {
+        return NULL;
+    }
+    for (int s = 0; s < QLEARN_STATES; s++) {
+        for (int a = 0; a < QLEARN_ACTIONS; a++) {
+            atomic_init(&table->states[s].reward_sum[a], 0);
+            atomic_init(&table->states[s].visits[a], 0);
+        }
+    }
+    atomic_init(&table->episodes, 0);
+    return table;
+}
+
+void qtable_destroy(QTable* table) {
+    free(table);
+}
+
+// Checkpoint layout: this header, then per state the sums and then the counts
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t states;
+    uint32_t actions;
+    uint32_t reserved;
+    uint64_t episodes;
+} QTableFileHeader;
+
+int qtable_save(const QTable* table, const char* path) {
+    char temp_path[1024];
+    QTableFileHeader header;
+
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        return -1;
+    }
+    FILE* out = fopen(temp_path, "wb");
+    if (!out) {
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, QTABLE_MAGIC, sizeof(header.magic));
+    header.version = QTABLE_VERSION;
+    header.states = QLEARN_STATES;
+    header.actions = QLEARN_ACTIONS;
+    header.episodes = atomic_load(&table->episodes);
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1;
+
+    for (int s = 0; s < QLEARN_STATES && ok; s++) {
+        uint64_t sums[QLEARN_ACTIONS];
+        uint32_t visits[QLEARN_ACTIONS];
+        for (int a = 0; a < QLEARN_ACTIONS; a++) {
+            sums[a] = atomic_load_explicit(&table->states[s].reward_sum[a], memory_order_relaxed);
+            visits[a] = (uint32_t)atomic_load_explicit(&table->states[s].visits[a], memory_order_relaxed);
+        }
+        ok = fwrite(sums, sizeof(sums), 1, out) == 1 && fwrite(visits, sizeof(visits), 1, out) == 1;
+    }
+
+    if (fclose(out) != 0 || !ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+QTable* qtable_load(const char* path) {
+    QTableFileHeader header;
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        return NULL;
+    }
+
+    QTable* table = NULL;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, QTABLE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != QTABLE_VERSION || header.states != QLEARN_STATES ||
+        header.actions != QLEARN_ACTIONS || !(table = qtable_create())) {
+        fclose(in);
+        return NULL;
+    }
+
+    atomic_store(&table->episodes, header.episodes);
+    for (int s = 0; s < QLEARN_STATES; s++) {
+        uint64_t sums[QLEARN_ACTIONS];
+        uint32_t visits[QLEARN_ACTIONS];
+        if (fread(sums, sizeof(sums), 1, in) != 1 || fread(visits, sizeof(visits), 1, in) != 1) {
+            qtable_destroy(table);
+            fclose(in);
+            return NULL;
+        }
+        for (int a = 0; a < QLEARN_ACTIONS; a++) {
+            atomic_store(&table->states[s].reward_sum[a], sums[a]);
+            atomic_store(&table->states[s].visits[a], visits[a]);
+        }
+    }
+    fclose(in);
+    return table;
+}
+
+void qtable_decay(QTable* table) {
+    for (int s = 0; s < QLEARN_STATES; s++) {
+        for (int a = 0; a < QLEARN_ACTIONS; a++) {
+            QStateEntry* entry = &table->states[s];
+            uint32_t visits = (uint32_t)atomic_load(&entry->visits[a]);
+            uint64_t sum = atomic_load(&entry->reward_sum[a]);
+            // Keep a single visit rather than forgetting the action was ever tried
+            if (visits > 1) {
+                atomic_store(&entry->visits[a], visits / 2);
+                atomic_store(&entry->reward_sum[a], sum / visits * (visits / 2));
+            }
+        }
+    }
+}
+
+uint64_t qtable_visited_states(const QTable* table) {
+    uint64_t visited = 0;
+    for (int s = 0; s < QLEARN_STATES; s++) {
+        for (int a = 0; a < QLEARN_ACTIONS; a++) {
+            if (atomic_load_explicit(&table->states[s].visits[a], memory_order_relaxed)) {
+                visited++;
+                break;
+            }
+        }
+    }
+    return visited;
+}
+
+// Per-worker exploring player: the policy ctx during training
+typedef struct {
+    QTable* table;
+    double epsilon;
+    uint64_t rng;
+    int decisions;
+    uint32_t state[QLEARN_MAX_DECISIONS];
+    uint8_t action[QLEARN_MAX_DECISIONS];
+} Learner;
+
+// xorshift64*, kept apart from the game's generator so exploring never shifts the trip
+static uint64_t learner_random(Learner* learner) {
+    learner->rng ^= learner->rng >> 12;
+    learner->rng ^= learner->rng << 25;
+    learner->rng ^= learner->rng >> 27;
+    return learner->rng * 0x2545f4914f6cdd1dull;
+}
+
+// Best of actions first..last (0-based); unvisited actions score unvisited_value
+static int best_action(const QStateEntry* entry, int first, int last, int64_t unvisited_value) {
+    int best = last;
+    int64_t best_value = INT64_MIN;
+    for (int a = first; a <= last; a++) {
+        uint32_t visits = (uint32_t)atomic_load_explicit(&entry->visits[a], memory_order_relaxed);
+        int64_t value = unvisited_value;
+        if (visits) {
+            value = (int64_t)(atomic_load_explicit(&entry->reward_sum[a], memory_order_relaxed) / visits);
+        }
+        if (value > best_value) {
+            best_value = value;
+            best = a;
+        }
+    }
+    return best;
+}
+
+// Pick and record an action; returns the game's 1-based choice
+static int explore(Learner* learner, int state, int first, int last) {
+    int action;
+    double roll = (double)(learner_random(learner) >> 11) / 9007199254740992.0;
+
+    if (roll < learner->epsilon) {
+        action = first + (int)(learner_random(learner) % (uint64_t)(last - first + 1));
+    } else {
+        // Optimistic about untried actions, so every one gets a first look
+        action = best_action(&learner->table->states[state], first, last, QLEARN_REWARD_SCALE);
+    }
+
+    if (learner->decisions < QLEARN_MAX_DECISIONS) {
+        learner->state[learner->decisions] = (uint32_t)state;
+        learner->action[learner->decisions] = (uint8_t)action;
+        learner->decisions++;
+    }
+    return action + 1;
+}
+
+static int explore_turn_action(const GameState* game, int fort_open, void* ctx) {
+    return explore((Learner*)ctx, turn_state(game, fort_open),
+                   fort_open ? ACTION_FORT - 1 : ACTION_HUNT - 1, ACTION_CONTINUE - 1);
+}
+
+static int explore_eating_level(const GameState* game, void* ctx) {
+    return explore((Learner*)ctx, eat_state(game), 0, 2);
+}
+
+static int explore_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    return explore((Learner*)ctx, rider_state(game, hostile), 0, TACTIC_CIRCLE_WAGONS - 1);
+}
+
+// Greedy player: unvisited actions are never preferred, and with no data the
+// game's own default (the last option) is used
+static int greedy(const QTable* table, int state, int first, int last) {
+    return best_action(&table->states[state], first, last, -1) + 1;
+}
+
+static int greedy_turn_action(const GameState* game, int fort_open, void* ctx) {
+    return greedy((const QTable*)ctx, turn_state(game, fort_open),
+                  fort_open ? ACTION_FORT - 1 : ACTION_HUNT - 1, ACTION_CONTINUE - 1);
+}
+
+static int greedy_eating_level(const GameState* game, void* ctx) {
+    return greedy((const QTable*)ctx, eat_state(game), 0, 2);
+}
+
+static int greedy_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    return greedy((const QTable*)ctx, rider_state(game, hostile), 0, TACTIC_CIRCLE_WAGONS - 1);
+}
+
+void qlearn_policy(const QTable* table, Policy* policy) {
+    policy->name = "learned";
+    policy->turn_action = greedy_turn_action;
+    policy->eating_level = greedy_eating_level;
+    policy->rider_tactic = greedy_rider_tactic;
+    policy->fort_purchase = cautious_fort_purchase;
+    policy->shot_result = bot_shot_result;
+    policy->ctx = (void*)table;
+}
+
+// Arrivals are worth the full scale; deaths a quarter of it in proportion to
+// the distance covered, so early training still has something to climb
+static uint64_t trip_return(const TripResult* result) {
+    if (result->outcome == TRIP_ARRIVED) {
+        return QLEARN_REWARD_SCALE;
+    }
+    int miles = result->miles_traveled;
+    if (miles < 0) miles = 0;
+    if (miles > TOTAL_DISTANCE) miles = TOTAL_DISTANCE;
+    return (uint64_t)miles * (QLEARN_REWARD_SCALE / 4) / TOTAL_DISTANCE;
+}
+
+typedef struct {
+    const TrainJob* job;
+    atomic_uint_fast64_t* next_trip;
+    Learner learner;
+    TrainStats stats;
+} TrainWorker;
+
+static void* train_worker_main(void* arg) {
+    TrainWorker* worker = (TrainWorker*)arg;
+    const TrainJob* job = worker->job;
+    Learner* learner = &worker->learner;
+    QTable* table = learner->table;
+    TripResult result;
+    Policy policy = {
+        "learning", explore_turn_action, explore_eating_level, explore_rider_tactic,
+        cautious_fort_purchase, bot_shot_result, learner
+    };
+
+    for (;;) {
+        uint64_t first = atomic_fetch_add(worker->next_trip, TRAIN_CHUNK);
+        if (first >= job->trips) {
+            break;
+        }
+        uint64_t last = first + TRAIN_CHUNK;
+        if (last > job->trips) {
+            last = job->trips;
+        }
+
+        for (uint64_t i = first; i < last; i++) {
+            unsigned int seed = (unsigned int)((job->first_seed + i) & SEED_MASK);
+            learner->decisions = 0;
+            simulate_trip(&job->plan, &policy, seed, NULL, NULL, &result);
+
+            uint64_t reward = trip_return(&result);
+            for (int d = 0; d < learner->decisions; d++) {
+                QStateEntry* entry = &table->states[learner->state[d]];
+                atomic_fetch_add_explicit(&entry->reward_sum[learner->action[d]], reward,
+                                          memory_order_relaxed);
+                atomic_fetch_add_explicit(&entry->visits[learner->action[d]], 1,
+                                          memory_order_relaxed);
+            }
+
+            worker->stats.trips++;
+            worker->stats.arrived += (result.outcome == TRIP_ARRIVED);
+            worker->stats.decisions += (uint64_t)learner->decisions;
+        }
+    }
+    atomic_fetch_add(&table->episodes, worker->stats.trips);
+    return NULL;
+}
+
+// Play one round of exploring self-play into table; returns 0, or -1 if the plan is invalid
+int qlearn_train(QTable* table, const TrainJob* job, TrainStats* stats) {
+    GameState probe;
+    atomic_uint_fast64_t next_trip;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+
+    if (apply_purchase_plan(&probe, &job->plan) != 0) {
+        return -1;
+    }
+
+    TrainWorker* workers = calloc((size_t)threads, sizeof(TrainWorker));
+    if (!workers) {
+        return -1;
+    }
+
+    atomic_init(&next_trip, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].job = job;
+        workers[w].next_trip = &next_trip;
+        workers[w].learner.table = table;
+        workers[w].learner.epsilon = job->epsilon;
+        // Summed in 64 bits, so never 0: a zero xorshift state stays 0
+        workers[w].learner.rng = 0x9e3779b97f4a7c15ull * ((uint64_t)job->first_seed + (uint64_t)w + 1);
+    }
+    run_worker_threads(train_worker_main, workers, sizeof(TrainWorker), threads);
+
+    memset(stats, 0, sizeof(TrainStats));
+    for (int w = 0; w < threads; w++) {
+        stats->trips += workers[w].stats.trips;
+        stats->arrived += workers[w].stats.arrived;
+        stats->decisions += workers[w].stats.decisions;
+    }
+
+    free(workers);
+    return 0;
+}
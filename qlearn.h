@@ -0,0 +1,84 @@
+/*
+ * Self-play reinforcement learning for the turn decisions.
+ *
+ * A tabular, every-visit Monte-Carlo learner: each decision the engine asks a
+ * policy for (turn action, eating level, rider tactic) is mapped to a
+ * discretised state, and the table keeps, for every state and action, the sum
+ * of the returns of the trips that took it and the number of such trips. The
+ * value of an action is their ratio.
+ *
+ * Training workers share one table without locks. Each worker plays whole
+ * trips with an epsilon-greedy reading of the table, and at the end of a trip
+ * adds the trip's return to every (state, action) it visited with relaxed
+ * atomic adds. Between rounds the table can be decayed (all sums and counts
+ * halved), so recent, better play outweighs the early random exploration.
+ *
+ * Fort purchases keep the cautious policy's rule and hunting always types the
+ * word correctly; only the three choices above are learned.
+ */
+
+#ifndef QLEARN_H
+#define QLEARN_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "oregon.h"
+
+#define QTABLE_MAGIC "ORQTAB1"
+#define QTABLE_VERSION 1
+
+// Decision kinds and their share of the state space
+#define QLEARN_TURN_STATES 10800    // fort x food x bullets x misc x cash x mileage x date
+#define QLEARN_EAT_STATES 360       // food x clothing x misc x mileage
+#define QLEARN_RIDER_STATES 40      // hostile x bullets x misc
+#define QLEARN_STATES (QLEARN_TURN_STATES + QLEARN_EAT_STATES + QLEARN_RIDER_STATES)
+#define QLEARN_ACTIONS 4
+
+// Returns are fixed point: an arrival is worth QLEARN_REWARD_SCALE
+#define QLEARN_REWARD_SCALE 65536
+
+typedef struct {
+    atomic_uint_fast64_t reward_sum[QLEARN_ACTIONS];
+    atomic_uint_fast32_t visits[QLEARN_ACTIONS];
+} QStateEntry;
+
+typedef struct {
+    QStateEntry states[QLEARN_STATES];
+    atomic_uint_fast64_t episodes;
+} QTable;
+
+QTable* qtable_create(void);
+void qtable_destroy(QTable* table);
+
+// Checkpoints are written to a temporary file and renamed over path
+int qtable_save(const QTable* table, const char* path);
+QTable* qtable_load(const char* path);
+
+// Halve every sum and count; call only while no trainer is running
+void qtable_decay(QTable* table);
+
+// States that have been visited at least once
+uint64_t qtable_visited_states(const QTable* table);
+
+// Greedy player reading table; the table must outlive the policy
+void qlearn_policy(const QTable* table, Policy* policy);
+
+typedef struct {
+    PurchasePlan plan;
+    unsigned int first_seed;
+    uint64_t trips;
+    int threads;            // 0 picks the number of online CPUs
+    double epsilon;         // Chance of a random action at each decision
+} TrainJob;
+
+typedef struct {
+    uint64_t trips;
+    uint64_t arrived;
+    uint64_t decisions;
+} TrainStats;
+
+// Play one round of exploring self-play into table; returns 0, or -1 if the
+// plan is invalid or memory runs out
+int qlearn_train(QTable* table, const TrainJob* job, TrainStats* stats);
+
+#endif // QLEARN_H
@@ -0,0 +1,378 @@
+/*
+ * Scenario files.
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include "scenario.h"
+#include "policy.h"
+#include "trail.h"
+
+#define SCENARIO_PATH_LEN 256
+
+typedef struct {
+    uint64_t line;
+    char name[SCENARIO_NAME_LEN];
+    char error[128];            // Why the line did not parse, empty if it did
+    BatchJob job;
+    const Trail* trail;         // NULL for the command line's
+    uint64_t next_trip;         // Next chunk to hand out
+    uint64_t done_trips;
+    BatchStats stats;
+} ScenarioSlot;
+
+typedef struct {
+    char path[SCENARIO_PATH_LEN];
+    Trail* trail;
+} LoadedTrail;
+
+typedef struct {
+    const ScenarioRun* run;
+    FILE* in;
+    ScenarioSlot* slots;
+    uint64_t window;
+
+    // Sequence numbers of scenarios: read_seq have been read, the ones before
+    // claim_seq have every chunk handed out, the ones before write_seq are out
+    pthread_mutex_t lock;
+    pthread_cond_t space;       // Reader: a slot was written out
+    pthread_cond_t work;        // Workers: a slot was read, or reading ended
+    pthread_cond_t done;        // Writer: a slot finished, or reading ended
+    uint64_t read_seq;
+    uint64_t claim_seq;
+    uint64_t write_seq;
+    int reader_done;
+
+    // The reader's own
+    LoadedTrail trails[SCENARIO_MAX_TRAILS];
+    int trail_count;
+} ScenarioQueue;
+
+static const char* const death_keys[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "winter_blizzard", "snakebite", "massacre"
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int slot_finished(const ScenarioSlot* slot) {
+    return slot->error[0] || slot->done_trips == slot->job.trips;
+}
+
+// Parsing
+
+static const Trail* find_trail(ScenarioQueue* queue, const char* path, ScenarioSlot* slot) {
+    char error[80];
+
+    for (int i = 0; i < queue->trail_count; i++) {
+        if (strcmp(queue->trails[i].path, path) == 0) {
+            return queue->trails[i].trail;
+        }
+    }
+    if (queue->trail_count == SCENARIO_MAX_TRAILS) {
+        snprintf(slot->error, sizeof(slot->error), "more than %d trail files", SCENARIO_MAX_TRAILS);
+        return NULL;
+    }
+    if (strlen(path) >= SCENARIO_PATH_LEN) {
+        snprintf(slot->error, sizeof(slot->error), "trail path too long");
+        return NULL;
+    }
+    Trail* trail = malloc(sizeof(Trail));
+    if (!trail) {
+        snprintf(slot->error, sizeof(slot->error), "out of memory");
+        return NULL;
+    }
+    if (trail_load(trail, path, error, sizeof(error)) != 0) {
+        snprintf(slot->error, sizeof(slot->error), "%.40s: %s", path, error);
+        free(trail);
+        return NULL;
+    }
+    LoadedTrail* loaded = &queue->trails[queue->trail_count++];
+    snprintf(loaded->path, sizeof(loaded->path), "%s", path);
+    loaded->trail = trail;
+    return trail;
+}
+
+// Fill a slot from a line's terms; an error is left in slot->error
+static void parse_scenario(ScenarioQueue* queue, char* line, ScenarioSlot* slot) {
+    const ScenarioRun* run = queue->run;
+    PurchasePlan* plan = &slot->job.plan;
+    GameState probe;
+    char* save = NULL;
+
+    slot->job = run->defaults;
+    slot->job.on_turn = NULL;
+    slot->job.on_trip = NULL;
+    slot->job.worker_ctx = NULL;
+    slot->job.on_chunk = NULL;
+    slot->job.chunk_ctx = NULL;
+    slot->trail = NULL;
+    snprintf(slot->name, sizeof(slot->name), "line%llu", (unsigned long long)slot->line);
+
+    for (char* term = strtok_r(line, " \t\r\n", &save); term; term = strtok_r(NULL, " \t\r\n", &save)) {
+        char* value = strchr(term, '=');
+        if (!value) {
+            snprintf(slot->error, sizeof(slot->error), "expected key=value, got '%.40s'", term);
+            return;
+        }
+        *value++ = '\0';
+        if (strcmp(term, "name") == 0) {
+            snprintf(slot->name, sizeof(slot->name), "%s", value);
+        } else if (strcmp(term, "policy") == 0) {
+            slot->job.policy = find_policy(value);
+            if (!slot->job.policy) {
+                snprintf(slot->error, sizeof(slot->error), "unknown policy '%.40s'", value);
+                return;
+            }
+        } else if (strcmp(term, "skill") == 0) {
+            plan->shooting_skill = atoi(value);
+        } else if (strcmp(term, "buy") == 0) {
+            if (sscanf(value, "%d,%d,%d,%d,%d", &plan->oxen, &plan->food, &plan->ammunition,
+                       &plan->clothing, &plan->misc_supplies) != 5) {
+                snprintf(slot->error, sizeof(slot->error), "buy expects OXEN,FOOD,AMMUNITION,CLOTHING,MISC");
+                return;
+            }
+        } else if (strcmp(term, "seed") == 0) {
+            slot->job.first_seed = (unsigned int)strtoul(value, NULL, 0);
+        } else if (strcmp(term, "trips") == 0) {
+            slot->job.trips = strtoull(value, NULL, 10);
+        } else if (strcmp(term, "trail") == 0) {
+            slot->trail = find_trail(queue, value, slot);
+            if (!slot->trail) {
+                return;
+            }
+        } else {
+            snprintf(slot->error, sizeof(slot->error), "unknown term '%.40s'", term);
+            return;
+        }
+    }
+    if (apply_purchase_plan(&probe, plan) != 0) {
+        snprintf(slot->error, sizeof(slot->error), "invalid purchase plan");
+    }
+}
+
+// Reader thread: lines into slots as the ring has room
+static void* scenario_reader_main(void* arg) {
+    ScenarioQueue* queue = (ScenarioQueue*)arg;
+    char line[SCENARIO_LINE_MAX];
+    uint64_t line_number = 0;
+
+    while (fgets(line, sizeof(line), queue->in)) {
+        size_t length = strlen(line);
+        int overlong = length == sizeof(line) - 1 && line[length - 1] != '\n';
+        line_number++;
+        if (overlong) {
+            int c;
+            while ((c = fgetc(queue->in)) != EOF && c != '\n') {
+                continue;
+            }
+        }
+        char* start = line + strspn(line, " \t\r\n");
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        while (queue->read_seq - queue->write_seq >= queue->window) {
+            pthread_cond_wait(&queue->space, &queue->lock);
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        // The slot is free: only this thread touches it until read_seq moves
+        ScenarioSlot* slot = &queue->slots[queue->read_seq % queue->window];
+        memset(slot, 0, sizeof(*slot));
+        slot->line = line_number;
+        if (overlong) {
+            snprintf(slot->name, sizeof(slot->name), "line%llu", (unsigned long long)line_number);
+            snprintf(slot->error, sizeof(slot->error), "line longer than %d bytes", SCENARIO_LINE_MAX - 1);
+        } else {
+            parse_scenario(queue, start, slot);
+        }
+
+        pthread_mutex_lock(&queue->lock);
+        queue->read_seq++;
+        pthread_cond_broadcast(&queue->work);
+        if (slot_finished(slot)) {
+            pthread_cond_signal(&queue->done);
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    queue->reader_done = 1;
+    pthread_cond_broadcast(&queue->work);
+    pthread_cond_signal(&queue->done);
+    pthread_mutex_unlock(&queue->lock);
+    return NULL;
+}
+
+typedef struct {
+    ScenarioQueue* queue;
+    int worker;
+} ScenarioWorker;
+
+// Worker threads: chunks of the oldest slots with trips left to hand out
+static void* scenario_worker_main(void* arg) {
+    ScenarioWorker* worker = (ScenarioWorker*)arg;
+    ScenarioQueue* queue = worker->queue;
+
+    pthread_mutex_lock(&queue->lock);
+    for (;;) {
+        ScenarioSlot* slot = NULL;
+        while (queue->claim_seq < queue->read_seq) {
+            ScenarioSlot* oldest = &queue->slots[queue->claim_seq % queue->window];
+            if (!oldest->error[0] && oldest->next_trip < oldest->job.trips) {
+                slot = oldest;
+                break;
+            }
+            queue->claim_seq++;
+        }
+        if (!slot) {
+            if (queue->reader_done) {
+                break;
+            }
+            pthread_cond_wait(&queue->work, &queue->lock);
+            continue;
+        }
+
+        uint64_t first = slot->next_trip;
+        uint64_t last = first + SCENARIO_CHUNK < slot->job.trips ? first + SCENARIO_CHUNK : slot->job.trips;
+        slot->next_trip = last;
+        pthread_mutex_unlock(&queue->lock);
+
+        BatchStats stats;
+        memset(&stats, 0, sizeof(stats));
+        set_thread_trail(slot->trail);
+        batch_play_range(&slot->job, worker->worker, first, last, &stats);
+
+        pthread_mutex_lock(&queue->lock);
+        batch_stats_merge(&slot->stats, &stats);
+        slot->done_trips += last - first;
+        if (slot_finished(slot)) {
+            pthread_cond_signal(&queue->done);
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    set_thread_trail(NULL);
+    return NULL;
+}
+
+static void print_result(FILE* out, const ScenarioSlot* slot) {
+    const BatchStats* stats = &slot->stats;
+    double trips = stats->trips ? (double)stats->trips : 1.0;
+    double arrived = stats->arrived ? (double)stats->arrived : 1.0;
+
+    if (slot->error[0]) {
+        fprintf(out, "name=%s error=\"line %llu: %s\"\n", slot->name, (unsigned long long)slot->line,
+                slot->error);
+        return;
+    }
+    fprintf(out, "name=%s trips=%llu arrived=%llu survival=%.4f turns=%.3f arrival_day=%.2f cash=%.2f",
+            slot->name, (unsigned long long)stats->trips, (unsigned long long)stats->arrived,
+            (double)stats->arrived / trips, (double)stats->turn_sum / trips,
+            (double)stats->arrival_day_sum / arrived, (double)stats->cash_sum / arrived);
+    for (int cause = 0; cause < DEATH_CAUSE_COUNT; cause++) {
+        fprintf(out, " %s=%llu", death_keys[cause], (unsigned long long)stats->deaths[cause]);
+    }
+    fputc('\n', out);
+}
+
+int run_scenarios(FILE* in, FILE* out, const ScenarioRun* run, ScenarioReport* report) {
+    ScenarioQueue queue;
+    pthread_t reader;
+    int threads = run->defaults.threads > 0 ? run->defaults.threads : batch_default_threads();
+    double start = now_seconds();
+
+    memset(report, 0, sizeof(*report));
+    memset(&queue, 0, sizeof(queue));
+    queue.run = run;
+    queue.in = in;
+    queue.window = run->window > 0 ? (uint64_t)run->window : SCENARIO_WINDOW;
+    queue.slots = calloc((size_t)queue.window, sizeof(ScenarioSlot));
+    ScenarioWorker* workers = calloc((size_t)threads, sizeof(ScenarioWorker));
+    pthread_t* handles = calloc((size_t)threads, sizeof(pthread_t));
+    if (!queue.slots || !workers || !handles) {
+        free(queue.slots);
+        free(workers);
+        free(handles);
+        return -1;
+    }
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.space, NULL);
+    pthread_cond_init(&queue.work, NULL);
+    pthread_cond_init(&queue.done, NULL);
+
+    // Workers first: they wait for slots, so any that start can serve the
+    // queue, and with none (or no reader) the queue is stopped before use
+    for (int w = 0; w < threads; w++) {
+        workers[w].queue = &queue;
+        workers[w].worker = w;
+    }
+    int started = start_worker_threads(handles, threads, scenario_worker_main, workers, sizeof(ScenarioWorker));
+    if (started == 0 || pthread_create(&reader, NULL, scenario_reader_main, &queue) != 0) {
+        pthread_mutex_lock(&queue.lock);
+        queue.reader_done = 1;
+        pthread_cond_broadcast(&queue.work);
+        pthread_mutex_unlock(&queue.lock);
+        for (int w = 0; w < started; w++) {
+            pthread_join(handles[w], NULL);
+        }
+        pthread_mutex_destroy(&queue.lock);
+        pthread_cond_destroy(&queue.space);
+        pthread_cond_destroy(&queue.work);
+        pthread_cond_destroy(&queue.done);
+        free(queue.slots);
+        free(workers);
+        free(handles);
+        return -1;
+    }
+
+    // Write the slots out in order as they finish
+    pthread_mutex_lock(&queue.lock);
+    for (;;) {
+        if (queue.write_seq == queue.read_seq) {
+            if (queue.reader_done) {
+                break;
+            }
+            pthread_cond_wait(&queue.done, &queue.lock);
+            continue;
+        }
+        ScenarioSlot* slot = &queue.slots[queue.write_seq % queue.window];
+        if (!slot_finished(slot)) {
+            pthread_cond_wait(&queue.done, &queue.lock);
+            continue;
+        }
+        pthread_mutex_unlock(&queue.lock);
+
+        // Finished and not yet handed back, so no other thread touches it
+        print_result(out, slot);
+        report->scenarios++;
+        report->errors += slot->error[0] != 0;
+        report->trips += slot->stats.trips;
+
+        pthread_mutex_lock(&queue.lock);
+        queue.write_seq++;
+        pthread_cond_signal(&queue.space);
+    }
+    pthread_mutex_unlock(&queue.lock);
+
+    pthread_join(reader, NULL);
+    for (int w = 0; w < started; w++) {
+        pthread_join(handles[w], NULL);
+    }
+    for (int i = 0; i < queue.trail_count; i++) {
+        free(queue.trails[i].trail);
+    }
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.space);
+    pthread_cond_destroy(&queue.work);
+    pthread_cond_destroy(&queue.done);
+    free(queue.slots);
+    free(workers);
+    free(handles);
+    report->seconds = now_seconds() - start;
+    return 0;
+}
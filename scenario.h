@@ -0,0 +1,58 @@
+/*
+ * Scenario files: large experiment plans run as one stream.
+ *
+ * A scenario is a batch (see batch.h) described on one line by terms like
+ * seed scan terms; the terms a line leaves out come from the command line:
+ *
+ *   # name      policy           purchases             seeds          trail
+ *   name=base   policy=cautious  buy=250,180,50,110,60 seed=1 trips=100000
+ *   name=forts  skill=4          buy=220,200,40,100,80 seed=1 trips=100000 trail=trails/forts.trail
+ *
+ *   name=TEXT          label for the result line (default lineN, N the line number)
+ *   policy=NAME        built-in policy
+ *   skill=K            shooting skill 1-5
+ *   buy=O,F,A,C,M      initial purchases in dollars
+ *   seed=S trips=N     seeds S .. S + N - 1
+ *   trail=FILE         rules variant: a trail map (see trail.h)
+ *
+ * One result line comes out per scenario, in input order, with the batch
+ * statistics as terms, or name=... error="..." for a line that did not parse.
+ *
+ * A reader thread parses lines into a ring of window slots, which is both the
+ * prefetch queue and the reorder buffer: workers play a slot's seed range a
+ * chunk at a time, oldest slot first, so a large scenario is spread over every
+ * thread, and the main thread writes slots out in order as they finish and
+ * hands them back to the reader. Memory is the ring and at most
+ * SCENARIO_MAX_TRAILS loaded trails, whatever the length of the plan.
+ */
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define SCENARIO_WINDOW 256         // Default ring size, in scenarios
+#define SCENARIO_CHUNK 4096         // Trips a worker plays at a time
+#define SCENARIO_LINE_MAX 1024
+#define SCENARIO_NAME_LEN 64
+#define SCENARIO_MAX_TRAILS 16      // Distinct trail files in one plan
+
+typedef struct {
+    BatchJob defaults;          // Plan, policy, seeds and trips for terms a line leaves out; threads
+    int window;                 // 0 for SCENARIO_WINDOW
+} ScenarioRun;
+
+typedef struct {
+    uint64_t scenarios;
+    uint64_t errors;            // Lines that did not parse
+    uint64_t trips;
+    double seconds;
+} ScenarioReport;
+
+// Run every scenario read from in, writing the results to out in input order;
+// returns 0, or -1 if a thread or the ring could not be set up
+int run_scenarios(FILE* in, FILE* out, const ScenarioRun* run, ScenarioReport* report);
+
+#endif // SCENARIO_H
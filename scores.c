@@ -0,0 +1,584 @@
+/*
+ * High-score and trip-history store.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "scores.h"
+
+#define SCORE_RECORD_DATA 28        // Bytes covered by the CRC
+
+const char* const score_board_names[SCORE_BOARD_COUNT] = {"arrival", "cash", "miles"};
+
+static const char* const outcome_names[DEATH_CAUSE_COUNT + 1] = {
+    "arrived", "starvation", "exhaustion", "disease", "injuries", "blizzard", "snakebite", "massacre"
+};
+
+// CRC-32 (IEEE), four bits at a time
+static uint32_t crc32_bytes(const void* data, size_t size) {
+    static const uint32_t nibble[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 4) ^ nibble[(crc ^ bytes[i]) & 15];
+        crc = (crc >> 4) ^ nibble[(crc ^ (bytes[i] >> 4)) & 15];
+    }
+    return ~crc;
+}
+
+static int16_t clamp16(int value) {
+    return (int16_t)(value < INT16_MIN ? INT16_MIN : value > INT16_MAX ? INT16_MAX : value);
+}
+
+void score_record_fill(ScoreRecord* record, const TripResult* result, unsigned int seed,
+                       int shooting_skill, uint32_t time) {
+    memset(record, 0, sizeof(*record));
+    record->seed = seed;
+    record->time = time;
+    record->bullets = result->bullets;
+    record->food = clamp16(result->food);
+    record->clothing = clamp16(result->clothing);
+    record->misc_supplies = clamp16(result->misc_supplies);
+    record->cash = clamp16(result->cash);
+    record->miles = clamp16(result->miles_traveled);
+    record->arrival_day = clamp16(result->arrival_day);
+    record->outcome = (uint8_t)(result->outcome == TRIP_ARRIVED ? 0 : 1 + result->death_cause);
+    record->shooting_skill = (uint8_t)shooting_skill;
+    record->turns = (uint8_t)result->turn_number;
+    record->crc = crc32_bytes(record, SCORE_RECORD_DATA);
+}
+
+int score_record_valid(const ScoreRecord* record) {
+    return record->crc == crc32_bytes(record, SCORE_RECORD_DATA) &&
+           record->shooting_skill >= 1 && record->shooting_skill <= SCORE_SKILLS &&
+           record->outcome <= DEATH_CAUSE_COUNT;
+}
+
+// Log files
+
+// Create the log with its header in one step: a complete temporary file is
+// linked into place, so a crash never leaves a log without a header, and a
+// log another process created first is kept
+static int create_log(const char* path) {
+    char temp_path[4096];
+    ScoreLogHeader header;
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCORE_LOG_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(ScoreRecord);
+    header.log_id = ((uint64_t)now.tv_sec << 32) ^ (uint64_t)now.tv_nsec ^ ((uint64_t)getpid() << 20);
+
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp.%ld", path, (long)getpid());
+    int fd = open(temp_path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    int ok = write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) && fsync(fd) == 0;
+    close(fd);
+    if (ok && link(temp_path, path) != 0 && errno != EEXIST) {
+        ok = 0;
+    }
+    unlink(temp_path);
+    return ok ? 0 : -1;
+}
+
+// Drop a partial last record and any records at the end that fail their CRC
+static void trim_tail(int fd) {
+    struct stat info;
+    ScoreRecord record;
+
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < sizeof(ScoreLogHeader)) {
+        return;
+    }
+    uint64_t records = ((uint64_t)info.st_size - sizeof(ScoreLogHeader)) / sizeof(ScoreRecord);
+    while (records > 0) {
+        off_t offset = (off_t)(sizeof(ScoreLogHeader) + (records - 1) * sizeof(ScoreRecord));
+        if (pread(fd, &record, sizeof(record), offset) == (ssize_t)sizeof(record) &&
+            score_record_valid(&record)) {
+            break;
+        }
+        records--;
+    }
+    off_t size = (off_t)(sizeof(ScoreLogHeader) + records * sizeof(ScoreRecord));
+    if (size != info.st_size && ftruncate(fd, size) == 0) {
+        fsync(fd);
+    }
+}
+
+int score_log_open(ScoreLog* log, const char* path) {
+    ScoreLogHeader header;
+
+    log->fd = -1;
+    int fd = open(path, O_RDWR | O_APPEND);
+    if (fd < 0 && errno == ENOENT) {
+        if (create_log(path) != 0) {
+            return -1;
+        }
+        fd = open(path, O_RDWR | O_APPEND);
+    }
+    if (fd < 0) {
+        return -1;
+    }
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        memcmp(header.magic, SCORE_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(ScoreRecord)) {
+        close(fd);
+        return -1;
+    }
+
+    // Writers hold a shared lock; only one that finds itself alone may trim
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+        trim_tail(fd);
+    }
+    flock(fd, LOCK_SH);
+
+    log->fd = fd;
+    log->log_id = header.log_id;
+    return 0;
+}
+
+// Whole records in one write, so concurrent appenders never interleave
+int score_log_append(ScoreLog* log, const ScoreRecord* records, size_t count) {
+    size_t size = count * sizeof(ScoreRecord);
+    ssize_t written;
+    do {
+        written = write(log->fd, records, size);
+    } while (written < 0 && errno == EINTR);
+    return written == (ssize_t)size ? 0 : -1;
+}
+
+int score_log_sync(ScoreLog* log) {
+    return fdatasync(log->fd);
+}
+
+void score_log_close(ScoreLog* log) {
+    if (log->fd >= 0) {
+        close(log->fd);
+    }
+    log->fd = -1;
+}
+
+static ScoreLog game_log = {-1, 0};
+
+static void record_game(const GameState* game, const TripResult* result, void* ctx) {
+    ScoreLog* log = (ScoreLog*)ctx;
+    ScoreRecord record;
+
+    score_record_fill(&record, result, game->rand_seed, game->shooting_skill, (uint32_t)time(NULL));
+    if (score_log_append(log, &record, 1) == 0) {
+        score_log_sync(log);
+    }
+}
+
+int score_log_record_games(const char* path) {
+    if (score_log_open(&game_log, path) != 0) {
+        return -1;
+    }
+    set_trip_recorder(record_game, &game_log);
+    return 0;
+}
+
+// Index
+
+static uint64_t align64(uint64_t size) {
+    return (size + 63) & ~(uint64_t)63;
+}
+
+int score_board_key(int board, const ScoreRecord* record, int32_t* key) {
+    switch (board) {
+        case SCORE_BOARD_ARRIVAL:
+            *key = record->arrival_day;
+            return record->outcome == 0;
+        case SCORE_BOARD_CASH:
+            *key = -record->cash;
+            return record->outcome == 0;
+        case SCORE_BOARD_MILES:
+            *key = -record->miles;
+            return 1;
+    }
+    return 0;
+}
+
+static int map_file(const char* path, const uint8_t** base, size_t* size) {
+    struct stat info;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    *base = (const uint8_t*)map;
+    *size = (size_t)info.st_size;
+    return 0;
+}
+
+static int map_log(const char* path, const uint8_t** base, size_t* size, uint64_t* records) {
+    if (map_file(path, base, size) != 0) {
+        return -1;
+    }
+    const ScoreLogHeader* header = (const ScoreLogHeader*)*base;
+    if (*size < sizeof(ScoreLogHeader) ||
+        memcmp(header->magic, SCORE_LOG_MAGIC, sizeof(header->magic)) != 0 ||
+        header->record_size != sizeof(ScoreRecord)) {
+        munmap((void*)*base, *size);
+        return -1;
+    }
+    *records = (*size - sizeof(ScoreLogHeader)) / sizeof(ScoreRecord);
+    return 0;
+}
+
+#define RECORD_VALID(r) (valid[(r) >> 3] >> ((r) & 7) & 1)
+
+// Each board is counting-sorted on (skill, key) in log order, which leaves
+// ties in log order; the seed table is radix-sorted, 16 bits a pass, through a
+// scratch area at the end of the file that is cut off afterwards
+int score_index_build(const char* log_path) {
+    const uint8_t* log_base;
+    size_t log_size;
+    uint64_t records;
+    ScoreIndexHeader header;
+    char index_path[4096], temp_path[4096];
+    int status = -1;
+
+    if (map_log(log_path, &log_base, &log_size, &records) != 0) {
+        return -1;
+    }
+    if (records > UINT32_MAX) {
+        munmap((void*)log_base, log_size);
+        return -1;
+    }
+    const ScoreRecord* log_records = (const ScoreRecord*)(log_base + sizeof(ScoreLogHeader));
+    snprintf(index_path, sizeof(index_path), "%s.idx", log_path);
+    snprintf(temp_path, sizeof(temp_path), "%s.idx.tmp", log_path);
+
+    // Pass 1: check every CRC once, and find key ranges and board sizes
+    uint8_t* valid = calloc(records / 8 + 1, 1);
+    if (!valid) {
+        munmap((void*)log_base, log_size);
+        return -1;
+    }
+    memset(&header, 0, sizeof(header));
+    int32_t low[SCORE_BOARD_COUNT], high[SCORE_BOARD_COUNT];
+    for (int b = 0; b < SCORE_BOARD_COUNT; b++) {
+        low[b] = INT32_MAX;
+        high[b] = INT32_MIN;
+    }
+    for (uint64_t r = 0; r < records; r++) {
+        const ScoreRecord* record = &log_records[r];
+        if (!score_record_valid(record)) {
+            header.skipped++;
+            continue;
+        }
+        valid[r >> 3] |= (uint8_t)(1u << (r & 7));
+        header.seed_count++;
+        for (int b = 0; b < SCORE_BOARD_COUNT; b++) {
+            int32_t key;
+            if (score_board_key(b, record, &key)) {
+                low[b] = key < low[b] ? key : low[b];
+                high[b] = key > high[b] ? key : high[b];
+                header.board_run[b][record->shooting_skill]++;
+            }
+        }
+    }
+
+    uint64_t offset = align64(sizeof(ScoreIndexHeader));
+    for (int b = 0; b < SCORE_BOARD_COUNT; b++) {
+        for (int s = 1; s <= SCORE_SKILLS; s++) {
+            header.board_run[b][s] += header.board_run[b][s - 1];
+        }
+        header.board_offset[b] = offset;
+        offset += align64(header.board_run[b][SCORE_SKILLS] * sizeof(ScoreEntry));
+    }
+    header.seed_offset = offset;
+    offset += align64(header.seed_count * sizeof(ScoreSeedEntry));
+    uint64_t scratch_offset = offset;
+    uint64_t mapped = offset + header.seed_count * sizeof(ScoreSeedEntry);
+
+    memcpy(header.magic, SCORE_INDEX_MAGIC, sizeof(header.magic));
+    header.log_id = ((const ScoreLogHeader*)log_base)->log_id;
+    header.records = records;
+
+    int fd = open(temp_path, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0) {
+        goto done;
+    }
+    if (ftruncate(fd, (off_t)mapped) != 0) {
+        close(fd);
+        goto done;
+    }
+    uint8_t* base = mmap(NULL, (size_t)mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        goto done;
+    }
+
+    // Pass 2, per board: counting sort on (skill, key)
+    for (int b = 0; b < SCORE_BOARD_COUNT; b++) {
+        if (header.board_run[b][SCORE_SKILLS] == 0) {
+            continue;
+        }
+        uint64_t range = (uint64_t)((int64_t)high[b] - low[b]) + 1;
+        uint64_t* cursor = calloc(SCORE_SKILLS * range + 1, sizeof(uint64_t));
+        if (!cursor) {
+            munmap(base, (size_t)mapped);
+            close(fd);
+            goto done;
+        }
+        for (uint64_t r = 0; r < records; r++) {
+            int32_t key;
+            if (RECORD_VALID(r) && score_board_key(b, &log_records[r], &key)) {
+                cursor[(log_records[r].shooting_skill - 1) * range + (uint64_t)(key - low[b]) + 1]++;
+            }
+        }
+        for (uint64_t i = 1; i <= SCORE_SKILLS * range; i++) {
+            cursor[i] += cursor[i - 1];
+        }
+        ScoreEntry* entries = (ScoreEntry*)(base + header.board_offset[b]);
+        for (uint64_t r = 0; r < records; r++) {
+            int32_t key;
+            if (RECORD_VALID(r) && score_board_key(b, &log_records[r], &key)) {
+                uint64_t slot = cursor[(log_records[r].shooting_skill - 1) * range + (uint64_t)(key - low[b])]++;
+                entries[slot].key = key;
+                entries[slot].record = (uint32_t)r;
+            }
+        }
+        free(cursor);
+    }
+
+    // Seed table: two stable 16-bit passes, into scratch and back
+    ScoreSeedEntry* seeds = (ScoreSeedEntry*)(base + header.seed_offset);
+    ScoreSeedEntry* scratch = (ScoreSeedEntry*)(base + scratch_offset);
+    uint64_t* counts = malloc(65537 * sizeof(uint64_t));
+    if (!counts) {
+        munmap(base, (size_t)mapped);
+        close(fd);
+        goto done;
+    }
+    uint64_t n = 0;
+    for (uint64_t r = 0; r < records; r++) {
+        if (RECORD_VALID(r)) {
+            seeds[n].seed = log_records[r].seed;
+            seeds[n].record = (uint32_t)r;
+            n++;
+        }
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        const ScoreSeedEntry* from = pass == 0 ? seeds : scratch;
+        ScoreSeedEntry* to = pass == 0 ? scratch : seeds;
+        int shift = 16 * pass;
+        memset(counts, 0, 65537 * sizeof(uint64_t));
+        for (uint64_t i = 0; i < n; i++) {
+            counts[((from[i].seed >> shift) & 0xffff) + 1]++;
+        }
+        for (int d = 1; d <= 65536; d++) {
+            counts[d] += counts[d - 1];
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            to[counts[(from[i].seed >> shift) & 0xffff]++] = from[i];
+        }
+    }
+    free(counts);
+
+    memcpy(base, &header, sizeof(header));
+    int synced = msync(base, (size_t)mapped, MS_SYNC) == 0;
+    munmap(base, (size_t)mapped);
+    if (synced && ftruncate(fd, (off_t)scratch_offset) == 0 && fsync(fd) == 0 &&
+        rename(temp_path, index_path) == 0) {
+        status = 0;
+    }
+    close(fd);
+
+done:
+    if (status != 0) {
+        unlink(temp_path);
+    }
+    free(valid);
+    munmap((void*)log_base, log_size);
+    return status;
+}
+
+int score_store_open(ScoreStore* store, const char* log_path) {
+    char index_path[4096];
+
+    memset(store, 0, sizeof(*store));
+    if (map_log(log_path, &store->log_base, &store->log_size, &store->log_records) != 0) {
+        return -1;
+    }
+    store->records = (const ScoreRecord*)(store->log_base + sizeof(ScoreLogHeader));
+
+    snprintf(index_path, sizeof(index_path), "%s.idx", log_path);
+    if (map_file(index_path, &store->index_base, &store->index_size) != 0) {
+        score_store_close(store);
+        return -1;
+    }
+    store->index = (const ScoreIndexHeader*)store->index_base;
+    if (store->index_size < sizeof(ScoreIndexHeader) ||
+        memcmp(store->index->magic, SCORE_INDEX_MAGIC, sizeof(store->index->magic)) != 0 ||
+        store->index->log_id != ((const ScoreLogHeader*)store->log_base)->log_id ||
+        store->index->records > store->log_records) {
+        score_store_close(store);
+        return -1;
+    }
+    return 0;
+}
+
+void score_store_close(ScoreStore* store) {
+    if (store->log_base) {
+        munmap((void*)store->log_base, store->log_size);
+    }
+    if (store->index_base) {
+        munmap((void*)store->index_base, store->index_size);
+    }
+    memset(store, 0, sizeof(*store));
+}
+
+static const ScoreEntry* board_entries(const ScoreStore* store, int board) {
+    return (const ScoreEntry*)(store->index_base + store->index->board_offset[board]);
+}
+
+static int entry_before(const ScoreEntry* a, const ScoreEntry* b) {
+    return a->key < b->key || (a->key == b->key && a->record < b->record);
+}
+
+uint64_t score_board_size(const ScoreStore* store, int board, int skill) {
+    const uint64_t* run = store->index->board_run[board];
+    return skill == 0 ? run[SCORE_SKILLS] : run[skill] - run[skill - 1];
+}
+
+size_t score_top(const ScoreStore* store, int board, int skill, ScoreEntry* top, size_t k) {
+    const ScoreEntry* entries = board_entries(store, board);
+    const uint64_t* run = store->index->board_run[board];
+    size_t count = 0;
+
+    if (skill != 0) {
+        for (uint64_t i = run[skill - 1]; i < run[skill] && count < k; i++) {
+            top[count++] = entries[i];
+        }
+        return count;
+    }
+
+    // Merge the skill runs
+    uint64_t head[SCORE_SKILLS];
+    for (int s = 0; s < SCORE_SKILLS; s++) {
+        head[s] = run[s];
+    }
+    while (count < k) {
+        int best = -1;
+        for (int s = 0; s < SCORE_SKILLS; s++) {
+            if (head[s] < run[s + 1] &&
+                (best < 0 || entry_before(&entries[head[s]], &entries[head[best]]))) {
+                best = s;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        top[count++] = entries[head[best]++];
+    }
+    return count;
+}
+
+// Entries of [first, last) that sort before target
+static uint64_t count_before(const ScoreEntry* entries, uint64_t first, uint64_t last,
+                             const ScoreEntry* target) {
+    uint64_t begin = first;
+    while (first < last) {
+        uint64_t middle = first + (last - first) / 2;
+        if (entry_before(&entries[middle], target)) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first - begin;
+}
+
+uint64_t score_rank(const ScoreStore* store, int board, int skill, uint32_t record) {
+    ScoreEntry target;
+
+    if (record >= store->index->records || !score_record_valid(&store->records[record]) ||
+        !score_board_key(board, &store->records[record], &target.key)) {
+        return 0;
+    }
+    int own_skill = store->records[record].shooting_skill;
+    if (skill != 0 && skill != own_skill) {
+        return 0;
+    }
+    target.record = record;
+
+    const ScoreEntry* entries = board_entries(store, board);
+    const uint64_t* run = store->index->board_run[board];
+    uint64_t before = 0;
+    for (int s = 1; s <= SCORE_SKILLS; s++) {
+        if (skill == 0 || s == skill) {
+            before += count_before(entries, run[s - 1], run[s], &target);
+        }
+    }
+    return before + 1;
+}
+
+size_t score_find_seed(const ScoreStore* store, uint32_t seed, uint32_t* records, size_t max) {
+    const ScoreSeedEntry* seeds = (const ScoreSeedEntry*)(store->index_base + store->index->seed_offset);
+    uint64_t first = 0, last = store->index->seed_count;
+    while (first < last) {
+        uint64_t middle = first + (last - first) / 2;
+        if (seeds[middle].seed < seed) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    size_t count = 0;
+    for (uint64_t i = first; i < store->index->seed_count && seeds[i].seed == seed; i++) {
+        if (count < max) {
+            records[count] = seeds[i].record;
+        }
+        count++;
+    }
+    return count;
+}
+
+// The arrival date as calculate_final_date prints it
+static void format_arrival(char* text, size_t size, int day) {
+    static const char* const months[] = {"JULY", "AUGUST", "SEPTEMBER", "OCTOBER", "NOVEMBER", "DECEMBER"};
+    static const int month_start[] = {93, 124, 155, 185, 216, 246};
+    int m = 0;
+    while (m < 5 && day > month_start[m + 1]) {
+        m++;
+    }
+    snprintf(text, size, "%s %d", months[m], day - month_start[m]);
+}
+
+void score_print_record(FILE* out, const ScoreStore* store, uint32_t record) {
+    const ScoreRecord* r = &store->records[record];
+    char arrival[32];
+
+    if (r->outcome == 0) {
+        format_arrival(arrival, sizeof(arrival), r->arrival_day);
+    } else {
+        snprintf(arrival, sizeof(arrival), "died: %s", outcome_names[r->outcome]);
+    }
+    fprintf(out, "#%-10u seed %-10u skill %d  %-18s turns %2d  miles %4d  food %4d  bullets %5d"
+            "  clothing %3d  misc %3d  cash %3d\n",
+            record, r->seed, r->shooting_skill, arrival, r->turns, r->miles, r->food,
+            (int)r->bullets, r->clothing, r->misc_supplies, r->cash);
+}
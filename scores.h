@@ -0,0 +1,140 @@
+/*
+ * High-score and trip-history store.
+ *
+ * The log is append-only: a 64-byte ScoreLogHeader, written once through a
+ * temporary file and link, then 32-byte ScoreRecords, each with a CRC-32 of
+ * its other bytes. Writers append whole records with single O_APPEND writes,
+ * so threads and processes can share a log. A writer that finds a torn or
+ * corrupt tail, left by a crash, trims it when it opens the log, provided no
+ * other writer has the log open. Readers skip any record whose CRC fails.
+ *
+ * The index (LOG.idx) is built from the log and read through mmap. Each
+ * leaderboard is one array of (key, record) entries sorted by shooting skill,
+ * then key (better first), then log order. So a skill's top k is a slice, the
+ * overall top k is a merge of the five skill runs, and a rank is a binary
+ * search per run. A seed table sorted by seed finds a player's records.
+ * Queries touch only the pages they read, whatever the log size.
+ */
+
+#ifndef SCORES_H
+#define SCORES_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "oregon.h"
+
+#define SCORE_LOG_MAGIC "ORSCORE1"
+#define SCORE_INDEX_MAGIC "ORSCIDX1"
+#define SCORE_SKILLS 5              // Shooting skill 1-5
+
+// One finished trip, 32 bytes
+typedef struct {
+    uint32_t seed;
+    uint32_t time;              // Unix time the trip was recorded
+    int32_t bullets;
+    int16_t food;
+    int16_t clothing;
+    int16_t misc_supplies;
+    int16_t cash;
+    int16_t miles;
+    int16_t arrival_day;        // Days after March 29 (calculate_final_date), 0 if died
+    uint8_t outcome;            // 0 arrived, 1 + DeathCause
+    uint8_t shooting_skill;
+    uint8_t turns;
+    uint8_t reserved;
+    uint32_t crc;               // CRC-32 of the 28 bytes above
+} ScoreRecord;
+
+typedef struct {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t log_id;            // Random at creation; ties an index to its log
+    uint8_t padding[40];
+} ScoreLogHeader;
+
+typedef enum {
+    SCORE_BOARD_ARRIVAL = 0,    // Fastest arrival, arrived trips
+    SCORE_BOARD_CASH,           // Most cash left, arrived trips
+    SCORE_BOARD_MILES,          // Farthest traveled, every trip
+    SCORE_BOARD_COUNT
+} ScoreBoard;
+
+extern const char* const score_board_names[SCORE_BOARD_COUNT];
+
+typedef struct {
+    int fd;
+    uint64_t log_id;
+} ScoreLog;
+
+// Index entry: a record of the log and its sort key, smaller is better
+typedef struct {
+    int32_t key;
+    uint32_t record;
+} ScoreEntry;
+
+typedef struct {
+    uint32_t seed;
+    uint32_t record;
+} ScoreSeedEntry;
+
+typedef struct {
+    char magic[8];
+    uint64_t log_id;
+    uint64_t records;                                       // Log records covered
+    uint64_t skipped;                                       // Of those, failed their CRC
+    uint64_t board_offset[SCORE_BOARD_COUNT];               // ScoreEntry[]
+    uint64_t board_run[SCORE_BOARD_COUNT][SCORE_SKILLS + 1]; // Skill s is entries run[s-1] .. run[s]
+    uint64_t seed_offset;                                   // ScoreSeedEntry[seed_count]
+    uint64_t seed_count;
+} ScoreIndexHeader;
+
+// A log and its index, both mapped read-only
+typedef struct {
+    const uint8_t* log_base;
+    size_t log_size;
+    uint64_t log_records;       // Records in the log now, which may be past the index
+    const ScoreRecord* records;
+    const uint8_t* index_base;
+    size_t index_size;
+    const ScoreIndexHeader* index;
+} ScoreStore;
+
+void score_record_fill(ScoreRecord* record, const TripResult* result, unsigned int seed,
+                       int shooting_skill, uint32_t time);
+int score_record_valid(const ScoreRecord* record);
+
+// Open for appending, creating the log if needed; returns 0 or -1
+int score_log_open(ScoreLog* log, const char* path);
+int score_log_append(ScoreLog* log, const ScoreRecord* records, size_t count);
+int score_log_sync(ScoreLog* log);
+void score_log_close(ScoreLog* log);
+
+// Log every interactive game that finishes from here on to path (see set_trip_recorder)
+int score_log_record_games(const char* path);
+
+// Build LOG.idx from LOG; returns 0 or -1
+int score_index_build(const char* log_path);
+
+int score_store_open(ScoreStore* store, const char* log_path);
+void score_store_close(ScoreStore* store);
+
+// Sort key of a record on a board; returns 0 if the record is not on the board
+int score_board_key(int board, const ScoreRecord* record, int32_t* key);
+
+// Up to k best entries of a board, skill 0 for all skills; returns the count
+size_t score_top(const ScoreStore* store, int board, int skill, ScoreEntry* top, size_t k);
+
+// 1-based rank of a record on a board (skill 0 for all skills), 0 if not on it
+uint64_t score_rank(const ScoreStore* store, int board, int skill, uint32_t record);
+
+// Entries on a board for one skill, or all skills with skill 0
+uint64_t score_board_size(const ScoreStore* store, int board, int skill);
+
+// Records of a seed, in log order; returns the count, writing up to max of them
+size_t score_find_seed(const ScoreStore* store, uint32_t seed, uint32_t* records, size_t max);
+
+void score_print_record(FILE* out, const ScoreStore* store, uint32_t record);
+
+#endif // SCORES_H
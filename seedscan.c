@@ -0,0 +1,351 @@
+/*
+ * Seed scanner over the full generator seed space.
+ */
+
+#include <time.h>
+#include "seedscan.h"
+
+#define SCAN_PROGRESS_WINDOWS 64        // Progress line every 64M seeds
+
+const char* const scan_feature_names[SCAN_FEATURE_COUNT] = {
+    "outcome", "turns", "arrival_day", "miles", "food", "bullets", "clothing", "misc",
+    "cash", "riders", "south_pass", "blue_mountains"
+};
+
+static const char* const cause_names[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "blizzard", "snakebite", "massacre"
+};
+
+// What the trip in progress on this thread has shown beyond its TripResult
+typedef struct {
+    int first_riders;
+    int flags;
+} ScanTrip;
+
+static OREGON_THREAD_LOCAL ScanTrip t_trip = {SCAN_NO_RIDERS, 0};
+
+// Wraps the job's policy to watch the trip and abandon it early
+typedef struct {
+    const Policy* base;
+    const ScanPredicate* predicate;
+} ScanPolicyCtx;
+
+typedef struct {
+    const ScanPredicate* predicate;
+    ScanMatch* matches;
+    size_t count;
+    size_t capacity;
+    uint64_t abandoned;
+    int failed;
+} ScanWorker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void scan_predicate_init(ScanPredicate* predicate) {
+    for (int f = 0; f < SCAN_FEATURE_COUNT; f++) {
+        predicate->low[f] = INT32_MIN;
+        predicate->high[f] = INT32_MAX;
+    }
+}
+
+static void narrow(ScanPredicate* predicate, int feature, int64_t low, int64_t high) {
+    if (low > predicate->low[feature]) {
+        predicate->low[feature] = low > INT32_MAX ? INT32_MAX : (int32_t)low;
+    }
+    if (high < predicate->high[feature]) {
+        predicate->high[feature] = high < INT32_MIN ? INT32_MIN : (int32_t)high;
+    }
+}
+
+int scan_predicate_parse_term(ScanPredicate* predicate, const char* term) {
+    char name[32];
+    size_t length = strcspn(term, "<>=");
+    if (length == 0 || length >= sizeof(name) || term[length] == '\0') {
+        return -1;
+    }
+    memcpy(name, term, length);
+    name[length] = '\0';
+
+    const char* op = term + length;
+    const char* value = op + ((op[1] == '=') ? 2 : 1);
+
+    // Outcome is matched by name
+    if (strcmp(name, "cause") == 0 || strcmp(name, "outcome") == 0) {
+        if (op[0] != '=') {
+            return -1;
+        }
+        if (strcmp(value, "arrived") == 0) {
+            narrow(predicate, SCAN_OUTCOME, 0, 0);
+            return 0;
+        }
+        if (strcmp(value, "died") == 0) {
+            narrow(predicate, SCAN_OUTCOME, 1, DEATH_CAUSE_COUNT);
+            return 0;
+        }
+        for (int c = 0; c < DEATH_CAUSE_COUNT; c++) {
+            if (strcmp(value, cause_names[c]) == 0) {
+                narrow(predicate, SCAN_OUTCOME, 1 + c, 1 + c);
+                return 0;
+            }
+        }
+        return -1;
+    }
+
+    int feature = -1;
+    for (int f = 0; f < SCAN_FEATURE_COUNT; f++) {
+        if (f != SCAN_OUTCOME && strcmp(name, scan_feature_names[f]) == 0) {
+            feature = f;
+        }
+    }
+    if (feature < 0) {
+        return -1;
+    }
+    if (feature == SCAN_RIDERS && op[0] == '=' && strcmp(value, "none") == 0) {
+        narrow(predicate, feature, SCAN_NO_RIDERS, SCAN_NO_RIDERS);
+        return 0;
+    }
+
+    char* end;
+    long long number = strtoll(value, &end, 10);
+    if (end == value) {
+        return -1;
+    }
+
+    if (op[0] == '=' && strncmp(end, "..", 2) == 0) {
+        const char* upper = end + 2;
+        long long high = strtoll(upper, &end, 10);
+        if (end == upper || *end) {
+            return -1;
+        }
+        narrow(predicate, feature, number, high);
+        return 0;
+    }
+    if (*end) {
+        return -1;
+    }
+
+    if (op[0] == '=') {
+        narrow(predicate, feature, number, number);
+    } else if (op[0] == '<') {
+        narrow(predicate, feature, INT32_MIN, op[1] == '=' ? number : number - 1);
+    } else {
+        narrow(predicate, feature, op[1] == '=' ? number : number + 1, INT32_MAX);
+    }
+    return 0;
+}
+
+void scan_print_match(FILE* out, const ScanMatch* match) {
+    const int32_t* features = match->features;
+
+    fprintf(out, "seed=%u outcome=%s", match->seed,
+            features[SCAN_OUTCOME] == 0 ? "arrived" : cause_names[features[SCAN_OUTCOME] - 1]);
+    for (int f = SCAN_TURNS; f < SCAN_FEATURE_COUNT; f++) {
+        if (f == SCAN_RIDERS && features[f] == SCAN_NO_RIDERS) {
+            fprintf(out, " riders=none");
+        } else {
+            fprintf(out, " %s=%d", scan_feature_names[f], (int)features[f]);
+        }
+    }
+    fprintf(out, "\n");
+}
+
+static int scan_turn_action(const GameState* game, int fort_open, void* ctx) {
+    const ScanPolicyCtx* scan = (const ScanPolicyCtx*)ctx;
+    if (game->turn_number > scan->predicate->high[SCAN_TURNS]) {
+        abandon_trip(game);
+    }
+    return scan->base->turn_action(game, fort_open, scan->base->ctx);
+}
+
+static int scan_eating_level(const GameState* game, void* ctx) {
+    const ScanPolicyCtx* scan = (const ScanPolicyCtx*)ctx;
+    return scan->base->eating_level(game, scan->base->ctx);
+}
+
+static int scan_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    const ScanPolicyCtx* scan = (const ScanPolicyCtx*)ctx;
+    if (t_trip.first_riders == SCAN_NO_RIDERS) {
+        t_trip.first_riders = game->miles_traveled;
+        if (game->miles_traveled < scan->predicate->low[SCAN_RIDERS] ||
+            game->miles_traveled > scan->predicate->high[SCAN_RIDERS]) {
+            abandon_trip(game);
+        }
+    }
+    return scan->base->rider_tactic(game, hostile, scan->base->ctx);
+}
+
+static int scan_fort_purchase(const GameState* game, int item, void* ctx) {
+    const ScanPolicyCtx* scan = (const ScanPolicyCtx*)ctx;
+    return scan->base->fort_purchase(game, item, scan->base->ctx);
+}
+
+static int scan_shot_result(int skill_level, const char* word, void* ctx) {
+    const ScanPolicyCtx* scan = (const ScanPolicyCtx*)ctx;
+    return scan->base->shot_result(skill_level, word, scan->base->ctx);
+}
+
+static void scan_on_turn(const GameState* game, void* ctx) {
+    (void)ctx;
+    t_trip.flags = game->game_flags;
+}
+
+static void scan_on_trip(int worker_index, unsigned int seed, const TripResult* result, void* ctx) {
+    ScanWorker* worker = (ScanWorker*)ctx;
+    const ScanPredicate* predicate = worker->predicate;
+    ScanTrip trip = t_trip;
+    (void)worker_index;
+
+    t_trip.first_riders = SCAN_NO_RIDERS;
+    t_trip.flags = 0;
+    if (result->outcome == TRIP_ABANDONED) {
+        worker->abandoned++;
+        return;
+    }
+
+    ScanMatch match;
+    match.seed = seed;
+    match.features[SCAN_OUTCOME] = result->outcome == TRIP_ARRIVED ? 0 : 1 + result->death_cause;
+    match.features[SCAN_TURNS] = result->turn_number;
+    match.features[SCAN_ARRIVAL_DAY] = result->arrival_day;
+    match.features[SCAN_MILES] = result->miles_traveled;
+    match.features[SCAN_FOOD] = result->food;
+    match.features[SCAN_BULLETS] = result->bullets;
+    match.features[SCAN_CLOTHING] = result->clothing;
+    match.features[SCAN_MISC_SUPPLIES] = result->misc_supplies;
+    match.features[SCAN_CASH] = result->cash;
+    match.features[SCAN_RIDERS] = trip.first_riders;
+    match.features[SCAN_SOUTH_PASS] = (trip.flags & FLAG_SOUTH_PASS) != 0;
+    match.features[SCAN_BLUE_MOUNTAINS] = (trip.flags & FLAG_BLUE_MOUNTAINS) != 0;
+
+    for (int f = 0; f < SCAN_FEATURE_COUNT; f++) {
+        if (match.features[f] < predicate->low[f] || match.features[f] > predicate->high[f]) {
+            return;
+        }
+    }
+
+    if (worker->count == worker->capacity) {
+        size_t capacity = worker->capacity ? worker->capacity * 2 : 256;
+        ScanMatch* grown = realloc(worker->matches, capacity * sizeof(ScanMatch));
+        if (!grown) {
+            worker->failed = 1;
+            return;
+        }
+        worker->matches = grown;
+        worker->capacity = capacity;
+    }
+    worker->matches[worker->count++] = match;
+}
+
+static int compare_matches(const void* a, const void* b) {
+    unsigned int seed_a = ((const ScanMatch*)a)->seed;
+    unsigned int seed_b = ((const ScanMatch*)b)->seed;
+    return (seed_a > seed_b) - (seed_a < seed_b);
+}
+
+int scan_seeds(const BatchJob* job, const ScanPredicate* predicate, ScanMatchHook on_match,
+               void* ctx, FILE* progress, ScanReport* report) {
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    ScanPolicyCtx policy_ctx = {job->policy, predicate};
+    Policy policy = {
+        job->policy->name, scan_turn_action, scan_eating_level, scan_rider_tactic,
+        scan_fort_purchase, scan_shot_result, &policy_ctx
+    };
+    ScanWorker* workers = calloc((size_t)threads, sizeof(ScanWorker));
+    void** contexts = calloc((size_t)threads, sizeof(void*));
+    ScanMatch* window_matches = NULL;
+    size_t window_capacity = 0;
+    int status = 0, stop = 0;
+    double start = now_seconds();
+
+    memset(report, 0, sizeof(*report));
+    if (!workers || !contexts) {
+        free(workers);
+        free(contexts);
+        return -1;
+    }
+    for (int w = 0; w < threads; w++) {
+        workers[w].predicate = predicate;
+        contexts[w] = &workers[w];
+    }
+
+    BatchJob window = *job;
+    window.policy = &policy;
+    window.threads = threads;
+    window.on_turn = scan_on_turn;
+    window.on_trip = scan_on_trip;
+    window.worker_ctx = contexts;
+
+    uint64_t windows = 0;
+    for (uint64_t done = 0; done < job->trips && !stop; windows++) {
+        // Windows never wrap past the top seed, so each one's seeds ascend
+        window.first_seed = (unsigned int)((job->first_seed + done) & SEED_MASK);
+        window.trips = job->trips - done;
+        if (window.trips > SCAN_WINDOW) {
+            window.trips = SCAN_WINDOW;
+        }
+        if (window.trips > (uint64_t)SEED_MASK + 1 - window.first_seed) {
+            window.trips = (uint64_t)SEED_MASK + 1 - window.first_seed;
+        }
+
+        BatchStats stats;
+        if (run_batch(&window, &stats) != 0) {
+            status = -1;
+            break;
+        }
+
+        size_t count = 0;
+        for (int w = 0; w < threads; w++) {
+            count += workers[w].count;
+            status |= workers[w].failed ? -1 : 0;
+        }
+        if (status == 0 && count > window_capacity) {
+            ScanMatch* grown = realloc(window_matches, count * sizeof(ScanMatch));
+            if (grown) {
+                window_matches = grown;
+                window_capacity = count;
+            } else {
+                status = -1;
+            }
+        }
+        if (status != 0) {
+            break;
+        }
+
+        count = 0;
+        for (int w = 0; w < threads; w++) {
+            memcpy(window_matches + count, workers[w].matches, workers[w].count * sizeof(ScanMatch));
+            count += workers[w].count;
+            report->abandoned += workers[w].abandoned;
+            workers[w].count = 0;
+            workers[w].abandoned = 0;
+        }
+        qsort(window_matches, count, sizeof(ScanMatch), compare_matches);
+        for (size_t m = 0; m < count && !stop; m++) {
+            report->matched++;
+            stop = on_match(&window_matches[m], ctx);
+        }
+
+        done += window.trips;
+        report->scanned = done;
+        if (progress && (windows % SCAN_PROGRESS_WINDOWS == SCAN_PROGRESS_WINDOWS - 1 ||
+                         done == job->trips)) {
+            double elapsed = now_seconds() - start;
+            fprintf(progress, "%llu of %llu seeds, %llu matches, %.0f seeds/s\n",
+                    (unsigned long long)done, (unsigned long long)job->trips,
+                    (unsigned long long)report->matched, elapsed > 0 ? (double)done / elapsed : 0.0);
+        }
+    }
+    report->seconds = now_seconds() - start;
+
+    for (int w = 0; w < threads; w++) {
+        free(workers[w].matches);
+    }
+    free(workers);
+    free(contexts);
+    free(window_matches);
+    return status;
+}
@@ -0,0 +1,80 @@
+/*
+ * Seed scanner: finds the generator seeds whose trip, under a fixed purchase
+ * plan and policy, satisfies a predicate.
+ *
+ * The generator has only 2^31 states, so the whole seed space can be swept.
+ * A predicate is a conjunction of inclusive ranges over trip features, written
+ * like trace query terms: "turns<=12", "outcome=arrived", "riders>=950",
+ * "south_pass=1". A trip is abandoned as soon as a term is known to fail (a
+ * turn started past the turns range, a first rider encounter outside the
+ * riders range), which rejects most seeds for the restrictive predicates within
+ * a turn or two.
+ *
+ * Seeds are played on the batch runner a window at a time, and each window's
+ * matches are reported in seed order, so the output is the same for any
+ * thread count.
+ */
+
+#ifndef SEEDSCAN_H
+#define SEEDSCAN_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define SCAN_WINDOW (1u << 20)          // Seeds per batch
+#define SCAN_NO_RIDERS 10000            // riders feature of a trip that met none
+
+typedef enum {
+    SCAN_OUTCOME = 0,       // 0 arrived, 1 + DeathCause
+    SCAN_TURNS,
+    SCAN_ARRIVAL_DAY,       // 0 if the party died
+    SCAN_MILES,
+    SCAN_FOOD,
+    SCAN_BULLETS,
+    SCAN_CLOTHING,
+    SCAN_MISC_SUPPLIES,
+    SCAN_CASH,
+    SCAN_RIDERS,            // Miles at the first rider encounter
+    SCAN_SOUTH_PASS,        // 1 if the party crossed South Pass
+    SCAN_BLUE_MOUNTAINS,    // 1 if the party cleared the Blue Mountains
+    SCAN_FEATURE_COUNT
+} ScanFeature;
+
+extern const char* const scan_feature_names[SCAN_FEATURE_COUNT];
+
+typedef struct {
+    int32_t low[SCAN_FEATURE_COUNT];
+    int32_t high[SCAN_FEATURE_COUNT];
+} ScanPredicate;
+
+typedef struct {
+    unsigned int seed;
+    int32_t features[SCAN_FEATURE_COUNT];
+} ScanMatch;
+
+typedef struct {
+    uint64_t scanned;
+    uint64_t matched;
+    uint64_t abandoned;     // Trips stopped early by the predicate
+    double seconds;
+} ScanReport;
+
+// Called for every match, in seed order; returns nonzero to stop the scan
+typedef int (*ScanMatchHook)(const ScanMatch* match, void* ctx);
+
+void scan_predicate_init(ScanPredicate* predicate);
+
+// Parse "turns<=12", "riders>=950", "outcome=arrived", "cause=disease", "cash=100..200"
+int scan_predicate_parse_term(ScanPredicate* predicate, const char* term);
+
+// One line of feature=value pairs, in the term syntax
+void scan_print_match(FILE* out, const ScanMatch* match);
+
+// Scan seeds job->first_seed .. + job->trips with the job's plan, policy and
+// threads (its hooks are replaced); progress lines go to progress if not NULL.
+// Returns 0, or -1 if the plan is invalid or memory runs out.
+int scan_seeds(const BatchJob* job, const ScanPredicate* predicate, ScanMatchHook on_match,
+               void* ctx, FILE* progress, ScanReport* report);
+
+#endif // SEEDSCAN_H
@@ -0,0 +1,290 @@
+/*
+ * Survival sensitivities by common-random-number differences and likelihood ratios.
+ */
+
+#include <math.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "sensitivity.h"
+#include "batch.h"
+
+// Seeds handed to a worker at a time
+#define SENSITIVITY_CHUNK 1024
+
+#define THRESHOLDS (EVENT_COUNT - 1)
+
+static const char* const difference_names[SENSITIVITY_DIFFERENCES] = {
+    "oxen", "food", "ammunition", "clothing", "misc supplies", "shooting skill"
+};
+
+static const char* const event_names[EVENT_COUNT] = {
+    "wagon breakdown", "ox injury", "daughter breaks arm", "ox wanders off",
+    "son gets lost", "unsafe water", "heavy rains", "bandits attack", "fire in wagon",
+    "lose way in fog", "poisonous snake", "wagon swamped fording", "wild animals attack",
+    "cold weather", "hail storm", "helpful indians"
+};
+
+// Sums over seeds, merged across workers
+typedef struct {
+    uint64_t trips;
+    uint64_t played;
+    uint64_t arrived;
+    int64_t difference[SENSITIVITY_DIFFERENCES];    // Arrived at the high end less at the low end
+    uint64_t changed[SENSITIVITY_DIFFERENCES];      // Seeds where the two ends differ
+    int64_t score[THRESHOLDS];                      // Scaled scores
+    int64_t arrived_score[THRESHOLDS];              // Of the trips that arrived
+    uint64_t score_sq[THRESHOLDS];
+    uint64_t arrived_score_sq[THRESHOLDS];
+} SensitivitySums;
+
+// How the engine maps draws to events, and what moving a threshold changes
+typedef struct {
+    int width[EVENT_COUNT];         // Draws 0..99 that pick each event
+    int loser[THRESHOLDS];          // Event that gives threshold j's next draw to event j, -1 if none
+} EventDraws;
+
+typedef struct {
+    const SensitivityJob* job;
+    const EventDraws* draws;
+    const PurchasePlan* low;        // Per difference
+    const PurchasePlan* high;
+    atomic_uint_fast64_t* next;
+    SensitivitySums sums;
+} SensitivityWorker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int* plan_value(PurchasePlan* plan, int difference) {
+    switch (difference) {
+        case 0:
+            return &plan->oxen;
+        case 1 + ITEM_FOOD:
+            return &plan->food;
+        case 1 + ITEM_AMMUNITION:
+            return &plan->ammunition;
+        case 1 + ITEM_CLOTHING:
+            return &plan->clothing;
+        case 1 + ITEM_MISC_SUPPLIES:
+            return &plan->misc_supplies;
+        default:
+            return &plan->shooting_skill;
+    }
+}
+
+// Taken from event_for_draw, the mapping the engine plays, so a draw that
+// falls past every threshold counts for whichever event it really picks
+static void event_draws(EventDraws* draws) {
+    memset(draws, 0, sizeof(*draws));
+    for (int draw = 0; draw < 100; draw++) {
+        draws->width[event_for_draw(draw)]++;
+    }
+    for (int j = 0; j < THRESHOLDS; j++) {
+        int next = event_probabilities[j] + 1;
+        draws->loser[j] = next < 100 && event_for_draw(next) != j ? event_for_draw(next) : -1;
+    }
+}
+
+// Threshold j's score is scaled by this, to keep it an integer
+static int64_t score_scale(const EventDraws* draws, int j) {
+    return draws->loser[j] < 0 ? 1 : (int64_t)draws->width[j] * draws->width[draws->loser[j]];
+}
+
+static int play(const SensitivityWorker* worker, const PurchasePlan* plan, unsigned int seed,
+                SensitivitySums* sums) {
+    TripResult result;
+    simulate_trip(plan, worker->job->policy, seed, NULL, NULL, &result);
+    sums->played++;
+    return result.outcome == TRIP_ARRIVED;
+}
+
+static void play_seed(SensitivityWorker* worker, unsigned int seed) {
+    const SensitivityJob* job = worker->job;
+    SensitivitySums* sums = &worker->sums;
+    unsigned int counts[EVENT_COUNT];
+
+    memset(counts, 0, sizeof(counts));
+    set_event_counts(counts);
+    int arrived = play(worker, &job->plan, seed, sums);
+    set_event_counts(NULL);
+    sums->trips++;
+    sums->arrived += (uint64_t)arrived;
+
+    for (int d = 0; d < SENSITIVITY_DIFFERENCES; d++) {
+        const PurchasePlan* low = &worker->low[d];
+        const PurchasePlan* high = &worker->high[d];
+        if (memcmp(low, high, sizeof(PurchasePlan)) == 0) {
+            continue;
+        }
+        int low_arrived = memcmp(low, &job->plan, sizeof(PurchasePlan)) == 0 ? arrived : play(worker, low, seed, sums);
+        int high_arrived = memcmp(high, &job->plan, sizeof(PurchasePlan)) == 0 ? arrived : play(worker, high, seed, sums);
+        sums->difference[d] += high_arrived - low_arrived;
+        sums->changed[d] += high_arrived != low_arrived;
+    }
+
+    for (int j = 0; j < THRESHOLDS; j++) {
+        // Score times width[j] * width[loser]
+        int loser = worker->draws->loser[j];
+        if (loser < 0) {
+            continue;
+        }
+        int64_t score = (int64_t)counts[j] * worker->draws->width[loser] -
+                        (int64_t)counts[loser] * worker->draws->width[j];
+        uint64_t score_sq = (uint64_t)(score * score);
+        sums->score[j] += score;
+        sums->score_sq[j] += score_sq;
+        if (arrived) {
+            sums->arrived_score[j] += score;
+            sums->arrived_score_sq[j] += score_sq;
+        }
+    }
+}
+
+static void* sensitivity_worker_main(void* arg) {
+    SensitivityWorker* worker = (SensitivityWorker*)arg;
+    const SensitivityJob* job = worker->job;
+
+    for (;;) {
+        uint64_t first = atomic_fetch_add(worker->next, SENSITIVITY_CHUNK);
+        if (first >= job->trips) {
+            break;
+        }
+        uint64_t last = first + SENSITIVITY_CHUNK < job->trips ? first + SENSITIVITY_CHUNK : job->trips;
+        for (uint64_t i = first; i < last; i++) {
+            play_seed(worker, (unsigned int)((job->first_seed + i) & SEED_MASK));
+        }
+    }
+    return NULL;
+}
+
+static void sums_merge(SensitivitySums* into, const SensitivitySums* from) {
+    into->trips += from->trips;
+    into->played += from->played;
+    into->arrived += from->arrived;
+    for (int d = 0; d < SENSITIVITY_DIFFERENCES; d++) {
+        into->difference[d] += from->difference[d];
+        into->changed[d] += from->changed[d];
+    }
+    for (int j = 0; j < THRESHOLDS; j++) {
+        into->score[j] += from->score[j];
+        into->arrived_score[j] += from->arrived_score[j];
+        into->score_sq[j] += from->score_sq[j];
+        into->arrived_score_sq[j] += from->arrived_score_sq[j];
+    }
+}
+
+// The step either side of the base plan that stays a valid plan
+static void difference_ends(const SensitivityJob* job, int difference, PurchasePlan* low, PurchasePlan* high) {
+    GameState probe;
+    int step = difference == SENSITIVITY_DIFFERENCES - 1 ? 1 : job->step;
+
+    *low = job->plan;
+    *high = job->plan;
+    *plan_value(low, difference) -= step;
+    *plan_value(high, difference) += step;
+    if (apply_purchase_plan(&probe, low) != 0) {
+        *low = job->plan;
+    }
+    if (apply_purchase_plan(&probe, high) != 0) {
+        *high = job->plan;
+    }
+}
+
+static void fill_rows(const SensitivityJob* job, const EventDraws* draws, const PurchasePlan* low_plans,
+                      const PurchasePlan* high_plans, const SensitivitySums* sums, SensitivityReport* report) {
+    double n = (double)sums->trips;
+    double mean = (double)sums->arrived / n;
+
+    report->survival = mean;
+    report->survival_error = sqrt(mean * (1.0 - mean) / n);
+    report->row_count = 0;
+
+    for (int d = 0; d < SENSITIVITY_DIFFERENCES; d++) {
+        SensitivityRow* row = &report->rows[report->row_count++];
+        PurchasePlan low = low_plans[d], high = high_plans[d];
+        PurchasePlan base = job->plan;
+        snprintf(row->name, sizeof(row->name), "%s", difference_names[d]);
+        row->unit = d == SENSITIVITY_DIFFERENCES - 1 ? "level" : "$";
+        row->value = *plan_value(&base, d);
+        row->low = *plan_value(&low, d);
+        row->high = *plan_value(&high, d);
+        row->derivative = row->std_error = 0.0;
+        if (row->high > row->low) {
+            // Paired differences in {-1, 0, 1}: mean and standard error, per unit
+            double span = (double)(row->high - row->low);
+            double diff = (double)sums->difference[d] / n;
+            double variance = ((double)sums->changed[d] / n - diff * diff) * n / (n > 1 ? n - 1 : 1);
+            row->derivative = diff / span;
+            row->std_error = sqrt(variance / n) / span;
+        }
+    }
+
+    for (int j = 0; j < THRESHOLDS; j++) {
+        SensitivityRow* row = &report->rows[report->row_count++];
+        double scale = (double)score_scale(draws, j);
+        double score = (double)sums->score[j] / n;
+        double arrived_score = (double)sums->arrived_score[j] / n;
+        double score_sq = (double)sums->score_sq[j] / n;
+        double arrived_score_sq = (double)sums->arrived_score_sq[j] / n;
+        // Per trip (arrived - mean) * score; arrived is 0 or 1
+        double term = arrived_score - mean * score;
+        double term_sq = arrived_score_sq * (1.0 - 2.0 * mean) + mean * mean * score_sq;
+        double variance = (term_sq - term * term) * n / (n > 1 ? n - 1 : 1);
+        snprintf(row->name, sizeof(row->name), "%s|%s", event_names[j],
+                 event_names[draws->loser[j] >= 0 ? draws->loser[j] : j + 1]);
+        row->unit = "point";
+        row->value = event_probabilities[j];
+        row->low = j > 0 ? event_probabilities[j - 1] : -1;
+        row->high = j + 1 < THRESHOLDS ? event_probabilities[j + 1] : 99;
+        row->derivative = term / scale;
+        row->std_error = variance > 0.0 ? sqrt(variance / n) / scale : 0.0;
+    }
+}
+
+int run_sensitivity(const SensitivityJob* job, SensitivityReport* report) {
+    PurchasePlan low[SENSITIVITY_DIFFERENCES], high[SENSITIVITY_DIFFERENCES];
+    EventDraws draws;
+    atomic_uint_fast64_t next;
+    GameState probe;
+    SensitivitySums sums;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    double start = now_seconds();
+
+    memset(report, 0, sizeof(*report));
+    if (job->trips < 1 || job->step < 1 || apply_purchase_plan(&probe, &job->plan) != 0) {
+        return -1;
+    }
+    for (int d = 0; d < SENSITIVITY_DIFFERENCES; d++) {
+        difference_ends(job, d, &low[d], &high[d]);
+    }
+    event_draws(&draws);
+
+    SensitivityWorker* workers = calloc((size_t)threads, sizeof(SensitivityWorker));
+    if (!workers) {
+        return -1;
+    }
+
+    atomic_init(&next, 0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].job = job;
+        workers[w].draws = &draws;
+        workers[w].low = low;
+        workers[w].high = high;
+        workers[w].next = &next;
+    }
+    run_worker_threads(sensitivity_worker_main, workers, sizeof(SensitivityWorker), threads);
+    memset(&sums, 0, sizeof(sums));
+    for (int w = 0; w < threads; w++) {
+        sums_merge(&sums, &workers[w].sums);
+    }
+
+    fill_rows(job, &draws, low, high, &sums, report);
+    report->trips = sums.trips;
+    report->played = sums.played;
+    report->seconds = now_seconds() - start;
+    free(workers);
+    return 0;
+}
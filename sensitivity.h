@@ -0,0 +1,69 @@
+/*
+ * Sensitivity of survival to the purchases and the event table, in one pass.
+ *
+ * Every seed plays the base plan once, and each purchase category's plan a
+ * step above and below it: a central difference taken on common random
+ * numbers, so the pair differs only where the extra dollars changed the
+ * trip's fate and most seeds contribute exactly zero. A category at the edge
+ * of its range (the budget, the oxen limits, nothing bought) falls back to a
+ * one-sided difference against the base trip. Shooting skill is differenced
+ * the same way, a level either side.
+ *
+ * The event thresholds (event_probabilities) cannot be moved in a built
+ * engine, so their derivatives come from the base trips alone, by the
+ * likelihood ratio: each turn's event is drawn as a number 0..99 and mapped
+ * by event_for_draw, so raising threshold j by a point hands the draw just
+ * above it, a hundredth of the chance, from the event that draw picks (the
+ * loser, normally event j + 1) to event j. The widths, draws per event, are
+ * counted from the same mapping, and the trip's score is
+ * counts[j] / width[j] - counts[loser] / width[loser]. Survival times the
+ * score, less the mean survival as a baseline, averages to the derivative.
+ * This is the derivative of the odds as smooth functions of the thresholds,
+ * which is the change per point to first order.
+ *
+ * Every sum is kept in integers, the scores scaled by width[j] * width[loser],
+ * so a report does not depend on the thread count.
+ */
+
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include <stdint.h>
+#include "oregon.h"
+
+#define SENSITIVITY_DIFFERENCES (ITEM_COUNT + 2)           // Oxen, the four items, skill
+#define SENSITIVITY_ROWS (SENSITIVITY_DIFFERENCES + EVENT_COUNT - 1)
+
+typedef struct {
+    PurchasePlan plan;
+    const Policy* policy;
+    unsigned int first_seed;    // Seed i is first_seed + i
+    uint64_t trips;             // Seeds
+    int step;                   // Dollars either side of each purchase
+    int threads;                // 0 picks the number of online CPUs
+} SensitivityJob;
+
+typedef struct {
+    char name[48];              // A purchase, or the two events either side of a threshold
+    const char* unit;           // What one unit of the derivative is: "$", "level" or "point"
+    int value;                  // At the base plan or table
+    int low;                    // A difference's ends (low == high if it has none); for a
+    int high;                   // threshold, its neighbours, between which it can move
+    double derivative;          // Survival per unit
+    double std_error;
+} SensitivityRow;
+
+typedef struct {
+    uint64_t trips;             // Seeds
+    uint64_t played;            // Trips over every plan
+    double survival;            // Of the base plan
+    double survival_error;
+    SensitivityRow rows[SENSITIVITY_ROWS];
+    int row_count;
+    double seconds;
+} SensitivityReport;
+
+// Returns 0, or -1 if the plan or step is invalid or memory runs out
+int run_sensitivity(const SensitivityJob* job, SensitivityReport* report);
+
+#endif // SENSITIVITY_H
@@ -0,0 +1,365 @@
+/*
+ * Sharded batches over worker processes.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "shard.h"
+
+#define SHARD_LINE 512
+#define SHARD_STATS_FIELDS (7 + DEATH_CAUSE_COUNT)
+
+#define SHARD_NONE UINT64_MAX
+
+typedef struct {
+    pid_t pid;                  // 0 once gone
+    int to_worker;
+    int from_worker;
+    int ready;
+    uint64_t shard;             // In flight, SHARD_NONE if idle
+    double sent_at;
+    char line[SHARD_LINE];
+    size_t used;
+} ShardWorker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// BatchStats as decimal fields on one line, and back
+static void format_stats(char* text, size_t size, const BatchStats* stats) {
+    int length = snprintf(text, size, "%llu %llu %llu %llu %llu %llu %lld",
+                          (unsigned long long)stats->trips, (unsigned long long)stats->arrived,
+                          (unsigned long long)stats->abandoned, (unsigned long long)stats->turn_sum,
+                          (unsigned long long)stats->arrival_day_sum,
+                          (unsigned long long)stats->arrival_day_sq_sum, (long long)stats->cash_sum);
+    for (int i = 0; i < DEATH_CAUSE_COUNT && length > 0 && (size_t)length < size; i++) {
+        length += snprintf(text + length, size - (size_t)length, " %llu",
+                           (unsigned long long)stats->deaths[i]);
+    }
+}
+
+static int parse_stats(const char* text, BatchStats* stats) {
+    unsigned long long fields[SHARD_STATS_FIELDS];
+    long long cash;
+    int consumed;
+
+    memset(stats, 0, sizeof(*stats));
+    if (sscanf(text, "%llu %llu %llu %llu %llu %llu %lld%n", &fields[0], &fields[1], &fields[2],
+               &fields[3], &fields[4], &fields[5], &cash, &consumed) != 7) {
+        return -1;
+    }
+    text += consumed;
+    for (int i = 0; i < DEATH_CAUSE_COUNT; i++) {
+        if (sscanf(text, "%llu%n", &fields[7 + i], &consumed) != 1) {
+            return -1;
+        }
+        text += consumed;
+        stats->deaths[i] = fields[7 + i];
+    }
+    stats->trips = fields[0];
+    stats->arrived = fields[1];
+    stats->abandoned = fields[2];
+    stats->turn_sum = fields[3];
+    stats->arrival_day_sum = fields[4];
+    stats->arrival_day_sq_sum = fields[5];
+    stats->cash_sum = cash;
+    return 0;
+}
+
+// Worker
+
+int shard_worker(const BatchJob* job, FILE* in, FILE* out, int die_after) {
+    char line[SHARD_LINE], text[SHARD_LINE];
+    unsigned long long id, first, trips;
+    int played = 0;
+
+    fprintf(out, "READY %d %016llx\n", SHARD_PROTOCOL, (unsigned long long)batch_job_digest(job));
+    fflush(out);
+
+    while (fgets(line, sizeof(line), in)) {
+        BatchJob shard = *job;
+        BatchStats stats;
+        if (sscanf(line, "SHARD %llu %llu %llu", &id, &first, &trips) != 3) {
+            fprintf(stderr, "shard-worker: unexpected request: %s", line);
+            return 2;
+        }
+        shard.first_seed = (unsigned int)(first & SEED_MASK);
+        shard.trips = trips;
+        if (run_batch(&shard, &stats) != 0) {
+            fprintf(stderr, "shard-worker: invalid purchase plan\n");
+            return 2;
+        }
+        if (die_after > 0 && ++played >= die_after) {
+            _exit(3); // Without answering, as a crashed host would
+        }
+        format_stats(text, sizeof(text), &stats);
+        fprintf(out, "DONE %llu %s\n", id, text);
+        fflush(out);
+    }
+    return 0;
+}
+
+// Coordinator
+
+static int start_worker(ShardWorker* worker, const ShardJob* job, int index) {
+    const char* command = job->worker_commands[index % job->command_count];
+    int to[2], from[2];
+
+    memset(worker, 0, sizeof(*worker));
+    worker->shard = SHARD_NONE;
+    if (pipe(to) != 0) {
+        return -1;
+    }
+    if (pipe(from) != 0) {
+        close(to[0]);
+        close(to[1]);
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(to[0]);
+        close(to[1]);
+        close(from[0]);
+        close(from[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(to[0], STDIN_FILENO);
+        dup2(from[1], STDOUT_FILENO);
+        close(to[0]);
+        close(to[1]);
+        close(from[0]);
+        close(from[1]);
+        execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+        _exit(127);
+    }
+    close(to[0]);
+    close(from[1]);
+    fcntl(to[1], F_SETFD, FD_CLOEXEC);
+    fcntl(from[0], F_SETFD, FD_CLOEXEC);
+    worker->pid = pid;
+    worker->to_worker = to[1];
+    worker->from_worker = from[0];
+    return 0;
+}
+
+static void stop_worker(ShardWorker* worker, int kill_it) {
+    if (!worker->pid) {
+        return;
+    }
+    close(worker->to_worker);
+    close(worker->from_worker);
+    if (kill_it) {
+        kill(worker->pid, SIGKILL);
+    }
+    waitpid(worker->pid, NULL, 0);
+    worker->pid = 0;
+}
+
+static int send_shard(ShardWorker* worker, uint64_t shard, const ShardJob* job, uint64_t shard_trips) {
+    char line[SHARD_LINE];
+    uint64_t offset = shard * shard_trips;
+    uint64_t trips = job->job.trips - offset < shard_trips ? job->job.trips - offset : shard_trips;
+    int length = snprintf(line, sizeof(line), "SHARD %llu %llu %llu\n", (unsigned long long)shard,
+                          (unsigned long long)((job->job.first_seed + offset) & SEED_MASK),
+                          (unsigned long long)trips);
+
+    if (write(worker->to_worker, line, (size_t)length) != length) {
+        return -1; // Pipe messages this short are written whole or not at all
+    }
+    worker->shard = shard;
+    worker->sent_at = now_seconds();
+    return 0;
+}
+
+static void log_message(const ShardJob* job, const char* format, ...) {
+    va_list args;
+    if (!job->log) {
+        return;
+    }
+    va_start(args, format);
+    vfprintf(job->log, format, args);
+    va_end(args);
+}
+
+int shard_coordinate(const ShardJob* job, BatchStats* stats, ShardReport* report) {
+    uint64_t shard_trips = job->shard_trips;
+    int worker_count = job->workers > 0 ? job->workers : 1;
+    char expected[64];
+    double start = now_seconds();
+    int status = -1;
+
+    memset(report, 0, sizeof(*report));
+    memset(stats, 0, sizeof(*stats));
+    if (shard_trips == 0) {
+        shard_trips = job->job.trips / ((uint64_t)worker_count * 8) + 1;
+    }
+    uint64_t shard_count = (job->job.trips + shard_trips - 1) / shard_trips;
+    snprintf(expected, sizeof(expected), "READY %d %016llx", SHARD_PROTOCOL,
+             (unsigned long long)batch_job_digest(&job->job));
+
+    // Shards are handed out from a queue; a failed one goes back on the end
+    uint64_t* queue = malloc((shard_count + 1) * sizeof(uint64_t));
+    uint8_t* done = calloc(shard_count + 1, 1);
+    ShardWorker* workers = calloc((size_t)worker_count, sizeof(ShardWorker));
+    struct pollfd* polls = calloc((size_t)worker_count, sizeof(struct pollfd));
+    if (!queue || !done || !workers || !polls) {
+        log_message(job, "out of memory\n");
+        goto cleanup;
+    }
+    uint64_t queue_head = 0, queue_tail = 0, queued = shard_count, finished = 0;
+    for (uint64_t s = 0; s < shard_count; s++) {
+        queue[queue_tail++] = s;
+    }
+    queue_tail %= shard_count + 1;
+
+    // A dead worker must show as EOF or EPIPE, not kill the coordinator
+    void (*old_sigpipe)(int) = signal(SIGPIPE, SIG_IGN);
+
+    for (int w = 0; w < worker_count; w++) {
+        if (start_worker(&workers[w], job, w) != 0) {
+            log_message(job, "cannot start worker: %s\n", strerror(errno));
+            goto restore;
+        }
+        report->started++;
+    }
+
+    while (finished < shard_count) {
+        int alive = 0;
+
+        // Hand a shard to every idle worker
+        for (int w = 0; w < worker_count; w++) {
+            ShardWorker* worker = &workers[w];
+            polls[w].fd = worker->pid ? worker->from_worker : -1;
+            polls[w].events = POLLIN;
+            polls[w].revents = 0;
+            if (!worker->pid) {
+                continue;
+            }
+            alive++;
+            if (worker->ready && worker->shard == SHARD_NONE && queued) {
+                uint64_t shard = queue[queue_head];
+                if (send_shard(worker, shard, job, shard_trips) == 0) {
+                    queue_head = (queue_head + 1) % (shard_count + 1);
+                    queued--;
+                }
+            }
+        }
+        if (!alive) {
+            log_message(job, "no workers left with %llu shards to play\n",
+                        (unsigned long long)(shard_count - finished));
+            goto restore;
+        }
+
+        int timeout_ms = job->shard_timeout > 0 ? 250 : -1;
+        if (poll(polls, (nfds_t)worker_count, timeout_ms) < 0 && errno != EINTR) {
+            log_message(job, "poll: %s\n", strerror(errno));
+            goto restore;
+        }
+
+        for (int w = 0; w < worker_count; w++) {
+            ShardWorker* worker = &workers[w];
+            const char* failure = NULL;
+            if (!worker->pid) {
+                continue;
+            }
+
+            if (polls[w].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t got = read(worker->from_worker, worker->line + worker->used,
+                                   sizeof(worker->line) - 1 - worker->used);
+                if (got <= 0) {
+                    failure = "exited";
+                } else {
+                    worker->used += (size_t)got;
+                }
+            }
+
+            // Every complete line
+            char* newline;
+            while (!failure && (newline = memchr(worker->line, '\n', worker->used)) != NULL) {
+                unsigned long long id;
+                int consumed;
+                BatchStats part;
+                *newline = '\0';
+                if (!worker->ready) {
+                    if (strcmp(worker->line, expected) != 0) {
+                        log_message(job, "worker %d is playing a different job (%s, expected %s)\n",
+                                    w, worker->line, expected);
+                        stop_worker(worker, 1);
+                        goto restore;
+                    }
+                    worker->ready = 1;
+                } else if (sscanf(worker->line, "DONE %llu%n", &id, &consumed) == 1 &&
+                           id == worker->shard && parse_stats(worker->line + consumed, &part) == 0) {
+                    if (!done[id]) {
+                        done[id] = 1;
+                        finished++;
+                        batch_stats_merge(stats, &part);
+                    }
+                    worker->shard = SHARD_NONE;
+                } else {
+                    failure = "sent a bad reply";
+                }
+                size_t line_length = (size_t)(newline - worker->line) + 1;
+                memmove(worker->line, newline + 1, worker->used - line_length);
+                worker->used -= line_length;
+            }
+            if (!failure && worker->used == sizeof(worker->line) - 1) {
+                failure = "sent a bad reply";
+            }
+            if (!failure && job->shard_timeout > 0 && worker->shard != SHARD_NONE &&
+                now_seconds() - worker->sent_at > job->shard_timeout) {
+                failure = "timed out";
+            }
+            if (!failure) {
+                continue;
+            }
+
+            // Take the shard back and replace the worker while the budget lasts
+            report->failures++;
+            if (worker->shard != SHARD_NONE) {
+                log_message(job, "worker %d %s on shard %llu; reassigning it\n", w, failure,
+                            (unsigned long long)worker->shard);
+                queue[queue_tail] = worker->shard;
+                queue_tail = (queue_tail + 1) % (shard_count + 1);
+                queued++;
+                report->reassigned++;
+            } else {
+                log_message(job, "worker %d %s\n", w, failure);
+            }
+            stop_worker(worker, 1);
+            if (report->failures <= job->max_failures && finished < shard_count) {
+                if (start_worker(worker, job, w) == 0) {
+                    report->started++;
+                } else {
+                    log_message(job, "cannot restart worker %d: %s\n", w, strerror(errno));
+                }
+            }
+        }
+    }
+    status = 0;
+
+restore:
+    for (int w = 0; w < worker_count; w++) {
+        stop_worker(&workers[w], status != 0); // Closing stdin ends a healthy worker
+    }
+    signal(SIGPIPE, old_sigpipe);
+cleanup:
+    report->shards = shard_count;
+    report->seconds = now_seconds() - start;
+    free(queue);
+    free(done);
+    free(workers);
+    free(polls);
+    return status;
+}
@@ -0,0 +1,62 @@
+/*
+ * Sharded batches: a coordinator splits a seed range into shards and hands
+ * them to worker processes, which play each shard on the batch runner and
+ * send back its BatchStats.
+ *
+ * A worker is any command whose stdin and stdout reach "oregon_sim
+ * shard-worker", so "ssh host oregon_sim" stands in for a remote machine as
+ * well as a local path does. The protocol is one text line per message:
+ *
+ *   worker       READY <version> <job digest>
+ *   coordinator  SHARD <id> <first seed> <trips>
+ *   worker       DONE <id> <BatchStats fields>
+ *
+ * and the coordinator closes the worker's stdin when the batch is done. The
+ * job digest (batch_job_digest) covers the policy, purchases, trail and some
+ * probe trips, so a worker started with other options or a different engine
+ * build is turned away instead of mixed in.
+ *
+ * A worker that exits, breaks the protocol or overruns the shard timeout is
+ * killed, its shard goes back in the queue for the next free worker, and a
+ * replacement is started while the failure budget lasts. BatchStats are
+ * integer sums, so the merged result is bit-identical to run_batch over the
+ * whole range whatever the shard size, order or reassignment.
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define SHARD_PROTOCOL 1
+
+typedef struct {
+    BatchJob job;               // The whole range; threads is ignored here
+    const char* const* worker_commands; // sh command lines; worker w runs w % command_count
+    int command_count;
+    int workers;
+    uint64_t shard_trips;       // 0 picks about eight shards per worker
+    int max_failures;           // Worker failures tolerated before giving up
+    double shard_timeout;       // Seconds before a shard is taken back, 0 for none
+    FILE* log;                  // Failures and progress, NULL for none
+} ShardJob;
+
+typedef struct {
+    uint64_t shards;
+    uint64_t reassigned;        // Shards handed out again after a failure
+    int failures;               // Workers lost
+    int started;                // Workers started, replacements included
+    double seconds;
+} ShardReport;
+
+// Worker side: answer shards from in on out until in ends; die_after > 0
+// exits abruptly after that many shards, to exercise reassignment
+int shard_worker(const BatchJob* job, FILE* in, FILE* out, int die_after);
+
+// Coordinator side: returns 0 with the merged stats, or -1 if the workers
+// could not finish the range (message in log)
+int shard_coordinate(const ShardJob* job, BatchStats* stats, ShardReport* report);
+
+#endif // SHARD_H
@@ -0,0 +1,482 @@
+/*
+ * Survival surrogate table.
+ */
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "surrogate.h"
+#include "batch.h"
+
+// Sampled trips handed to a builder at a time
+#define SURROGATE_CHUNK 16
+
+// Bucket limits: a value falls in the bucket of the first limit it is below
+static const int food_limits[] = {13, 40, 80, 150};
+static const int bullet_limits[] = {40, 300, 1000, 2500};
+static const int clothing_limits[] = {22, 40, 70, 110};
+static const int misc_limits[] = {5, 15, 30, 60};
+static const int cash_limits[] = {1, 50, 150, 300};
+
+#define LIMIT_COUNT(limits) (int)(sizeof(limits) / sizeof(limits[0]))
+
+#define TURN_BUCKETS 20
+#define MILE_STEP 120
+#define MILE_BUCKETS(length) ((length) / MILE_STEP + 1)
+#define COARSE_STATES(mile_buckets) (TURN_BUCKETS * (mile_buckets))
+#define STATES(mile_buckets) (COARSE_STATES(mile_buckets) * 5 * 5 * 5 * 5 * 5)
+
+typedef struct {
+    atomic_uint trials;
+    atomic_uint arrived;
+    atomic_uint arrival_turns;  // Sum over arrived rollouts
+} CellCount;
+
+typedef struct {
+    const SurrogateJob* job;
+    const Trail* trail;         // Sampled on
+    int mile_buckets;
+    CellCount* counts;          // STATES then COARSE_STATES, each times SURROGATE_ACTIONS
+    atomic_uint_fast64_t next_trip;
+    atomic_uint_fast64_t prompts;
+    atomic_uint_fast64_t rollouts;
+} SurrogateBuild;
+
+typedef struct {
+    const Policy* policy;
+    uint64_t rng;
+} Sampler;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t next_rng(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static int bucket(int value, const int* limits, int count) {
+    int b = 0;
+    while (b < count && value >= limits[b]) {
+        b++;
+    }
+    return b;
+}
+
+// Mixed-radix state index: index * (count + 1) + bucket
+#define ADD_FEATURE(index, value, limits) \
+    ((index) * (LIMIT_COUNT(limits) + 1) + bucket((value), (limits), LIMIT_COUNT(limits)))
+
+static int clamp(int value, int low, int high) {
+    return value < low ? low : value > high ? high : value;
+}
+
+static int coarse_state(int mile_buckets, const GameState* game) {
+    int turn = clamp(game->turn_number, 0, TURN_BUCKETS - 1);
+    return turn * mile_buckets + clamp(game->miles_traveled / MILE_STEP, 0, mile_buckets - 1);
+}
+
+static int fine_state(int mile_buckets, const GameState* game) {
+    int index = coarse_state(mile_buckets, game);
+    index = ADD_FEATURE(index, game->food, food_limits);
+    index = ADD_FEATURE(index, game->bullets, bullet_limits);
+    index = ADD_FEATURE(index, game->clothing, clothing_limits);
+    index = ADD_FEATURE(index, game->misc_supplies, misc_limits);
+    index = ADD_FEATURE(index, game->cash, cash_limits);
+    return index;
+}
+
+// Building
+
+// Sampled trips take a random turn action and leave the rest to the job's policy
+static int sample_turn_action(const GameState* game, int fort_open, void* ctx) {
+    Sampler* sampler = (Sampler*)ctx;
+    (void)game;
+    int first = fort_open ? ACTION_FORT : ACTION_HUNT;
+    return first + (int)(next_rng(&sampler->rng) % (uint64_t)(ACTION_CONTINUE - first + 1));
+}
+
+static int sample_eating_level(const GameState* game, void* ctx) {
+    const Policy* policy = ((Sampler*)ctx)->policy;
+    return policy->eating_level(game, policy->ctx);
+}
+
+static int sample_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    const Policy* policy = ((Sampler*)ctx)->policy;
+    return policy->rider_tactic(game, hostile, policy->ctx);
+}
+
+static int sample_fort_purchase(const GameState* game, int item, void* ctx) {
+    const Policy* policy = ((Sampler*)ctx)->policy;
+    return policy->fort_purchase(game, item, policy->ctx);
+}
+
+static int sample_shot_result(int skill_level, const char* word, void* ctx) {
+    const Policy* policy = ((Sampler*)ctx)->policy;
+    return policy->shot_result(skill_level, word, policy->ctx);
+}
+
+// Random oxen spending, then the rest split at random over the supplies and cash
+static void random_plan(PurchasePlan* plan, int skill, uint64_t* rng) {
+    uint64_t weights[5], total = 0;
+    int* parts[4] = {&plan->food, &plan->ammunition, &plan->clothing, &plan->misc_supplies};
+
+    plan->shooting_skill = skill;
+    plan->oxen = 200 + (int)(next_rng(rng) % 101);
+    for (int i = 0; i < 5; i++) {
+        weights[i] = next_rng(rng) % 1000 + 1;
+        total += weights[i];
+    }
+    int money = AVAILABLE_MONEY - plan->oxen;
+    for (int i = 0; i < 4; i++) {
+        *parts[i] = (int)((uint64_t)money * weights[i] / total);
+    }
+}
+
+// The rest of a trip from a turn prompt, taking action there
+static void rollout(const GameState* at_prompt, int action, unsigned int random_state,
+                    const Policy* policy, TripResult* result) {
+    GameState game = *at_prompt;
+    int choice;
+
+    seed_random(random_state);
+    if (finish_turn(&game, action, policy, result)) {
+        return;
+    }
+    while (!begin_turn(&game, policy, &choice, result) && !finish_turn(&game, choice, policy, result)) {
+        continue;
+    }
+}
+
+static void count_rollout(CellCount* cell, const TripResult* result) {
+    atomic_fetch_add_explicit(&cell->trials, 1, memory_order_relaxed);
+    if (result->outcome == TRIP_ARRIVED) {
+        atomic_fetch_add_explicit(&cell->arrived, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&cell->arrival_turns, (unsigned int)result->turn_number,
+                                  memory_order_relaxed);
+    }
+}
+
+// Every valid action at the prompt, on the same rollout futures
+static uint64_t sample_prompt(SurrogateBuild* build, const GameState* game, uint64_t* rng) {
+    const SurrogateJob* job = build->job;
+    int buckets = build->mile_buckets;
+    CellCount* fine = &build->counts[(size_t)fine_state(buckets, game) * SURROGATE_ACTIONS];
+    CellCount* coarse = &build->counts[((size_t)STATES(buckets) + coarse_state(buckets, game)) * SURROGATE_ACTIONS];
+    int first = game->fort_available == -1 ? ACTION_FORT : ACTION_HUNT;
+    TripResult result;
+
+    for (int r = 0; r < job->rollouts; r++) {
+        unsigned int random_state = (unsigned int)(next_rng(rng) >> 33) & SEED_MASK;
+        for (int action = first; action <= ACTION_CONTINUE; action++) {
+            rollout(game, action, random_state, job->policy, &result);
+            count_rollout(&fine[action - ACTION_FORT], &result);
+            count_rollout(&coarse[action - ACTION_FORT], &result);
+        }
+    }
+    return (uint64_t)job->rollouts * (uint64_t)(ACTION_CONTINUE - first + 1);
+}
+
+static void sample_trip(SurrogateBuild* build, uint64_t index) {
+    const SurrogateJob* job = build->job;
+    Sampler sampler;
+    Policy policy = {
+        "surrogate sampler", sample_turn_action, sample_eating_level, sample_rider_tactic,
+        sample_fort_purchase, sample_shot_result, &sampler
+    };
+    PurchasePlan plan;
+    GameState game;
+    TripResult result;
+    uint64_t rng = ((uint64_t)job->first_seed << 32) ^ index;
+    uint64_t prompts = 0, rollouts = 0;
+    int choice;
+
+    sampler.policy = job->policy;
+    sampler.rng = next_rng(&rng);
+    random_plan(&plan, job->shooting_skill, &rng);
+    init_game_seeded(&game, (unsigned int)(job->first_seed + index) & SEED_MASK);
+    apply_purchase_plan(&game, &plan);
+
+    while (!begin_turn(&game, &policy, &choice, &result)) {
+        unsigned int random_state = get_random_state();
+        rollouts += sample_prompt(build, &game, &rng);
+        prompts++;
+        seed_random(random_state); // The sampled trip plays on as if nothing happened
+        if (finish_turn(&game, choice, &policy, &result)) {
+            break;
+        }
+    }
+    atomic_fetch_add_explicit(&build->prompts, prompts, memory_order_relaxed);
+    atomic_fetch_add_explicit(&build->rollouts, rollouts, memory_order_relaxed);
+}
+
+static void* surrogate_worker_main(void* arg) {
+    SurrogateBuild* build = (SurrogateBuild*)arg;
+    uint64_t trips = build->job->trips;
+
+    for (;;) {
+        uint64_t first = atomic_fetch_add(&build->next_trip, SURROGATE_CHUNK);
+        if (first >= trips) {
+            break;
+        }
+        uint64_t last = first + SURROGATE_CHUNK < trips ? first + SURROGATE_CHUNK : trips;
+        for (uint64_t i = first; i < last; i++) {
+            sample_trip(build, i);
+        }
+    }
+    return NULL;
+}
+
+static SurrogateCell quantize(const CellCount* count, unsigned int min_rollouts) {
+    SurrogateCell cell = {SURROGATE_UNKNOWN, SURROGATE_UNKNOWN};
+    unsigned int trials = atomic_load_explicit(&count->trials, memory_order_relaxed);
+    unsigned int arrived = atomic_load_explicit(&count->arrived, memory_order_relaxed);
+
+    if (trials == 0 || trials < min_rollouts) {
+        return cell;
+    }
+    cell.survival = (uint8_t)((arrived * 250ull + trials / 2) / trials);
+    if (arrived > 0) {
+        uint64_t turns = atomic_load_explicit(&count->arrival_turns, memory_order_relaxed);
+        cell.arrival_turn = (uint8_t)clamp((int)((turns * 10 + arrived / 2) / arrived), 0, 250);
+    }
+    return cell;
+}
+
+static int write_table(const SurrogateBuild* build, const char* path, uint64_t* known_states) {
+    const SurrogateJob* job = build->job;
+    size_t states = STATES(build->mile_buckets), coarse_states = COARSE_STATES(build->mile_buckets);
+    char temp_path[1024];
+    SurrogateHeader header;
+    SurrogateCell cells[SURROGATE_ACTIONS];
+
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        return -1;
+    }
+    FILE* out = fopen(temp_path, "wb");
+    if (!out) {
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SURROGATE_MAGIC, sizeof(header.magic));
+    header.version = SURROGATE_VERSION;
+    header.states = (uint32_t)states;
+    header.coarse_states = (uint32_t)coarse_states;
+    header.actions = SURROGATE_ACTIONS;
+    header.shooting_skill = (uint32_t)job->shooting_skill;
+    header.min_rollouts = (uint32_t)job->min_rollouts;
+    header.trail_length = (uint32_t)build->trail->length;
+    header.rules = batch_rules_digest();
+    header.trail = batch_trail_digest(build->trail);
+    header.trips = job->trips;
+    header.rollouts = atomic_load(&build->rollouts);
+    snprintf(header.policy, sizeof(header.policy), "%s", job->policy_name ? job->policy_name : "");
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1;
+
+    *known_states = 0;
+    for (size_t s = 0; s < states + coarse_states && ok; s++) {
+        int known = 0;
+        for (int a = 0; a < SURROGATE_ACTIONS; a++) {
+            cells[a] = quantize(&build->counts[s * SURROGATE_ACTIONS + a], (unsigned int)job->min_rollouts);
+            known |= cells[a].survival != SURROGATE_UNKNOWN;
+        }
+        *known_states += s < states && known;
+        ok = fwrite(cells, sizeof(cells), 1, out) == 1;
+    }
+
+    if (fclose(out) != 0 || !ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return -1;
+    }
+    return 0;
+}
+
+int surrogate_build(const SurrogateJob* job, const char* path, SurrogateReport* report) {
+    SurrogateBuild build;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    double start = now_seconds();
+
+    memset(report, 0, sizeof(*report));
+    if (job->shooting_skill < 1 || job->shooting_skill > 5 || job->rollouts < 1) {
+        return -1;
+    }
+    memset(&build, 0, sizeof(build));
+    build.job = job;
+    build.trail = current_trail();
+    build.mile_buckets = MILE_BUCKETS(build.trail->length);
+    build.counts = calloc(((size_t)STATES(build.mile_buckets) + COARSE_STATES(build.mile_buckets)) *
+                          SURROGATE_ACTIONS, sizeof(CellCount));
+    if (!build.counts) {
+        return -1;
+    }
+    atomic_init(&build.next_trip, 0);
+    atomic_init(&build.prompts, 0);
+    atomic_init(&build.rollouts, 0);
+
+    run_worker_threads(surrogate_worker_main, &build, 0, threads); // Every worker shares the build
+
+    int status = write_table(&build, path, &report->known_states);
+    report->prompts = atomic_load(&build.prompts);
+    report->rollouts = atomic_load(&build.rollouts);
+    report->seconds = now_seconds() - start;
+    free(build.counts);
+    return status;
+}
+
+// Lookup
+
+int surrogate_open(SurrogateTable* table, const char* path, char* error, size_t error_size) {
+    struct stat info;
+
+    memset(table, 0, sizeof(*table));
+    snprintf(error, error_size, "not a surrogate table");
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        snprintf(error, error_size, "%s", strerror(errno));
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SurrogateHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    // The cells are laid out for the trail the table was built on
+    const SurrogateHeader* header = (const SurrogateHeader*)map;
+    int ok = memcmp(header->magic, SURROGATE_MAGIC, sizeof(header->magic)) == 0 &&
+             header->version == SURROGATE_VERSION && header->actions == SURROGATE_ACTIONS &&
+             header->trail_length > 0 && header->trail_length <= TRAIL_MAX_MILES;
+    int mile_buckets = ok ? MILE_BUCKETS((int)header->trail_length) : 0;
+    size_t cells = ((size_t)STATES(mile_buckets) + COARSE_STATES(mile_buckets)) * SURROGATE_ACTIONS;
+    ok = ok && header->states == (uint32_t)STATES(mile_buckets) &&
+         header->coarse_states == (uint32_t)COARSE_STATES(mile_buckets) &&
+         (size_t)info.st_size == sizeof(SurrogateHeader) + cells * sizeof(SurrogateCell);
+    if (ok && header->rules != batch_rules_digest()) {
+        snprintf(error, error_size, "built under other game rules; rebuild it");
+        ok = 0;
+    } else if (ok && header->trail != batch_trail_digest(current_trail())) {
+        snprintf(error, error_size, "built on another trail; use that trail or rebuild it");
+        ok = 0;
+    }
+    if (!ok) {
+        munmap(map, (size_t)info.st_size);
+        return -1;
+    }
+    table->base = (const uint8_t*)map;
+    table->size = (size_t)info.st_size;
+    table->header = header;
+    table->mile_buckets = mile_buckets;
+    table->cells = (const SurrogateCell*)(table->base + sizeof(SurrogateHeader));
+    table->coarse = table->cells + (size_t)header->states * SURROGATE_ACTIONS;
+    return 0;
+}
+
+void surrogate_close(SurrogateTable* table) {
+    if (table->base) {
+        munmap((void*)table->base, table->size);
+    }
+    memset(table, 0, sizeof(*table));
+}
+
+void surrogate_odds(const SurrogateTable* table, const GameState* game, int action, SurrogateOdds* odds) {
+    memset(odds, 0, sizeof(*odds));
+    if (action < ACTION_FORT || action > ACTION_CONTINUE ||
+        (uint32_t)game->shooting_skill != table->header->shooting_skill) {
+        return;
+    }
+
+    int buckets = table->mile_buckets;
+    const SurrogateCell* cell =
+        &table->cells[(size_t)fine_state(buckets, game) * SURROGATE_ACTIONS + action - ACTION_FORT];
+    odds->known = 2;
+    if (cell->survival == SURROGATE_UNKNOWN) {
+        cell = &table->coarse[(size_t)coarse_state(buckets, game) * SURROGATE_ACTIONS + action - ACTION_FORT];
+        odds->known = 1;
+        if (cell->survival == SURROGATE_UNKNOWN) {
+            odds->known = 0;
+            return;
+        }
+    }
+    odds->survival = cell->survival / 250.0;
+    odds->arrival_turn = cell->arrival_turn == SURROGATE_UNKNOWN ? 0.0 : cell->arrival_turn / 10.0;
+}
+
+// The wrapped player: odds first, then let the player answer
+
+static int hinted_turn_action(const GameState* game, int fort_open, void* ctx) {
+    SurrogateHint* hint = (SurrogateHint*)ctx;
+    static const char* const names[SURROGATE_ACTIONS] = {"FORT", "HUNT", "CONTINUE"};
+
+    if ((uint32_t)game->shooting_skill != hint->table->header->shooting_skill) {
+        if (!hint->warned) {
+            printf("[ODDS: TABLE IS FOR SHOOTING SKILL %u]\n", hint->table->header->shooting_skill);
+            hint->warned = 1;
+        }
+    } else {
+        int first = fort_open ? ACTION_FORT : ACTION_HUNT;
+        printf("[ODDS --");
+        for (int action = first; action <= ACTION_CONTINUE; action++) {
+            SurrogateOdds odds;
+            surrogate_odds(hint->table, game, action, &odds);
+            printf("%s %s: ", action > first ? "," : "", names[action - ACTION_FORT]);
+            if (!odds.known) {
+                printf("?");
+                continue;
+            }
+            // A coarse estimate only knows the date and the miles
+            printf("%s%.0f%%", odds.known == 1 ? "~" : "", 100.0 * odds.survival);
+            if (odds.arrival_turn > 0) {
+                printf(" BY TURN %.1f", odds.arrival_turn);
+            }
+        }
+        printf("]\n");
+    }
+    return hint->player->turn_action(game, fort_open, hint->player->ctx);
+}
+
+static int hinted_eating_level(const GameState* game, void* ctx) {
+    const Policy* player = ((SurrogateHint*)ctx)->player;
+    return player->eating_level(game, player->ctx);
+}
+
+static int hinted_rider_tactic(const GameState* game, int hostile, void* ctx) {
+    const Policy* player = ((SurrogateHint*)ctx)->player;
+    return player->rider_tactic(game, hostile, player->ctx);
+}
+
+static int hinted_fort_purchase(const GameState* game, int item, void* ctx) {
+    const Policy* player = ((SurrogateHint*)ctx)->player;
+    return player->fort_purchase(game, item, player->ctx);
+}
+
+static int hinted_shot_result(int skill_level, const char* word, void* ctx) {
+    const Policy* player = ((SurrogateHint*)ctx)->player;
+    return player->shot_result(skill_level, word, player->ctx);
+}
+
+void surrogate_wrap_policy(SurrogateHint* hint, const SurrogateTable* table, const Policy* player,
+                           Policy* wrapped) {
+    hint->table = table;
+    hint->player = player;
+    hint->warned = 0;
+    wrapped->name = player->name;
+    wrapped->turn_action = hinted_turn_action;
+    wrapped->eating_level = hinted_eating_level;
+    wrapped->rider_tactic = hinted_rider_tactic;
+    wrapped->fort_purchase = hinted_fort_purchase;
+    wrapped->shot_result = hinted_shot_result;
+    wrapped->ctx = hint;
+}
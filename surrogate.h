@@ -0,0 +1,119 @@
+/*
+ * Survival surrogate: a precomputed table of the odds of each turn action,
+ * for hints on hardware too slow to run the advisor's search at a prompt.
+ *
+ * A turn-prompt state is bucketed on turn, miles, food, bullets, clothing,
+ * misc supplies and cash into a dense mixed-radix index, and each state and
+ * action (fort, hunt, continue) has one two-byte cell: the chance of arriving
+ * in 1/250ths and the mean turn of arrival in tenths. A second, coarse table
+ * on turn and miles alone answers for states the build never sampled often
+ * enough.
+ *
+ * The builder plays sampled trips a turn at a time, with random purchases
+ * and random turn actions to spread the states, and at every prompt plays
+ * rollouts of each valid action with the job's policy. The rollouts of one
+ * prompt share their generator states across the actions, so the actions are
+ * compared on the same futures. Counts are added atomically and every random
+ * choice comes from the sample's number, so the table does not depend on the
+ * thread count.
+ *
+ * The file is the header and the cells as they are used; surrogate_open maps
+ * it and checks only the header, so opening costs nothing however large the
+ * table, and a lookup reads one cell. A table holds one shooting skill. Its
+ * mile buckets span the trail it was built on, and the header carries digests
+ * of that trail and of the game rules, so a table is only opened under both.
+ */
+
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "oregon.h"
+
+#define SURROGATE_MAGIC "ORSURR1"
+#define SURROGATE_VERSION 2
+#define SURROGATE_ACTIONS 3         // ACTION_FORT .. ACTION_CONTINUE
+#define SURROGATE_UNKNOWN 255       // Cell value with too few rollouts behind it
+
+typedef struct {
+    uint8_t survival;           // Chance of arriving, in 1/250ths
+    uint8_t arrival_turn;       // Mean turn of arrival, in tenths
+} SurrogateCell;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t states;            // Cells follow: states, then coarse_states, each times actions
+    uint32_t coarse_states;
+    uint32_t actions;
+    uint32_t shooting_skill;
+    uint32_t min_rollouts;      // Rollouts a cell needs to be known
+    uint32_t trail_length;      // Miles are bucketed up to it
+    uint64_t rules;             // batch_rules_digest of the build
+    uint64_t trail;             // batch_trail_digest of the trail it was built on
+    uint64_t trips;             // Sampled trips
+    uint64_t rollouts;
+    char policy[16];            // Played the rollouts
+} SurrogateHeader;
+
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    const SurrogateHeader* header;
+    int mile_buckets;
+    const SurrogateCell* cells;
+    const SurrogateCell* coarse;
+} SurrogateTable;
+
+// Odds of one action at a turn prompt
+typedef struct {
+    int known;                  // 0 no estimate, 1 from the coarse table, 2 from the state's own cell
+    double survival;
+    double arrival_turn;        // 0 if no rollout arrived
+} SurrogateOdds;
+
+typedef struct {
+    const Policy* policy;       // Plays the rollouts and the sampled trips' other decisions
+    const char* policy_name;
+    int shooting_skill;
+    unsigned int first_seed;    // Sample i starts from seed first_seed + i
+    uint64_t trips;             // Sampled trips
+    int rollouts;               // Per valid action at each sampled prompt
+    int min_rollouts;
+    int threads;                // 0 picks the number of online CPUs
+} SurrogateJob;
+
+typedef struct {
+    uint64_t prompts;
+    uint64_t rollouts;
+    uint64_t known_states;      // States with at least one known action
+    double seconds;
+} SurrogateReport;
+
+// Build a table for the trail in use into path (through a temporary file);
+// returns 0, or -1 if the skill is out of range, memory runs out or the file
+// cannot be written
+int surrogate_build(const SurrogateJob* job, const char* path, SurrogateReport* report);
+
+// Map a table read-only; returns 0, or -1 with a message in error if it is not
+// a table of this layout or was built under other rules or on another trail
+// than the one in use
+int surrogate_open(SurrogateTable* table, const char* path, char* error, size_t error_size);
+void surrogate_close(SurrogateTable* table);
+
+// Odds of action (ACTION_*) at a turn prompt in game; nothing is known for a
+// game whose shooting skill is not the table's
+void surrogate_odds(const SurrogateTable* table, const GameState* game, int action, SurrogateOdds* odds);
+
+// Wrap player so every turn prompt first prints the table's odds
+typedef struct {
+    const SurrogateTable* table;
+    const Policy* player;
+    int warned;                 // Skill mismatch reported
+} SurrogateHint;
+
+void surrogate_wrap_policy(SurrogateHint* hint, const SurrogateTable* table, const Policy* player,
+                           Policy* wrapped);
+
+#endif // SURROGATE_H
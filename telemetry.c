@@ -0,0 +1,208 @@
+/*
+ * Live batch telemetry in shared memory, written through seqlocks.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+#define TELEMETRY_SLOT_WORDS (sizeof(TelemetryWorker) / sizeof(uint64_t))
+
+// Reads of a slot that is being written, before giving up on it
+#define TELEMETRY_READ_TRIES 100000
+
+_Static_assert(sizeof(TelemetryWorker) % sizeof(uint64_t) == 0, "slot copies whole words");
+
+typedef struct {
+    alignas(64) atomic_uint_fast64_t seq;   // Odd while the worker writes
+    atomic_uint_fast64_t words[TELEMETRY_SLOT_WORDS];
+} TelemetrySlot;
+
+struct TelemetryBlock {
+    char magic[8];
+    atomic_uint_fast64_t ready;         // Set once the header below is filled in
+    atomic_uint_fast64_t finished_ns;
+    uint64_t workers;
+    uint64_t trips;
+    uint64_t first_seed;
+    uint64_t started_ns;
+    int64_t pid;
+    char description[160];
+    TelemetrySlot slots[];
+};
+
+uint64_t telemetry_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void segment_name(char* out, size_t size, const char* name) {
+    snprintf(out, size, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+// The chunk hook: write the worker's slot
+static void publish(int worker, const BatchStats* totals, uint64_t handed_out, int finished, void* ctx) {
+    TelemetrySlot* slot = &((TelemetryBlock*)ctx)->slots[worker];
+    uint64_t words[TELEMETRY_SLOT_WORDS];
+    TelemetryWorker value;
+
+    value.updated_ns = telemetry_now_ns();
+    value.handed_out = handed_out;
+    value.finished = (uint64_t)finished;
+    value.stats = *totals;
+    memcpy(words, &value, sizeof(words));
+
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < TELEMETRY_SLOT_WORDS; i++) {
+        atomic_store_explicit(&slot->words[i], words[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+int telemetry_create(Telemetry* telemetry, const char* name, BatchJob* job, const char* description,
+                     FILE* log) {
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+
+    memset(telemetry, 0, sizeof(*telemetry));
+    segment_name(telemetry->name, sizeof(telemetry->name), name);
+    if (threads > TELEMETRY_MAX_WORKERS) {
+        fprintf(log, "telemetry covers at most %d threads\n", TELEMETRY_MAX_WORKERS);
+        return -1;
+    }
+
+    shm_unlink(telemetry->name); // Left by a run that did not finish
+    int fd = shm_open(telemetry->name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    size_t bytes = sizeof(TelemetryBlock) + (size_t)threads * sizeof(TelemetrySlot);
+    if (fd < 0 || ftruncate(fd, (off_t)bytes) != 0) {
+        fprintf(log, "%s: %s\n", telemetry->name, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(telemetry->name);
+        }
+        return -1;
+    }
+    void* map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(log, "%s: %s\n", telemetry->name, strerror(errno));
+        shm_unlink(telemetry->name);
+        return -1;
+    }
+
+    // The segment starts zeroed: every slot is even and empty
+    TelemetryBlock* block = (TelemetryBlock*)map;
+    memcpy(block->magic, TELEMETRY_MAGIC, sizeof(block->magic));
+    block->workers = (uint64_t)threads;
+    block->trips = job->trips;
+    block->first_seed = job->first_seed;
+    block->started_ns = telemetry_now_ns();
+    block->pid = (int64_t)getpid();
+    snprintf(block->description, sizeof(block->description), "%s", description);
+    atomic_store_explicit(&block->ready, 1, memory_order_release);
+
+    telemetry->block = block;
+    telemetry->bytes = bytes;
+    job->on_chunk = publish;
+    job->chunk_ctx = block;
+    return 0;
+}
+
+void telemetry_finish(Telemetry* telemetry) {
+    atomic_store_explicit(&telemetry->block->finished_ns, telemetry_now_ns(), memory_order_release);
+}
+
+void telemetry_close(Telemetry* telemetry) {
+    if (telemetry->block) {
+        munmap(telemetry->block, telemetry->bytes);
+        shm_unlink(telemetry->name);
+        telemetry->block = NULL;
+    }
+}
+
+int telemetry_attach(TelemetryView* view, const char* name, FILE* log) {
+    char path[256];
+    struct stat info;
+
+    memset(view, 0, sizeof(*view));
+    segment_name(path, sizeof(path), name);
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(log, "%s: %s\n", path, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    size_t bytes = (size_t)info.st_size;
+    void* map = bytes >= sizeof(TelemetryBlock) ? mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(log, "%s: not a batch's telemetry\n", path);
+        return -1;
+    }
+
+    const TelemetryBlock* block = (const TelemetryBlock*)map;
+    if (memcmp(block->magic, TELEMETRY_MAGIC, sizeof(block->magic)) != 0 ||
+        atomic_load_explicit(&((TelemetryBlock*)map)->ready, memory_order_acquire) != 1 ||
+        block->workers < 1 || block->workers > TELEMETRY_MAX_WORKERS ||
+        bytes < sizeof(TelemetryBlock) + (size_t)block->workers * sizeof(TelemetrySlot)) {
+        fprintf(log, "%s: not a batch's telemetry, or still starting\n", path);
+        munmap(map, bytes);
+        return -1;
+    }
+
+    view->block = block;
+    view->bytes = bytes;
+    view->workers = (int)block->workers;
+    view->trips = block->trips;
+    view->first_seed = (unsigned int)block->first_seed;
+    view->pid = (long)block->pid;
+    view->started_ns = block->started_ns;
+    memcpy(view->description, block->description, sizeof(view->description));
+    view->description[sizeof(view->description) - 1] = '\0';
+    return 0;
+}
+
+void telemetry_detach(TelemetryView* view) {
+    if (view->block) {
+        munmap((void*)view->block, view->bytes);
+        view->block = NULL;
+    }
+}
+
+int telemetry_read_worker(const TelemetryView* view, int w, TelemetryWorker* worker) {
+    TelemetrySlot* slot = (TelemetrySlot*)&view->block->slots[w];
+    uint64_t words[TELEMETRY_SLOT_WORDS];
+
+    for (int tries = 0; tries < TELEMETRY_READ_TRIES; tries++) {
+        uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (before & 1) {
+            sched_yield();
+            continue;
+        }
+        for (size_t i = 0; i < TELEMETRY_SLOT_WORDS; i++) {
+            words[i] = atomic_load_explicit(&slot->words[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) == before) {
+            memcpy(worker, words, sizeof(*worker));
+            return 0;
+        }
+    }
+    memset(worker, 0, sizeof(*worker));
+    return -1;
+}
+
+uint64_t telemetry_finished_ns(const TelemetryView* view) {
+    return atomic_load_explicit(&((TelemetryBlock*)view->block)->finished_ns, memory_order_acquire);
+}
@@ -0,0 +1,88 @@
+/*
+ * Live telemetry of a running batch, in a POSIX shared-memory segment that
+ * another process attaches to and reads while the batch plays.
+ *
+ * The segment holds a header describing the job and one slot per worker.
+ * Each worker writes only its own slot, from run_batch's chunk hook: its
+ * running BatchStats, how far the shared queue of trips had been handed out,
+ * and when it last wrote. So the writer never waits and pays a few dozen
+ * stores per chunk of 1024 trips.
+ *
+ * A slot is a seqlock: the worker makes the sequence odd, stores the words,
+ * then makes it even again, and a reader copies the words and accepts them
+ * only if the sequence was the same even number before and after. Slots sit
+ * on cache lines of their own, so workers do not share a line either.
+ *
+ * Readers derive the rest: totals and survival with its confidence interval
+ * from the summed slots, the queue depth from the furthest hand-out, per-worker
+ * rates from successive reads, and stalls from how long ago a slot was
+ * written. Times are CLOCK_MONOTONIC, which every process on the host shares.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define TELEMETRY_MAGIC "ORTELE1"
+#define TELEMETRY_MAX_WORKERS 1024
+
+// One worker's slot, as read
+typedef struct {
+    uint64_t updated_ns;        // When the worker last wrote, 0 before it started
+    uint64_t handed_out;        // Trips of the job given to workers, as the worker last saw
+    uint64_t finished;          // 1 once the worker has stopped
+    BatchStats stats;           // The worker's trips so far
+} TelemetryWorker;
+
+typedef struct TelemetryBlock TelemetryBlock;
+
+// The batch's side: a segment it publishes into
+typedef struct {
+    char name[256];
+    TelemetryBlock* block;
+    size_t bytes;
+} Telemetry;
+
+// Create the segment name (a leading '/' is added if missing) for the job,
+// replacing one left by an earlier run, and point the job's chunk hook at it.
+// description is shown to readers. Returns 0, or -1 with a message in log
+int telemetry_create(Telemetry* telemetry, const char* name, BatchJob* job, const char* description,
+                     FILE* log);
+
+// Mark the batch done, for readers still attached
+void telemetry_finish(Telemetry* telemetry);
+
+// Unmap and remove the segment; attached readers keep their mapping
+void telemetry_close(Telemetry* telemetry);
+
+// A reader's view of a segment
+typedef struct {
+    const TelemetryBlock* block;
+    size_t bytes;
+    int workers;
+    uint64_t trips;             // Of the job
+    unsigned int first_seed;
+    long pid;                   // Of the batch
+    uint64_t started_ns;
+    char description[160];
+} TelemetryView;
+
+// Returns 0, or -1 with a message in log if there is no such segment or it is
+// not a batch's
+int telemetry_attach(TelemetryView* view, const char* name, FILE* log);
+void telemetry_detach(TelemetryView* view);
+
+// A consistent copy of worker w's slot; returns 0, or -1 if the slot stayed
+// half written (its worker died while writing)
+int telemetry_read_worker(const TelemetryView* view, int w, TelemetryWorker* worker);
+
+// When the batch finished, 0 while it runs
+uint64_t telemetry_finished_ns(const TelemetryView* view);
+
+// CLOCK_MONOTONIC in nanoseconds, the segment's clock
+uint64_t telemetry_now_ns(void);
+
+#endif // TELEMETRY_H
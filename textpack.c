@@ -0,0 +1,263 @@
+/*
+ * textpack: generate oregon_text_packed.h from oregon_text.def.
+ *
+ * Every message is coded with one canonical Huffman code over its bytes,
+ * each message ending with a 0 symbol, and the codes are packed MSB first
+ * into a single bit string. The output holds the code lengths (codes per
+ * length and the symbols in code order), each message's starting bit, and
+ * the bits. Before writing, every message is decoded again the way the game
+ * decodes it and compared with its text.
+ *
+ *   textpack OUTPUT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define MAX_CODE_BITS 15
+#define SYMBOLS 256
+
+static const char* const texts[] = {
+#define TEXT(id, text) text,
+#include "oregon_text.def"
+#undef TEXT
+};
+
+static const char* const names[] = {
+#define TEXT(id, text) #id,
+#include "oregon_text.def"
+#undef TEXT
+};
+
+#define TEXT_COUNT (int)(sizeof(texts) / sizeof(texts[0]))
+
+typedef struct {
+    uint64_t weight;
+    int left, right;            // Children, -1 for a leaf
+} Node;
+
+// Code length of each symbol from Huffman's construction
+static int huffman_lengths(const uint64_t* freq, int* lengths) {
+    Node nodes[2 * SYMBOLS];
+    int live[2 * SYMBOLS];
+    int node_count = 0, live_count = 0;
+
+    memset(lengths, 0, SYMBOLS * sizeof(int));
+    for (int s = 0; s < SYMBOLS; s++) {
+        if (freq[s]) {
+            nodes[node_count] = (Node){freq[s], -1, s};
+            live[live_count++] = node_count++;
+        }
+    }
+    if (live_count == 1) {
+        lengths[nodes[0].right] = 1;
+        return 1;
+    }
+
+    // Merge the two lightest until one tree is left
+    while (live_count > 1) {
+        for (int pass = 0; pass < 2; pass++) {
+            int lightest = pass;
+            for (int i = pass + 1; i < live_count; i++) {
+                if (nodes[live[i]].weight < nodes[live[lightest]].weight) {
+                    lightest = i;
+                }
+            }
+            int swap = live[pass];
+            live[pass] = live[lightest];
+            live[lightest] = swap;
+        }
+        nodes[node_count] = (Node){nodes[live[0]].weight + nodes[live[1]].weight, live[0], live[1]};
+        live[0] = node_count++;
+        live[1] = live[--live_count];
+    }
+
+    // Depth of every leaf
+    int stack[2 * SYMBOLS], depth[2 * SYMBOLS], top = 0, longest = 0;
+    stack[top] = live[0];
+    depth[top++] = 0;
+    while (top > 0) {
+        top--;
+        int node = stack[top], d = depth[top];
+        if (nodes[node].left < 0) {
+            lengths[nodes[node].right] = d;
+            longest = d > longest ? d : longest;
+        } else {
+            stack[top] = nodes[node].left;
+            depth[top++] = d + 1;
+            stack[top] = nodes[node].right;
+            depth[top++] = d + 1;
+        }
+    }
+    return longest;
+}
+
+typedef struct {
+    uint8_t* bytes;             // Zeroed, room for every code
+    uint32_t bit_count;
+} BitString;
+
+static void put_bits(BitString* bits, uint32_t code, int length) {
+    for (int b = length - 1; b >= 0; b--) {
+        if ((code >> b) & 1) {
+            bits->bytes[bits->bit_count >> 3] |= (uint8_t)(0x80 >> (bits->bit_count & 7));
+        }
+        bits->bit_count++;
+    }
+}
+
+// Same decoding as unpack_text_char in oregon.c
+static int decode_char(const BitString* bits, const int* counts, const uint8_t* symbols,
+                       uint32_t* bit_pos) {
+    int code = 0, first = 0, index = 0;
+    for (int length = 1; length <= MAX_CODE_BITS; length++) {
+        code |= (bits->bytes[*bit_pos >> 3] >> (7 - (*bit_pos & 7))) & 1;
+        (*bit_pos)++;
+        if (code - first < counts[length]) {
+            return symbols[index + code - first];
+        }
+        index += counts[length];
+        first = (first + counts[length]) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static void write_bytes(FILE* out, const char* declaration, const uint8_t* bytes, size_t count) {
+    fprintf(out, "%s = {", declaration);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(out, "%s0x%02x,", i % 12 ? " " : "\n    ", bytes[i]);
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+int main(int argc, char** argv) {
+    uint64_t freq[SYMBOLS] = {0};
+    int lengths[SYMBOLS];
+    size_t plain_bytes = 0, format_size = 1;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: textpack OUTPUT\n");
+        return 2;
+    }
+
+    for (int t = 0; t < TEXT_COUNT; t++) {
+        size_t length = strlen(texts[t]);
+        for (size_t i = 0; i < length; i++) {
+            freq[(unsigned char)texts[t][i]]++;
+        }
+        freq[0]++;
+        plain_bytes += length + 1;
+        if (strchr(texts[t], '%') && length + 1 > format_size) {
+            format_size = length + 1;
+        }
+    }
+
+    // Flatten the weights until no code is longer than the decoder reads
+    int longest;
+    uint64_t scaled[SYMBOLS];
+    memcpy(scaled, freq, sizeof(scaled));
+    while ((longest = huffman_lengths(scaled, lengths)) > MAX_CODE_BITS) {
+        for (int s = 0; s < SYMBOLS; s++) {
+            scaled[s] = scaled[s] ? scaled[s] / 2 + 1 : 0;
+        }
+    }
+
+    // Canonical codes: by length, then by symbol
+    int counts[MAX_CODE_BITS + 1] = {0};
+    uint8_t symbols[SYMBOLS];
+    uint32_t codes[SYMBOLS];
+    int symbol_count = 0;
+    for (int length = 1; length <= longest; length++) {
+        for (int s = 0; s < SYMBOLS; s++) {
+            if (lengths[s] == length) {
+                symbols[symbol_count++] = (uint8_t)s;
+                counts[length]++;
+            }
+        }
+    }
+    uint32_t code = 0;
+    for (int i = 0, length = 1; i < symbol_count; i++) {
+        while (lengths[symbols[i]] > length) {
+            code <<= 1;
+            length++;
+        }
+        codes[symbols[i]] = code++;
+    }
+
+    BitString bits = {calloc(plain_bytes * 2, 1), 0}; // Codes are under 16 bits
+    uint32_t* offsets = malloc(TEXT_COUNT * sizeof(uint32_t));
+    for (int t = 0; t < TEXT_COUNT; t++) {
+        offsets[t] = bits.bit_count;
+        for (const unsigned char* c = (const unsigned char*)texts[t];; c++) {
+            put_bits(&bits, codes[*c], lengths[*c]);
+            if (*c == 0) {
+                break;
+            }
+        }
+    }
+    uint32_t byte_count = (bits.bit_count + 7) / 8;
+
+    // Decode everything back before trusting the table
+    for (int t = 0; t < TEXT_COUNT; t++) {
+        uint32_t bit_pos = offsets[t];
+        for (const unsigned char* c = (const unsigned char*)texts[t];; c++) {
+            if (decode_char(&bits, counts, symbols, &bit_pos) != *c) {
+                fprintf(stderr, "textpack: %s does not decode to its text\n", names[t]);
+                return 1;
+            }
+            if (*c == 0) {
+                break;
+            }
+        }
+    }
+
+    char temp_path[4096];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", argv[1]);
+    FILE* out = fopen(temp_path, "w");
+    if (!out) {
+        perror(temp_path);
+        return 1;
+    }
+    int wide = bits.bit_count > UINT16_MAX;
+    fprintf(out, "// Generated by textpack from oregon_text.def; do not edit.\n");
+    fprintf(out, "// %d messages, %zu bytes of text in %u bytes of code.\n\n", TEXT_COUNT,
+            plain_bytes, byte_count);
+    fprintf(out, "#define PACKED_TEXT_MAX_BITS %d\n", longest);
+    fprintf(out, "#define PACKED_TEXT_FORMAT_SIZE %zu   // Longest format, with its terminator\n\n",
+            format_size);
+
+    uint8_t count_bytes[MAX_CODE_BITS + 1];
+    for (int length = 0; length <= longest; length++) {
+        count_bytes[length] = (uint8_t)counts[length];
+    }
+    write_bytes(out, "static const uint8_t packed_text_counts[PACKED_TEXT_MAX_BITS + 1]",
+                count_bytes, (size_t)longest + 1);
+    char declaration[128];
+    snprintf(declaration, sizeof(declaration), "static const uint8_t packed_text_symbols[%d]",
+             symbol_count);
+    write_bytes(out, declaration, symbols, (size_t)symbol_count);
+
+    fprintf(out, "static const %s packed_text_offsets[TEXT_COUNT] = {",
+            wide ? "uint32_t" : "uint16_t");
+    for (int t = 0; t < TEXT_COUNT; t++) {
+        fprintf(out, "%s%u,", t % 8 ? " " : "\n    ", offsets[t]);
+    }
+    fprintf(out, "\n};\n\n");
+
+    snprintf(declaration, sizeof(declaration), "static const uint8_t packed_text_bits[%u]", byte_count);
+    write_bytes(out, declaration, bits.bytes, byte_count);
+
+    if (fclose(out) != 0 || rename(temp_path, argv[1]) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    printf("textpack: %d messages, %zu bytes of text -> %u bytes of code, %u bytes of offsets\n",
+           TEXT_COUNT, plain_bytes, byte_count,
+           (unsigned int)(TEXT_COUNT * (wide ? sizeof(uint32_t) : sizeof(uint16_t))));
+    free(offsets);
+    free(bits.bytes);
+    return 0;
+}
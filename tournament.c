@@ -0,0 +1,223 @@
+/*
+ * Policy tournament with sequential early stopping.
+ */
+
+#include <math.h>
+#include <time.h>
+#include "tournament.h"
+
+// Outcomes of one entry's trips this round, by seed offset
+typedef struct {
+    uint8_t* arrived;
+    unsigned int first_seed;
+} RoundRecord;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void record_trip(int worker, unsigned int seed, const TripResult* result, void* ctx) {
+    RoundRecord* record = (RoundRecord*)ctx;
+    (void)worker;
+    record->arrived[(seed - record->first_seed) & SEED_MASK] = result->outcome == TRIP_ARRIVED;
+}
+
+static double survival(const TournamentEntry* entry) {
+    return entry->stats.trips ? (double)entry->stats.arrived / (double)entry->stats.trips : 0.0;
+}
+
+// Paired difference of survival on n common trips, where i_only trips arrived
+// only for entry i and j_only only for entry j: its mean and sample variance
+static void paired_difference(uint64_t i_only, uint64_t j_only, uint64_t n, double* mean, double* variance) {
+    *mean = ((double)i_only - (double)j_only) / (double)n;
+    *variance = n > 1 ? ((double)(i_only + j_only) - (double)n * *mean * *mean) / (double)(n - 1) : 1.0;
+}
+
+// Empirical Bernstein lower bound (Maurer and Pontil) on the mean of a
+// difference in [-1, 1], which holds with probability 1 - delta
+static double lower_bound(uint64_t i_only, uint64_t j_only, uint64_t n, double delta) {
+    double mean, variance;
+    if (n < 2) {
+        return -1.0;
+    }
+    paired_difference(i_only, j_only, n, &mean, &variance);
+    double log_term = log(2.0 / delta);
+    return mean - sqrt(2.0 * variance * log_term / (double)n) - 14.0 * log_term / (3.0 * (double)(n - 1));
+}
+
+// One-sided normal confidence that entry i's survival is above entry j's
+static double order_confidence(uint64_t i_only, uint64_t j_only, uint64_t n) {
+    double mean, variance;
+    if (n < 2) {
+        return 0.5;
+    }
+    paired_difference(i_only, j_only, n, &mean, &variance);
+    if (variance <= 0.0) {
+        return mean > 0.0 ? 1.0 : 0.5;
+    }
+    return 0.5 * erfc(-mean / sqrt(variance / (double)n) / sqrt(2.0));
+}
+
+// Finishers by survival, then the dropped entries, latest drop first
+static int rank_before(const TournamentEntry* a, const TournamentEntry* b) {
+    if ((a->dropped_round == 0) != (b->dropped_round == 0)) {
+        return a->dropped_round == 0;
+    }
+    if (a->dropped_round != b->dropped_round) {
+        return a->dropped_round > b->dropped_round;
+    }
+    return survival(a) > survival(b);
+}
+
+static void rank_entries(const TournamentJob* job, const uint64_t* only) {
+    int count = job->entry_count;
+    int order[TOURNAMENT_MAX_ENTRIES];
+
+    for (int i = 0; i < count; i++) {
+        int k = i;
+        while (k > 0 && rank_before(&job->entries[i], &job->entries[order[k - 1]])) {
+            order[k] = order[k - 1];
+            k--;
+        }
+        order[k] = i;
+    }
+    for (int k = 0; k < count; k++) {
+        TournamentEntry* entry = &job->entries[order[k]];
+        entry->rank = k + 1;
+        entry->confidence = 0.0;
+        if (k + 1 < count) {
+            // Over the trips both played, which is all of the shorter run
+            int i = order[k], j = order[k + 1];
+            uint64_t n = job->entries[j].stats.trips < entry->stats.trips ?
+                         job->entries[j].stats.trips : entry->stats.trips;
+            entry->confidence = order_confidence(only[i * count + j], only[j * count + i], n);
+        }
+    }
+}
+
+int run_tournament(const TournamentJob* job, TournamentReport* report) {
+    int count = job->entry_count;
+    uint64_t block = job->block ? job->block : TOURNAMENT_BLOCK;
+    int threads = job->threads > 0 ? job->threads : batch_default_threads();
+    double pairs = (double)count * (double)(count > 1 ? count - 1 : 1);
+    double start = now_seconds();
+    GameState probe;
+    int status = -1;
+
+    memset(report, 0, sizeof(*report));
+    if (count < 1 || count > TOURNAMENT_MAX_ENTRIES) {
+        return -1;
+    }
+    for (int e = 0; e < count; e++) {
+        if (apply_purchase_plan(&probe, &job->entries[e].plan) != 0) {
+            return -1;
+        }
+        memset(&job->entries[e].stats, 0, sizeof(BatchStats));
+        job->entries[e].dropped_round = 0;
+        job->entries[e].dropped_by = -1;
+    }
+
+    // only[i * count + j]: common trips on which i arrived and j did not
+    uint64_t* only = calloc((size_t)count * (size_t)count, sizeof(uint64_t));
+    uint8_t* arrived = malloc((size_t)count * (size_t)block);
+    RoundRecord* records = calloc((size_t)count, sizeof(RoundRecord));
+    void** worker_ctx = calloc((size_t)threads, sizeof(void*));
+    if (!only || !arrived || !records || !worker_ctx) {
+        goto done;
+    }
+
+    int alive = count;
+    uint64_t played = 0;
+    while (alive > 1 && played < job->max_trips) {
+        uint64_t trips = job->max_trips - played < block ? job->max_trips - played : block;
+        unsigned int first_seed = (unsigned int)((job->first_seed + played) & SEED_MASK);
+        report->rounds++;
+
+        for (int e = 0; e < count; e++) {
+            TournamentEntry* entry = &job->entries[e];
+            BatchJob batch;
+            BatchStats stats;
+            if (entry->dropped_round) {
+                continue;
+            }
+            records[e].arrived = arrived + (size_t)e * block;
+            records[e].first_seed = first_seed;
+            for (int w = 0; w < threads; w++) {
+                worker_ctx[w] = &records[e];
+            }
+            memset(&batch, 0, sizeof(batch));
+            batch.plan = entry->plan;
+            batch.policy = entry->policy;
+            batch.first_seed = first_seed;
+            batch.trips = trips;
+            batch.threads = threads;
+            batch.generic = job->generic;
+            batch.on_trip = record_trip;
+            batch.worker_ctx = worker_ctx;
+            run_batch(&batch, &stats);
+            batch_stats_merge(&entry->stats, &stats);
+            report->trips += trips;
+        }
+        played += trips;
+
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < count && !job->entries[i].dropped_round; j++) {
+                if (i == j || job->entries[j].dropped_round) {
+                    continue;
+                }
+                const uint8_t* a = records[i].arrived;
+                const uint8_t* b = records[j].arrived;
+                uint64_t i_only = 0;
+                for (uint64_t t = 0; t < trips; t++) {
+                    i_only += a[t] & !b[t];
+                }
+                only[i * count + j] += i_only;
+            }
+        }
+
+        // Decide every drop on this round's standings before applying any
+        double round_delta = job->delta / (pairs * report->rounds * (report->rounds + 1));
+        int dropped_by[TOURNAMENT_MAX_ENTRIES];
+        for (int j = 0; j < count; j++) {
+            dropped_by[j] = -1;
+            for (int i = 0; i < count && !job->entries[j].dropped_round; i++) {
+                if (i == j || job->entries[i].dropped_round) {
+                    continue;
+                }
+                if (lower_bound(only[i * count + j], only[j * count + i], played, round_delta) > 0.0) {
+                    if (dropped_by[j] < 0 || survival(&job->entries[i]) > survival(&job->entries[dropped_by[j]])) {
+                        dropped_by[j] = i;
+                    }
+                }
+            }
+        }
+        for (int j = 0; j < count; j++) {
+            TournamentEntry* entry = &job->entries[j];
+            if (dropped_by[j] < 0) {
+                continue;
+            }
+            entry->dropped_round = report->rounds;
+            entry->dropped_by = dropped_by[j];
+            alive--;
+            if (job->log) {
+                fprintf(job->log, "round %d, %llu trips each: dropped %s (%.4f), beaten by %s (%.4f)\n",
+                        report->rounds, (unsigned long long)played, entry->name, survival(entry),
+                        job->entries[dropped_by[j]].name, survival(&job->entries[dropped_by[j]]));
+            }
+        }
+    }
+
+    rank_entries(job, only);
+    report->fixed_trips = job->max_trips * (uint64_t)count;
+    status = 0;
+
+done:
+    report->seconds = now_seconds() - start;
+    free(only);
+    free(arrived);
+    free(records);
+    free(worker_ctx);
+    return status;
+}
@@ -0,0 +1,64 @@
+/*
+ * Policy tournament with sequential early stopping (racing).
+ *
+ * Every entry, a player with its purchases, plays the same block of seeds
+ * each round, so any two entries still in the race have played exactly the
+ * same trips and are compared on paired outcomes: per seed, one arrived and
+ * the other did not, or not. After each round an entry is dropped once some
+ * other entry's survival beats it by an empirical Bernstein bound on the
+ * paired difference. The bound's error rate is split over the pairs and
+ * over the rounds (delta / (pairs * r * (r + 1)) at round r), so the chance
+ * that any drop was wrong stays below delta however long the race runs.
+ * Compute then goes only to the entries still close.
+ *
+ * The race ends when one entry is left or the rest have played max_trips
+ * each. The ranking puts the finishers by survival first, then the dropped
+ * entries, latest drop first.
+ */
+
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "batch.h"
+
+#define TOURNAMENT_MAX_ENTRIES 64
+#define TOURNAMENT_BLOCK 4096           // Default seeds per round
+
+typedef struct {
+    char name[48];
+    const Policy* policy;
+    PurchasePlan plan;
+
+    // Filled in by the race
+    BatchStats stats;
+    int dropped_round;          // 0 while still in the race
+    int dropped_by;             // Entry whose bound beat it, -1 if none
+    int rank;                   // 1 is the winner
+    double confidence;          // Finishers: that this entry beats the next one down
+} TournamentEntry;
+
+typedef struct {
+    TournamentEntry* entries;
+    int entry_count;
+    unsigned int first_seed;
+    uint64_t block;             // Seeds per round, 0 for TOURNAMENT_BLOCK
+    uint64_t max_trips;         // Per entry
+    double delta;               // Chance that any drop is wrong, e.g. 0.05
+    int threads;                // 0 picks the number of online CPUs
+    int generic;                // As in BatchJob
+    FILE* log;                  // Drops as they happen, NULL for none
+} TournamentJob;
+
+typedef struct {
+    int rounds;
+    uint64_t trips;             // Played over all entries
+    uint64_t fixed_trips;       // A fixed design: every entry max_trips
+    double seconds;
+} TournamentReport;
+
+// Race the entries; returns 0, or -1 if an entry's plan is invalid or memory runs out
+int run_tournament(const TournamentJob* job, TournamentReport* report);
+
+#endif // TOURNAMENT_H
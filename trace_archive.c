@@ -0,0 +1,398 @@
+/*
+ * Columnar per-turn trace archive.
+ */
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace_archive.h"
+
+// Packed columns are read and written eight bytes at a time, so every column
+// keeps this much slack after its last value
+#define TRACE_PACK_SLACK 8
+
+const char* const trace_column_names[TRACE_COLUMN_COUNT] = {
+    "trip", "turn", "miles", "miles_previous", "food", "bullets",
+    "clothing", "misc_supplies", "cash", "oxen_cost", "flags", "event"
+};
+
+const char* const trip_column_names[TRIP_COLUMN_COUNT] = {
+    "seed", "outcome", "death_cause", "turns", "arrival_day", "miles",
+    "food", "bullets", "clothing", "misc_supplies", "cash"
+};
+
+struct TraceWriter {
+    int fd;
+    atomic_uint_fast64_t next_offset;
+    atomic_uint_fast64_t block_count;
+    atomic_uint_fast64_t row_count;
+    atomic_int failed;          // Set by any block that could not be written
+};
+
+struct TraceBlockBuilder {
+    TraceWriter* writer;
+    int table;
+    int column_count;
+    uint32_t rows;
+    int32_t columns[TRACE_COLUMN_COUNT][TRACE_BLOCK_ROWS];
+    uint32_t work[TRACE_BLOCK_ROWS];
+    uint8_t* encoded;
+    size_t encoded_capacity;
+};
+
+static int bits_for_range(uint64_t range) {
+    int bits = 0;
+    while (range) {
+        bits++;
+        range >>= 1;
+    }
+    return bits;
+}
+
+static size_t packed_size(uint32_t rows, int bits) {
+    size_t bytes = ((size_t)rows * (size_t)bits + 7) / 8 + TRACE_PACK_SLACK;
+    return (bytes + 7) & ~(size_t)7;
+}
+
+static void pack_bits(uint8_t* data, const uint32_t* values, uint32_t rows, int bits) {
+    uint64_t bit = 0;
+
+    if (bits == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        uint64_t word;
+        memcpy(&word, data + (bit >> 3), sizeof(word));
+        word |= (uint64_t)values[i] << (bit & 7);
+        memcpy(data + (bit >> 3), &word, sizeof(word));
+        bit += (uint64_t)bits;
+    }
+}
+
+static void unpack_bits(const uint8_t* data, uint32_t rows, int bits, int32_t base, int32_t* out) {
+    uint64_t mask = (bits == 32) ? 0xffffffffu : ((1u << bits) - 1);
+    uint64_t bit = 0;
+
+    if (bits == 0) {
+        for (uint32_t i = 0; i < rows; i++) {
+            out[i] = base;
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < rows; i++) {
+        uint64_t word;
+        memcpy(&word, data + (bit >> 3), sizeof(word));
+        out[i] = (int32_t)((uint32_t)base + (uint32_t)((word >> (bit & 7)) & mask));
+        bit += (uint64_t)bits;
+    }
+}
+
+TraceWriter* trace_writer_open(const char* path) {
+    TraceFileHeader header;
+    TraceWriter* writer = calloc(1, sizeof(TraceWriter));
+    if (!writer) {
+        return NULL;
+    }
+
+    writer->fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (writer->fd < 0) {
+        free(writer);
+        return NULL;
+    }
+
+    // Placeholder header; counts are filled in by trace_writer_close
+    memset(&header, 0, sizeof(header));
+    if (pwrite(writer->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(writer->fd);
+        free(writer);
+        return NULL;
+    }
+
+    atomic_init(&writer->next_offset, sizeof(TraceFileHeader));
+    atomic_init(&writer->block_count, 0);
+    atomic_init(&writer->row_count, 0);
+    atomic_init(&writer->failed, 0);
+    return writer;
+}
+
+int trace_writer_close(TraceWriter* writer) {
+    TraceFileHeader header;
+    int status = 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.block_rows = TRACE_BLOCK_ROWS;
+    header.column_count = TRACE_COLUMN_COUNT;
+    header.block_count = atomic_load(&writer->block_count);
+    header.row_count = atomic_load(&writer->row_count);
+    header.data_end = atomic_load(&writer->next_offset);
+
+    if (atomic_load(&writer->failed) ||
+        pwrite(writer->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        status = -1;
+    }
+    if (close(writer->fd) != 0) {
+        status = -1;
+    }
+    free(writer);
+    return status;
+}
+
+TraceBlockBuilder* trace_builder_create(TraceWriter* writer, int table) {
+    TraceBlockBuilder* builder = calloc(1, sizeof(TraceBlockBuilder));
+    if (!builder) {
+        return NULL;
+    }
+
+    builder->writer = writer;
+    builder->table = table;
+    builder->column_count = (table == TRACE_TABLE_TRIPS) ? TRIP_COLUMN_COUNT : TRACE_COLUMN_COUNT;
+    builder->encoded_capacity = sizeof(TraceBlockHeader) +
+                                TRACE_COLUMN_COUNT * packed_size(TRACE_BLOCK_ROWS, 32);
+    builder->encoded = malloc(builder->encoded_capacity);
+    if (!builder->encoded) {
+        free(builder);
+        return NULL;
+    }
+    return builder;
+}
+
+int trace_builder_add(TraceBlockBuilder* builder, const GameState* game) {
+    uint32_t row = builder->rows;
+
+    builder->columns[TRACE_COL_TRIP][row] = (int32_t)game->rand_seed;
+    builder->columns[TRACE_COL_TURN][row] = game->turn_number;
+    builder->columns[TRACE_COL_MILES][row] = game->miles_traveled;
+    builder->columns[TRACE_COL_MILES_PREVIOUS][row] = game->miles_previous_turn;
+    builder->columns[TRACE_COL_FOOD][row] = game->food;
+    builder->columns[TRACE_COL_BULLETS][row] = game->bullets;
+    builder->columns[TRACE_COL_CLOTHING][row] = game->clothing;
+    builder->columns[TRACE_COL_MISC_SUPPLIES][row] = game->misc_supplies;
+    builder->columns[TRACE_COL_CASH][row] = game->cash;
+    builder->columns[TRACE_COL_OXEN_COST][row] = game->oxen_cost;
+    builder->columns[TRACE_COL_FLAGS][row] = game->game_flags;
+    builder->columns[TRACE_COL_EVENT][row] = game->last_event;
+
+    if (++builder->rows == TRACE_BLOCK_ROWS) {
+        return trace_builder_flush(builder);
+    }
+    return 0;
+}
+
+int trace_builder_add_trip(TraceBlockBuilder* builder, unsigned int seed, const TripResult* result) {
+    uint32_t row = builder->rows;
+
+    builder->columns[TRIP_COL_SEED][row] = (int32_t)seed;
+    builder->columns[TRIP_COL_OUTCOME][row] = result->outcome;
+    builder->columns[TRIP_COL_DEATH_CAUSE][row] = result->death_cause;
+    builder->columns[TRIP_COL_TURNS][row] = result->turn_number;
+    builder->columns[TRIP_COL_ARRIVAL_DAY][row] = result->arrival_day;
+    builder->columns[TRIP_COL_MILES][row] = result->miles_traveled;
+    builder->columns[TRIP_COL_FOOD][row] = result->food;
+    builder->columns[TRIP_COL_BULLETS][row] = result->bullets;
+    builder->columns[TRIP_COL_CLOTHING][row] = result->clothing;
+    builder->columns[TRIP_COL_MISC_SUPPLIES][row] = result->misc_supplies;
+    builder->columns[TRIP_COL_CASH][row] = result->cash;
+
+    if (++builder->rows == TRACE_BLOCK_ROWS) {
+        return trace_builder_flush(builder);
+    }
+    return 0;
+}
+
+// A block that cannot be written is kept by the writer for trace_writer_close
+void trace_turn_hook(const GameState* game, void* ctx) {
+    trace_builder_add(((TraceWorkerBuffers*)ctx)->turns, game);
+}
+
+void trace_trip_hook(int worker, unsigned int seed, const TripResult* result, void* ctx) {
+    (void)worker;
+    trace_builder_add_trip(((TraceWorkerBuffers*)ctx)->trips, seed, result);
+}
+
+// Pick the smaller encoding for one column and pack it at data
+static size_t encode_column(TraceBlockBuilder* builder, const int32_t* values,
+                            TraceColumnDesc* desc, uint8_t* data) {
+    uint32_t rows = builder->rows;
+    int64_t min = values[0], max = values[0];
+    int64_t delta_min = 0, delta_max = 0;
+
+    for (uint32_t i = 1; i < rows; i++) {
+        int64_t delta = (int64_t)values[i] - values[i - 1];
+        if (values[i] < min) min = values[i];
+        if (values[i] > max) max = values[i];
+        if (i == 1 || delta < delta_min) delta_min = delta;
+        if (i == 1 || delta > delta_max) delta_max = delta;
+    }
+
+    int for_bits = bits_for_range((uint64_t)(max - min));
+    int delta_bits = bits_for_range((uint64_t)(delta_max - delta_min));
+    memset(desc, 0, sizeof(*desc));
+
+    // Differences must fit the int32 decode arithmetic to be usable
+    if (rows > 1 && delta_bits < for_bits &&
+        delta_min >= INT32_MIN && delta_max <= INT32_MAX) {
+        desc->encoding = TRACE_ENCODING_DELTA;
+        desc->bits = (uint8_t)delta_bits;
+        desc->base = (int32_t)delta_min;
+        desc->first = values[0];
+        for (uint32_t i = 1; i < rows; i++) {
+            builder->work[i - 1] = (uint32_t)((int64_t)values[i] - values[i - 1] - delta_min);
+        }
+        size_t size = packed_size(rows - 1, delta_bits);
+        memset(data, 0, size);
+        pack_bits(data, builder->work, rows - 1, delta_bits);
+        return size;
+    }
+
+    desc->encoding = TRACE_ENCODING_FOR;
+    desc->bits = (uint8_t)for_bits;
+    desc->base = (int32_t)min;
+    for (uint32_t i = 0; i < rows; i++) {
+        builder->work[i] = (uint32_t)((int64_t)values[i] - min);
+    }
+    size_t size = packed_size(rows, for_bits);
+    memset(data, 0, size);
+    pack_bits(data, builder->work, rows, for_bits);
+    return size;
+}
+
+int trace_builder_flush(TraceBlockBuilder* builder) {
+    TraceBlockHeader* header = (TraceBlockHeader*)builder->encoded;
+    TraceWriter* writer = builder->writer;
+    size_t size = sizeof(TraceBlockHeader);
+
+    if (builder->rows == 0) {
+        return 0;
+    }
+
+    memset(header, 0, sizeof(*header));
+    for (int c = 0; c < builder->column_count; c++) {
+        uint32_t offset = (uint32_t)size;
+        size += encode_column(builder, builder->columns[c], &header->columns[c],
+                              builder->encoded + size);
+        header->columns[c].offset = offset;
+    }
+    header->magic = TRACE_BLOCK_MAGIC;
+    header->rows = builder->rows;
+    header->size = (uint32_t)size;
+    header->table = (uint32_t)builder->table;
+
+    // Claim a slot in the file; no other synchronisation between writers
+    uint64_t offset = atomic_fetch_add(&writer->next_offset, size);
+    ssize_t written = pwrite(writer->fd, builder->encoded, size, (off_t)offset);
+    atomic_fetch_add(&writer->block_count, 1);
+    if (builder->table == TRACE_TABLE_TURNS) {
+        atomic_fetch_add(&writer->row_count, builder->rows);
+    }
+
+    builder->rows = 0;
+    if (written != (ssize_t)size) {
+        atomic_store(&writer->failed, 1);
+        return -1;
+    }
+    return 0;
+}
+
+void trace_builder_destroy(TraceBlockBuilder* builder) {
+    if (builder) {
+        free(builder->encoded);
+        free(builder);
+    }
+}
+
+int trace_reader_open(TraceReader* reader, const char* path) {
+    struct stat info;
+    const TraceFileHeader* header;
+
+    memset(reader, 0, sizeof(*reader));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TraceFileHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    reader->base = (const uint8_t*)map;
+    reader->size = (size_t)info.st_size;
+
+    header = (const TraceFileHeader*)reader->base;
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TRACE_VERSION || header->column_count != TRACE_COLUMN_COUNT ||
+        header->block_rows != TRACE_BLOCK_ROWS || header->data_end > reader->size) {
+        trace_reader_close(reader);
+        return -1;
+    }
+    madvise(map, reader->size, MADV_SEQUENTIAL);
+
+    // The header counts blocks of both tables, so either directory fits
+    size_t directory_size = (size_t)(header->block_count ? header->block_count : 1) *
+                            sizeof(*reader->blocks);
+    reader->blocks = malloc(directory_size);
+    reader->trip_blocks = malloc(directory_size);
+    if (!reader->blocks || !reader->trip_blocks) {
+        trace_reader_close(reader);
+        return -1;
+    }
+
+    // Walk the block chain once to build the directories
+    uint64_t offset = sizeof(TraceFileHeader);
+    uint64_t blocks_seen = 0;
+    while (offset + sizeof(TraceBlockHeader) <= header->data_end &&
+           blocks_seen < header->block_count) {
+        const TraceBlockHeader* block = (const TraceBlockHeader*)(reader->base + offset);
+        if (block->magic != TRACE_BLOCK_MAGIC || block->rows == 0 ||
+            block->rows > TRACE_BLOCK_ROWS || block->size < sizeof(TraceBlockHeader) ||
+            offset + block->size > header->data_end || block->table > TRACE_TABLE_TRIPS) {
+            trace_reader_close(reader);
+            return -1;
+        }
+        if (block->table == TRACE_TABLE_TRIPS) {
+            reader->trip_blocks[reader->trip_block_count++] = block;
+            reader->trip_count += block->rows;
+        } else {
+            reader->blocks[reader->block_count++] = block;
+            reader->row_count += block->rows;
+        }
+        blocks_seen++;
+        offset += block->size;
+    }
+    return 0;
+}
+
+void trace_reader_close(TraceReader* reader) {
+    if (reader->base) {
+        munmap((void*)reader->base, reader->size);
+    }
+    free(reader->blocks);
+    free(reader->trip_blocks);
+    memset(reader, 0, sizeof(*reader));
+}
+
+void trace_decode_block_column(const TraceBlockHeader* header, int column, int32_t* out) {
+    const TraceColumnDesc* desc = &header->columns[column];
+    const uint8_t* data = (const uint8_t*)header + desc->offset;
+    uint32_t rows = header->rows;
+
+    if (desc->encoding == TRACE_ENCODING_FOR) {
+        unpack_bits(data, rows, desc->bits, desc->base, out);
+        return;
+    }
+
+    // Delta: unpack the differences behind the first value, then prefix-sum
+    out[0] = desc->first;
+    unpack_bits(data, rows - 1, desc->bits, desc->base, out + 1);
+    for (uint32_t i = 1; i < rows; i++) {
+        out[i] = (int32_t)((uint32_t)out[i - 1] + (uint32_t)out[i]);
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Columnar per-turn trace archive.
+ *
+ * Every turn of every headless trip becomes one row of the turns table, and
+ * every finished trip one row of the trips table. Rows are grouped into
+ * blocks of TRACE_BLOCK_ROWS, and inside a block each column is stored on its
+ * own, either frame-of-reference bit-packed (value - minimum) or delta encoded
+ * (first value, then bit-packed differences from the minimum difference),
+ * whichever is smaller.
+ *
+ * File layout: a 64-byte TraceFileHeader, then blocks back to back. Each block
+ * starts with a TraceBlockHeader holding the column directory. Workers build
+ * whole blocks privately and claim space for them with a single atomic add on
+ * the file offset, so writers never wait for each other. Block order in the
+ * file therefore follows completion order, not seed order.
+ *
+ * The reader maps the file read-only and decodes columns straight out of the
+ * mapping into a caller buffer, one block at a time.
+ */
+
+#ifndef TRACE_ARCHIVE_H
+#define TRACE_ARCHIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "oregon.h"
+
+#define TRACE_MAGIC "ORTRACE1"
+#define TRACE_VERSION 2
+#define TRACE_BLOCK_MAGIC 0x4b4c4254u // "TBLK"
+#define TRACE_BLOCK_ROWS 4096
+
+// Tables
+#define TRACE_TABLE_TURNS 0
+#define TRACE_TABLE_TRIPS 1
+
+// Turns table columns, one per GameState field of interest
+typedef enum {
+    TRACE_COL_TRIP = 0,     // Trip seed
+    TRACE_COL_TURN,
+    TRACE_COL_MILES,
+    TRACE_COL_MILES_PREVIOUS,
+    TRACE_COL_FOOD,
+    TRACE_COL_BULLETS,
+    TRACE_COL_CLOTHING,
+    TRACE_COL_MISC_SUPPLIES,
+    TRACE_COL_CASH,
+    TRACE_COL_OXEN_COST,
+    TRACE_COL_FLAGS,
+    TRACE_COL_EVENT,
+    TRACE_COLUMN_COUNT
+} TraceColumn;
+
+// Trips table columns (a block has room for TRACE_COLUMN_COUNT)
+typedef enum {
+    TRIP_COL_SEED = 0,
+    TRIP_COL_OUTCOME,       // TRIP_ARRIVED or TRIP_DIED
+    TRIP_COL_DEATH_CAUSE,   // -1 for arrivals
+    TRIP_COL_TURNS,
+    TRIP_COL_ARRIVAL_DAY,
+    TRIP_COL_MILES,
+    TRIP_COL_FOOD,
+    TRIP_COL_BULLETS,
+    TRIP_COL_CLOTHING,
+    TRIP_COL_MISC_SUPPLIES,
+    TRIP_COL_CASH,
+    TRIP_COLUMN_COUNT
+} TripColumn;
+
+// Column encodings
+#define TRACE_ENCODING_FOR 0
+#define TRACE_ENCODING_DELTA 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_rows;
+    uint32_t column_count;
+    uint32_t reserved;
+    uint64_t block_count;
+    uint64_t row_count;
+    uint64_t data_end;      // File offset just past the last block
+    uint8_t padding[16];
+} TraceFileHeader;
+
+typedef struct {
+    uint32_t offset;        // Packed data, from the start of the block
+    uint8_t encoding;       // TRACE_ENCODING_*
+    uint8_t bits;           // Width of every packed value, 0-32
+    uint16_t reserved;
+    int32_t base;           // Minimum value (FOR) or minimum difference (delta)
+    int32_t first;          // First value (delta only)
+} TraceColumnDesc;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t rows;
+    uint32_t size;          // Whole block including this header, multiple of 8
+    uint32_t table;         // TRACE_TABLE_*
+    TraceColumnDesc columns[TRACE_COLUMN_COUNT];
+} TraceBlockHeader;
+
+extern const char* const trace_column_names[TRACE_COLUMN_COUNT];
+extern const char* const trip_column_names[TRIP_COLUMN_COUNT];
+
+// Writing: one TraceWriter per file, one TraceBlockBuilder per table per worker thread
+typedef struct TraceWriter TraceWriter;
+typedef struct TraceBlockBuilder TraceBlockBuilder;
+
+TraceWriter* trace_writer_open(const char* path);
+// Returns 0, or -1 if the header or any block was not written
+int trace_writer_close(TraceWriter* writer);
+
+// The add calls flush each full block; they and trace_builder_flush return
+// 0, or -1 if the block could not be written, which the writer also keeps for
+// trace_writer_close
+TraceBlockBuilder* trace_builder_create(TraceWriter* writer, int table);
+int trace_builder_add(TraceBlockBuilder* builder, const GameState* game);
+int trace_builder_add_trip(TraceBlockBuilder* builder, unsigned int seed, const TripResult* result);
+int trace_builder_flush(TraceBlockBuilder* builder);
+void trace_builder_destroy(TraceBlockBuilder* builder);
+
+// Batch hooks; ctx is the worker's TraceWorkerBuffers
+typedef struct {
+    TraceBlockBuilder* turns;
+    TraceBlockBuilder* trips;
+} TraceWorkerBuffers;
+
+void trace_turn_hook(const GameState* game, void* ctx);
+void trace_trip_hook(int worker, unsigned int seed, const TripResult* result, void* ctx);
+
+// Reading
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    uint64_t row_count;             // Turns table
+    uint64_t block_count;
+    const TraceBlockHeader** blocks;
+    uint64_t trip_count;            // Trips table
+    uint64_t trip_block_count;
+    const TraceBlockHeader** trip_blocks;
+} TraceReader;
+
+int trace_reader_open(TraceReader* reader, const char* path);
+void trace_reader_close(TraceReader* reader);
+
+static inline uint32_t trace_block_rows(const TraceReader* reader, uint64_t block) {
+    return reader->blocks[block]->rows;
+}
+
+// Decode one column of one block into out (TRACE_BLOCK_ROWS entries)
+void trace_decode_block_column(const TraceBlockHeader* block, int column, int32_t* out);
+
+static inline void trace_decode_column(const TraceReader* reader, uint64_t block, int column,
+                                       int32_t* out) {
+    trace_decode_block_column(reader->blocks[block], column, out);
+}
+
+static inline void trace_decode_trip_column(const TraceReader* reader, uint64_t block, int column,
+                                            int32_t* out) {
+    trace_decode_block_column(reader->trip_blocks[block], column, out);
+}
+
+#endif // TRACE_ARCHIVE_H
@@ -0,0 +1,711 @@
+/*
+ * Secondary index and query engine over trace archives.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "trace_index.h"
+#include "trace_archive.h"
+
+// Rows evaluated per chunk, so a chunk's masks stay in L1
+#define QUERY_CHUNK_WORDS 64
+
+const int32_t index_level_thresholds[INDEX_BITMAP_COLUMNS][INDEX_LEVELS] = {
+    {13, 20, 40, 60, 100, 150, 200, 300},           // Food
+    {40, 100, 200, 400, 800, 1500, 2500, 5000},     // Bullets
+    {10, 20, 30, 50, 75, 100, 150, 200},            // Clothing
+    {1, 5, 10, 15, 25, 50, 75, 100},                // Misc supplies
+    {1, 10, 20, 50, 100, 200, 300, 500}             // Cash
+};
+
+const double query_quantile_points[QUERY_QUANTILES] = {0.10, 0.25, 0.50, 0.75, 0.90};
+
+const char* const query_field_names[QUERY_FIELD_COUNT] = {
+    "turn", "miles", "food", "bullets", "clothing", "misc", "cash",
+    "outcome", "arrival_day", "turns"
+};
+
+static const char* const cause_names[DEATH_CAUSE_COUNT] = {
+    "starvation", "exhaustion", "disease", "injuries", "blizzard", "snakebite", "massacre"
+};
+
+// Projection column holding each query field, -1 for turn (implied by the cell)
+static const int field_columns[QUERY_FIELD_COUNT] = {
+    -1, INDEX_COL_MILES, INDEX_COL_FOOD, INDEX_COL_BULLETS, INDEX_COL_CLOTHING,
+    INDEX_COL_MISC_SUPPLIES, INDEX_COL_CASH, INDEX_COL_OUTCOME, INDEX_COL_ARRIVAL_DAY,
+    INDEX_COL_TRIP_TURNS
+};
+
+typedef struct {
+    uint32_t seed;
+    int32_t code;
+    int32_t arrival_day;
+    int32_t turns;
+} TripRow;
+
+static int mile_bucket(int32_t miles) {
+    if (miles < 0) {
+        return 0;
+    }
+    int bucket = miles / INDEX_MILE_BUCKET;
+    return bucket < INDEX_MILE_BUCKETS ? bucket : INDEX_MILE_BUCKETS - 1;
+}
+
+static int cell_of(int32_t turn, int32_t miles) {
+    if (turn < 0) turn = 0;
+    if (turn > INDEX_MAX_TURN) turn = INDEX_MAX_TURN;
+    return turn * INDEX_MILE_BUCKETS + mile_bucket(miles);
+}
+
+static uint64_t align64(uint64_t value) {
+    return (value + 63) & ~(uint64_t)63;
+}
+
+static int compare_trip_seed(const void* a, const void* b) {
+    uint32_t x = ((const TripRow*)a)->seed, y = ((const TripRow*)b)->seed;
+    return (x > y) - (x < y);
+}
+
+// Trip outcome lookup by seed: a dense table when the seeds are a compact range
+typedef struct {
+    TripRow* trips;
+    uint64_t count;
+    int32_t* dense;
+    uint32_t dense_base;
+    uint64_t dense_size;
+} TripLookup;
+
+static const TripRow* find_trip(const TripLookup* lookup, uint32_t seed) {
+    if (lookup->dense) {
+        uint64_t slot = (uint64_t)seed - lookup->dense_base;
+        if (seed < lookup->dense_base || slot >= lookup->dense_size || lookup->dense[slot] < 0) {
+            return NULL;
+        }
+        return &lookup->trips[lookup->dense[slot]];
+    }
+
+    uint64_t low = 0, high = lookup->count;
+    while (low < high) {
+        uint64_t mid = (low + high) / 2;
+        if (lookup->trips[mid].seed < seed) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < lookup->count && lookup->trips[low].seed == seed) ? &lookup->trips[low] : NULL;
+}
+
+static int load_trips(const TraceReader* reader, TripLookup* lookup) {
+    static int32_t columns[5][TRACE_BLOCK_ROWS];
+    static const int wanted[5] = {
+        TRIP_COL_SEED, TRIP_COL_OUTCOME, TRIP_COL_DEATH_CAUSE, TRIP_COL_ARRIVAL_DAY, TRIP_COL_TURNS
+    };
+
+    memset(lookup, 0, sizeof(*lookup));
+    lookup->trips = malloc((size_t)(reader->trip_count ? reader->trip_count : 1) * sizeof(TripRow));
+    if (!lookup->trips) {
+        return -1;
+    }
+
+    for (uint64_t b = 0; b < reader->trip_block_count; b++) {
+        uint32_t rows = reader->trip_blocks[b]->rows;
+        for (int c = 0; c < 5; c++) {
+            trace_decode_trip_column(reader, b, wanted[c], columns[c]);
+        }
+        for (uint32_t r = 0; r < rows; r++) {
+            TripRow* trip = &lookup->trips[lookup->count++];
+            trip->seed = (uint32_t)columns[0][r];
+            trip->code = (columns[1][r] == TRIP_ARRIVED) ? 0 : 1 + columns[2][r];
+            trip->arrival_day = columns[3][r];
+            trip->turns = columns[4][r];
+        }
+    }
+    qsort(lookup->trips, (size_t)lookup->count, sizeof(TripRow), compare_trip_seed);
+
+    if (lookup->count > 0) {
+        uint32_t low = lookup->trips[0].seed;
+        uint64_t span = (uint64_t)lookup->trips[lookup->count - 1].seed - low + 1;
+        if (span <= 2 * lookup->count) {
+            lookup->dense = malloc((size_t)span * sizeof(int32_t));
+            if (lookup->dense) {
+                memset(lookup->dense, 0xff, (size_t)span * sizeof(int32_t));
+                for (uint64_t i = 0; i < lookup->count; i++) {
+                    lookup->dense[lookup->trips[i].seed - low] = (int32_t)i;
+                }
+                lookup->dense_base = low;
+                lookup->dense_size = span;
+            }
+        }
+    }
+    return 0;
+}
+
+int trace_index_build(const char* archive_path, const char* index_path) {
+    static int32_t turn_col[TRACE_BLOCK_ROWS], miles_col[TRACE_BLOCK_ROWS], seed_col[TRACE_BLOCK_ROWS];
+    static int32_t resource_col[INDEX_BITMAP_COLUMNS][TRACE_BLOCK_ROWS];
+    static const int resource_source[INDEX_BITMAP_COLUMNS] = {
+        TRACE_COL_FOOD, TRACE_COL_BULLETS, TRACE_COL_CLOTHING, TRACE_COL_MISC_SUPPLIES, TRACE_COL_CASH
+    };
+    TraceReader reader;
+    TripLookup lookup;
+    IndexFileHeader header;
+    uint64_t cursor[INDEX_CELLS];
+    int status = -1;
+
+    if (trace_reader_open(&reader, archive_path) != 0) {
+        return -1;
+    }
+    if (load_trips(&reader, &lookup) != 0) {
+        trace_reader_close(&reader);
+        return -1;
+    }
+
+    // Pass 1: size every (turn, mile bucket) cell
+    memset(&header, 0, sizeof(header));
+    for (uint64_t b = 0; b < reader.block_count; b++) {
+        uint32_t rows = trace_block_rows(&reader, b);
+        trace_decode_column(&reader, b, TRACE_COL_TURN, turn_col);
+        trace_decode_column(&reader, b, TRACE_COL_MILES, miles_col);
+        for (uint32_t r = 0; r < rows; r++) {
+            header.cell_rows[cell_of(turn_col[r], miles_col[r])]++;
+        }
+    }
+
+    uint64_t padded = 0;
+    for (int cell = 0; cell < INDEX_CELLS; cell++) {
+        header.cell_start[cell] = padded;
+        cursor[cell] = padded;
+        padded += align64(header.cell_rows[cell]);
+    }
+
+    // Lay out the file: header, columns, bitmaps, trip groups
+    uint64_t offset = align64(sizeof(IndexFileHeader));
+    for (int c = 0; c < INDEX_COLUMN_COUNT; c++) {
+        header.column_offset[c] = offset;
+        offset += align64(padded * sizeof(int32_t));
+    }
+    for (int r = 0; r < INDEX_BITMAP_COLUMNS; r++) {
+        for (int l = 0; l < INDEX_LEVELS; l++) {
+            header.bitmap_offset[r][l] = offset;
+            offset += align64(padded / 8);
+        }
+    }
+    header.trip_arrival_offset = offset;
+    offset += align64(lookup.count * sizeof(int32_t));
+    header.trip_turns_offset = offset;
+    offset += align64(lookup.count * sizeof(int32_t));
+
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.column_count = INDEX_COLUMN_COUNT;
+    header.levels = INDEX_LEVELS;
+    header.row_count = reader.row_count;
+    header.padded_rows = padded;
+    header.trip_count = lookup.count;
+
+    int fd = open(index_path, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0) {
+        goto done;
+    }
+    if (ftruncate(fd, (off_t)offset) != 0) {
+        close(fd);
+        goto done;
+    }
+    uint8_t* base = mmap(NULL, (size_t)offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        goto done;
+    }
+
+    int32_t* columns[INDEX_COLUMN_COUNT];
+    for (int c = 0; c < INDEX_COLUMN_COUNT; c++) {
+        columns[c] = (int32_t*)(base + header.column_offset[c]);
+    }
+    // Padding rows belong to no trip
+    for (int cell = 0; cell < INDEX_CELLS; cell++) {
+        uint64_t end = header.cell_start[cell] + align64(header.cell_rows[cell]);
+        for (uint64_t row = header.cell_start[cell] + header.cell_rows[cell]; row < end; row++) {
+            columns[INDEX_COL_OUTCOME][row] = -1;
+        }
+    }
+
+    // Pass 2: scatter rows into their cells and join the trip outcome
+    for (uint64_t b = 0; b < reader.block_count; b++) {
+        uint32_t rows = trace_block_rows(&reader, b);
+        trace_decode_column(&reader, b, TRACE_COL_TRIP, seed_col);
+        trace_decode_column(&reader, b, TRACE_COL_TURN, turn_col);
+        trace_decode_column(&reader, b, TRACE_COL_MILES, miles_col);
+        for (int r = 0; r < INDEX_BITMAP_COLUMNS; r++) {
+            trace_decode_column(&reader, b, resource_source[r], resource_col[r]);
+        }
+
+        const TripRow* trip = NULL;
+        for (uint32_t r = 0; r < rows; r++) {
+            if (!trip || trip->seed != (uint32_t)seed_col[r]) {
+                trip = find_trip(&lookup, (uint32_t)seed_col[r]);
+            }
+            uint64_t row = cursor[cell_of(turn_col[r], miles_col[r])]++;
+            columns[INDEX_COL_MILES][row] = miles_col[r];
+            for (int k = 0; k < INDEX_BITMAP_COLUMNS; k++) {
+                columns[INDEX_BITMAP_FIRST + k][row] = resource_col[k][r];
+            }
+            columns[INDEX_COL_OUTCOME][row] = trip ? trip->code : -1;
+            columns[INDEX_COL_ARRIVAL_DAY][row] = trip ? trip->arrival_day : 0;
+            columns[INDEX_COL_TRIP_TURNS][row] = trip ? trip->turns : 0;
+        }
+    }
+
+    // Range-encoded level bitmaps over the whole projection
+    for (int r = 0; r < INDEX_BITMAP_COLUMNS; r++) {
+        const int32_t* values = columns[INDEX_BITMAP_FIRST + r];
+        for (int l = 0; l < INDEX_LEVELS; l++) {
+            uint64_t* bitmap = (uint64_t*)(base + header.bitmap_offset[r][l]);
+            int32_t threshold = index_level_thresholds[r][l];
+            for (uint64_t w = 0; w < padded / 64; w++) {
+                uint64_t bits = 0;
+                for (int i = 0; i < 64; i++) {
+                    bits |= (uint64_t)(values[w * 64 + i] < threshold) << i;
+                }
+                bitmap[w] = bits;
+            }
+        }
+    }
+
+    // Trips grouped by outcome code (counting sort)
+    int32_t* arrival = (int32_t*)(base + header.trip_arrival_offset);
+    int32_t* turns = (int32_t*)(base + header.trip_turns_offset);
+    uint64_t group_cursor[INDEX_OUTCOME_CODES];
+    memset(header.outcome_start, 0, sizeof(header.outcome_start));
+    for (uint64_t i = 0; i < lookup.count; i++) {
+        header.outcome_start[lookup.trips[i].code + 1]++;
+    }
+    for (int code = 0; code < INDEX_OUTCOME_CODES; code++) {
+        header.outcome_start[code + 1] += header.outcome_start[code];
+        group_cursor[code] = header.outcome_start[code];
+    }
+    for (uint64_t i = 0; i < lookup.count; i++) {
+        uint64_t slot = group_cursor[lookup.trips[i].code]++;
+        arrival[slot] = lookup.trips[i].arrival_day;
+        turns[slot] = lookup.trips[i].turns;
+    }
+
+    memcpy(base, &header, sizeof(header));
+    status = (msync(base, (size_t)offset, MS_SYNC) == 0) ? 0 : -1;
+    munmap(base, (size_t)offset);
+
+done:
+    free(lookup.trips);
+    free(lookup.dense);
+    trace_reader_close(&reader);
+    return status;
+}
+
+int trace_index_open(TraceIndex* index, const char* path) {
+    struct stat info;
+
+    memset(index, 0, sizeof(*index));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(IndexFileHeader)) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    index->base = (const uint8_t*)map;
+    index->size = (size_t)info.st_size;
+    index->header = (const IndexFileHeader*)map;
+    if (memcmp(index->header->magic, INDEX_MAGIC, sizeof(index->header->magic)) != 0 ||
+        index->header->column_count != INDEX_COLUMN_COUNT ||
+        index->header->levels != INDEX_LEVELS) {
+        trace_index_close(index);
+        return -1;
+    }
+    return 0;
+}
+
+void trace_index_close(TraceIndex* index) {
+    if (index->base) {
+        munmap((void*)index->base, index->size);
+    }
+    memset(index, 0, sizeof(*index));
+}
+
+void trace_query_init(TraceQuery* query) {
+    for (int f = 0; f < QUERY_FIELD_COUNT; f++) {
+        query->low[f] = INT32_MIN;
+        query->high[f] = INT32_MAX;
+    }
+    query->quantile_field = -1;
+}
+
+static void narrow(TraceQuery* query, int field, int64_t low, int64_t high) {
+    if (low > query->low[field]) {
+        query->low[field] = low > INT32_MAX ? INT32_MAX : (int32_t)low;
+    }
+    if (high < query->high[field]) {
+        query->high[field] = high < INT32_MIN ? INT32_MIN : (int32_t)high;
+    }
+}
+
+int trace_query_parse_term(TraceQuery* query, const char* term) {
+    char name[32];
+    size_t length = strcspn(term, "<>=");
+    if (length == 0 || length >= sizeof(name) || term[length] == '\0') {
+        return -1;
+    }
+    memcpy(name, term, length);
+    name[length] = '\0';
+
+    const char* op = term + length;
+    const char* value = op + ((op[1] == '=') ? 2 : 1);
+
+    // Outcome is matched by name
+    if (strcmp(name, "cause") == 0 || strcmp(name, "outcome") == 0) {
+        if (op[0] != '=') {
+            return -1;
+        }
+        if (strcmp(value, "arrived") == 0) {
+            narrow(query, QUERY_OUTCOME, 0, 0);
+            return 0;
+        }
+        if (strcmp(value, "died") == 0) {
+            narrow(query, QUERY_OUTCOME, 1, DEATH_CAUSE_COUNT);
+            return 0;
+        }
+        for (int c = 0; c < DEATH_CAUSE_COUNT; c++) {
+            if (strcmp(value, cause_names[c]) == 0) {
+                narrow(query, QUERY_OUTCOME, 1 + c, 1 + c);
+                return 0;
+            }
+        }
+        return -1;
+    }
+
+    int field = -1;
+    for (int f = 0; f < QUERY_FIELD_COUNT; f++) {
+        if (f != QUERY_OUTCOME && strcmp(name, query_field_names[f]) == 0) {
+            field = f;
+        }
+    }
+    if (field < 0) {
+        return -1;
+    }
+
+    char* end;
+    long long number = strtoll(value, &end, 10);
+    if (end == value) {
+        return -1;
+    }
+
+    if (op[0] == '=' && strncmp(end, "..", 2) == 0) {
+        const char* upper = end + 2;
+        long long high = strtoll(upper, &end, 10);
+        if (end == upper || *end) {
+            return -1;
+        }
+        narrow(query, field, number, high);
+        return 0;
+    }
+    if (*end) {
+        return -1;
+    }
+
+    if (op[0] == '=') {
+        narrow(query, field, number, number);
+    } else if (op[0] == '<') {
+        narrow(query, field, INT32_MIN, op[1] == '=' ? number : number - 1);
+    } else {
+        narrow(query, field, op[1] == '=' ? number : number + 1, INT32_MAX);
+    }
+    return 0;
+}
+
+static int field_filtered(const TraceQuery* query, int field) {
+    return query->low[field] != INT32_MIN || query->high[field] != INT32_MAX;
+}
+
+// mask[w] &= bits of values[64w .. 64w+63] that lie in [low, high]
+static void filter_range(const int32_t* values, uint64_t words, int32_t low, int32_t high,
+                         uint64_t* mask) {
+#if defined(__AVX2__)
+    __m256i vlow = _mm256_set1_epi32(low), vhigh = _mm256_set1_epi32(high);
+    for (uint64_t w = 0; w < words; w++) {
+        uint64_t bits = 0;
+        for (int k = 0; k < 8; k++) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(values + w * 64 + k * 8));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(vlow, v), _mm256_cmpgt_epi32(v, vhigh));
+            uint32_t out = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(outside));
+            bits |= (uint64_t)(~out & 0xffu) << (k * 8);
+        }
+        mask[w] &= bits;
+    }
+#elif defined(__SSE2__)
+    __m128i vlow = _mm_set1_epi32(low), vhigh = _mm_set1_epi32(high);
+    for (uint64_t w = 0; w < words; w++) {
+        uint64_t bits = 0;
+        for (int k = 0; k < 16; k++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(values + w * 64 + k * 4));
+            __m128i outside = _mm_or_si128(_mm_cmplt_epi32(v, vlow), _mm_cmpgt_epi32(v, vhigh));
+            uint32_t out = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(outside));
+            bits |= (uint64_t)(~out & 0xfu) << (k * 4);
+        }
+        mask[w] &= bits;
+    }
+#else
+    for (uint64_t w = 0; w < words; w++) {
+        uint64_t bits = 0;
+        for (int i = 0; i < 64; i++) {
+            int32_t v = values[w * 64 + i];
+            bits |= (uint64_t)(v >= low && v <= high) << i;
+        }
+        mask[w] &= bits;
+    }
+#endif
+}
+
+// Use a level bitmap when the predicate is exactly "below a level" or "at least a level"
+static int filter_with_bitmap(const TraceIndex* index, int resource, int32_t low, int32_t high,
+                              uint64_t first_word, uint64_t words, uint64_t* mask) {
+    for (int l = 0; l < INDEX_LEVELS; l++) {
+        int32_t threshold = index_level_thresholds[resource][l];
+        const uint64_t* bitmap = (const uint64_t*)(index->base +
+                                 index->header->bitmap_offset[resource][l]) + first_word;
+        if (low == INT32_MIN && (int64_t)high + 1 == threshold) {
+            for (uint64_t w = 0; w < words; w++) {
+                mask[w] &= bitmap[w];
+            }
+            return 1;
+        }
+        if (high == INT32_MAX && low == threshold) {
+            for (uint64_t w = 0; w < words; w++) {
+                mask[w] &= ~bitmap[w];
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Collected values for quantiles
+typedef struct {
+    int32_t* values;
+    uint64_t count;
+    uint64_t capacity;
+} ValueList;
+
+// Returns 0, or -1 if memory runs out (the list keeps what it had)
+static int value_list_push(ValueList* list, int32_t value) {
+    if (list->count == list->capacity) {
+        uint64_t capacity = list->capacity ? list->capacity * 2 : 4096;
+        int32_t* values = realloc(list->values, (size_t)capacity * sizeof(int32_t));
+        if (!values) {
+            return -1;
+        }
+        list->values = values;
+        list->capacity = capacity;
+    }
+    list->values[list->count++] = value;
+    return 0;
+}
+
+// k-th smallest (quickselect), reordering values
+static int32_t select_kth(int32_t* values, uint64_t count, uint64_t k) {
+    uint64_t low = 0, high = count - 1;
+    while (low < high) {
+        int32_t pivot = values[low + (high - low) / 2];
+        uint64_t i = low, j = high;
+        while (i <= j) {
+            while (values[i] < pivot) i++;
+            while (values[j] > pivot) j--;
+            if (i <= j) {
+                int32_t t = values[i];
+                values[i] = values[j];
+                values[j] = t;
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (k <= j) {
+            high = j;
+        } else if (k >= i) {
+            low = i;
+        } else {
+            break;
+        }
+    }
+    return values[k];
+}
+
+static void finish_quantiles(ValueList* list, QueryResult* result) {
+    for (int q = 0; q < QUERY_QUANTILES; q++) {
+        result->quantiles[q] = 0.0;
+        if (list->count) {
+            uint64_t k = (uint64_t)(query_quantile_points[q] * (double)(list->count - 1));
+            result->quantiles[q] = select_kth(list->values, list->count, k);
+        }
+    }
+    free(list->values);
+}
+
+static int collect_masked(const int32_t* values, const uint64_t* mask, uint64_t words,
+                          ValueList* list) {
+    for (uint64_t w = 0; w < words; w++) {
+        uint64_t bits = mask[w];
+        while (bits) {
+            int i = __builtin_ctzll(bits);
+            if (value_list_push(list, values[w * 64 + i]) != 0) {
+                return -1;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return 0;
+}
+
+// Questions with no turn-level filter are answered from the outcome groups
+static int run_trip_query(const TraceIndex* index, const TraceQuery* query, QueryResult* result,
+                          ValueList* list) {
+    const IndexFileHeader* header = index->header;
+    const int32_t* arrival = (const int32_t*)(index->base + header->trip_arrival_offset);
+    const int32_t* turns = (const int32_t*)(index->base + header->trip_turns_offset);
+    int low = query->low[QUERY_OUTCOME] < 0 ? 0 : query->low[QUERY_OUTCOME];
+    int high = query->high[QUERY_OUTCOME] >= INDEX_OUTCOME_CODES ? INDEX_OUTCOME_CODES - 1
+                                                                  : query->high[QUERY_OUTCOME];
+
+    result->trip_level = 1;
+    for (int code = low; code <= high; code++) {
+        for (uint64_t i = header->outcome_start[code]; i < header->outcome_start[code + 1]; i++) {
+            if (arrival[i] < query->low[QUERY_ARRIVAL_DAY] || arrival[i] > query->high[QUERY_ARRIVAL_DAY] ||
+                turns[i] < query->low[QUERY_TRIP_TURNS] || turns[i] > query->high[QUERY_TRIP_TURNS]) {
+                continue;
+            }
+            result->matched++;
+            result->survived += (code == 0);
+            if ((query->quantile_field == QUERY_ARRIVAL_DAY && value_list_push(list, arrival[i]) != 0) ||
+                (query->quantile_field == QUERY_TRIP_TURNS && value_list_push(list, turns[i]) != 0)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int trace_query_run(const TraceIndex* index, const TraceQuery* query, QueryResult* result) {
+    const IndexFileHeader* header = index->header;
+    uint64_t mask[QUERY_CHUNK_WORDS], arrived[QUERY_CHUNK_WORDS];
+    ValueList list = {NULL, 0, 0};
+    const int32_t* columns[INDEX_COLUMN_COUNT];
+
+    memset(result, 0, sizeof(*result));
+    for (int c = 0; c < INDEX_COLUMN_COUNT; c++) {
+        columns[c] = (const int32_t*)(index->base + header->column_offset[c]);
+    }
+
+    int turn_level = 0;
+    for (int f = QUERY_TURN; f <= QUERY_CASH; f++) {
+        turn_level |= field_filtered(query, f);
+    }
+    if (query->quantile_field >= QUERY_TURN && query->quantile_field <= QUERY_CASH) {
+        turn_level = 1;
+    }
+    if (!turn_level) {
+        if (run_trip_query(index, query, result, &list) != 0) {
+            free(list.values);
+            return -1;
+        }
+        finish_quantiles(&list, result);
+        return 0;
+    }
+
+    int32_t turn_low = query->low[QUERY_TURN] < 0 ? 0 : query->low[QUERY_TURN];
+    int32_t turn_high = query->high[QUERY_TURN] > INDEX_MAX_TURN ? INDEX_MAX_TURN : query->high[QUERY_TURN];
+    int bucket_low = mile_bucket(query->low[QUERY_MILES]);
+    int bucket_high = mile_bucket(query->high[QUERY_MILES]);
+
+    for (int32_t turn = turn_low; turn <= turn_high; turn++) {
+        for (int bucket = bucket_low; bucket <= bucket_high; bucket++) {
+            int cell = turn * INDEX_MILE_BUCKETS + bucket;
+            uint64_t start = header->cell_start[cell];
+            uint64_t rows = header->cell_rows[cell];
+            if (rows == 0) {
+                continue;
+            }
+            result->cells_visited++;
+
+            // The mileage filter is implied when it covers the whole bucket
+            int64_t span_low = bucket == 0 ? INT32_MIN : (int64_t)bucket * INDEX_MILE_BUCKET;
+            int64_t span_high = bucket == INDEX_MILE_BUCKETS - 1 ? INT32_MAX
+                                : (int64_t)(bucket + 1) * INDEX_MILE_BUCKET - 1;
+            int check_miles = query->low[QUERY_MILES] > span_low || query->high[QUERY_MILES] < span_high;
+
+            for (uint64_t done = 0; done < rows; done += QUERY_CHUNK_WORDS * 64) {
+                uint64_t chunk_rows = rows - done;
+                if (chunk_rows > QUERY_CHUNK_WORDS * 64) {
+                    chunk_rows = QUERY_CHUNK_WORDS * 64;
+                }
+                uint64_t words = (chunk_rows + 63) / 64;
+                uint64_t first_row = start + done;
+
+                for (uint64_t w = 0; w < words; w++) {
+                    mask[w] = ~(uint64_t)0;
+                }
+                if (chunk_rows % 64) {
+                    mask[words - 1] = ((uint64_t)1 << (chunk_rows % 64)) - 1;
+                }
+
+                for (int f = QUERY_MILES; f < QUERY_FIELD_COUNT; f++) {
+                    if (!field_filtered(query, f) || (f == QUERY_MILES && !check_miles)) {
+                        continue;
+                    }
+                    int column = field_columns[f];
+                    if (column >= INDEX_BITMAP_FIRST && column < INDEX_BITMAP_FIRST + INDEX_BITMAP_COLUMNS &&
+                        filter_with_bitmap(index, column - INDEX_BITMAP_FIRST, query->low[f],
+                                           query->high[f], first_row / 64, words, mask)) {
+                        result->bitmap_filters++;
+                        continue;
+                    }
+                    filter_range(columns[column] + first_row, words, query->low[f], query->high[f], mask);
+                }
+
+                memcpy(arrived, mask, (size_t)words * sizeof(uint64_t));
+                filter_range(columns[INDEX_COL_OUTCOME] + first_row, words, 0, 0, arrived);
+                for (uint64_t w = 0; w < words; w++) {
+                    result->matched += (uint64_t)__builtin_popcountll(mask[w]);
+                    result->survived += (uint64_t)__builtin_popcountll(arrived[w]);
+                }
+
+                int collected = 0;
+                if (query->quantile_field == QUERY_TURN) {
+                    for (uint64_t w = 0; w < words && collected == 0; w++) {
+                        for (int i = __builtin_popcountll(mask[w]); i > 0 && collected == 0; i--) {
+                            collected = value_list_push(&list, turn);
+                        }
+                    }
+                } else if (query->quantile_field > QUERY_TURN) {
+                    collected = collect_masked(columns[field_columns[query->quantile_field]] + first_row,
+                                               mask, words, &list);
+                }
+                if (collected != 0) {
+                    free(list.values);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    finish_quantiles(&list, result);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Secondary index and query engine over trace archives.
+ *
+ * trace_index_build() reorganises an archive into an index file that answers
+ * filtered aggregate queries without touching the archive again:
+ *
+ *   - Every turn row is copied, uncompressed, into a projection clustered by
+ *     (turn, 100-mile bucket) cell, with the trip's final outcome, death cause
+ *     and arrival day joined onto it. Cells start on 64-row boundaries.
+ *   - For food, bullets, clothing, misc supplies and cash there is one
+ *     range-encoded bitmap per level in index_level_thresholds (bit set when
+ *     the value is below the threshold), so "food<40" is a word-wise AND.
+ *   - Trips are also grouped by outcome code (arrived, then each DeathCause)
+ *     for trip-level questions.
+ *
+ * Queries pick the cells their turn and miles predicates can reach, AND in
+ * any bitmaps that match a predicate exactly, and evaluate the remaining
+ * predicates with SIMD compares over the cell's columns.
+ */
+
+#ifndef TRACE_INDEX_H
+#define TRACE_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "oregon.h"
+
+#define INDEX_MAGIC "ORINDEX1"
+#define INDEX_MAX_TURN 20
+#define INDEX_MILE_BUCKET 100
+#define INDEX_MILE_BUCKETS 26       // Negative mileage joins bucket 0, 2500+ the last
+#define INDEX_CELLS ((INDEX_MAX_TURN + 1) * INDEX_MILE_BUCKETS)
+#define INDEX_LEVELS 8
+
+// Outcome codes: 0 arrived, 1 + DeathCause otherwise
+#define INDEX_OUTCOME_CODES (DEATH_CAUSE_COUNT + 1)
+
+// Projection columns
+typedef enum {
+    INDEX_COL_MILES = 0,
+    INDEX_COL_FOOD,
+    INDEX_COL_BULLETS,
+    INDEX_COL_CLOTHING,
+    INDEX_COL_MISC_SUPPLIES,
+    INDEX_COL_CASH,
+    INDEX_COL_OUTCOME,          // Outcome code of the trip this turn belongs to
+    INDEX_COL_ARRIVAL_DAY,      // Of the trip, 0 if it died
+    INDEX_COL_TRIP_TURNS,       // Turns the whole trip lasted
+    INDEX_COLUMN_COUNT
+} IndexColumn;
+
+// Columns with level bitmaps: INDEX_COL_FOOD .. INDEX_COL_CASH
+#define INDEX_BITMAP_FIRST INDEX_COL_FOOD
+#define INDEX_BITMAP_COLUMNS 5
+
+extern const int32_t index_level_thresholds[INDEX_BITMAP_COLUMNS][INDEX_LEVELS];
+
+typedef struct {
+    char magic[8];
+    uint32_t column_count;
+    uint32_t levels;
+    uint64_t row_count;         // Turn rows, excluding padding
+    uint64_t padded_rows;       // Projection length
+    uint64_t trip_count;
+    uint64_t cell_start[INDEX_CELLS];
+    uint64_t cell_rows[INDEX_CELLS];
+    uint64_t column_offset[INDEX_COLUMN_COUNT];                 // int32[padded_rows]
+    uint64_t bitmap_offset[INDEX_BITMAP_COLUMNS][INDEX_LEVELS]; // uint64[padded_rows / 64]
+    uint64_t outcome_start[INDEX_OUTCOME_CODES + 1];            // Trips grouped by outcome
+    uint64_t trip_arrival_offset;                               // int32[trip_count]
+    uint64_t trip_turns_offset;                                 // int32[trip_count]
+} IndexFileHeader;
+
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    const IndexFileHeader* header;
+} TraceIndex;
+
+// Build an index file from a trace archive; returns 0 or -1
+int trace_index_build(const char* archive_path, const char* index_path);
+
+int trace_index_open(TraceIndex* index, const char* path);
+void trace_index_close(TraceIndex* index);
+
+// Query filters, all inclusive ranges; a column left at INT32_MIN..INT32_MAX is unfiltered
+typedef enum {
+    QUERY_TURN = 0,
+    QUERY_MILES,
+    QUERY_FOOD,
+    QUERY_BULLETS,
+    QUERY_CLOTHING,
+    QUERY_MISC_SUPPLIES,
+    QUERY_CASH,
+    QUERY_OUTCOME,              // Outcome code
+    QUERY_ARRIVAL_DAY,
+    QUERY_TRIP_TURNS,
+    QUERY_FIELD_COUNT
+} QueryField;
+
+typedef struct {
+    int32_t low[QUERY_FIELD_COUNT];
+    int32_t high[QUERY_FIELD_COUNT];
+    int quantile_field;         // QueryField to summarise, -1 for none
+} TraceQuery;
+
+#define QUERY_QUANTILES 5
+
+typedef struct {
+    uint64_t matched;           // Turn rows, or trips for trip-level queries
+    uint64_t survived;
+    int trip_level;             // No turn-level filter, answered from the trip groups
+    double quantiles[QUERY_QUANTILES];  // 10th, 25th, 50th, 75th, 90th percentile
+    uint64_t cells_visited;
+    uint64_t bitmap_filters;    // Predicates answered from level bitmaps
+} QueryResult;
+
+extern const double query_quantile_points[QUERY_QUANTILES];
+extern const char* const query_field_names[QUERY_FIELD_COUNT];
+
+void trace_query_init(TraceQuery* query);
+
+// Parse "food<40", "turn=8", "miles=900..999", "cause=disease", "outcome=arrived"
+int trace_query_parse_term(TraceQuery* query, const char* term);
+
+// Returns 0, or -1 if memory for the quantile values runs out
+int trace_query_run(const TraceIndex* index, const TraceQuery* query, QueryResult* result);
+
+#endif // TRACE_INDEX_H
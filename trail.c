@@ -0,0 +1,354 @@
+/*
+ * Trail map loading and compilation.
+ */
+
+#include <errno.h>
+#ifdef OREGON_SHARED_LIB
+#include <pthread.h>
+#endif
+#include "trail.h"
+
+// The original game's trail; trails/oregon.trail is a copy
+const char trail_default_text[] =
+    "name Oregon Trail (1847)\n"
+    "length 2040\n"
+    "mountains 950 2040\n"
+    "pass south_pass 0\n"
+    "pass blue_mountains 1700\n"
+    "river 0 2040 Rivers and creeks\n"
+    "forts alternate 2/3\n"
+    "landmark 0 Independence\n"
+    "landmark 102 Kansas River\n"
+    "landmark 304 Fort Kearney\n"
+    "landmark 554 Chimney Rock\n"
+    "landmark 640 Fort Laramie\n"
+    "landmark 830 Independence Rock\n"
+    "landmark 950 South Pass\n"
+    "landmark 1150 Fort Bridger\n"
+    "landmark 1350 Fort Hall\n"
+    "landmark 1530 Snake River\n"
+    "landmark 1640 Fort Boise\n"
+    "landmark 1700 Blue Mountains\n"
+    "landmark 1900 The Dalles\n"
+    "landmark 2040 Oregon City\n";
+
+static const Trail* g_trail;        // NULL for the default
+
+#ifdef OREGON_SHARED_LIB
+// The library's TLS must fit the static block (see OREGON_THREAD_LOCAL_HOT), so
+// its threads share one copy of the default, compiled by the first caller
+static Trail g_default_trail;
+static pthread_once_t g_default_once = PTHREAD_ONCE_INIT;
+
+static void compile_default_trail(void) {
+    trail_parse(&g_default_trail, trail_default_text, NULL, 0);
+}
+#else
+// Each thread compiles its own copy of the default, so nothing is shared
+// before set_trail is called
+static OREGON_THREAD_LOCAL Trail t_default_trail;
+#endif
+
+static OREGON_THREAD_LOCAL_HOT const Trail* t_default;     // Set once compiled
+static OREGON_THREAD_LOCAL_HOT const Trail* t_trail;       // set_thread_trail, over g_trail
+
+void set_trail(const Trail* trail) {
+    g_trail = trail;
+}
+
+void set_thread_trail(const Trail* trail) {
+    t_trail = trail;
+}
+
+const Trail* current_trail(void) {
+    if (t_trail) {
+        return t_trail;
+    }
+    if (g_trail) {
+        return g_trail;
+    }
+    if (t_default) {
+        return t_default;
+    }
+#ifdef OREGON_SHARED_LIB
+    pthread_once(&g_default_once, compile_default_trail);
+    t_default = &g_default_trail;
+#else
+    trail_parse(&t_default_trail, trail_default_text, NULL, 0);
+    t_default = &t_default_trail;
+#endif
+    return t_default;
+}
+
+// Parsing
+
+static int fail(char* error, size_t error_size, int line, const char* message) {
+    if (error && error_size) {
+        snprintf(error, error_size, "line %d: %s", line, message);
+    }
+    return -1;
+}
+
+// Copy the rest of a line, trimmed, as a name
+static void copy_name(char* name, const char* text) {
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    size_t length = strlen(text);
+    while (length && isspace((unsigned char)text[length - 1])) {
+        length--;
+    }
+    if (length >= TRAIL_NAME_LEN) {
+        length = TRAIL_NAME_LEN - 1;
+    }
+    memcpy(name, text, length);
+    name[length] = '\0';
+}
+
+static int parse_rate(const char* text, int* num, int* den) {
+    return sscanf(text, "%d/%d", num, den) == 2 && *num >= 0 && *den > 0 ? 0 : -1;
+}
+
+// Flags, fort, landmark and river of one mile
+static TrailSegment segment_at_mile(const Trail* trail, int mile, int mountains_from,
+                                    int mountains_to, int south_pass, int blue_mountains) {
+    TrailSegment segment = {mile, 0, -1, -1, -1};
+
+    if (mile >= mountains_from && mile <= mountains_to) {
+        segment.flags |= TRAIL_HIDE_MILEAGE;
+        if (mile > mountains_from) {
+            segment.flags |= TRAIL_MOUNTAINS;
+        }
+    }
+    if (south_pass >= 0 && mile >= south_pass) {
+        segment.flags |= TRAIL_SOUTH_PASS;
+    }
+    if (blue_mountains >= 0 && mile >= blue_mountains) {
+        segment.flags |= TRAIL_BLUE_MOUNTAINS;
+    }
+    for (int r = 0; r < trail->river_count; r++) {
+        if (mile >= trail->rivers[r].first_mile && mile <= trail->rivers[r].last_mile) {
+            segment.flags |= TRAIL_RIVER;
+            segment.river = (int8_t)r;
+            break;
+        }
+    }
+    // The nearest fort ahead that is within reach
+    for (int f = 0; f < trail->fort_count; f++) {
+        int ahead = trail->forts[f].mile - mile;
+        if (ahead >= 0 && ahead <= trail->reach &&
+            (segment.fort < 0 || trail->forts[f].mile < trail->forts[segment.fort].mile)) {
+            segment.fort = (int8_t)f;
+        }
+    }
+    for (int l = 0; l < trail->landmark_count; l++) {
+        if (trail->landmarks[l].mile <= mile &&
+            (segment.landmark < 0 || trail->landmarks[l].mile >= trail->landmarks[segment.landmark].mile)) {
+            segment.landmark = (int8_t)l;
+        }
+    }
+    return segment;
+}
+
+int trail_parse(Trail* trail, const char* text, char* error, size_t error_size) {
+    int mountains_from = -1, mountains_to = -1;
+    int south_pass = -1, blue_mountains = -1;
+    int line_number = 0;
+    char line[256];
+
+    memset(trail, 0, sizeof(*trail));
+    trail->reach = TRAIL_DEFAULT_REACH;
+
+    while (*text) {
+        // One line, without its comment
+        size_t length = strcspn(text, "\n");
+        size_t copied = length < sizeof(line) - 1 ? length : sizeof(line) - 1;
+        memcpy(line, text, copied);
+        line[copied] = '\0';
+        text += length + (text[length] == '\n');
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char directive[32], word[32];
+        int a, b, consumed = 0;
+        if (sscanf(line, "%31s%n", directive, &consumed) != 1) {
+            continue; // Blank
+        }
+        const char* rest = line + consumed;
+
+        if (strcmp(directive, "name") == 0) {
+            copy_name(trail->name, rest);
+        } else if (strcmp(directive, "length") == 0) {
+            if (sscanf(rest, "%d", &a) != 1 || a < 1 || a > TRAIL_MAX_MILES) {
+                return fail(error, error_size, line_number, "length out of range");
+            }
+            trail->length = a;
+        } else if (strcmp(directive, "mountains") == 0) {
+            if (sscanf(rest, "%d %d", &a, &b) != 2 || a < 0 || b < a) {
+                return fail(error, error_size, line_number, "expected mountains FROM TO");
+            }
+            mountains_from = a;
+            mountains_to = b;
+            trail->shown_mileage = a;
+        } else if (strcmp(directive, "pass") == 0) {
+            if (sscanf(rest, "%31s %d", word, &a) != 2 || a < 0) {
+                return fail(error, error_size, line_number, "expected pass NAME MILE");
+            }
+            if (strcmp(word, "south_pass") == 0) {
+                south_pass = a;
+            } else if (strcmp(word, "blue_mountains") == 0) {
+                blue_mountains = a;
+            } else {
+                return fail(error, error_size, line_number, "passes are south_pass and blue_mountains");
+            }
+        } else if (strcmp(directive, "river") == 0) {
+            if (sscanf(rest, "%d %d%n", &a, &b, &consumed) != 2 || a < 0 || b < a) {
+                return fail(error, error_size, line_number, "expected river FROM TO NAME");
+            }
+            if (trail->river_count == TRAIL_MAX_RIVERS) {
+                return fail(error, error_size, line_number, "too many rivers");
+            }
+            TrailRiver* river = &trail->rivers[trail->river_count++];
+            river->first_mile = a;
+            river->last_mile = b;
+            copy_name(river->name, rest + consumed);
+        } else if (strcmp(directive, "forts") == 0) {
+            if (sscanf(rest, "%31s %31s", word, directive) != 2 || strcmp(word, "alternate") != 0 ||
+                parse_rate(directive, &trail->alternate_num, &trail->alternate_den) != 0) {
+                return fail(error, error_size, line_number, "expected forts alternate NUM/DEN");
+            }
+            trail->alternate_forts = 1;
+        } else if (strcmp(directive, "fort") == 0) {
+            TrailFort fort;
+            if (sscanf(rest, "%d %31s%n", &fort.mile, word, &consumed) != 2 || fort.mile < 0 ||
+                parse_rate(word, &fort.rate_num, &fort.rate_den) != 0) {
+                return fail(error, error_size, line_number, "expected fort MILE NUM/DEN NAME");
+            }
+            if (trail->fort_count == TRAIL_MAX_FORTS) {
+                return fail(error, error_size, line_number, "too many forts");
+            }
+            copy_name(fort.name, rest + consumed);
+            trail->forts[trail->fort_count++] = fort;
+        } else if (strcmp(directive, "reach") == 0) {
+            if (sscanf(rest, "%d", &a) != 1 || a < 0) {
+                return fail(error, error_size, line_number, "expected reach MILES");
+            }
+            trail->reach = a;
+        } else if (strcmp(directive, "landmark") == 0) {
+            if (sscanf(rest, "%d%n", &a, &consumed) != 1 || a < 0) {
+                return fail(error, error_size, line_number, "expected landmark MILE NAME");
+            }
+            if (trail->landmark_count == TRAIL_MAX_LANDMARKS) {
+                return fail(error, error_size, line_number, "too many landmarks");
+            }
+            TrailLandmark* landmark = &trail->landmarks[trail->landmark_count++];
+            landmark->mile = a;
+            copy_name(landmark->name, rest + consumed);
+        } else {
+            return fail(error, error_size, line_number, "unknown directive");
+        }
+    }
+
+    if (trail->length == 0) {
+        return fail(error, error_size, line_number, "no length");
+    }
+    if (trail->alternate_forts && trail->fort_count) {
+        return fail(error, error_size, line_number, "forts alternate and fort lines do not mix");
+    }
+
+    // Compile: one segment per run of miles that answer the same
+    trail->segment_count = 0;
+    for (int mile = 0; mile <= trail->length; mile++) {
+        TrailSegment segment = segment_at_mile(trail, mile, mountains_from, mountains_to,
+                                               south_pass, blue_mountains);
+        const TrailSegment* last = trail->segment_count ? &trail->segments[trail->segment_count - 1] : NULL;
+        if (!last || last->flags != segment.flags || last->fort != segment.fort ||
+            last->landmark != segment.landmark || last->river != segment.river) {
+            if (trail->segment_count == TRAIL_MAX_SEGMENTS) {
+                return fail(error, error_size, line_number, "trail has too many segments");
+            }
+            trail->segments[trail->segment_count++] = segment;
+        }
+        trail->mile_segment[mile] = (uint8_t)(trail->segment_count - 1);
+    }
+    return 0;
+}
+
+int trail_load(Trail* trail, const char* path, char* error, size_t error_size) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        snprintf(error, error_size, "%s", strerror(errno));
+        return -1;
+    }
+
+    size_t capacity = 4096, size = 0;
+    char* text = malloc(capacity);
+    size_t got;
+    while (text && (got = fread(text + size, 1, capacity - size - 1, file)) > 0) {
+        size += got;
+        if (size + 1 == capacity) {
+            char* grown = realloc(text, capacity * 2);
+            if (!grown) {
+                free(text);
+                text = NULL;
+                break;
+            }
+            text = grown;
+            capacity *= 2;
+        }
+    }
+    fclose(file);
+    if (!text) {
+        snprintf(error, error_size, "out of memory");
+        return -1;
+    }
+    text[size] = '\0';
+
+    int status = trail_parse(trail, text, error, error_size);
+    free(text);
+    return status;
+}
+
+static void print_flags(FILE* out, int flags) {
+    static const char* const names[] = {"hidden", "mountains", "south_pass", "blue_mountains", "river"};
+    int first = 1;
+    for (int i = 0; i < 5; i++) {
+        if (flags & (1 << i)) {
+            fprintf(out, "%s%s", first ? "" : ",", names[i]);
+            first = 0;
+        }
+    }
+    if (first) {
+        fprintf(out, "plains");
+    }
+}
+
+void trail_print(FILE* out, const Trail* trail) {
+    fprintf(out, "%s: %d miles, %d segments, ", trail->name[0] ? trail->name : "(unnamed)",
+            trail->length, trail->segment_count);
+    if (trail->alternate_forts) {
+        fprintf(out, "a fort every other turn at %d/%d\n", trail->alternate_num, trail->alternate_den);
+    } else {
+        fprintf(out, "%d forts\n", trail->fort_count);
+    }
+    for (int s = 0; s < trail->segment_count; s++) {
+        const TrailSegment* segment = &trail->segments[s];
+        int last = s + 1 < trail->segment_count ? trail->segments[s + 1].first_mile - 1 : trail->length;
+        fprintf(out, "%5d-%-5d ", segment->first_mile, last);
+        print_flags(out, segment->flags);
+        if (segment->river >= 0) {
+            fprintf(out, "  river: %s", trail->rivers[segment->river].name);
+        }
+        if (segment->fort >= 0) {
+            const TrailFort* fort = &trail->forts[segment->fort];
+            fprintf(out, "  fort: %s (%d/%d)", fort->name, fort->rate_num, fort->rate_den);
+        }
+        if (segment->landmark >= 0) {
+            fprintf(out, "  past %s", trail->landmarks[segment->landmark].name);
+        }
+        fprintf(out, "\n");
+    }
+}
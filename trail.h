@@ -0,0 +1,131 @@
+/*
+ * Trail map: where the regions, passes, river crossings, forts and landmarks
+ * lie along the trail.
+ *
+ * A trail is read from a small text file (see trails/oregon.trail, which is
+ * the built-in default) and compiled into a flat table with one byte per mile
+ * that names the segment the mile lies in. A segment holds everything the game
+ * asks about a stretch of trail, so every "where am I" check is one lookup
+ * whatever the trail looks like.
+ *
+ * Trail files have one directive per line; '#' starts a comment:
+ *
+ *   name TEXT                  trail name
+ *   length MILES               distance to Oregon City
+ *   mountains FROM TO          mountain hazards and cold weather past FROM,
+ *                              no heavy rains; from FROM on the status shows
+ *                              FROM as the mileage
+ *   pass south_pass MILE       where South Pass can be crossed, from MILE on
+ *   pass blue_mountains MILE   where the Blue Mountains begin
+ *   river FROM TO NAME         a wagon can be swamped fording in FROM..TO
+ *   forts alternate NUM/DEN    a fort every other turn (the original rule),
+ *                              goods at NUM/DEN of the dollars paid
+ *   fort MILE NUM/DEN NAME     a fort at MILE, open on turns that start within
+ *                              reach of it until the party stops there
+ *   reach MILES                how far ahead a fort can be reached (200)
+ *   landmark MILE NAME
+ *
+ * A trail with no fort or forts line has no forts.
+ */
+
+#ifndef TRAIL_H
+#define TRAIL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "oregon.h"
+
+// Longest trail; the UNIVAC build keeps the mile table small
+#ifdef UNIVAC
+#define TRAIL_MAX_MILES 2500
+#else
+#define TRAIL_MAX_MILES 8000
+#endif
+#define TRAIL_MAX_SEGMENTS 255
+#define TRAIL_MAX_FORTS 16
+#define TRAIL_MAX_LANDMARKS 32
+#define TRAIL_MAX_RIVERS 16
+#define TRAIL_NAME_LEN 40
+#define TRAIL_DEFAULT_REACH 200
+
+// Segment flags
+#define TRAIL_HIDE_MILEAGE 1        // The status shows shown_mileage instead
+#define TRAIL_MOUNTAINS 2           // Mountain travel and cold weather, no heavy rains
+#define TRAIL_SOUTH_PASS 4          // South Pass can be crossed
+#define TRAIL_BLUE_MOUNTAINS 8      // The Blue Mountains can be cleared
+#define TRAIL_RIVER 16              // A wagon can be swamped fording
+
+typedef struct {
+    int mile;
+    int rate_num;               // Goods bought per dollar, as a fraction
+    int rate_den;
+    char name[TRAIL_NAME_LEN];
+} TrailFort;
+
+typedef struct {
+    int mile;
+    char name[TRAIL_NAME_LEN];
+} TrailLandmark;
+
+typedef struct {
+    int first_mile;
+    int last_mile;
+    char name[TRAIL_NAME_LEN];
+} TrailRiver;
+
+// A stretch of miles that all answer the same
+typedef struct {
+    int first_mile;
+    uint8_t flags;              // TRAIL_*
+    int8_t fort;                // Fort within reach, -1 if none (fixed forts only)
+    int8_t landmark;            // Last landmark passed, -1 before the first
+    int8_t river;               // River range the stretch lies in, -1 if none
+} TrailSegment;
+
+typedef struct {
+    char name[TRAIL_NAME_LEN];
+    int length;
+    int shown_mileage;          // Mileage the status shows where it is hidden
+    int reach;
+    int alternate_forts;        // 1 for the original every-other-turn forts
+    int alternate_num;
+    int alternate_den;
+    TrailFort forts[TRAIL_MAX_FORTS];
+    int fort_count;
+    TrailLandmark landmarks[TRAIL_MAX_LANDMARKS];
+    int landmark_count;
+    TrailRiver rivers[TRAIL_MAX_RIVERS];
+    int river_count;
+
+    // Compiled
+    TrailSegment segments[TRAIL_MAX_SEGMENTS];
+    int segment_count;
+    uint8_t mile_segment[TRAIL_MAX_MILES + 1];  // Miles 0..length
+} Trail;
+
+extern const char trail_default_text[];
+
+// Parse and compile a trail; returns 0, or -1 with a message in error
+int trail_parse(Trail* trail, const char* text, char* error, size_t error_size);
+int trail_load(Trail* trail, const char* path, char* error, size_t error_size);
+
+// Use trail for every game started from here on (NULL for the default); the
+// trail must stay valid while games run. Call before any game starts.
+void set_trail(const Trail* trail);
+
+// Use trail for the games this thread starts from here on, whatever set_trail
+// says (NULL to follow set_trail again)
+void set_thread_trail(const Trail* trail);
+
+// The trail games on this thread use
+const Trail* current_trail(void);
+
+// Segment of a mile; miles before the start or past the end count as the ends
+static inline const TrailSegment* trail_segment(const Trail* trail, int miles) {
+    int mile = miles < 0 ? 0 : miles > trail->length ? trail->length : miles;
+    return &trail->segments[trail->mile_segment[mile]];
+}
+
+void trail_print(FILE* out, const Trail* trail);
+
+#endif // TRAIL_H
@@ -0,0 +1,550 @@
+/*
+ * Full-screen terminal front end for the interactive game.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "tui.h"
+#include "trail.h"
+
+#define ATTR_PLAIN 0
+#define ATTR_BOLD 1
+#define ATTR_REVERSE 2
+
+// Unchanged cells up to this many are rewritten rather than skipped with a
+// cursor move, which costs more bytes
+#define TUI_REWRITE_GAP 4
+
+typedef struct {
+    char ch;
+    unsigned char attr;
+} TuiCell;
+
+typedef struct {
+    int rows;
+    int cols;
+    TuiCell* front;             // What the terminal shows
+    TuiCell* back;              // The frame being drawn
+    int front_valid;            // 0 until the terminal is cleared to match front
+    int cursor_row;             // Terminal cursor, -1 when unknown
+    int cursor_col;
+    unsigned char attr;         // Attribute in effect on the terminal
+    uint64_t log_top;           // Log line at the top of the log area on the terminal
+} TuiScreen;
+
+typedef struct {
+    char* bytes;
+    size_t size;
+    size_t capacity;
+} TuiBuffer;
+
+typedef struct {
+    TuiScreen screen;
+    TuiBuffer out;              // Escapes and text for the frame being sent
+    struct termios saved_termios;
+    int active;
+
+    // Event log: a ring of finished lines and the unfinished one, which is the
+    // prompt while the game waits for an answer
+    char log[TUI_LOG_LINES][TUI_MAX_COLS + 1];
+    uint64_t log_total;         // Lines ever finished; line n is in slot n % TUI_LOG_LINES
+    char partial[TUI_MAX_COLS + 1];
+    int partial_length;
+
+    char answer[MAX_INPUT_LEN];
+    int answer_length;
+    int escape;                 // 1 after ESC, 2 inside a CSI sequence
+    char input[MAX_INPUT_LEN + 1];  // Answer handed to the console, with its newline
+
+    int have_status;
+    GameState status;
+} Tui;
+
+static Tui tui;
+static volatile sig_atomic_t tui_resized = 0;
+
+static const char tui_enter_sequence[] = "\x1b[?1049h";
+static const char tui_leave_sequence[] = "\x1b[r\x1b[0m\x1b[?25h\x1b[?1049l";
+
+static void write_all(const char* bytes, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(STDOUT_FILENO, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+}
+
+// Put the terminal back as it was; safe to call from a signal handler
+static void tui_restore(void) {
+    if (!tui.active) {
+        return;
+    }
+    tui.active = 0;
+    write_all(tui_leave_sequence, sizeof(tui_leave_sequence) - 1);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &tui.saved_termios);
+}
+
+static void on_fatal_signal(int sig) {
+    tui_restore();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void on_resize(int sig) {
+    (void)sig;
+    tui_resized = 1;
+}
+
+static void buffer_put(TuiBuffer* buffer, const char* bytes, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+        char* grown = realloc(buffer->bytes, capacity);
+        if (!grown) {
+            return;
+        }
+        buffer->bytes = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->bytes + buffer->size, bytes, size);
+    buffer->size += size;
+}
+
+static void buffer_puts(TuiBuffer* buffer, const char* text) {
+    buffer_put(buffer, text, strlen(text));
+}
+
+static void move_cursor(TuiScreen* screen, int row, int col) {
+    char sequence[32];
+    snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", row + 1, col + 1);
+    buffer_puts(&tui.out, sequence);
+    screen->cursor_row = row;
+    screen->cursor_col = col;
+}
+
+static void set_attr(TuiScreen* screen, unsigned char attr) {
+    static const char* const sequences[] = {"\x1b[0m", "\x1b[0;1m", "\x1b[0;7m"};
+    buffer_puts(&tui.out, sequences[attr]);
+    screen->attr = attr;
+}
+
+static void clear_cells(TuiCell* cells, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        cells[i].ch = ' ';
+        cells[i].attr = ATTR_PLAIN;
+    }
+}
+
+// Match the screen model to the terminal size; the next frame repaints everything
+static void resize_screen(void) {
+    TuiScreen* screen = &tui.screen;
+    struct winsize size;
+    int rows = 24, cols = 80;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        rows = size.ws_row;
+        cols = size.ws_col < TUI_MAX_COLS ? size.ws_col : TUI_MAX_COLS;
+    }
+    size_t cells = (size_t)rows * (size_t)cols;
+    TuiCell* front = malloc(cells * sizeof(TuiCell));
+    TuiCell* back = malloc(cells * sizeof(TuiCell));
+    if (!front || !back) {
+        free(front);
+        free(back);
+        return; // Keep drawing at the old size
+    }
+    free(screen->front);
+    free(screen->back);
+    screen->front = front;
+    screen->back = back;
+    screen->rows = rows;
+    screen->cols = cols;
+    screen->front_valid = 0;
+}
+
+// Event log
+
+static void log_finish_line(void) {
+    char* line = tui.log[tui.log_total % TUI_LOG_LINES];
+    memcpy(line, tui.partial, (size_t)tui.partial_length);
+    line[tui.partial_length] = '\0';
+    tui.log_total++;
+    tui.partial_length = 0;
+}
+
+static void log_putc(int c) {
+    int width = tui.screen.cols > 1 ? tui.screen.cols - 1 : TUI_MAX_COLS;
+
+    if (c == '\n') {
+        log_finish_line();
+    } else if (c == '\t') {
+        do {
+            log_putc(' ');
+        } while (tui.partial_length % 8 != 0);
+    } else if (c != '\r') {
+        if (tui.partial_length >= width) {
+            log_finish_line(); // Wrap
+        }
+        tui.partial[tui.partial_length++] = isprint(c) ? (char)c : '?';
+    }
+}
+
+// Move everything the game printed since the last read into the log
+static void take_output(GameConsole* console) {
+    for (size_t i = 0; i < console->output_size; i++) {
+        log_putc((unsigned char)console->output[i]);
+    }
+    console->output_size = 0;
+}
+
+// Frame drawing
+
+static void put_text(int row, int col, const char* text, int length, unsigned char attr) {
+    TuiScreen* screen = &tui.screen;
+    for (int i = 0; i < length && col + i < screen->cols; i++) {
+        TuiCell* cell = &screen->back[row * screen->cols + col + i];
+        cell->ch = text[i];
+        cell->attr = attr;
+    }
+}
+
+static void put_string(int row, int col, const char* text, unsigned char attr) {
+    put_text(row, col, text, (int)strlen(text), attr);
+}
+
+static int log_area_rows(void) {
+    return tui.screen.rows - TUI_PANEL_ROWS - 1;
+}
+
+static uint64_t log_top_line(void) {
+    uint64_t rows = (uint64_t)log_area_rows();
+    return tui.log_total > rows ? tui.log_total - rows : 0;
+}
+
+// Draw the whole frame into the back buffer; returns the cursor column on the prompt line
+static int draw_frame(void) {
+    static const char* const labels[] = {"FOOD", "BULLETS", "CLOTHING", "MISC. SUPP.", "CASH"};
+    TuiScreen* screen = &tui.screen;
+    char text[64];
+
+    clear_cells(screen->back, (size_t)screen->rows * (size_t)screen->cols);
+    if (screen->rows < TUI_MIN_ROWS || screen->cols < TUI_MIN_COLS) {
+        put_string(0, 0, "ENLARGE THE WINDOW", ATTR_BOLD);
+        return 0;
+    }
+
+    // Status panel
+    for (int col = 0; col < screen->cols; col++) {
+        screen->back[col].attr = ATTR_REVERSE;
+    }
+    put_string(0, 1, "THE OREGON TRAIL", ATTR_REVERSE);
+    if (tui.have_status) {
+        const GameState* game = &tui.status;
+        int values[] = {game->food, game->bullets, game->clothing, game->misc_supplies, game->cash};
+
+        snprintf(text, sizeof(text), "TURN %d", game->turn_number);
+        put_string(0, screen->cols - (int)strlen(text) - 1, text, ATTR_REVERSE);
+        // The game hides the real mileage in the mountains
+        const Trail* trail = current_trail();
+        const TrailSegment* segment = trail_segment(trail, game->miles_traveled);
+        snprintf(text, sizeof(text), "TOTAL MILEAGE IS %d",
+                 segment->flags & TRAIL_HIDE_MILEAGE ? trail->shown_mileage : game->miles_traveled);
+        put_string(1, 1, text, ATTR_PLAIN);
+        for (int i = 0; i < 5; i++) {
+            put_string(2, 1 + 13 * i, labels[i], ATTR_BOLD);
+            snprintf(text, sizeof(text), "%d", values[i]);
+            put_string(3, 1 + 13 * i, text, ATTR_PLAIN);
+        }
+    }
+    for (int col = 0; col < screen->cols; col++) {
+        screen->back[(TUI_PANEL_ROWS - 1) * screen->cols + col].ch = '-';
+    }
+
+    // Event log, the newest lines that fit
+    uint64_t top = log_top_line();
+    for (uint64_t line = top; line < tui.log_total; line++) {
+        put_string(TUI_PANEL_ROWS + (int)(line - top), 0, tui.log[line % TUI_LOG_LINES], ATTR_PLAIN);
+    }
+
+    // Prompt and answer, scrolled to keep the end in view; the bottom right
+    // cell stays empty so the terminal never scrolls
+    char prompt[TUI_MAX_COLS + MAX_INPUT_LEN + 2];
+    int length = 0;
+    if (tui.partial_length == 0) {
+        prompt[length++] = '>';
+        prompt[length++] = ' ';
+    }
+    memcpy(prompt + length, tui.partial, (size_t)tui.partial_length);
+    length += tui.partial_length;
+    memcpy(prompt + length, tui.answer, (size_t)tui.answer_length);
+    length += tui.answer_length;
+
+    int width = screen->cols - 1;
+    int first = length > width ? length - width : 0;
+    put_text(screen->rows - 1, 0, prompt + first, length - first, ATTR_PLAIN);
+    return length - first;
+}
+
+// Scroll the log area on the terminal itself when the log only moved up,
+// so the diff below sends just the new lines
+static void scroll_log_area(void) {
+    TuiScreen* screen = &tui.screen;
+    uint64_t top = log_top_line();
+    int rows = log_area_rows();
+    uint64_t shift = top - screen->log_top;
+
+    screen->log_top = top;
+    if (shift == 0 || shift >= (uint64_t)rows || rows < 2) {
+        return;
+    }
+
+    char sequence[32];
+    snprintf(sequence, sizeof(sequence), "\x1b[%d;%dr", TUI_PANEL_ROWS + 1, TUI_PANEL_ROWS + rows);
+    buffer_puts(&tui.out, sequence);
+    if (screen->attr != ATTR_PLAIN) {
+        set_attr(screen, ATTR_PLAIN);   // New lines are cleared in the current attribute
+    }
+    move_cursor(screen, TUI_PANEL_ROWS + rows - 1, 0);
+    for (uint64_t i = 0; i < shift; i++) {
+        buffer_puts(&tui.out, "\n");
+    }
+    buffer_puts(&tui.out, "\x1b[r");
+    screen->cursor_row = -1;            // Resetting the region homes the cursor
+
+    TuiCell* area = screen->front + TUI_PANEL_ROWS * screen->cols;
+    size_t kept = (size_t)(rows - (int)shift) * (size_t)screen->cols;
+    memmove(area, area + shift * (uint64_t)screen->cols, kept * sizeof(TuiCell));
+    clear_cells(area + kept, (size_t)shift * (size_t)screen->cols);
+}
+
+// Send the cells that differ between the back and front buffers
+static void present(int cursor_col) {
+    TuiScreen* screen = &tui.screen;
+    int cols = screen->cols;
+
+    tui.out.size = 0;
+    if (!screen->front_valid) {
+        buffer_puts(&tui.out, "\x1b[0m\x1b[H\x1b[2J");
+        clear_cells(screen->front, (size_t)screen->rows * (size_t)cols);
+        screen->attr = ATTR_PLAIN;
+        screen->cursor_row = 0;
+        screen->cursor_col = 0;
+        screen->log_top = log_top_line();
+        screen->front_valid = 1;
+    } else {
+        scroll_log_area();
+    }
+
+    for (int row = 0; row < screen->rows; row++) {
+        TuiCell* front = screen->front + row * cols;
+        TuiCell* back = screen->back + row * cols;
+        for (int col = 0; col < cols; col++) {
+            if (front[col].ch == back[col].ch && front[col].attr == back[col].attr) {
+                continue;
+            }
+
+            int gap = col - screen->cursor_col;
+            int rewrite = screen->cursor_row == row && gap > 0 && gap <= TUI_REWRITE_GAP;
+            for (int i = screen->cursor_col; rewrite && i < col; i++) {
+                rewrite = front[i].attr == screen->attr;
+            }
+            if (rewrite) {
+                for (int i = screen->cursor_col; i < col; i++) {
+                    buffer_put(&tui.out, &front[i].ch, 1);
+                }
+            } else if (screen->cursor_row != row || screen->cursor_col != col) {
+                move_cursor(screen, row, col);
+            }
+
+            if (back[col].attr != screen->attr) {
+                set_attr(screen, back[col].attr);
+            }
+            buffer_put(&tui.out, &back[col].ch, 1);
+            front[col] = back[col];
+            screen->cursor_col = col + 1;
+            if (screen->cursor_col >= cols) {
+                screen->cursor_row = -1;    // Pending wrap; position it explicitly next time
+            }
+        }
+    }
+
+    if (screen->cursor_row != screen->rows - 1 || screen->cursor_col != cursor_col) {
+        move_cursor(screen, screen->rows - 1, cursor_col);
+    }
+    write_all(tui.out.bytes, tui.out.size);
+}
+
+// Edit an answer on the prompt line; returns 0 on Enter, -1 at end of input
+static int read_answer(void) {
+    for (;;) {
+        if (tui_resized) {
+            tui_resized = 0;
+            resize_screen();
+        }
+        present(draw_frame());
+
+        unsigned char key;
+        ssize_t got = read(STDIN_FILENO, &key, 1);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return -1;
+        }
+
+        // Cursor and function keys are dropped: ESC [ parameters final-byte
+        if (tui.escape) {
+            if (tui.escape == 1 && (key == '[' || key == 'O')) {
+                tui.escape = 2;
+            } else if (!(tui.escape == 2 && key >= 0x20 && key < 0x40)) {
+                tui.escape = 0;
+            }
+            continue;
+        }
+
+        switch (key) {
+            case 27:
+                tui.escape = 1;
+                break;
+            case '\r':
+            case '\n':
+                return 0;
+            case 4:     // Ctrl-D on an empty line
+                if (tui.answer_length == 0) {
+                    return -1;
+                }
+                break;
+            case 8:
+            case 127:
+                if (tui.answer_length > 0) {
+                    tui.answer_length--;
+                }
+                break;
+            case 12:    // Ctrl-L repaints
+                tui.screen.front_valid = 0;
+                break;
+            case 21:    // Ctrl-U clears the answer
+                tui.answer_length = 0;
+                break;
+            default:
+                if (key >= 32 && key < 127 && tui.answer_length < MAX_INPUT_LEN - 1) {
+                    tui.answer[tui.answer_length++] = (char)key;
+                }
+                break;
+        }
+    }
+}
+
+// Console callbacks
+
+static int tui_refill(GameConsole* console, void* ctx) {
+    (void)ctx;
+    take_output(console);
+    int status = read_answer();
+
+    // The prompt and its answer stay in the log as one line
+    for (int i = 0; i < tui.answer_length; i++) {
+        log_putc((unsigned char)tui.answer[i]);
+    }
+    log_putc('\n');
+    if (status != 0) {
+        tui.answer_length = 0;
+        return 0;
+    }
+
+    memcpy(tui.input, tui.answer, (size_t)tui.answer_length);
+    tui.input[tui.answer_length] = '\n';
+    console->input = tui.input;
+    console->input_size = (size_t)tui.answer_length + 1;
+    console->input_pos = 0;
+    tui.answer_length = 0;
+    return 1;
+}
+
+static void tui_show_status(GameConsole* console, const GameState* game) {
+    (void)console;
+    tui.status = *game;
+    tui.have_status = 1;
+}
+
+static int tui_enter(void) {
+    struct termios raw;
+    struct sigaction action;
+
+    if (tcgetattr(STDIN_FILENO, &tui.saved_termios) != 0) {
+        return -1;
+    }
+    raw = tui.saved_termios;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+        return -1;
+    }
+    tui.active = 1;
+    atexit(tui_restore);
+
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = on_fatal_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+    sigaction(SIGQUIT, &action, NULL);
+    action.sa_handler = on_resize;      // No SA_RESTART: a resize interrupts the key read
+    sigaction(SIGWINCH, &action, NULL);
+
+    write_all(tui_enter_sequence, sizeof(tui_enter_sequence) - 1);
+    resize_screen();
+    return tui.screen.back ? 0 : -1;
+}
+
+int tui_play(void) {
+    GameConsole console;
+    const char* fixed_seed = getenv("OREGON_SEED");
+
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+        fprintf(stderr, "oregon: --tui needs a terminal\n");
+        return 1;
+    }
+    if (tui_enter() != 0) {
+        tui_restore();
+        fprintf(stderr, "oregon: cannot set up the terminal\n");
+        return 1;
+    }
+
+    memset(&console, 0, sizeof(console));
+    console.seed = fixed_seed ? (unsigned int)strtoul(fixed_seed, NULL, 0) : (unsigned int)time(NULL);
+    console.refill = tui_refill;
+    console.show_status = tui_show_status;
+    play_game_console(&console);
+
+    // Leave the last screen up until Enter
+    take_output(&console);
+    if (tui.partial_length > 0) {
+        log_putc('\n');
+    }
+    memcpy(tui.partial, "PRESS ENTER TO LEAVE", 20);
+    tui.partial_length = 20;
+    read_answer();
+
+    tui_restore();
+    free(console.output);
+    free(tui.out.bytes);
+    free(tui.screen.front);
+    free(tui.screen.back);
+    return 0;
+}
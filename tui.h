@@ -0,0 +1,29 @@
+/*
+ * Full-screen terminal front end for the interactive game (oregon --tui).
+ *
+ * The game runs on an in-memory GameConsole. Its output becomes a scrolling
+ * event log, the supplies table is shown in a status panel that is updated in
+ * place, and the prompt waiting for an answer sits on the bottom line with the
+ * answer being typed.
+ *
+ * Frames are drawn into a back buffer and compared cell by cell with what the
+ * terminal already shows; only changed cells are sent, and log scrolling uses
+ * the terminal's scroll region, so a turn costs a few hundred bytes instead of
+ * a repaint. Needs a POSIX terminal (termios and ANSI escapes).
+ */
+
+#ifndef TUI_H
+#define TUI_H
+
+#include "oregon.h"
+
+#define TUI_PANEL_ROWS 5        // Title, mileage, labels, values, rule
+#define TUI_MIN_ROWS 12
+#define TUI_MIN_COLS 40
+#define TUI_MAX_COLS 256        // Wider terminals leave the rest blank
+#define TUI_LOG_LINES 512       // Event log kept for redraws
+
+// Play one game full-screen on the controlling terminal; returns the exit status
+int tui_play(void);
+
+#endif // TUI_H
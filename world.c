@@ -0,0 +1,441 @@
+/*
+ * Shared world of many wagons with finite fort inventories.
+ */
+
+#include <stdatomic.h>
+#include <time.h>
+#include "world.h"
+
+// Wagons handed to a worker at a time
+#define WORLD_CHUNK 512
+
+#define WAGON_TRAVELING 0
+#define WAGON_FINISHED 1
+
+// Demand and sales of one tick, per fort and item; summed across workers
+typedef struct {
+    int64_t demand[TRAIL_MAX_FORTS][ITEM_COUNT];   // Goods asked for at the posted price
+    int64_t sold[TRAIL_MAX_FORTS][ITEM_COUNT];
+    uint32_t visits[TRAIL_MAX_FORTS];
+    uint32_t finished;
+} WorldTally;
+
+struct World {
+    WorldConfig config;
+    Policy deliver;             // The policy, taking no goods at the fort itself
+    int fort_count;
+    WorldFort forts[TRAIL_MAX_FORTS];
+    int64_t demand[TRAIL_MAX_FORTS][ITEM_COUNT];    // This tick's, in goods at the posted price
+    int rationing[TRAIL_MAX_FORTS][ITEM_COUNT];     // This tick's demand exceeds the stock
+    uint32_t tick;
+
+    // Components, indexed by wagon
+    GameState* trip;
+    unsigned int* rng;
+    uint8_t* status;
+    uint8_t* choice;            // This tick's turn action
+    int8_t* fort;               // Fort of this tick's stop, -1 if none
+    int32_t (*bid)[ITEM_COUNT]; // Dollars bid this tick
+    TripResult* result;         // Set when finished
+
+    // Wagons still traveling, in wagon order
+    uint32_t* active;
+    uint32_t active_count;
+    uint32_t arrived;
+    uint32_t died;
+};
+
+typedef struct {
+    World* world;
+    void (*system)(World* world, uint32_t wagon, WorldTally* tally);
+    atomic_uint_fast32_t* next;
+    WorldTally tally;
+} WorldWorker;
+
+// Goods a bid buys at the fort's posted price
+static int64_t posted_goods(const WorldFort* fort, int item, int64_t dollars) {
+    return dollars * fort->rate_num * WORLD_PRICE_ONE / ((int64_t)fort->rate_den * fort->price[item]);
+}
+
+static void add_goods(GameState* game, int item, int64_t goods) {
+    switch (item) {
+        case ITEM_FOOD:
+            game->food += (int)goods;
+            break;
+        case ITEM_AMMUNITION:
+            game->bullets += (int)goods * 50;
+            break;
+        case ITEM_CLOTHING:
+            game->clothing += (int)goods;
+            break;
+        case ITEM_MISC_SUPPLIES:
+            game->misc_supplies += (int)goods;
+            break;
+    }
+}
+
+// The fort stop of a wagon at the action prompt
+static int fort_here(const GameState* game) {
+    const Trail* trail = current_trail();
+    return trail->alternate_forts ? 0 : trail_segment(trail, game->miles_traveled)->fort;
+}
+
+static int deliver_fort_purchase(const GameState* game, int item, void* ctx) {
+    (void)game;
+    (void)item;
+    (void)ctx;
+    return 0; // Paid for and delivered before the turn goes on
+}
+
+// Systems, run on one wagon each
+
+// Up to the action prompt, then the bids of a fort stop: the policy is asked
+// item by item as at a real fort, seeing the goods it has bid for so far
+static void begin_system(World* world, uint32_t w, WorldTally* tally) {
+    const Policy* policy = world->config.policy;
+    int choice = ACTION_CONTINUE;
+
+    seed_random(world->rng[w]);
+    world->fort[w] = -1;
+    if (begin_turn(&world->trip[w], policy, &choice, &world->result[w])) {
+        world->status[w] = WAGON_FINISHED;
+        world->rng[w] = get_random_state();
+        tally->finished++;
+        return;
+    }
+    world->choice[w] = (uint8_t)choice;
+
+    if (choice == ACTION_FORT) {
+        int f = fort_here(&world->trip[w]);
+        const WorldFort* fort = &world->forts[f];
+        GameState view = world->trip[w];
+        world->fort[w] = (int8_t)f;
+        tally->visits[f]++;
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            int amount = policy->fort_purchase(&view, item, policy->ctx);
+            if (amount < 0 || amount > view.cash) {
+                amount = 0; // As get_purchase_amount
+            }
+            int64_t goods = posted_goods(fort, item, amount);
+            world->bid[w][item] = amount;
+            view.cash -= amount;
+            add_goods(&view, item, goods);
+            tally->demand[f][item] += goods;
+        }
+    }
+    world->rng[w] = get_random_state();
+}
+
+// Pay, take the goods, and play the rest of the turn
+static void finish_system(World* world, uint32_t w, WorldTally* tally) {
+    GameState* game = &world->trip[w];
+    int f = world->fort[w];
+
+    if (world->status[w] != WAGON_TRAVELING) {
+        return;
+    }
+    if (f >= 0) {
+        const WorldFort* fort = &world->forts[f];
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            int64_t goods = posted_goods(fort, item, world->bid[w][item]);
+            if (world->rationing[f][item]) {
+                goods = goods * fort->stock[item] / world->demand[f][item];
+            }
+            game->cash -= world->bid[w][item];
+            add_goods(game, item, goods);
+            tally->sold[f][item] += goods;
+        }
+    }
+
+    seed_random(world->rng[w]);
+    if (finish_turn(game, world->choice[w], &world->deliver, &world->result[w])) {
+        world->status[w] = WAGON_FINISHED;
+        tally->finished++;
+    }
+    world->rng[w] = get_random_state();
+}
+
+static void tally_merge(WorldTally* into, const WorldTally* from) {
+    for (int f = 0; f < TRAIL_MAX_FORTS; f++) {
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            into->demand[f][item] += from->demand[f][item];
+            into->sold[f][item] += from->sold[f][item];
+        }
+        into->visits[f] += from->visits[f];
+    }
+    into->finished += from->finished;
+}
+
+static void* world_worker_main(void* arg) {
+    WorldWorker* worker = (WorldWorker*)arg;
+    World* world = worker->world;
+
+    for (;;) {
+        uint32_t first = (uint32_t)atomic_fetch_add(worker->next, WORLD_CHUNK);
+        if (first >= world->active_count) {
+            break;
+        }
+        uint32_t last = first + WORLD_CHUNK;
+        if (last > world->active_count) {
+            last = world->active_count;
+        }
+        for (uint32_t i = first; i < last; i++) {
+            worker->system(world, world->active[i], &worker->tally);
+        }
+    }
+    return NULL;
+}
+
+// Run a system over every active wagon and sum the workers' tallies
+static void run_system(World* world, void (*system)(World*, uint32_t, WorldTally*),
+                       WorldWorker* workers, int threads, WorldTally* tally) {
+    atomic_uint_fast32_t next;
+
+    atomic_init(&next, 0);
+    for (int w = 0; w < threads; w++) {
+        memset(&workers[w].tally, 0, sizeof(WorldTally));
+        workers[w].world = world;
+        workers[w].system = system;
+        workers[w].next = &next;
+    }
+    if (threads == 1) {
+        world_worker_main(&workers[0]);
+    } else {
+        run_worker_threads(world_worker_main, workers, sizeof(WorldWorker), threads);
+    }
+
+    memset(tally, 0, sizeof(WorldTally));
+    for (int w = 0; w < threads; w++) {
+        tally_merge(tally, &workers[w].tally);
+    }
+}
+
+World* world_create(const WorldConfig* config) {
+    const Trail* trail = current_trail();
+    GameState probe;
+
+    if (apply_purchase_plan(&probe, &config->plan) != 0) {
+        return NULL;
+    }
+
+    World* world = calloc(1, sizeof(World));
+    if (!world) {
+        return NULL;
+    }
+    size_t wagons = config->wagons ? config->wagons : 1;
+    world->config = *config;
+    world->deliver = *config->policy;
+    world->deliver.fort_purchase = deliver_fort_purchase;
+    world->trip = malloc(wagons * sizeof(GameState));
+    world->rng = malloc(wagons * sizeof(unsigned int));
+    world->status = calloc(wagons, 1);
+    world->choice = calloc(wagons, 1);
+    world->fort = malloc(wagons);
+    world->bid = malloc(wagons * sizeof(*world->bid));
+    world->result = calloc(wagons, sizeof(TripResult));
+    world->active = malloc(wagons * sizeof(uint32_t));
+    if (!world->trip || !world->rng || !world->status || !world->choice || !world->fort ||
+        !world->bid || !world->result || !world->active) {
+        world_destroy(world);
+        return NULL;
+    }
+
+    if (trail->alternate_forts) {
+        WorldFort* fort = &world->forts[world->fort_count++];
+        snprintf(fort->name, sizeof(fort->name), "Trading post");
+        fort->rate_num = trail->alternate_num;
+        fort->rate_den = trail->alternate_den;
+    } else {
+        for (int f = 0; f < trail->fort_count; f++) {
+            WorldFort* fort = &world->forts[world->fort_count++];
+            memcpy(fort->name, trail->forts[f].name, sizeof(fort->name));
+            fort->rate_num = trail->forts[f].rate_num;
+            fort->rate_den = trail->forts[f].rate_den;
+        }
+    }
+    for (int f = 0; f < world->fort_count; f++) {
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            world->forts[f].stock[item] = config->stock;
+            world->forts[f].price[item] = WORLD_PRICE_ONE;
+        }
+    }
+
+    for (uint32_t w = 0; w < config->wagons; w++) {
+        init_game_seeded(&world->trip[w], (config->first_seed + w) & SEED_MASK);
+        apply_purchase_plan(&world->trip[w], &config->plan);
+        world->rng[w] = get_random_state();
+        world->active[w] = w;
+    }
+    world->active_count = config->wagons;
+    return world;
+}
+
+void world_destroy(World* world) {
+    if (!world) {
+        return;
+    }
+    free(world->trip);
+    free(world->rng);
+    free(world->status);
+    free(world->choice);
+    free(world->fort);
+    free(world->bid);
+    free(world->result);
+    free(world->active);
+    free(world);
+}
+
+// Clear each fort's market: ration every item asked for beyond its stock
+static void auction(World* world, const WorldTally* tally) {
+    int limited = world->config.stock > 0;
+
+    memcpy(world->demand, tally->demand, sizeof(world->demand));
+    for (int f = 0; f < world->fort_count; f++) {
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            world->rationing[f][item] = limited && tally->demand[f][item] > world->forts[f].stock[item];
+        }
+    }
+}
+
+// Take the tick's sales from the stock, restock, and move the prices
+static void settle_forts(World* world, const WorldTally* tally) {
+    const WorldConfig* config = &world->config;
+
+    for (int f = 0; f < world->fort_count; f++) {
+        WorldFort* fort = &world->forts[f];
+        fort->visits += tally->visits[f];
+        for (int item = 0; item < ITEM_COUNT; item++) {
+            fort->sold[item] += (uint64_t)tally->sold[f][item];
+            if (config->stock <= 0) {
+                continue; // Unlimited: the price never moves
+            }
+            fort->stock[item] -= tally->sold[f][item];
+            fort->stock[item] += config->restock;
+            if (fort->stock[item] > config->stock) {
+                fort->stock[item] = config->stock;
+            }
+
+            int32_t price = fort->price[item];
+            if (world->rationing[f][item]) {
+                fort->rationed++;
+                price += price / 8;
+                if (price > WORLD_PRICE_MAX) {
+                    price = WORLD_PRICE_MAX;
+                }
+            } else if (2 * tally->demand[f][item] < fort->stock[item]) {
+                // An eighth of the way back, rounded away from zero so the
+                // price settles on the trail's rate rather than just above it
+                int32_t above = price - WORLD_PRICE_ONE;
+                price -= above > 0 ? (above + 7) / 8 : -((7 - above) / 8);
+            }
+            fort->price[item] = price;
+        }
+    }
+}
+
+int world_tick(World* world, WorldTickReport* report) {
+    int threads = world->config.threads > 0 ? world->config.threads : batch_default_threads();
+    WorldWorker* workers = calloc((size_t)threads, sizeof(WorldWorker));
+    WorldTally* begun = malloc(sizeof(WorldTally));
+    WorldTally* finished = malloc(sizeof(WorldTally));
+    struct timespec start, end;
+    uint64_t rationed_before = 0;
+
+    if (!workers || !begun || !finished) {
+        free(workers);
+        free(begun);
+        free(finished);
+        return -1;
+    }
+    for (int f = 0; f < world->fort_count; f++) {
+        rationed_before += world->forts[f].rationed;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    run_system(world, begin_system, workers, threads, begun);
+    auction(world, begun);
+    run_system(world, finish_system, workers, threads, finished);
+    for (int f = 0; f < world->fort_count; f++) {
+        memcpy(finished->demand[f], begun->demand[f], sizeof(finished->demand[f]));
+        finished->visits[f] = begun->visits[f];
+    }
+    settle_forts(world, finished);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // Drop the finished wagons, keeping wagon order
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < world->active_count; i++) {
+        uint32_t w = world->active[i];
+        if (world->status[w] == WAGON_TRAVELING) {
+            world->active[kept++] = w;
+        } else if (world->result[w].outcome == TRIP_ARRIVED) {
+            world->arrived++;
+        } else {
+            world->died++;
+        }
+    }
+    world->active_count = kept;
+    world->tick++;
+
+    if (report) {
+        memset(report, 0, sizeof(*report));
+        report->tick = world->tick;
+        report->traveling = world->active_count;
+        report->arrived = world->arrived;
+        report->died = world->died;
+        for (int f = 0; f < world->fort_count; f++) {
+            report->fort_stops += begun->visits[f];
+            report->rationed += world->forts[f].rationed;
+            for (int item = 0; item < ITEM_COUNT; item++) {
+                report->goods_sold += (uint64_t)finished->sold[f][item];
+            }
+        }
+        report->rationed -= rationed_before;
+        report->seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    }
+
+    free(workers);
+    free(begun);
+    free(finished);
+    return world->active_count > 0;
+}
+
+void world_stats(const World* world, BatchStats* stats) {
+    memset(stats, 0, sizeof(BatchStats));
+    for (uint32_t w = 0; w < world->config.wagons; w++) {
+        if (world->status[w] != WAGON_TRAVELING) {
+            batch_stats_add(stats, &world->result[w]);
+        }
+    }
+}
+
+int world_fort_count(const World* world) {
+    return world->fort_count;
+}
+
+const WorldFort* world_fort(const World* world, int fort) {
+    return fort >= 0 && fort < world->fort_count ? &world->forts[fort] : NULL;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t world_digest(const World* world) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (uint32_t w = 0; w < world->config.wagons; w++) {
+        hash = fnv1a(hash, &world->trip[w], sizeof(GameState));
+        hash = fnv1a(hash, &world->rng[w], sizeof(unsigned int));
+        hash = fnv1a(hash, &world->status[w], 1);
+    }
+    for (int f = 0; f < world->fort_count; f++) {
+        hash = fnv1a(hash, world->forts[f].stock, sizeof(world->forts[f].stock));
+        hash = fnv1a(hash, world->forts[f].price, sizeof(world->forts[f].price));
+    }
+    return hash;
+}
@@ -0,0 +1,93 @@
+/*
+ * Shared world: many wagon parties on the same trail at once, buying from
+ * forts with finite stock.
+ *
+ * Wagons are entities; their components are parallel arrays indexed by wagon
+ * (the engine's trip state, generator state, status, this tick's action and
+ * fort bids). A tick is one turn for every wagon still traveling, played by
+ * systems that each sweep the active wagons on all threads:
+ *
+ *   begin    each wagon plays its turn up to the action prompt (begin_turn);
+ *            a wagon stopping at a fort bids dollars for each item, as it
+ *            would buy them at the fort's posted prices
+ *   auction  per fort and item, total demand at the posted price is compared
+ *            with the stock; if it exceeds the stock, every bidder gets the
+ *            same share of the stock (a uniform clearing price)
+ *   finish   each wagon pays its bids, takes its goods and plays the rest of
+ *            its turn (finish_turn)
+ *
+ * Then each fort's stock is reduced by what it sold and restocked, and its
+ * posted price moves with demand: up an eighth after a sold-out tick, back
+ * toward the trail's price when less than half the stock was asked for.
+ *
+ * Every wagon has its own generator stream, and the auction depends only on
+ * integer sums of the bids, so a world is deterministic for its seed whatever
+ * the thread count; no locks are taken. With unlimited stock a wagon plays
+ * exactly the trip simulate_trip plays for its seed.
+ *
+ * Forts are the trail's fort lines; a trail with a fort every other turn has
+ * one shared fort.
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "oregon.h"
+#include "batch.h"
+#include "trail.h"
+
+#define WORLD_PRICE_ONE 256         // Posted price of the trail's rate
+#define WORLD_PRICE_MAX (4 * WORLD_PRICE_ONE)
+
+typedef struct {
+    PurchasePlan plan;
+    const Policy* policy;
+    unsigned int first_seed;    // Wagon w plays seed first_seed + w
+    uint32_t wagons;
+    int threads;                // 0 picks the number of online CPUs
+    int64_t stock;              // Goods of each item a full fort holds, 0 for unlimited
+    int64_t restock;            // Goods of each item added every tick
+} WorldConfig;
+
+typedef struct {
+    char name[TRAIL_NAME_LEN];
+    int rate_num;               // Goods per dollar at WORLD_PRICE_ONE
+    int rate_den;
+    int64_t stock[ITEM_COUNT];
+    int32_t price[ITEM_COUNT];  // WORLD_PRICE_ONE is the trail's rate
+    uint64_t sold[ITEM_COUNT];  // Goods sold so far
+    uint64_t visits;
+    uint64_t rationed;          // Item bids filled only in part
+} WorldFort;
+
+typedef struct {
+    uint32_t tick;
+    uint32_t traveling;         // After the tick
+    uint32_t arrived;           // So far
+    uint32_t died;
+    uint32_t fort_stops;        // This tick
+    uint64_t goods_sold;
+    uint64_t rationed;
+    double seconds;
+} WorldTickReport;
+
+typedef struct World World;
+
+// NULL if the purchase plan is invalid or memory runs out
+World* world_create(const WorldConfig* config);
+void world_destroy(World* world);
+
+// Play one tick; returns 1 while any wagon is still traveling, 0 when all
+// have finished, -1 if memory runs out
+int world_tick(World* world, WorldTickReport* report);
+
+void world_stats(const World* world, BatchStats* stats);
+int world_fort_count(const World* world);
+const WorldFort* world_fort(const World* world, int fort);
+
+// Hash of every wagon and fort, for comparing runs
+uint64_t world_digest(const World* world);
+
+#endif // WORLD_H